@@ -0,0 +1,464 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+#include "Machine.hh"
+#include "Error.hh"
+#include "BenchDesign.hh"
+
+namespace sta {
+
+// Liberty table axes (ns, pf).
+static const float bench_slews[] = {0.01F, 0.05F, 0.2F, 0.8F};
+static const float bench_caps[] = {0.001F, 0.005F, 0.02F, 0.08F};
+static const int bench_axis_length = 4;
+static const float bench_pin_cap = 0.002F;
+// RC network values (pf, kohm).
+static const float bench_node_cap = 0.001F;
+static const float bench_node_res = 0.01F;
+static const float bench_load_res = 0.005F;
+static const float bench_clk_period = 10.0F;
+// Gate cells and their input pins indexed by input count - 1.
+static const int bench_gate_inputs_max = 4;
+static const char *bench_gate_cells[] = {"INV", "NAND2", "NAND3", "NAND4"};
+static const char *bench_gate_pins[] = {"A", "B", "C", "D"};
+
+static FILE *
+openBenchFile(const char *filename);
+static void
+writeTable(const char *group,
+	   const char *table_template,
+	   float intercept,
+	   float slew_coef,
+	   float cap_coef,
+	   const float *axis2,
+	   FILE *stream);
+
+BenchDesignParams::BenchDesignParams() :
+  gate_count_(10000),
+  depth_(20),
+  fanout_(3.0F),
+  fanout_skew_(0.0F),
+  clock_count_(1),
+  exception_count_(0),
+  rc_nodes_(3),
+  seed_(1)
+{
+}
+
+BenchDesign::BenchDesign(const BenchDesignParams &params) :
+  params_(params),
+  width_(std::max(1, params.gate_count_ / std::max(1, params.depth_))),
+  random_(params.seed_)
+{
+  params_.depth_ = std::max(1, params_.depth_);
+  params_.clock_count_ = std::max(1, params_.clock_count_);
+  params_.fanout_ = std::min(std::max(1.0F, params_.fanout_),
+			     static_cast<float>(bench_gate_inputs_max));
+  params_.fanout_skew_ = std::max(0.0F, params_.fanout_skew_);
+  params_.rc_nodes_ = std::max(0, params_.rc_nodes_);
+  makeNetlist();
+}
+
+int
+BenchDesign::random(int count)
+{
+  // Avoid std distributions so designs are the same on all platforms.
+  return random_() % count;
+}
+
+float
+BenchDesign::randomUnit()
+{
+  return static_cast<float>(random_()) / 4294967296.0F;
+}
+
+void
+BenchDesign::makeNetlist()
+{
+  int depth = params_.depth_;
+  net_loads_.resize(depth + 1);
+  for (auto &level_loads : net_loads_)
+    level_loads.resize(width_);
+  // Every level has width_ gates, so the average fanout is the average
+  // gate input count.
+  int fanout_floor = static_cast<int>(params_.fanout_);
+  float fanout_frac = params_.fanout_ - fanout_floor;
+  float skew_exp = 1.0F + params_.fanout_skew_;
+  gates_.resize(depth);
+  for (int level = 1; level <= depth; level++) {
+    std::vector<BenchGate> &level_gates = gates_[level - 1];
+    level_gates.resize(width_);
+    int input_count = 0;
+    for (int i = 0; i < width_; i++) {
+      BenchGate &gate = level_gates[i];
+      int gate_inputs = fanout_floor + (randomUnit() < fanout_frac ? 1 : 0);
+      gate_inputs = std::min(std::max(gate_inputs, 1), bench_gate_inputs_max);
+      gate.inputs_.resize(gate_inputs);
+      input_count += gate_inputs;
+    }
+    // Each net of the previous level drives one input and the rest of
+    // the inputs are drawn from all of the nets, favoring the low
+    // numbered nets when the fanout is skewed.
+    std::vector<int> input_nets;
+    input_nets.reserve(input_count);
+    for (int i = 0; i < width_ && i < input_count; i++)
+      input_nets.push_back(i);
+    while (static_cast<int>(input_nets.size()) < input_count) {
+      int input = static_cast<int>(width_ * pow(randomUnit(), skew_exp));
+      input_nets.push_back(std::min(input, width_ - 1));
+    }
+    for (int i = input_count - 1; i > 0; i--)
+      std::swap(input_nets[i], input_nets[random(i + 1)]);
+    size_t next_input = 0;
+    for (int i = 0; i < width_; i++) {
+      BenchGate &gate = level_gates[i];
+      for (size_t j = 0; j < gate.inputs_.size(); j++) {
+	int input = input_nets[next_input++];
+	gate.inputs_[j] = input;
+	string load = "g_" + std::to_string(level)
+	  + "_" + std::to_string(i)
+	  + ":" + bench_gate_pins[j];
+	net_loads_[level - 1][input].push_back(load);
+      }
+    }
+  }
+  for (int i = 0; i < width_; i++)
+    net_loads_[depth][i].push_back("r_" + std::to_string(i) + ":D");
+}
+
+void
+BenchDesign::write(const char *dir)
+{
+  string prefix = string(dir) + "/bench";
+  liberty_filename_ = prefix + ".lib";
+  verilog_filename_ = prefix + ".v";
+  sdc_filename_ = prefix + ".sdc";
+  exceptions_filename_ = prefix + "_exceptions.sdc";
+  writeLiberty(liberty_filename_.c_str());
+  writeVerilog(verilog_filename_.c_str());
+  if (params_.rc_nodes_ > 0) {
+    spef_filename_ = prefix + ".spef";
+    writeSpef(spef_filename_.c_str());
+  }
+  else
+    spef_filename_.clear();
+  writeSdc(sdc_filename_.c_str(), exceptions_filename_.c_str());
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+BenchDesign::writeLiberty(const char *filename)
+{
+  FILE *stream = openBenchFile(filename);
+  fprintf(stream, "library (bench) {\n");
+  fprintf(stream, "  delay_model : table_lookup;\n");
+  fprintf(stream, "  time_unit : \"1ns\";\n");
+  fprintf(stream, "  voltage_unit : \"1V\";\n");
+  fprintf(stream, "  current_unit : \"1mA\";\n");
+  fprintf(stream, "  pulling_resistance_unit : \"1kohm\";\n");
+  fprintf(stream, "  capacitive_load_unit (1, pf);\n");
+  fprintf(stream, "  nom_process : 1.0;\n");
+  fprintf(stream, "  nom_voltage : 1.0;\n");
+  fprintf(stream, "  nom_temperature : 25.0;\n");
+  fprintf(stream, "  input_threshold_pct_rise : 50;\n");
+  fprintf(stream, "  input_threshold_pct_fall : 50;\n");
+  fprintf(stream, "  output_threshold_pct_rise : 50;\n");
+  fprintf(stream, "  output_threshold_pct_fall : 50;\n");
+  fprintf(stream, "  slew_lower_threshold_pct_rise : 20;\n");
+  fprintf(stream, "  slew_lower_threshold_pct_fall : 20;\n");
+  fprintf(stream, "  slew_upper_threshold_pct_rise : 80;\n");
+  fprintf(stream, "  slew_upper_threshold_pct_fall : 80;\n");
+  fprintf(stream, "  slew_derate_from_library : 1.0;\n");
+
+  fprintf(stream, "  lu_table_template (delay_template) {\n");
+  fprintf(stream, "    variable_1 : input_net_transition;\n");
+  fprintf(stream, "    variable_2 : total_output_net_capacitance;\n");
+  fprintf(stream, "    index_1 (\"0.01, 0.05, 0.2, 0.8\");\n");
+  fprintf(stream, "    index_2 (\"0.001, 0.005, 0.02, 0.08\");\n");
+  fprintf(stream, "  }\n");
+  fprintf(stream, "  lu_table_template (check_template) {\n");
+  fprintf(stream, "    variable_1 : constrained_pin_transition;\n");
+  fprintf(stream, "    variable_2 : related_pin_transition;\n");
+  fprintf(stream, "    index_1 (\"0.01, 0.05, 0.2, 0.8\");\n");
+  fprintf(stream, "    index_2 (\"0.01, 0.05, 0.2, 0.8\");\n");
+  fprintf(stream, "  }\n");
+
+  writeCell("INV", "!A", "negative_unate", {"A"}, 1.0F, stream);
+  writeCell("NAND2", "!(A*B)", "negative_unate", {"A", "B"}, 1.3F, stream);
+  writeCell("NAND3", "!(A*B*C)", "negative_unate", {"A", "B", "C"}, 1.6F,
+	    stream);
+  writeCell("NAND4", "!(A*B*C*D)", "negative_unate", {"A", "B", "C", "D"},
+	    1.9F, stream);
+
+  fprintf(stream, "  cell (DFF) {\n");
+  fprintf(stream, "    area : 4;\n");
+  fprintf(stream, "    ff (IQ, IQN) {\n");
+  fprintf(stream, "      next_state : \"D\";\n");
+  fprintf(stream, "      clocked_on : \"CK\";\n");
+  fprintf(stream, "    }\n");
+  fprintf(stream, "    pin (CK) {\n");
+  fprintf(stream, "      direction : input;\n");
+  fprintf(stream, "      clock : true;\n");
+  fprintf(stream, "      capacitance : %g;\n", bench_pin_cap);
+  fprintf(stream, "    }\n");
+  fprintf(stream, "    pin (D) {\n");
+  fprintf(stream, "      direction : input;\n");
+  fprintf(stream, "      capacitance : %g;\n", bench_pin_cap);
+  const char *checks[] = {"setup_rising", "hold_rising"};
+  for (const char *check : checks) {
+    bool setup = check == checks[0];
+    fprintf(stream, "      timing () {\n");
+    fprintf(stream, "        related_pin : \"CK\";\n");
+    fprintf(stream, "        timing_type : %s;\n", check);
+    writeTable("rise_constraint", "check_template", setup ? 0.05F : 0.01F,
+	       setup ? 0.2F : -0.05F, 0.1F, bench_slews, stream);
+    writeTable("fall_constraint", "check_template", setup ? 0.06F : 0.01F,
+	       setup ? 0.2F : -0.05F, 0.1F, bench_slews, stream);
+    fprintf(stream, "      }\n");
+  }
+  fprintf(stream, "    }\n");
+  fprintf(stream, "    pin (Q) {\n");
+  fprintf(stream, "      direction : output;\n");
+  fprintf(stream, "      function : \"IQ\";\n");
+  fprintf(stream, "      timing () {\n");
+  fprintf(stream, "        related_pin : \"CK\";\n");
+  fprintf(stream, "        timing_type : rising_edge;\n");
+  writeTable("cell_rise", "delay_template", 0.08F, 0.1F, 2.0F,
+	     bench_caps, stream);
+  writeTable("rise_transition", "delay_template", 0.02F, 0.05F, 4.0F,
+	     bench_caps, stream);
+  writeTable("cell_fall", "delay_template", 0.09F, 0.1F, 1.8F,
+	     bench_caps, stream);
+  writeTable("fall_transition", "delay_template", 0.02F, 0.05F, 3.5F,
+	     bench_caps, stream);
+  fprintf(stream, "      }\n");
+  fprintf(stream, "    }\n");
+  fprintf(stream, "  }\n");
+  fprintf(stream, "}\n");
+  fclose(stream);
+}
+
+void
+BenchDesign::writeCell(const char *name,
+		       const char *function,
+		       const char *sense,
+		       const std::vector<const char*> &inputs,
+		       float delay_scale,
+		       FILE *stream)
+{
+  fprintf(stream, "  cell (%s) {\n", name);
+  fprintf(stream, "    area : %zu;\n", inputs.size());
+  for (const char *input : inputs) {
+    fprintf(stream, "    pin (%s) {\n", input);
+    fprintf(stream, "      direction : input;\n");
+    fprintf(stream, "      capacitance : %g;\n", bench_pin_cap);
+    fprintf(stream, "    }\n");
+  }
+  fprintf(stream, "    pin (Y) {\n");
+  fprintf(stream, "      direction : output;\n");
+  fprintf(stream, "      function : \"%s\";\n", function);
+  for (const char *input : inputs) {
+    fprintf(stream, "      timing () {\n");
+    fprintf(stream, "        related_pin : \"%s\";\n", input);
+    fprintf(stream, "        timing_sense : %s;\n", sense);
+    writeTable("cell_rise", "delay_template", 0.02F * delay_scale,
+	       0.2F, 3.0F * delay_scale, bench_caps, stream);
+    writeTable("rise_transition", "delay_template", 0.01F,
+	       0.1F, 5.0F * delay_scale, bench_caps, stream);
+    writeTable("cell_fall", "delay_template", 0.018F * delay_scale,
+	       0.18F, 2.5F * delay_scale, bench_caps, stream);
+    writeTable("fall_transition", "delay_template", 0.01F,
+	       0.1F, 4.0F * delay_scale, bench_caps, stream);
+    fprintf(stream, "      }\n");
+  }
+  fprintf(stream, "    }\n");
+  fprintf(stream, "  }\n");
+}
+
+// Table of intercept + slew_coef * index_1 + cap_coef * index_2.
+static void
+writeTable(const char *group,
+	   const char *table_template,
+	   float intercept,
+	   float slew_coef,
+	   float cap_coef,
+	   const float *axis2,
+	   FILE *stream)
+{
+  fprintf(stream, "        %s (%s) {\n", group, table_template);
+  fprintf(stream, "          values (");
+  for (int i = 0; i < bench_axis_length; i++) {
+    fprintf(stream, "%s\"", i == 0 ? "" : ", ");
+    for (int j = 0; j < bench_axis_length; j++)
+      fprintf(stream, "%s%.4f", j == 0 ? "" : ", ",
+	      intercept + slew_coef * bench_slews[i] + cap_coef * axis2[j]);
+    fprintf(stream, "\"");
+  }
+  fprintf(stream, ");\n");
+  fprintf(stream, "        }\n");
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+BenchDesign::writeVerilog(const char *filename)
+{
+  FILE *stream = openBenchFile(filename);
+  int clk_count = params_.clock_count_;
+  fprintf(stream, "module %s (", topName());
+  for (int k = 0; k < clk_count; k++)
+    fprintf(stream, "%sclk%d", k == 0 ? "" : ", ", k);
+  fprintf(stream, ");\n");
+  for (int k = 0; k < clk_count; k++)
+    fprintf(stream, "  input clk%d;\n", k);
+  int depth = params_.depth_;
+  for (int level = 0; level <= depth; level++) {
+    for (int i = 0; i < width_; i++)
+      fprintf(stream, "  wire n_%d_%d;\n", level, i);
+  }
+  for (int i = 0; i < width_; i++)
+    fprintf(stream, "  DFF r_%d (.CK(clk%d), .D(n_%d_%d), .Q(n_0_%d));\n",
+	    i, i % clk_count, depth, i, i);
+  for (int level = 1; level <= depth; level++) {
+    const std::vector<BenchGate> &level_gates = gates_[level - 1];
+    for (int i = 0; i < width_; i++) {
+      const BenchGate &gate = level_gates[i];
+      fprintf(stream, "  %s g_%d_%d (",
+	      bench_gate_cells[gate.inputs_.size() - 1], level, i);
+      for (size_t j = 0; j < gate.inputs_.size(); j++)
+	fprintf(stream, ".%s(n_%d_%d), ",
+		bench_gate_pins[j], level - 1, gate.inputs_[j]);
+      fprintf(stream, ".Y(n_%d_%d));\n", level, i);
+    }
+  }
+  fprintf(stream, "endmodule\n");
+  fclose(stream);
+}
+
+////////////////////////////////////////////////////////////////
+
+// Each net is a chain of rc_nodes nodes from the driver with the
+// loads spread along the chain.
+void
+BenchDesign::writeSpef(const char *filename)
+{
+  FILE *stream = openBenchFile(filename);
+  fprintf(stream, "*SPEF \"IEEE 1481-1998\"\n");
+  fprintf(stream, "*DESIGN \"%s\"\n", topName());
+  fprintf(stream, "*DATE \"\"\n");
+  fprintf(stream, "*VENDOR \"\"\n");
+  fprintf(stream, "*PROGRAM \"sta_bench\"\n");
+  fprintf(stream, "*VERSION \"\"\n");
+  fprintf(stream, "*DESIGN_FLOW \"\"\n");
+  fprintf(stream, "*DIVIDER /\n");
+  fprintf(stream, "*DELIMITER :\n");
+  fprintf(stream, "*BUS_DELIMITER [ ]\n");
+  fprintf(stream, "*T_UNIT 1 NS\n");
+  fprintf(stream, "*C_UNIT 1 PF\n");
+  fprintf(stream, "*R_UNIT 1 KOHM\n");
+  fprintf(stream, "*L_UNIT 1 HENRY\n\n");
+  int node_count = params_.rc_nodes_;
+  for (int level = 0; level <= params_.depth_; level++) {
+    for (int i = 0; i < width_; i++) {
+      const std::vector<string> &loads = net_loads_[level][i];
+      string net = "n_" + std::to_string(level) + "_" + std::to_string(i);
+      string drvr = (level == 0)
+	? "r_" + std::to_string(i) + ":Q"
+	: "g_" + std::to_string(level) + "_" + std::to_string(i) + ":Y";
+      fprintf(stream, "*D_NET %s %g\n", net.c_str(),
+	      node_count * bench_node_cap);
+      fprintf(stream, "*CONN\n");
+      fprintf(stream, "*I %s O\n", drvr.c_str());
+      for (const string &load : loads)
+	fprintf(stream, "*I %s I\n", load.c_str());
+      fprintf(stream, "*CAP\n");
+      for (int node = 1; node <= node_count; node++)
+	fprintf(stream, "%d %s:%d %g\n", node, net.c_str(), node,
+		bench_node_cap);
+      fprintf(stream, "*RES\n");
+      int res_index = 1;
+      fprintf(stream, "%d %s %s:1 %g\n", res_index++,
+	      drvr.c_str(), net.c_str(), bench_node_res);
+      for (int node = 2; node <= node_count; node++)
+	fprintf(stream, "%d %s:%d %s:%d %g\n", res_index++,
+		net.c_str(), node - 1, net.c_str(), node, bench_node_res);
+      int load_count = loads.size();
+      for (int j = 0; j < load_count; j++) {
+	int node = 1 + (j * node_count) / load_count;
+	fprintf(stream, "%d %s:%d %s %g\n", res_index++,
+		net.c_str(), node, loads[j].c_str(), bench_load_res);
+      }
+      fprintf(stream, "*END\n\n");
+    }
+  }
+  fclose(stream);
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+BenchDesign::writeSdc(const char *filename,
+		      const char *exceptions_filename)
+{
+  FILE *stream = openBenchFile(filename);
+  FILE *exceptions_stream = openBenchFile(exceptions_filename);
+  for (int k = 0; k < params_.clock_count_; k++)
+    fprintf(stream, "create_clock -name clk%d -period %g [get_ports clk%d]\n",
+	    k, bench_clk_period, k);
+  fprintf(stream, "set_input_transition 0.05 [all_inputs]\n");
+  for (int e = 0; e < params_.exception_count_; e++) {
+    int from = random(width_);
+    int to = random(width_);
+    char exception[200];
+    switch (e % 3) {
+    case 0:
+      snprintf(exception, sizeof(exception),
+	       "set_false_path -from [get_pins r_%d/CK] -to [get_pins r_%d/D]\n",
+	       from, to);
+      break;
+    case 1:
+      snprintf(exception, sizeof(exception),
+	       "set_multicycle_path 2 -setup -from [get_pins r_%d/CK] -to [get_pins r_%d/D]\n",
+	       from, to);
+      break;
+    default: {
+      int level = 1 + random(params_.depth_);
+      snprintf(exception, sizeof(exception),
+	       "set_max_delay %g -through [get_pins g_%d_%d/Y]\n",
+	       bench_clk_period * 0.8F, level, random(width_));
+      break;
+    }
+    }
+    fputs(exception, stream);
+    fputs(exception, exceptions_stream);
+  }
+  fclose(stream);
+  fclose(exceptions_stream);
+}
+
+static FILE *
+openBenchFile(const char *filename)
+{
+  FILE *stream = fopen(filename, "w");
+  if (stream == nullptr)
+    throw FileNotWritable(filename);
+  return stream;
+}
+
+} // namespace
@@ -0,0 +1,120 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_BENCH_DESIGN_H
+#define STA_BENCH_DESIGN_H
+
+#include <stdio.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+
+namespace sta {
+
+using std::string;
+
+class BenchDesignParams
+{
+public:
+  BenchDesignParams();
+
+  // Combinational gates (INV and NAND2 to NAND4).
+  int gate_count_;
+  // Gate levels between register banks.
+  int depth_;
+  // Average fanout (1 to 4) of the gate and register outputs that
+  // drive the next level. Every output drives at least one load.
+  float fanout_;
+  // 0 spreads loads evenly over the driving nets. Larger values make
+  // a few nets with large fanouts and many with small fanouts.
+  float fanout_skew_;
+  int clock_count_;
+  // False path, multicycle path and max delay exceptions.
+  int exception_count_;
+  // RC network nodes of each net. 0 writes no parasitics.
+  int rc_nodes_;
+  unsigned seed_;
+};
+
+// Synthetic design generator for benchmarks.
+//
+// The design is a bank of registers that drives depth levels of
+// gates that feed back to the register D pins. The registers are
+// spread over the clocks so there are paths between clock domains.
+// A Liberty library of the cells, the Verilog netlist, SPEF
+// parasitics and SDC constraints are written to a directory.
+// Designs with the same parameters and seed are identical.
+class BenchDesign
+{
+public:
+  BenchDesign(const BenchDesignParams &params);
+  // Write bench.lib, bench.v, bench.spef, bench.sdc and
+  // bench_exceptions.sdc to dir, which must exist.
+  void write(const char *dir);
+  const string &libertyFilename() const { return liberty_filename_; }
+  const string &verilogFilename() const { return verilog_filename_; }
+  // Empty when there are no parasitics.
+  const string &spefFilename() const { return spef_filename_; }
+  const string &sdcFilename() const { return sdc_filename_; }
+  // The exceptions of the sdc file alone.
+  const string &exceptionsFilename() const { return exceptions_filename_; }
+  int registerCount() const { return width_; }
+  static const char *topName() { return "top"; }
+
+protected:
+  void makeNetlist();
+  void writeLiberty(const char *filename);
+  void writeCell(const char *name,
+		 const char *function,
+		 const char *sense,
+		 const std::vector<const char*> &inputs,
+		 float delay_scale,
+		 FILE *stream);
+  void writeVerilog(const char *filename);
+  void writeSpef(const char *filename);
+  void writeSdc(const char *filename,
+		const char *exceptions_filename);
+  int random(int count);
+  float randomUnit();
+
+  class BenchGate
+  {
+  public:
+    // Input nets; one for INV and two to four for NAND2 to NAND4.
+    std::vector<int> inputs_;
+  };
+
+  BenchDesignParams params_;
+  int width_;
+  std::mt19937 random_;
+  // Gates of levels 1 to depth indexed by [level-1][index].
+  std::vector<std::vector<BenchGate>> gates_;
+  // Load pins of each net indexed by [level][index].
+  // Level 0 nets are driven by the registers.
+  std::vector<std::vector<std::vector<string>>> net_loads_;
+  string liberty_filename_;
+  string verilog_filename_;
+  string spef_filename_;
+  string sdc_filename_;
+  string exceptions_filename_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(BenchDesign);
+};
+
+} // namespace
+#endif
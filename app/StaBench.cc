@@ -0,0 +1,760 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// sta_bench generates a synthetic design, times the phases of a
+// timing update at several thread counts and runs microbenchmarks of
+// the table lookup, DMP driver solve, tag lookup, path enumeration,
+// exception merging and network edit hot paths. The results can be written as a baseline and compared
+// with a previous baseline.
+
+#include <tcl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include "Machine.hh"
+#include "StringUtil.hh"
+#include "Error.hh"
+#include "MinMax.hh"
+#include "Transition.hh"
+#include "TimingRole.hh"
+#include "TimingArc.hh"
+#include "TableModel.hh"
+#include "Liberty.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "Corner.hh"
+#include "Sdc.hh"
+#include "DcalcAnalysisPt.hh"
+#include "ArcDelayCalc.hh"
+#include "GraphDelayCalc.hh"
+#include "DmpDelayCalc.hh"
+#include "Tag.hh"
+#include "Search.hh"
+#include "Sta.hh"
+#include "StaMain.hh"
+#include "BenchDesign.hh"
+
+using std::string;
+
+using sta::BenchDesign;
+using sta::BenchDesignParams;
+using sta::Sta;
+
+// Swig uses C linkage for init functions.
+extern "C" {
+extern int Sta_Init(Tcl_Interp *interp);
+}
+
+namespace sta {
+extern const char *tcl_inits[];
+}
+
+namespace {
+
+class BenchResult
+{
+public:
+  string name_;
+  double value_;
+  // "s", "ps" (values are still seconds) or "bytes"
+  const char *unit_;
+};
+
+typedef std::vector<BenchResult> BenchResultSeq;
+typedef std::map<string, double> BenchBaseline;
+
+// Input slew used by the driver solve benchmark (seconds).
+const float bench_in_slew = 50e-12F;
+
+void
+showBenchUsage(const char *prog);
+bool
+parseArgs(int argc,
+	  char *argv[],
+	  BenchDesignParams &params,
+	  std::vector<int> &thread_counts,
+	  int &iterations,
+	  string &dir,
+	  const char *&baseline_filename,
+	  const char *&write_baseline_filename,
+	  float &tolerance);
+Tcl_Interp *
+makeInterp(Sta *sta);
+void
+evalCmd(Tcl_Interp *interp,
+	const string &cmd);
+void
+benchCmd(Tcl_Interp *interp,
+	 const char *name,
+	 const string &cmd,
+	 BenchResultSeq &results);
+void
+benchUpdateTiming(Sta *sta,
+		  const std::vector<int> &thread_counts,
+		  int iterations,
+		  BenchResultSeq &results);
+void
+benchCompactDelays(Sta *sta,
+		   BenchResultSeq &results);
+void
+benchTableFindValue(Sta *sta,
+		    int iterations,
+		    BenchResultSeq &results);
+void
+benchGateDelays(Sta *sta,
+		int iterations,
+		BenchResultSeq &results);
+void
+benchFindTag(Sta *sta,
+	     int iterations,
+	     BenchResultSeq &results);
+void
+benchPathEnum(Tcl_Interp *interp,
+	      int iterations,
+	      BenchResultSeq &results);
+void
+benchExceptions(Tcl_Interp *interp,
+		Sta *sta,
+		const BenchDesign &design,
+		BenchResultSeq &results);
+void
+benchEditBatch(Sta *sta,
+	       BenchResultSeq &results);
+void
+reportResults(const BenchResultSeq &results,
+	      const BenchBaseline &baseline,
+	      float tolerance,
+	      int &regression_count);
+string
+resultValueString(double value,
+		  const char *unit);
+void
+writeBaseline(const char *filename,
+	      const BenchResultSeq &results);
+void
+readBaseline(const char *filename,
+	     BenchBaseline &baseline);
+
+} // namespace
+
+int
+main(int argc,
+     char *argv[])
+{
+  BenchDesignParams params;
+  std::vector<int> thread_counts;
+  int iterations = 3;
+  string dir = "sta_bench";
+  const char *baseline_filename = nullptr;
+  const char *write_baseline_filename = nullptr;
+  float tolerance = 10.0;
+  if (!parseArgs(argc, argv, params, thread_counts, iterations, dir,
+		 baseline_filename, write_baseline_filename, tolerance)) {
+    showBenchUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  sta::initSta();
+  Sta *sta = new Sta;
+  Sta::setSta(sta);
+  sta->makeComponents();
+  Tcl_Interp *interp = makeInterp(sta);
+
+  try {
+    printf("Generating %d gates depth %d in %s\n",
+	   params.gate_count_, params.depth_, dir.c_str());
+    evalCmd(interp, "file mkdir " + dir);
+    BenchDesign design(params);
+    design.write(dir.c_str());
+
+    BenchResultSeq results;
+    benchCmd(interp, "read_liberty",
+	     "read_liberty " + design.libertyFilename(), results);
+    benchCmd(interp, "read_verilog",
+	     "read_verilog " + design.verilogFilename(), results);
+    benchCmd(interp, "link_design",
+	     string("link_design ") + BenchDesign::topName(), results);
+    if (!design.spefFilename().empty())
+      benchCmd(interp, "read_spef",
+	       "read_spef " + design.spefFilename(), results);
+    benchCmd(interp, "read_sdc", "read_sdc " + design.sdcFilename(), results);
+
+    benchUpdateTiming(sta, thread_counts, iterations, results);
+    benchCompactDelays(sta, results);
+    sta->setThreadCount(1);
+    benchTableFindValue(sta, iterations, results);
+    if (!design.spefFilename().empty())
+      benchGateDelays(sta, iterations, results);
+    benchFindTag(sta, iterations, results);
+    benchPathEnum(interp, iterations, results);
+    if (params.exception_count_ > 0)
+      benchExceptions(interp, sta, design, results);
+    benchEditBatch(sta, results);
+    results.push_back({"memory", static_cast<double>(sta::peakMemoryUsage()),
+		       "bytes"});
+
+    BenchBaseline baseline;
+    if (baseline_filename)
+      readBaseline(baseline_filename, baseline);
+    int regression_count = 0;
+    reportResults(results, baseline, tolerance, regression_count);
+    if (write_baseline_filename)
+      writeBaseline(write_baseline_filename, results);
+    if (regression_count > 0) {
+      printf("%d benchmarks regressed more than %.0f%%.\n",
+	     regression_count, tolerance);
+      return EXIT_FAILURE;
+    }
+  }
+  catch (sta::StaException &excp) {
+    fprintf(stderr, "Error: %s\n", excp.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+namespace {
+
+void
+showBenchUsage(const char *prog)
+{
+  printf("Usage: %s [-gates count] [-depth levels] [-fanout average]\n",
+	 prog);
+  printf("       [-fanout_skew skew] [-clocks count] [-exceptions count]\n");
+  printf("       [-rc_nodes count] [-seed seed] [-threads count,...]\n");
+  printf("       [-iterations count] [-dir dir] [-baseline filename]\n");
+  printf("       [-write_baseline filename] [-tolerance percent]\n");
+  printf("  -gates           combinational gates (10000)\n");
+  printf("  -depth           gate levels between registers (20)\n");
+  printf("  -fanout          average net fanout, 1 to 4 (3)\n");
+  printf("  -fanout_skew     0 for even fanouts, larger for a few large fanouts (0)\n");
+  printf("  -clocks          register clocks (1)\n");
+  printf("  -exceptions      false/multicycle/max delay paths (0)\n");
+  printf("  -rc_nodes        RC nodes per net, 0 for no parasitics (3)\n");
+  printf("  -threads         thread counts to time (1,max)\n");
+  printf("  -iterations      runs of each benchmark; the fastest is used (3)\n");
+  printf("  -dir             directory for the design files (sta_bench)\n");
+  printf("  -baseline        compare results with a baseline file\n");
+  printf("  -write_baseline  write results as a baseline file\n");
+  printf("  -tolerance       percent slower than baseline that fails (10)\n");
+}
+
+bool
+parseArgs(int argc,
+	  char *argv[],
+	  BenchDesignParams &params,
+	  std::vector<int> &thread_counts,
+	  int &iterations,
+	  string &dir,
+	  const char *&baseline_filename,
+	  const char *&write_baseline_filename,
+	  float &tolerance)
+{
+  if (sta::findCmdLineFlag(argc, argv, "-help"))
+    return false;
+  const char *arg;
+  if ((arg = sta::findCmdLineKey(argc, argv, "-gates")))
+    params.gate_count_ = atoi(arg);
+  if ((arg = sta::findCmdLineKey(argc, argv, "-depth")))
+    params.depth_ = atoi(arg);
+  if ((arg = sta::findCmdLineKey(argc, argv, "-fanout")))
+    params.fanout_ = atof(arg);
+  if ((arg = sta::findCmdLineKey(argc, argv, "-fanout_skew")))
+    params.fanout_skew_ = atof(arg);
+  if ((arg = sta::findCmdLineKey(argc, argv, "-clocks")))
+    params.clock_count_ = atoi(arg);
+  if ((arg = sta::findCmdLineKey(argc, argv, "-exceptions")))
+    params.exception_count_ = atoi(arg);
+  if ((arg = sta::findCmdLineKey(argc, argv, "-rc_nodes")))
+    params.rc_nodes_ = atoi(arg);
+  if ((arg = sta::findCmdLineKey(argc, argv, "-seed")))
+    params.seed_ = atoi(arg);
+  if ((arg = sta::findCmdLineKey(argc, argv, "-iterations")))
+    iterations = std::max(1, atoi(arg));
+  if ((arg = sta::findCmdLineKey(argc, argv, "-dir")))
+    dir = arg;
+  baseline_filename = sta::findCmdLineKey(argc, argv, "-baseline");
+  write_baseline_filename = sta::findCmdLineKey(argc, argv,
+						"-write_baseline");
+  if ((arg = sta::findCmdLineKey(argc, argv, "-tolerance")))
+    tolerance = atof(arg);
+  if ((arg = sta::findCmdLineKey(argc, argv, "-threads"))) {
+    string threads = arg;
+    size_t begin = 0;
+    while (begin < threads.size()) {
+      size_t end = threads.find(',', begin);
+      if (end == string::npos)
+	end = threads.size();
+      string count = threads.substr(begin, end - begin);
+      if (sta::stringEqual(count.c_str(), "max"))
+	thread_counts.push_back(sta::processorCount());
+      else if (sta::isDigits(count.c_str()) && atoi(count.c_str()) > 0)
+	thread_counts.push_back(atoi(count.c_str()));
+      else {
+	fprintf(stderr, "Error: -threads must be a list of max or positive integers.\n");
+	return false;
+      }
+      begin = end + 1;
+    }
+  }
+  else {
+    thread_counts.push_back(1);
+    if (sta::processorCount() > 1)
+      thread_counts.push_back(sta::processorCount());
+  }
+  if (argc > 1) {
+    fprintf(stderr, "Error: unknown argument %s.\n", argv[1]);
+    return false;
+  }
+  return true;
+}
+
+Tcl_Interp *
+makeInterp(Sta *sta)
+{
+  Tcl_Interp *interp = Tcl_CreateInterp();
+  Tcl_Init(interp);
+  Sta_Init(interp);
+  sta->setTclInterp(interp);
+  sta::evalTclInit(interp, sta::tcl_inits);
+  Tcl_Eval(interp, "sta::define_sta_cmds");
+  Tcl_Eval(interp, "namespace import sta::*");
+  return interp;
+}
+
+void
+evalCmd(Tcl_Interp *interp,
+	const string &cmd)
+{
+  if (Tcl_Eval(interp, cmd.c_str()) != TCL_OK) {
+    fprintf(stderr, "Error: %s: %s\n", cmd.c_str(),
+	    Tcl_GetStringResult(interp));
+    exit(EXIT_FAILURE);
+  }
+}
+
+void
+benchCmd(Tcl_Interp *interp,
+	 const char *name,
+	 const string &cmd,
+	 BenchResultSeq &results)
+{
+  double begin = sta::elapsedRunTime();
+  evalCmd(interp, cmd);
+  results.push_back({name, sta::elapsedRunTime() - begin, "s"});
+}
+
+// Full delay calculation and search, and search alone (parallel BFS
+// visits of the arrivals), at each thread count.
+void
+benchUpdateTiming(Sta *sta,
+		  const std::vector<int> &thread_counts,
+		  int iterations,
+		  BenchResultSeq &results)
+{
+  for (int thread_count : thread_counts) {
+    sta->setThreadCount(thread_count);
+    double update_time = std::numeric_limits<double>::max();
+    double arrivals_time = std::numeric_limits<double>::max();
+    for (int i = 0; i < iterations; i++) {
+      sta->graphDelayCalc()->delaysInvalid();
+      double begin = sta::elapsedRunTime();
+      sta->updateTiming(true);
+      update_time = std::min(update_time, sta::elapsedRunTime() - begin);
+
+      begin = sta::elapsedRunTime();
+      sta->updateTiming(true);
+      arrivals_time = std::min(arrivals_time, sta::elapsedRunTime() - begin);
+    }
+    string suffix = "_threads_" + std::to_string(thread_count);
+    results.push_back({"update_timing" + suffix, update_time, "s"});
+    results.push_back({"arrivals" + suffix, arrivals_time, "s"});
+  }
+}
+
+// Graph delay storage in full and compact (sta_compact_delays) modes,
+// and the largest difference between the arc delays and vertex slacks
+// found in the two modes.
+void
+benchCompactDelays(Sta *sta,
+		   BenchResultSeq &results)
+{
+  bool compact = sta->compactDelays();
+  std::vector<float> full_delays, full_slacks;
+  double max_delay_error = 0.0;
+  double max_slack_error = 0.0;
+  for (bool compact_delays : {false, true}) {
+    sta->setCompactDelays(compact_delays);
+    sta->updateTiming(true);
+    sta::Graph *graph = sta->graph();
+    sta::DcalcAPIndex ap_count = sta->corners()->dcalcAnalysisPtCount();
+    size_t delay_index = 0;
+    sta::VertexIterator vertex_iter(graph);
+    while (vertex_iter.hasNext()) {
+      sta::Vertex *vertex = vertex_iter.next();
+      sta::VertexOutEdgeIterator edge_iter(vertex, graph);
+      while (edge_iter.hasNext()) {
+	sta::Edge *edge = edge_iter.next();
+	sta::TimingArcSetArcIterator arc_iter(edge->timingArcSet());
+	while (arc_iter.hasNext()) {
+	  sta::TimingArc *arc = arc_iter.next();
+	  for (sta::DcalcAPIndex ap_index = 0; ap_index < ap_count; ap_index++){
+	    float delay = sta::delayAsFloat(graph->arcDelay(edge, arc, ap_index));
+	    if (compact_delays)
+	      max_delay_error = std::max(max_delay_error,
+					 std::abs(static_cast<double>(delay)
+						  - full_delays[delay_index++]));
+	    else
+	      full_delays.push_back(delay);
+	  }
+	}
+      }
+    }
+    size_t slack_index = 0;
+    sta::VertexIterator vertex_iter2(graph);
+    while (vertex_iter2.hasNext()) {
+      sta::Vertex *vertex = vertex_iter2.next();
+      float slack = sta::delayAsFloat(sta->vertexSlack(vertex,
+						       sta::MinMax::max()));
+      if (compact_delays) {
+	float full_slack = full_slacks[slack_index++];
+	// Unconstrained vertices have INF slack in both modes.
+	if (slack < sta::INF && full_slack < sta::INF)
+	  max_slack_error = std::max(max_slack_error,
+				     std::abs(static_cast<double>(slack)
+					      - full_slack));
+      }
+      else
+	full_slacks.push_back(slack);
+    }
+    results.push_back({compact_delays
+		       ? "delay_memory_bytes_compact"
+		       : "delay_memory_bytes_full",
+		       static_cast<double>(sta->delayMemoryBytes()), "bytes"});
+  }
+  results.push_back({"compact_max_delay_error", max_delay_error, "ps"});
+  results.push_back({"compact_max_slack_error", max_slack_error, "ps"});
+  sta->setCompactDelays(compact);
+  sta->updateTiming(true);
+}
+
+// Table2::findValue through the gate table models of the library.
+void
+benchTableFindValue(Sta *sta,
+		    int iterations,
+		    BenchResultSeq &results)
+{
+  sta::LibertyLibrary *library = sta->network()->findLiberty("bench");
+  std::vector<std::pair<const sta::TableModel*,
+			const sta::LibertyCell*>> models;
+  sta::LibertyCellIterator cell_iter(library);
+  while (cell_iter.hasNext()) {
+    sta::LibertyCell *cell = cell_iter.next();
+    sta::LibertyCellTimingArcSetIterator set_iter(cell);
+    while (set_iter.hasNext()) {
+      sta::TimingArcSet *arc_set = set_iter.next();
+      sta::TimingArcSetArcIterator arc_iter(arc_set);
+      while (arc_iter.hasNext()) {
+	sta::TimingArc *arc = arc_iter.next();
+	sta::GateTableModel *model =
+	  dynamic_cast<sta::GateTableModel*>(arc->model());
+	if (model && model->delayModel())
+	  models.push_back({model->delayModel(), cell});
+      }
+    }
+  }
+  if (!models.empty()) {
+    const int lookup_count = 1000000;
+    const sta::Pvt *pvt = library->defaultOperatingConditions();
+    double time = std::numeric_limits<double>::max();
+    float sum = 0.0;
+    for (int i = 0; i < iterations; i++) {
+      double begin = sta::elapsedRunTime();
+      for (int j = 0; j < lookup_count; j++) {
+	const auto &model_cell = models[j % models.size()];
+	// Slews from 10ps to 800ps and caps from 1ff to 80ff, both
+	// inside and beyond the table axes.
+	float slew = (10 + (j * 7) % 900) * 1e-12F;
+	float cap = (1 + (j * 13) % 90) * 1e-15F;
+	sum += model_cell.first->findValue(library, model_cell.second, pvt,
+					   slew, cap, 0.0);
+      }
+      time = std::min(time, sta::elapsedRunTime() - begin);
+    }
+    // Keep the compiler from removing the lookups.
+    if (sum == 0.0)
+      printf("\n");
+    results.push_back({"table_find_value_1M", time, "s"});
+  }
+}
+
+// DMP effective capacitance driver solves of every driver arc with a
+// calculator that starts with an empty driver solution cache.
+void
+benchGateDelays(Sta *sta,
+		int iterations,
+		BenchResultSeq &results)
+{
+  sta::Graph *graph = sta->graph();
+  sta::Network *network = sta->network();
+  const sta::DcalcAnalysisPt *dcalc_ap =
+    sta->cmdCorner()->findDcalcAnalysisPt(sta::MinMax::max());
+  const sta::Pvt *pvt = dcalc_ap->operatingConditions();
+  double time = std::numeric_limits<double>::max();
+  for (int i = 0; i < iterations; i++) {
+    sta::ArcDelayCalc *calc = sta::makeDmpCeffElmoreDelayCalc(sta);
+    double begin = sta::elapsedRunTime();
+    sta::VertexIterator vertex_iter(graph);
+    while (vertex_iter.hasNext()) {
+      sta::Vertex *vertex = vertex_iter.next();
+      const sta::Pin *pin = vertex->pin();
+      const sta::LibertyCell *cell =
+	network->libertyCell(network->instance(pin));
+      if (cell && vertex->isDriver(network)) {
+	sta::VertexInEdgeIterator edge_iter(vertex, graph);
+	while (edge_iter.hasNext()) {
+	  sta::Edge *edge = edge_iter.next();
+	  sta::TimingArcSet *arc_set = edge->timingArcSet();
+	  if (!arc_set->role()->isTimingCheck()) {
+	    sta::TimingArcSetArcIterator arc_iter(arc_set);
+	    while (arc_iter.hasNext()) {
+	      sta::TimingArc *arc = arc_iter.next();
+	      const sta::TransRiseFall *tr = arc->toTrans()->asRiseFall();
+	      sta::Parasitic *parasitic = calc->findParasitic(pin, tr,
+							      dcalc_ap);
+	      sta::ArcDelay gate_delay;
+	      sta::Slew drvr_slew;
+	      calc->gateDelay(cell, arc, bench_in_slew, 0.0, parasitic, 0.0,
+			      pvt, dcalc_ap, gate_delay, drvr_slew);
+	    }
+	  }
+	}
+	calc->finishDrvrPin();
+      }
+    }
+    time = std::min(time, sta::elapsedRunTime() - begin);
+    delete calc;
+  }
+  results.push_back({"dmp_gate_delays", time, "s"});
+}
+
+// Search::findTag of every tag made by the timing update.
+void
+benchFindTag(Sta *sta,
+	     int iterations,
+	     BenchResultSeq &results)
+{
+  sta::Search *search = sta->search();
+  const int repeat_count = 100;
+  double time = std::numeric_limits<double>::max();
+  for (int i = 0; i < iterations; i++) {
+    double begin = sta::elapsedRunTime();
+    for (int r = 0; r < repeat_count; r++) {
+      for (sta::TagIndex t = 0; t < search->tagCount(); t++) {
+	sta::Tag *tag = search->tag(t);
+	if (tag)
+	  search->findTag(tag->transition(), tag->pathAnalysisPt(sta),
+			  tag->clkInfo(), tag->isClock(), tag->inputDelay(),
+			  tag->isSegmentStart(), tag->states(), false);
+      }
+    }
+    time = std::min(time, sta::elapsedRunTime() - begin);
+  }
+  results.push_back({"find_tag_x100", time, "s"});
+}
+
+// Several paths per endpoint use PathEnum.
+void
+benchPathEnum(Tcl_Interp *interp,
+	      int iterations,
+	      BenchResultSeq &results)
+{
+  double time = std::numeric_limits<double>::max();
+  for (int i = 0; i < iterations; i++) {
+    double begin = sta::elapsedRunTime();
+    evalCmd(interp, "find_timing_paths -group_count 1000 -endpoint_count 10");
+    time = std::min(time, sta::elapsedRunTime() - begin);
+    Tcl_ResetResult(interp);
+  }
+  results.push_back({"path_enum", time, "s"});
+}
+
+// Read the design exceptions with the exceptions merged as they are
+// defined and with read_sdc -bulk, and compare the worst slacks.
+void
+benchExceptions(Tcl_Interp *interp,
+		Sta *sta,
+		const BenchDesign &design,
+		BenchResultSeq &results)
+{
+  float worst_slacks[2];
+  for (int bulk = 0; bulk < 2; bulk++) {
+    // Tags refer to the exceptions.
+    sta->search()->arrivalsInvalid();
+    sta->sdc()->deleteExceptions();
+    string cmd = string("read_sdc ") + (bulk ? "-bulk " : "")
+      + design.exceptionsFilename();
+    benchCmd(interp, bulk ? "read_exceptions_bulk" : "read_exceptions",
+	     cmd, results);
+    sta::Slack worst_slack;
+    sta::Vertex *worst_vertex;
+    sta->worstSlack(sta::MinMax::max(), worst_slack, worst_vertex);
+    worst_slacks[bulk] = sta::delayAsFloat(worst_slack);
+  }
+  results.push_back({"exceptions_bulk_slack_error",
+		     std::abs(static_cast<double>(worst_slacks[1])
+			      - worst_slacks[0]), "ps"});
+}
+
+// Disconnect and reconnect gate input pins (50k edits) one at a time
+// and in an edit batch, followed by the incremental timing update.
+// The edits restore the netlist so the worst slack must not change.
+void
+benchEditBatch(Sta *sta,
+	       BenchResultSeq &results)
+{
+  const int edit_count = 50000;
+  sta::Network *network = sta->network();
+  std::vector<std::pair<sta::Pin*, sta::Net*>> pin_nets;
+  sta::LeafInstanceIterator *inst_iter = network->leafInstanceIterator();
+  while (inst_iter->hasNext()) {
+    sta::Instance *inst = inst_iter->next();
+    sta::LibertyCell *cell = network->libertyCell(inst);
+    if (cell && !cell->hasSequentials()) {
+      sta::InstancePinIterator *pin_iter = network->pinIterator(inst);
+      while (pin_iter->hasNext()) {
+	sta::Pin *pin = pin_iter->next();
+	sta::Net *net = network->net(pin);
+	if (net && network->isLoad(pin))
+	  pin_nets.push_back({pin, net});
+      }
+      delete pin_iter;
+    }
+  }
+  delete inst_iter;
+
+  if (!pin_nets.empty()) {
+    sta::Slack worst_slack;
+    sta::Vertex *worst_vertex;
+    sta->worstSlack(sta::MinMax::max(), worst_slack, worst_vertex);
+    float ref_slack = sta::delayAsFloat(worst_slack);
+    double max_slack_error = 0.0;
+    for (bool batch : {false, true}) {
+      double begin = sta::elapsedRunTime();
+      if (batch)
+	sta->editBatchBegin();
+      for (int i = 0; i < edit_count / 2; i++) {
+	auto &pin_net = pin_nets[i % pin_nets.size()];
+	sta::Pin *pin = pin_net.first;
+	sta::Instance *inst = network->instance(pin);
+	sta::Port *port = network->port(pin);
+	sta->disconnectPin(pin);
+	sta->connectPin(inst, port, pin_net.second);
+      }
+      if (batch)
+	sta->editBatchEnd();
+      sta->updateTiming(false);
+      double time = sta::elapsedRunTime() - begin;
+      results.push_back({batch ? "edits_50k_batch" : "edits_50k", time, "s"});
+
+      sta->worstSlack(sta::MinMax::max(), worst_slack, worst_vertex);
+      max_slack_error =
+	std::max(max_slack_error,
+		 std::abs(static_cast<double>(sta::delayAsFloat(worst_slack))
+			  - ref_slack));
+    }
+    results.push_back({"edit_batch_slack_error", max_slack_error, "ps"});
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+reportResults(const BenchResultSeq &results,
+	      const BenchBaseline &baseline,
+	      float tolerance,
+	      int &regression_count)
+{
+  printf("%-28s %14s %14s %8s\n", "Benchmark", "Value", "Baseline", "Ratio");
+  printf("%-28s %14s %14s %8s\n", "---------", "-----", "--------", "-----");
+  regression_count = 0;
+  for (const BenchResult &result : results) {
+    string value = resultValueString(result.value_, result.unit_);
+    auto base_iter = baseline.find(result.name_);
+    if (base_iter == baseline.end())
+      printf("%-28s %14s\n", result.name_.c_str(), value.c_str());
+    else {
+      double base = base_iter->second;
+      double ratio = (base > 0.0) ? result.value_ / base : 1.0;
+      bool regressed = ratio > 1.0 + tolerance / 100.0;
+      if (regressed)
+	regression_count++;
+      string base_value = resultValueString(base, result.unit_);
+      printf("%-28s %14s %14s %8.2f%s\n",
+	     result.name_.c_str(),
+	     value.c_str(),
+	     base_value.c_str(),
+	     ratio,
+	     regressed ? " *" : "");
+    }
+  }
+}
+
+string
+resultValueString(double value,
+		  const char *unit)
+{
+  string str;
+  if (sta::stringEq(unit, "bytes"))
+    sta::stringPrint(str, "%.1fMb", value * 1e-6);
+  else if (sta::stringEq(unit, "ps"))
+    sta::stringPrint(str, "%.3fps", value * 1e12);
+  else
+    sta::stringPrint(str, "%.4fs", value);
+  return str;
+}
+
+// Baseline files have a "name value" line for each result.
+void
+writeBaseline(const char *filename,
+	      const BenchResultSeq &results)
+{
+  FILE *stream = fopen(filename, "w");
+  if (stream == nullptr)
+    throw sta::FileNotWritable(filename);
+  for (const BenchResult &result : results)
+    fprintf(stream, "%s %.6g\n", result.name_.c_str(), result.value_);
+  fclose(stream);
+}
+
+void
+readBaseline(const char *filename,
+	     BenchBaseline &baseline)
+{
+  FILE *stream = fopen(filename, "r");
+  if (stream == nullptr)
+    throw sta::FileNotReadable(filename);
+  char name[256];
+  double value;
+  while (fscanf(stream, "%255s %lf", name, &value) == 2)
+    baseline[name] = value;
+  fclose(stream);
+}
+
+} // namespace
@@ -24,6 +24,7 @@
 #include "StaState.hh"
 #include "LibertyClass.hh"
 #include "NetworkClass.hh"
+#include "GraphClass.hh"
 
 namespace sta {
 
@@ -129,6 +130,20 @@ public:
 				int digits,
 				string *result) = 0;
   virtual void finishDrvrPin() = 0;
+  // Called before and after GraphDelayCalc finds delays. Incremental
+  // is false when the delays of all the drivers are found.
+  virtual void findDelaysBegin(bool /* incremental */) {}
+  virtual void findDelaysEnd() {}
+  // Called between findDelaysBegin and findDelaysEnd after the drivers
+  // of a level have been found by all threads.
+  virtual void levelFinished(Level /* level */) {}
+  // Hits and misses of calculators that cache driver solutions.
+  virtual void cacheStats(// Return values.
+			  size_t &hits,
+			  size_t &misses) const { hits = misses = 0; }
+  // Forget cached driver solutions because the gate models or pvts
+  // they are keyed by may have changed or been deleted.
+  virtual void clearCache() {}
 
 protected:
   GateTimingModel *gateModel(TimingArc *arc,
@@ -30,6 +30,7 @@
 #include "TableModel.hh"
 #include "Network.hh"
 #include "Graph.hh"
+#include "Corner.hh"
 #include "Parasitics.hh"
 #include "Sdc.hh"
 #include "DcalcAnalysisPt.hh"
@@ -113,9 +114,13 @@ public:
   ArnoldiDelayCalc(StaState *sta);
   virtual ~ArnoldiDelayCalc();
   virtual ArcDelayCalc *copy();
+  virtual void copyState(const StaState *sta);
   virtual Parasitic *findParasitic(const Pin *drvr_pin,
 				   const TransRiseFall *tr,
 				   const DcalcAnalysisPt *dcalc_ap);
+  virtual void findDelaysBegin(bool incremental);
+  virtual void findDelaysEnd();
+  virtual void levelFinished(Level level);
   virtual void gateDelay(const LibertyCell *drvr_cell,
 			 TimingArc *arc,
 			 const Slew &in_slew,
@@ -154,6 +159,13 @@ public:
 				 double derate);
 
 private:
+  // Share the reducers of calc.
+  void shareReducePool(ArnoldiDelayCalc *calc);
+  ArnoldiReduce *reduce();
+  Parasitic *reduceParasitic(Parasitic *parasitic_network,
+			     const Pin *drvr_pin,
+			     const TransRiseFall *tr,
+			     const DcalcAnalysisPt *dcalc_ap);
   void gateDelaySlew(const LibertyCell *drvr_cell,
 		     GateTableModel *table_model,
 		     const Slew &in_slew,
@@ -224,7 +236,17 @@ private:
   double *_slewV;
   int pin_n_;
   bool input_port_;
+  // Reducer taken from reduce_pool_ when it is first used.
   ArnoldiReduce *reduce_;
+  ArnoldiReducePool *reduce_pool_;
+  // The pool is owned by the prototype delay calculator and shared by
+  // its copies.
+  bool own_reduce_pool_;
+  // Models are kept while the delays are found.
+  bool keep_models_;
+  // Models of the drivers visited by this calculator in the current
+  // level. Each thread has its own.
+  ArnoldiModels *models_;
   delay_work *delay_work_;
 };
 
@@ -236,7 +258,11 @@ makeArnoldiDelayCalc(StaState *sta)
 
 ArnoldiDelayCalc::ArnoldiDelayCalc(StaState *sta) :
   RCDelayCalc(sta),
-  reduce_(new ArnoldiReduce(sta)),
+  reduce_(nullptr),
+  reduce_pool_(new ArnoldiReducePool),
+  own_reduce_pool_(true),
+  keep_models_(false),
+  models_(new ArnoldiModels),
   delay_work_(delay_work_create())
 {
   _pinNmax = 1024;
@@ -247,7 +273,10 @@ ArnoldiDelayCalc::ArnoldiDelayCalc(StaState *sta) :
 ArcDelayCalc *
 ArnoldiDelayCalc::copy()
 {
-  return new ArnoldiDelayCalc(this);
+  ArnoldiDelayCalc *calc = new ArnoldiDelayCalc(this);
+  calc->shareReducePool(this);
+  calc->keep_models_ = keep_models_;
+  return calc;
 }
 
 ArnoldiDelayCalc::~ArnoldiDelayCalc()
@@ -255,7 +284,105 @@ ArnoldiDelayCalc::~ArnoldiDelayCalc()
   delay_work_destroy(delay_work_);
   free(_delayV);
   free(_slewV);
-  delete reduce_;
+  // parasitics_ may be deleted before the delay calculator.
+  for (auto parasitic : unsaved_parasitics_)
+    delete static_cast<ConcreteParasitic*>(parasitic);
+  if (reduce_)
+    reduce_pool_->push(reduce_);
+  delete models_;
+  if (own_reduce_pool_)
+    delete reduce_pool_;
+}
+
+void
+ArnoldiDelayCalc::shareReducePool(ArnoldiDelayCalc *calc)
+{
+  if (own_reduce_pool_)
+    delete reduce_pool_;
+  reduce_pool_ = calc->reduce_pool_;
+  own_reduce_pool_ = false;
+}
+
+void
+ArnoldiDelayCalc::copyState(const StaState *sta)
+{
+  RCDelayCalc::copyState(sta);
+  if (reduce_)
+    reduce_->copyState(sta);
+  models_->clear();
+}
+
+ArnoldiReduce *
+ArnoldiDelayCalc::reduce()
+{
+  if (reduce_ == nullptr)
+    reduce_ = reduce_pool_->pop(this);
+  return reduce_;
+}
+
+// Models are kept while the delays are found. Outside of that the
+// network and parasitics can change, so models are reduced for each
+// call and deleted by finishDrvrPin.
+//
+// The parasitics of a driver are reduced when the driver is visited by
+// the delay calculation, so only the models of the level being visited
+// exist at one time. Each thread copy reduces with a reducer from the
+// pool and deletes its models with the copy at the end of the level.
+void
+ArnoldiDelayCalc::findDelaysBegin(bool)
+{
+  keep_models_ = true;
+  models_->clear();
+}
+
+void
+ArnoldiDelayCalc::findDelaysEnd()
+{
+  keep_models_ = false;
+  models_->clear();
+}
+
+// Models of the drivers visited without threads.
+void
+ArnoldiDelayCalc::levelFinished(Level)
+{
+  if (keep_models_) {
+    debugPrint2(debug_, "arnoldi", 2, "%lu models for %lu drivers\n",
+		models_->modelCount(),
+		models_->drvrCount());
+    models_->clear();
+  }
+}
+
+// The reduction only depends on the transition and analysis point
+// through the load pin capacitances, so a model with the same pin
+// capacitances is used instead of reducing the network again.
+Parasitic *
+ArnoldiDelayCalc::reduceParasitic(Parasitic *parasitic_network,
+				  const Pin *drvr_pin,
+				  const TransRiseFall *tr,
+				  const DcalcAnalysisPt *dcalc_ap)
+{
+  const ParasiticAnalysisPt *parasitic_ap = dcalc_ap->parasiticAnalysisPt();
+  const MinMax *cnst_min_max = dcalc_ap->constraintMinMax();
+  const OperatingConditions *op_cond = dcalc_ap->operatingConditions();
+  const Corner *corner = dcalc_ap->corner();
+  ArnoldiReduce *reduce = this->reduce();
+  FloatSeq pin_caps;
+  reduce->loadPinCaps(parasitic_network, tr, op_cond, corner, cnst_min_max,
+		      pin_caps);
+  Parasitic *model;
+  if (models_->findSharedModel(drvr_pin, parasitic_ap, pin_caps, model))
+    models_->setModel(drvr_pin, tr, dcalc_ap, model);
+  else {
+    model = reduce->reduceToArnoldi(parasitic_network,
+				    drvr_pin,
+				    parasitic_ap->couplingCapFactor(),
+				    tr, op_cond, corner,
+				    cnst_min_max, parasitic_ap);
+    models_->insertModel(drvr_pin, tr, dcalc_ap, pin_caps, model);
+  }
+  return model;
 }
 
 Parasitic *
@@ -265,6 +392,10 @@ ArnoldiDelayCalc::findParasitic(const Pin *drvr_pin,
 {
   // set_load has precidence over parasitics.
   if (!sdc_->drvrPinHasWireCap(drvr_pin)) {
+    Parasitic *model;
+    if (keep_models_
+	&& models_->findModel(drvr_pin, drvr_tr, dcalc_ap, model))
+      return model;
     const ParasiticAnalysisPt *parasitic_ap = dcalc_ap->parasiticAnalysisPt();
     Parasitic *parasitic_network =
       parasitics_->findParasiticNetwork(drvr_pin, parasitic_ap);
@@ -288,17 +419,22 @@ ArnoldiDelayCalc::findParasitic(const Pin *drvr_pin,
     }
     
     if (parasitic_network) {
+      if (keep_models_ && !delete_parasitic_network)
+	return reduceParasitic(parasitic_network, drvr_pin, drvr_tr,
+			       dcalc_ap);
       Parasitic *parasitic =
-	reduce_->reduceToArnoldi(parasitic_network,
-				 drvr_pin,
-				 parasitic_ap->couplingCapFactor(),
-				 drvr_tr, op_cond, corner,
-				 cnst_min_max, parasitic_ap);
+	reduce()->reduceToArnoldi(parasitic_network,
+				  drvr_pin,
+				  parasitic_ap->couplingCapFactor(),
+				  drvr_tr, op_cond, corner,
+				  cnst_min_max, parasitic_ap);
       if (delete_parasitic_network) {
 	Net *net = network_->net(drvr_pin);
 	parasitics_->deleteParasiticNetwork(net, parasitic_ap);
       }
-      reduced_parasitic_drvrs_.push_back(drvr_pin);
+      // Models that are not kept are deleted by finishDrvrPin.
+      if (parasitic)
+	unsaved_parasitics_.push_back(parasitic);
       return parasitic;
     }
   }
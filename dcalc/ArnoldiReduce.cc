@@ -22,12 +22,15 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <math.h>
+#include <algorithm>
 #include "Machine.hh"
+#include "Mutex.hh"
 #include "Debug.hh"
 #include "Units.hh"
 #include "MinMax.hh"
 #include "Sdc.hh"
 #include "Network.hh"
+#include "DcalcAnalysisPt.hh"
 #include "ArnoldiReduce.hh"
 #include "Arnoldi.hh"
 #include "ConcreteParasiticsPvt.hh"
@@ -157,6 +160,30 @@ ArnoldiReduce::reduceToArnoldi(Parasitic *parasitic,
   return makeRcmodelDrv();
 }
 
+void
+ArnoldiReduce::loadPinCaps(Parasitic *parasitic,
+			   const TransRiseFall *tr,
+			   const OperatingConditions *op_cond,
+			   const Corner *corner,
+			   const MinMax *cnst_min_max,
+			   // Return value.
+			   FloatSeq &pin_caps)
+{
+  parasitic_network_ = reinterpret_cast<ConcreteParasiticNetwork*>(parasitic);
+  tr_ = tr;
+  op_cond_ = op_cond;
+  corner_ = corner;
+  cnst_min_max_ = cnst_min_max;
+  pin_caps.clear();
+  // Same order as loadWork.
+  ConcreteParasiticPinNodeMap::Iterator
+    pin_node_iter(parasitic_network_->pinNodes());
+  while (pin_node_iter.hasNext()) {
+    ConcreteParasiticPinNode *node = pin_node_iter.next();
+    pin_caps.push_back(pinCapacitance(node));
+  }
+}
+
 void
 ArnoldiReduce::loadWork()
 {
@@ -643,4 +670,187 @@ ArnoldiReduce::makeRcmodelFromW()
   return mod;
 }
 
+////////////////////////////////////////////////////////////////
+
+ArnoldiReducePool::ArnoldiReducePool()
+{
+}
+
+ArnoldiReducePool::~ArnoldiReducePool()
+{
+  for (auto reduce : reducers_)
+    delete reduce;
+}
+
+ArnoldiReduce *
+ArnoldiReducePool::pop(const StaState *sta)
+{
+  ArnoldiReduce *reduce = nullptr;
+  {
+    UniqueLock lock(lock_);
+    if (!reducers_.empty()) {
+      reduce = reducers_.back();
+      reducers_.pop_back();
+    }
+  }
+  if (reduce)
+    reduce->copyState(sta);
+  else
+    reduce = new ArnoldiReduce(const_cast<StaState*>(sta));
+  return reduce;
+}
+
+void
+ArnoldiReducePool::push(ArnoldiReduce *reduce)
+{
+  UniqueLock lock(lock_);
+  reducers_.push_back(reduce);
+}
+
+////////////////////////////////////////////////////////////////
+
+class ArnoldiSharedModel
+{
+public:
+  const ParasiticAnalysisPt *ap;
+  FloatSeq pin_caps;
+  Parasitic *model;
+};
+
+class ArnoldiDrvrModels
+{
+public:
+  ArnoldiDrvrModels();
+  ~ArnoldiDrvrModels();
+
+  // Indexed by dcalc ap index * TransRiseFall::index_count + tr index.
+  std::vector<Parasitic*> models;
+  std::vector<bool> found;
+  // The models owned by the driver.
+  std::vector<ArnoldiSharedModel> shared;
+};
+
+ArnoldiDrvrModels::ArnoldiDrvrModels()
+{
+}
+
+ArnoldiDrvrModels::~ArnoldiDrvrModels()
+{
+  for (ArnoldiSharedModel &shared_model : shared)
+    delete static_cast<ConcreteParasitic*>(shared_model.model);
+}
+
+static size_t
+arnoldiModelIndex(const TransRiseFall *tr,
+		  const DcalcAnalysisPt *dcalc_ap)
+{
+  return dcalc_ap->index() * TransRiseFall::index_count + tr->index();
+}
+
+ArnoldiModels::ArnoldiModels()
+{
+}
+
+ArnoldiModels::~ArnoldiModels()
+{
+  clear();
+}
+
+void
+ArnoldiModels::clear()
+{
+  drvr_models_.deleteContentsClear();
+}
+
+bool
+ArnoldiModels::findModel(const Pin *drvr_pin,
+			 const TransRiseFall *tr,
+			 const DcalcAnalysisPt *dcalc_ap,
+			 // Return value.
+			 Parasitic *&model) const
+{
+  ArnoldiDrvrModels *drvr_models = drvr_models_.findKey(drvr_pin);
+  if (drvr_models) {
+    size_t index = arnoldiModelIndex(tr, dcalc_ap);
+    if (index < drvr_models->found.size()
+	&& drvr_models->found[index]) {
+      model = drvr_models->models[index];
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+ArnoldiModels::findSharedModel(const Pin *drvr_pin,
+			       const ParasiticAnalysisPt *ap,
+			       const FloatSeq &pin_caps,
+			       // Return value.
+			       Parasitic *&model) const
+{
+  ArnoldiDrvrModels *drvr_models = drvr_models_.findKey(drvr_pin);
+  if (drvr_models) {
+    for (ArnoldiSharedModel &shared_model : drvr_models->shared) {
+      if (shared_model.ap == ap
+	  && shared_model.pin_caps == pin_caps) {
+	model = shared_model.model;
+	return true;
+      }
+    }
+  }
+  return false;
+}
+
+void
+ArnoldiModels::insertModel(const Pin *drvr_pin,
+			   const TransRiseFall *tr,
+			   const DcalcAnalysisPt *dcalc_ap,
+			   const FloatSeq &pin_caps,
+			   Parasitic *model)
+{
+  ArnoldiDrvrModels *drvr_models = ensureDrvrModels(drvr_pin);
+  ArnoldiSharedModel shared_model;
+  shared_model.ap = dcalc_ap->parasiticAnalysisPt();
+  shared_model.pin_caps = pin_caps;
+  shared_model.model = model;
+  drvr_models->shared.push_back(shared_model);
+  setModel(drvr_pin, tr, dcalc_ap, model);
+}
+
+void
+ArnoldiModels::setModel(const Pin *drvr_pin,
+			const TransRiseFall *tr,
+			const DcalcAnalysisPt *dcalc_ap,
+			Parasitic *model)
+{
+  ArnoldiDrvrModels *drvr_models = ensureDrvrModels(drvr_pin);
+  size_t index = arnoldiModelIndex(tr, dcalc_ap);
+  if (index >= drvr_models->found.size()) {
+    drvr_models->models.resize(index + 1, nullptr);
+    drvr_models->found.resize(index + 1, false);
+  }
+  drvr_models->models[index] = model;
+  drvr_models->found[index] = true;
+}
+
+ArnoldiDrvrModels *
+ArnoldiModels::ensureDrvrModels(const Pin *drvr_pin)
+{
+  ArnoldiDrvrModels *drvr_models = drvr_models_.findKey(drvr_pin);
+  if (drvr_models == nullptr) {
+    drvr_models = new ArnoldiDrvrModels;
+    drvr_models_[drvr_pin] = drvr_models;
+  }
+  return drvr_models;
+}
+
+size_t
+ArnoldiModels::modelCount() const
+{
+  size_t count = 0;
+  for (auto pin_models : drvr_models_)
+    count += pin_models.second->shared.size();
+  return count;
+}
+
 } // namespace
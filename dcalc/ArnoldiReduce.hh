@@ -21,20 +21,28 @@
 #ifndef STA_ARNOLDI_REDUCE_H
 #define STA_ARNOLDI_REDUCE_H
 
+#include <mutex>
+#include <vector>
+#include "DisallowCopyAssign.hh"
 #include "Map.hh"
+#include "UnorderedMap.hh"
 #include "NetworkClass.hh"
+#include "SdcClass.hh"
 #include "ParasiticsClass.hh"
 
 namespace sta {
 
 class ConcreteParasiticNetwork;
 class ConcreteParasiticNode;
+class DcalcAnalysisPt;
+class ArnoldiDrvrModels;
 
 class rcmodel;
 struct ts_edge;
 struct ts_point;
 
 typedef Map<ConcreteParasiticNode*, int> ArnolidPtMap;
+typedef UnorderedMap<const Pin*, ArnoldiDrvrModels*> ArnoldiDrvrModelsMap;
 
 class ArnoldiReduce : public StaState
 {
@@ -49,6 +57,15 @@ public:
 			     const Corner *corner,
 			     const MinMax *cnst_min_max,
 			     const ParasiticAnalysisPt *ap);
+  // Capacitances of the pins of a parasitic network in the order the
+  // pin nodes are reduced.
+  void loadPinCaps(Parasitic *parasitic,
+		   const TransRiseFall *tr,
+		   const OperatingConditions *op_cond,
+		   const Corner *corner,
+		   const MinMax *cnst_min_max,
+		   // Return value.
+		   FloatSeq &pin_caps);
 
 protected:
   void loadWork();
@@ -111,6 +128,73 @@ protected:
   int order;
 };
 
+// Reducers shared by the copies of a delay calculator. A copy holds a
+// reducer while it exists so the work arrays are allocated once per
+// thread instead of once per copy.
+class ArnoldiReducePool
+{
+public:
+  ArnoldiReducePool();
+  ~ArnoldiReducePool();
+  // The reducer uses the state of sta.
+  ArnoldiReduce *pop(const StaState *sta);
+  void push(ArnoldiReduce *reduce);
+
+protected:
+  std::vector<ArnoldiReduce*> reducers_;
+  std::mutex lock_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ArnoldiReducePool);
+};
+
+// Reduced models of the driver pins visited by one thread in a level
+// of the delay calculation. Models reduced with the same parasitic
+// analysis point and the same load pin capacitances are the same, so
+// one model is shared by the rise/fall transitions and the corners
+// that match. The models are not locked because each thread has its
+// own.
+class ArnoldiModels
+{
+public:
+  ArnoldiModels();
+  ~ArnoldiModels();
+  void clear();
+  // Return true if the model (possibly null) for drvr_pin has been found.
+  bool findModel(const Pin *drvr_pin,
+		 const TransRiseFall *tr,
+		 const DcalcAnalysisPt *dcalc_ap,
+		 // Return value.
+		 Parasitic *&model) const;
+  // Return true if a model with the same pin caps has been reduced.
+  bool findSharedModel(const Pin *drvr_pin,
+		       const ParasiticAnalysisPt *ap,
+		       const FloatSeq &pin_caps,
+		       // Return value.
+		       Parasitic *&model) const;
+  // Take ownership of a reduced model and use it for tr/dcalc_ap.
+  void insertModel(const Pin *drvr_pin,
+		   const TransRiseFall *tr,
+		   const DcalcAnalysisPt *dcalc_ap,
+		   const FloatSeq &pin_caps,
+		   Parasitic *model);
+  // Use a shared model for tr/dcalc_ap.
+  void setModel(const Pin *drvr_pin,
+		const TransRiseFall *tr,
+		const DcalcAnalysisPt *dcalc_ap,
+		Parasitic *model);
+  size_t modelCount() const;
+  size_t drvrCount() const { return drvr_models_.size(); }
+
+protected:
+  ArnoldiDrvrModels *ensureDrvrModels(const Pin *drvr_pin);
+
+  ArnoldiDrvrModelsMap drvr_models_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ArnoldiModels);
+};
+
 } // namespace
 #endif
 
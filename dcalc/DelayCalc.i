@@ -19,6 +19,10 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "Sta.hh"
+#include "Report.hh"
+#include "GraphDelayCalc.hh"
+#include "Search.hh"
+#include "DmpCeff.hh"
 
 %}
 
@@ -48,4 +52,31 @@ set_delay_calc_incremental_tolerance(float tol)
   sta::Sta::sta()->setIncrementalDelayTolerance(tol);
 }
 
+void
+set_dmp_ceff_tolerance_cmd(float tol)
+{
+  sta::Sta *sta = sta::Sta::sta();
+  sta::DmpCeffDelayCalc *dmp_calc =
+    dynamic_cast<sta::DmpCeffDelayCalc*>(sta->arcDelayCalc());
+  if (dmp_calc) {
+    dmp_calc->setCacheTolerance(tol);
+    sta->graphDelayCalc()->delaysInvalid();
+    sta->search()->arrivalsInvalid();
+  }
+}
+
+void
+report_dmp_ceff_cache()
+{
+  sta::Sta *sta = sta::Sta::sta();
+  sta::DmpCeffDelayCalc *dmp_calc =
+    dynamic_cast<sta::DmpCeffDelayCalc*>(sta->arcDelayCalc());
+  if (dmp_calc) {
+    size_t hits, misses;
+    dmp_calc->cacheStats(hits, misses);
+    sta->report()->print("DMP Ceff solutions %lu cached %lu solved\n",
+			 hits, misses);
+  }
+}
+
 %} // inline
@@ -121,5 +121,16 @@ proc set_delay_calculator { alg } {
   }
 }
 
+################################################################
+
+define_hidden_cmd_args "set_dmp_ceff_tolerance" {tolerance}
+
+# Relative tolerance of the driver slew and pi model values that share
+# a DMP effective capacitance solution. Zero does not cache solutions.
+proc set_dmp_ceff_tolerance { tol } {
+  check_positive_float "tolerance" $tol
+  set_dmp_ceff_tolerance_cmd $tol
+}
+
 # sta namespace end
 }
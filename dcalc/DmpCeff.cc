@@ -24,9 +24,14 @@
 
 #include <algorithm> // abs, min
 #include <math.h>    // sqrt
+#include <string.h>  // memcpy
 #include "Machine.hh"
+#include "Mutex.hh"
+#include "Hash.hh"
+#include "UnorderedMap.hh"
 #include "Report.hh"
 #include "Debug.hh"
+#include "Trace.hh"
 #include "Units.hh"
 #include "TimingArc.hh"
 #include "TableModel.hh"
@@ -62,6 +67,9 @@ enum DmpFunc { y20, y50, ipi };
 
 static const char *dmp_func_index_strings[] = {"y20", "y50", "Ipi"};
 
+// Cached driver solutions and seeds are evicted beyond this size.
+static const size_t dmp_cache_size_max = 1 << 20;
+
 static double
 gateModelRd(const LibertyCell *cell,
 	    GateTableModel *gate_model,
@@ -122,6 +130,19 @@ luDecomp(double **a,
 
 ////////////////////////////////////////////////////////////////
 
+// Driver parameters and gate delay/slew found by a DmpAlg.
+class DmpSolution
+{
+public:
+  double t0;
+  double dt;
+  double ceff;
+  double vo_delay;
+  double delay;
+  double slew;
+  bool driver_valid;
+};
+
 // Base class for Dartu/Menezes/Pileggi algorithm.
 // Derived classes handle different cases of zero values in the Pi model.
 class DmpAlg : public StaState
@@ -149,6 +170,15 @@ public:
 			     ArcDelay &delay,
 			     Slew &slew);
   double ceff() { return ceff_; }
+  void solution(double delay,
+		double slew,
+		// Return value.
+		DmpSolution &solution) const;
+  // Use a cached solution instead of gateDelaySlew.
+  void setSolution(const DmpSolution &solution);
+  // Start the Newton-Raphson driver parameter solve following init
+  // at a previous solution instead of the table delay estimate.
+  void setSeed(const DmpSolution &seed);
 
   // Given x_ as a vector of input parameters, fill fvec_ with the
   // equations evaluated at x_ and fjac_ with the jabobian evaluated at x_.
@@ -172,6 +202,8 @@ protected:
 	    float related_out_cap);
   // Find driver parameters t0, delta_t, Ceff.
   bool findDriverParams(double &ceff);
+  bool solveDriverParams(// Return value.
+			 const char *&nr_error);
   void gateCapDelaySlew(double cl,
 			double &delay,
 			double &slew);
@@ -253,6 +285,8 @@ protected:
   double *scale_;
   double *p_;
   int *index_;
+  DmpSolution seed_;
+  bool has_seed_;
 
   // Gate slew used to check load delay.
   double gate_slew_;
@@ -273,7 +307,8 @@ private:
 DmpAlg::DmpAlg(int nr_order,
 	       StaState *sta):
   StaState(sta),
-  nr_order_(nr_order)
+  nr_order_(nr_order),
+  has_seed_(false)
 {
   x_ = new double[nr_order_];
   fvec_ = new double[nr_order_];
@@ -315,6 +350,7 @@ DmpAlg::init(const LibertyLibrary *drvr_library,
   in_slew_ = in_slew;
   related_out_cap_ = related_out_cap;
   driver_valid_ = false;
+  has_seed_ = false;
   vth_ = drvr_library->outputThreshold(tr);
   vl_ = drvr_library->slewLowerThreshold(tr);
   vh_ = drvr_library->slewUpperThreshold(tr);
@@ -328,13 +364,38 @@ DmpAlg::init(const LibertyLibrary *drvr_library,
 bool
 DmpAlg::findDriverParams(double &ceff)
 {
+  const char *nr_error;
+  if (has_seed_) {
+    has_seed_ = false;
+    // ceff may be x_[DmpParam::ceff].
+    double ceff_init = ceff;
+    x_[DmpParam::t0] = seed_.t0;
+    x_[DmpParam::dt] = seed_.dt;
+    if (nr_order_ > DmpParam::ceff)
+      x_[DmpParam::ceff] = min(seed_.ceff, ceff_init);
+    if (solveDriverParams(nr_error))
+      return true;
+    // Start over from the table delay estimate.
+    ceff = ceff_init;
+  }
   double t_vth, t_vl, slew;
   gateDelays(ceff, t_vth, t_vl, slew);
   double dt = slew / (vh_ - vl_);
   double t0 = t_vth + log(1.0 - vth_) * rd_ * ceff - vth_ * dt;
   x_[DmpParam::dt] = dt;
   x_[DmpParam::t0] = t0;
-  const char *nr_error;
+  if (solveDriverParams(nr_error))
+    return true;
+  else {
+    fail(nr_error);
+    return false;
+  }
+}
+
+bool
+DmpAlg::solveDriverParams(// Return value.
+			  const char *&nr_error)
+{
   if (newtonRaphson(100, x_, nr_order_, driver_param_tol, evalDmpEqnsState,
 		    this, fvec_, fjac_, index_, p_, scale_, nr_error)) {
     t0_ = x_[DmpParam::t0];
@@ -347,10 +408,41 @@ DmpAlg::findDriverParams(double &ceff)
       showVo();
     return true;
   }
-  else {
-    fail(nr_error);
+  else
     return false;
-  }
+}
+
+void
+DmpAlg::solution(double delay,
+		 double slew,
+		 // Return value.
+		 DmpSolution &solution) const
+{
+  solution.t0 = t0_;
+  solution.dt = dt_;
+  solution.ceff = ceff_;
+  solution.vo_delay = vo_delay_;
+  solution.delay = delay;
+  solution.slew = slew;
+  solution.driver_valid = driver_valid_;
+}
+
+void
+DmpAlg::setSolution(const DmpSolution &solution)
+{
+  t0_ = solution.t0;
+  dt_ = solution.dt;
+  ceff_ = solution.ceff;
+  vo_delay_ = solution.vo_delay;
+  gate_slew_ = solution.slew;
+  driver_valid_ = solution.driver_valid;
+}
+
+void
+DmpAlg::setSeed(const DmpSolution &seed)
+{
+  seed_ = seed;
+  has_seed_ = seed.driver_valid && seed.dt > 0.0;
 }
 
 static bool
@@ -1370,14 +1462,17 @@ newtonRaphson(const int max_iter,
 	  all_under_x_tol = false;
 	x[i] += p[i];
       }
-      if (all_under_x_tol)
+      if (all_under_x_tol) {
+	traceEvent2("newton_raphson", size, k + 1);
 	return true;
+      }
     }
     else {
       error = lu_error;
       return false;
     }
   }
+  traceEvent2("newton_raphson_max_iter", size, max_iter);
   error = "Newton-Raphson max iterations exceeded.\n";
   return false;
 }
@@ -1545,6 +1640,355 @@ testLuDecomp2()
 
 ////////////////////////////////////////////////////////////////
 
+// Driver solution cache key. The slew and pi model values are
+// quantized to buckets tolerance wide (relative); values that are not
+// positive are exact. The drive resistance, algorithm and thresholds are all
+// found from these and the gate model, so they are not part of the key.
+class DmpCeffKey
+{
+public:
+  DmpCeffKey(const GateTableModel *gate_model,
+	     const Pvt *pvt,
+	     const char *alg_name,
+	     double in_slew,
+	     float related_out_cap,
+	     double c2,
+	     double rpi,
+	     double c1,
+	     float tolerance);
+  Hash hash() const;
+  bool equal(const DmpCeffKey &key) const;
+
+private:
+  static int64_t quantize(double value,
+			  float tolerance);
+
+  const GateTableModel *gate_model_;
+  const Pvt *pvt_;
+  // Algorithm name strings are static.
+  const char *alg_name_;
+  int64_t values_[5];
+};
+
+DmpCeffKey::DmpCeffKey(const GateTableModel *gate_model,
+		       const Pvt *pvt,
+		       const char *alg_name,
+		       double in_slew,
+		       float related_out_cap,
+		       double c2,
+		       double rpi,
+		       double c1,
+		       float tolerance) :
+  gate_model_(gate_model),
+  pvt_(pvt),
+  alg_name_(alg_name)
+{
+  values_[0] = quantize(in_slew, tolerance);
+  values_[1] = quantize(related_out_cap, tolerance);
+  values_[2] = quantize(c2, tolerance);
+  values_[3] = quantize(rpi, tolerance);
+  values_[4] = quantize(c1, tolerance);
+}
+
+int64_t
+DmpCeffKey::quantize(double value,
+		     float tolerance)
+{
+  if (tolerance > 0.0 && value > 0.0)
+    return static_cast<int64_t>(floor(log(value) / log1p(tolerance) + 0.5));
+  else {
+    // Exact values are distinct from bucket indices.
+    float value1 = static_cast<float>(value);
+    uint32_t bits;
+    memcpy(&bits, &value1, sizeof(bits));
+    return (int64_t(1) << 40) | bits;
+  }
+}
+
+Hash
+DmpCeffKey::hash() const
+{
+  Hash hash = hash_init_value;
+  hashIncr(hash, reinterpret_cast<uintptr_t>(gate_model_) >> 3);
+  hashIncr(hash, reinterpret_cast<uintptr_t>(pvt_) >> 3);
+  hashIncr(hash, reinterpret_cast<uintptr_t>(alg_name_));
+  for (int64_t value : values_)
+    hashIncr(hash, static_cast<Hash>(value ^ (value >> 32)));
+  return hash;
+}
+
+bool
+DmpCeffKey::equal(const DmpCeffKey &key) const
+{
+  return gate_model_ == key.gate_model_
+    && pvt_ == key.pvt_
+    && alg_name_ == key.alg_name_
+    && memcmp(values_, key.values_, sizeof(values_)) == 0;
+}
+
+class DmpCeffKeyHash
+{
+public:
+  size_t operator()(const DmpCeffKey &key) const { return key.hash(); }
+};
+
+class DmpCeffKeyEqual
+{
+public:
+  bool operator()(const DmpCeffKey &key1,
+		  const DmpCeffKey &key2) const { return key1.equal(key2); }
+};
+
+// Map that keeps the entries of the current and previous epochs.
+// Entries found in the previous epoch move to the current one, and the
+// previous epoch is dropped when the current one is full, so entries
+// that are still used survive eviction.
+template <class KEY, class VALUE, class HASH, class EQUAL>
+class DmpEpochMap
+{
+public:
+  explicit DmpEpochMap(size_t epoch_size) :
+    epoch_size_(epoch_size)
+  {
+  }
+
+  bool
+  find(const KEY &key,
+       // Return value.
+       VALUE &value)
+  {
+    auto itr = current_.find(key);
+    if (itr != current_.end()) {
+      value = itr->second;
+      return true;
+    }
+    itr = previous_.find(key);
+    if (itr != previous_.end()) {
+      value = itr->second;
+      previous_.erase(itr);
+      insert(key, value);
+      return true;
+    }
+    return false;
+  }
+
+  bool
+  hasKey(const KEY &key) const
+  {
+    return current_.hasKey(key)
+      || previous_.hasKey(key);
+  }
+
+  void
+  insert(const KEY &key,
+	 const VALUE &value)
+  {
+    if (current_.size() >= epoch_size_) {
+      previous_.swap(current_);
+      current_.clear();
+    }
+    current_[key] = value;
+  }
+
+  void
+  clear()
+  {
+    current_.clear();
+    previous_.clear();
+  }
+
+private:
+  UnorderedMap<KEY, VALUE, HASH, EQUAL> current_;
+  UnorderedMap<KEY, VALUE, HASH, EQUAL> previous_;
+  size_t epoch_size_;
+};
+
+class DmpParasiticHash
+{
+public:
+  size_t operator()(const Parasitic *parasitic) const
+  {
+    return reinterpret_cast<uintptr_t>(parasitic) >> 3;
+  }
+};
+
+class DmpParasiticEqual
+{
+public:
+  bool operator()(const Parasitic *parasitic1,
+		  const Parasitic *parasitic2) const
+  {
+    return parasitic1 == parasitic2;
+  }
+};
+
+typedef DmpEpochMap<DmpCeffKey, DmpSolution,
+		    DmpCeffKeyHash, DmpCeffKeyEqual> DmpSolutionMap;
+typedef DmpEpochMap<const Parasitic*, DmpSolution,
+		    DmpParasiticHash, DmpParasiticEqual> DmpSeedMap;
+
+// Cache shards so delay calculator threads rarely wait on each other.
+static const size_t dmp_cache_shard_count = 64;
+
+class DmpCeffCacheShard
+{
+public:
+  DmpCeffCacheShard();
+
+  DmpSolutionMap solutions_;
+  // Parasitics are only used as keys and may have been deleted.
+  DmpSeedMap seeds_;
+  size_t hits_;
+  size_t misses_;
+  std::mutex lock_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DmpCeffCacheShard);
+};
+
+DmpCeffCacheShard::DmpCeffCacheShard() :
+  // Current and previous epochs hold up to dmp_cache_size_max entries.
+  solutions_(dmp_cache_size_max / (dmp_cache_shard_count * 2)),
+  seeds_(dmp_cache_size_max / (dmp_cache_shard_count * 2)),
+  hits_(0),
+  misses_(0)
+{
+}
+
+// Driver solutions shared by the delay calculator threads.
+// Solutions are sharded by key hash and seeds by driver parasitic,
+// each shard with its own lock.
+class DmpCeffCache
+{
+public:
+  DmpCeffCache();
+  float tolerance() const { return tolerance_; }
+  // The cache is flushed if the tolerance changes.
+  void setTolerance(float tolerance);
+  // Return true if a solution for key was found.
+  bool findSolution(const DmpCeffKey &key,
+		    // Return value.
+		    DmpSolution &solution);
+  // Previous solution of the driver with drvr_parasitic.
+  bool findSeed(const Parasitic *drvr_parasitic,
+		// Return value.
+		DmpSolution &seed);
+  void insert(const DmpCeffKey &key,
+	      const Parasitic *drvr_parasitic,
+	      const DmpSolution &solution);
+  void clear();
+  void stats(// Return values.
+	     size_t &hits,
+	     size_t &misses);
+
+private:
+  DmpCeffCacheShard &shard(const DmpCeffKey &key);
+  DmpCeffCacheShard &shard(const Parasitic *drvr_parasitic);
+
+  DmpCeffCacheShard shards_[dmp_cache_shard_count];
+  // Only changed between delay calculation runs.
+  float tolerance_;
+
+  DISALLOW_COPY_AND_ASSIGN(DmpCeffCache);
+};
+
+DmpCeffCache::DmpCeffCache() :
+  tolerance_(0.0)
+{
+}
+
+DmpCeffCacheShard &
+DmpCeffCache::shard(const DmpCeffKey &key)
+{
+  return shards_[key.hash() % dmp_cache_shard_count];
+}
+
+DmpCeffCacheShard &
+DmpCeffCache::shard(const Parasitic *drvr_parasitic)
+{
+  DmpParasiticHash hash;
+  return shards_[hash(drvr_parasitic) % dmp_cache_shard_count];
+}
+
+void
+DmpCeffCache::setTolerance(float tolerance)
+{
+  if (tolerance != tolerance_) {
+    clear();
+    tolerance_ = tolerance;
+  }
+}
+
+bool
+DmpCeffCache::findSolution(const DmpCeffKey &key,
+			   // Return value.
+			   DmpSolution &solution)
+{
+  DmpCeffCacheShard &key_shard = shard(key);
+  UniqueLock lock(key_shard.lock_);
+  bool exists = key_shard.solutions_.find(key, solution);
+  if (exists)
+    key_shard.hits_++;
+  else
+    key_shard.misses_++;
+  return exists;
+}
+
+bool
+DmpCeffCache::findSeed(const Parasitic *drvr_parasitic,
+		       // Return value.
+		       DmpSolution &seed)
+{
+  DmpCeffCacheShard &seed_shard = shard(drvr_parasitic);
+  UniqueLock lock(seed_shard.lock_);
+  return seed_shard.seeds_.find(drvr_parasitic, seed);
+}
+
+void
+DmpCeffCache::insert(const DmpCeffKey &key,
+		     const Parasitic *drvr_parasitic,
+		     const DmpSolution &solution)
+{
+  {
+    DmpCeffCacheShard &key_shard = shard(key);
+    UniqueLock lock(key_shard.lock_);
+    key_shard.solutions_.insert(key, solution);
+  }
+  if (solution.driver_valid) {
+    DmpCeffCacheShard &seed_shard = shard(drvr_parasitic);
+    UniqueLock lock(seed_shard.lock_);
+    seed_shard.seeds_.insert(drvr_parasitic, solution);
+  }
+}
+
+void
+DmpCeffCache::clear()
+{
+  for (DmpCeffCacheShard &shard : shards_) {
+    UniqueLock lock(shard.lock_);
+    shard.solutions_.clear();
+    shard.seeds_.clear();
+    shard.hits_ = 0;
+    shard.misses_ = 0;
+  }
+}
+
+void
+DmpCeffCache::stats(// Return values.
+		    size_t &hits,
+		    size_t &misses)
+{
+  hits = 0;
+  misses = 0;
+  for (DmpCeffCacheShard &shard : shards_) {
+    UniqueLock lock(shard.lock_);
+    hits += shard.hits_;
+    misses += shard.misses_;
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
 bool DmpCeffDelayCalc::unsuppored_model_warned_ = false;
 
 DmpCeffDelayCalc::DmpCeffDelayCalc(StaState *sta) :
@@ -1552,7 +1996,9 @@ DmpCeffDelayCalc::DmpCeffDelayCalc(StaState *sta) :
   dmp_cap_(new DmpCap(sta)),
   dmp_pi_(new DmpPi(sta)),
   dmp_zero_c2_(new DmpZeroC2(sta)),
-  dmp_alg_(nullptr)
+  dmp_alg_(nullptr),
+  cache_(new DmpCeffCache),
+  own_cache_(true)
 {
 }
 
@@ -1561,6 +2007,43 @@ DmpCeffDelayCalc::~DmpCeffDelayCalc()
   delete dmp_cap_;
   delete dmp_pi_;
   delete dmp_zero_c2_;
+  if (own_cache_)
+    delete cache_;
+}
+
+void
+DmpCeffDelayCalc::shareCache(DmpCeffDelayCalc *calc)
+{
+  if (own_cache_)
+    delete cache_;
+  cache_ = calc->cache_;
+  own_cache_ = false;
+}
+
+void
+DmpCeffDelayCalc::setCacheTolerance(float tol)
+{
+  cache_->setTolerance(tol);
+}
+
+float
+DmpCeffDelayCalc::cacheTolerance() const
+{
+  return cache_->tolerance();
+}
+
+void
+DmpCeffDelayCalc::cacheStats(// Return values.
+			     size_t &hits,
+			     size_t &misses) const
+{
+  cache_->stats(hits, misses);
+}
+
+void
+DmpCeffDelayCalc::clearCache()
+{
+  cache_->clear();
 }
 
 void
@@ -1602,7 +2085,9 @@ DmpCeffDelayCalc::gateDelay(const LibertyCell *drvr_cell,
 		     in_slew1, related_out_cap,
 		     c2, rpi, c1);
     double dmp_gate_delay, dmp_drvr_slew;
-    gateDelaySlew(dmp_gate_delay, dmp_drvr_slew);
+    gateDelaySlew(table_model, pvt, drvr_parasitic, in_slew1,
+		  related_out_cap, c2, rpi, c1,
+		  dmp_gate_delay, dmp_drvr_slew);
     gate_delay = static_cast<float>(dmp_gate_delay);
     drvr_slew = static_cast<float>(dmp_drvr_slew);
   }
@@ -1757,6 +2242,45 @@ DmpCeffDelayCalc::gateDelaySlew(double &delay,
   dmp_alg_->gateDelaySlew(delay, slew);
 }
 
+void
+DmpCeffDelayCalc::gateDelaySlew(const GateTableModel *gate_model,
+				const Pvt *pvt,
+				const Parasitic *drvr_parasitic,
+				double in_slew,
+				float related_out_cap,
+				double c2,
+				double rpi,
+				double c1,
+				// Return values.
+				double &delay,
+				double &slew)
+{
+  // Capacitive loads are a table lookup. Without a tolerance the
+  // solve is not worth hashing the key and locking a shard.
+  if (dmp_alg_ == dmp_cap_
+      || cache_->tolerance() == 0.0)
+    gateDelaySlew(delay, slew);
+  else {
+    DmpCeffKey key(gate_model, pvt, dmp_alg_->name(), in_slew,
+		   related_out_cap, c2, rpi, c1, cache_->tolerance());
+    DmpSolution solution;
+    if (cache_->findSolution(key, solution)) {
+      debugPrint0(debug_, "delay_calc", 3, "    DMP cached solution\n");
+      dmp_alg_->setSolution(solution);
+      delay = solution.delay;
+      slew = solution.slew;
+    }
+    else {
+      DmpSolution seed;
+      if (cache_->findSeed(drvr_parasitic, seed))
+	dmp_alg_->setSeed(seed);
+      gateDelaySlew(delay, slew);
+      dmp_alg_->solution(delay, slew, solution);
+      cache_->insert(key, drvr_parasitic, solution);
+    }
+  }
+}
+
 void
 DmpCeffDelayCalc::loadDelaySlew(const Pin *load_pin,
 				double elmore,
@@ -1775,6 +2299,9 @@ DmpCeffDelayCalc::copyState(const StaState *sta)
   dmp_cap_->copyState(sta);
   dmp_pi_->copyState(sta);
   dmp_zero_c2_->copyState(sta);
+  // Cached gate models and pvts may have been deleted.
+  if (own_cache_)
+    cache_->clear();
 }
 
 } // namespace
@@ -26,9 +26,16 @@ class DmpAlg;
 class DmpCap;
 class DmpPi;
 class DmpZeroC2;
+class DmpCeffCache;
 
 // Delay calculator using Dartu/Menezes/Pileggi effective capacitance
 // algorithm for RSPF loads.
+//
+// With a cache tolerance, driver solutions are cached by gate model,
+// pvt and pi model so drivers with the same arc and load (clock tree
+// buffers, regular datapaths, wireload estimated parasitics) skip the
+// Newton-Raphson solve. The cache is shared by the copies used by
+// delay calc threads.
 class DmpCeffDelayCalc : public RCDelayCalc
 {
 public:
@@ -69,10 +76,36 @@ public:
 			       int digits,
 			       string *result);
   virtual void copyState(const StaState *sta);
+  // Relative tolerance of the slew and pi model values that share a
+  // cached driver solution. The tolerance also seeds the driver solve
+  // with the previous solution of the driver. Zero tolerance (the
+  // default) does not use the cache.
+  // The tolerance is shared by the copies of this delay calculator.
+  void setCacheTolerance(float tol);
+  float cacheTolerance() const;
+  virtual void cacheStats(// Return values.
+			  size_t &hits,
+			  size_t &misses) const;
+  virtual void clearCache();
 
 protected:
   void gateDelaySlew(double &delay,
 		     double &slew);
+  // Find the driver solution for the current algorithm in the cache
+  // or solve for it.
+  void gateDelaySlew(const GateTableModel *gate_model,
+		     const Pvt *pvt,
+		     const Parasitic *drvr_parasitic,
+		     double in_slew,
+		     float related_out_cap,
+		     double c2,
+		     double rpi,
+		     double c1,
+		     // Return values.
+		     double &delay,
+		     double &slew);
+  // Use the driver solution cache of calc (for copy()).
+  void shareCache(DmpCeffDelayCalc *calc);
   void loadDelaySlew(const Pin *load_pin,
 		     double elmore,
 		     ArcDelay &delay,
@@ -98,6 +131,8 @@ private:
   DmpPi *dmp_pi_;
   DmpZeroC2 *dmp_zero_c2_;
   DmpAlg *dmp_alg_;
+  DmpCeffCache *cache_;
+  bool own_cache_;
 };
 
 } // namespace
@@ -64,7 +64,9 @@ DmpCeffElmoreDelayCalc::DmpCeffElmoreDelayCalc(StaState *sta) :
 ArcDelayCalc *
 DmpCeffElmoreDelayCalc::copy()
 {
-  return new DmpCeffElmoreDelayCalc(this);
+  DmpCeffElmoreDelayCalc *calc = new DmpCeffElmoreDelayCalc(this);
+  calc->shareCache(this);
+  return calc;
 }
 
 void
@@ -192,7 +194,9 @@ DmpCeffTwoPoleDelayCalc::DmpCeffTwoPoleDelayCalc(StaState *sta) :
 ArcDelayCalc *
 DmpCeffTwoPoleDelayCalc::copy()
 {
-  return new DmpCeffTwoPoleDelayCalc(this);
+  DmpCeffTwoPoleDelayCalc *calc = new DmpCeffTwoPoleDelayCalc(this);
+  calc->shareCache(this);
+  return calc;
 }
 
 Parasitic *
@@ -49,6 +49,10 @@ public:
   virtual void copyState(const StaState *sta);
   // Find arc delays and vertex slews thru level.
   virtual void findDelays(Level /* level */) {};
+  // Find the arc delays and slews of a driver from the current slews
+  // of its fanin without propagating them or notifying the observer.
+  // For what-if analysis that restores them afterwards (RegionTiming).
+  virtual void findDriverDelaysUnobserved(Vertex * /* drvr_vertex */) {}
   // Invalidate all delays/slews.
   virtual void delaysInvalid() {};
   // Invalidate vertex and downstream delays/slews.
@@ -56,6 +60,14 @@ public:
 ;
   virtual void delayInvalid(const Pin * /* pin */) {};
   virtual void deleteVertexBefore(Vertex * /* vertex */) {};
+  // Forget pending incremental updates because the delays/slews
+  // were restored to their values before the invalidation.
+  virtual void clearInvalidDelays() {}
+  // Number of delay invalidations.
+  virtual size_t invalidCount() const { return 0; }
+  // Replace the ideal clocks found by delay calculation with the
+  // clocks of the same name in the current sdc.
+  virtual void remapIdealClks() {}
   // Reset to virgin state.
   virtual void clear() {}
   // Returned string is owned by the caller.
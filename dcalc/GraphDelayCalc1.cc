@@ -17,7 +17,10 @@
 #include "Machine.hh"
 #include "Debug.hh"
 #include "Stats.hh"
+#include "Profiler.hh"
+#include "Trace.hh"
 #include "Mutex.hh"
+#include "ThreadForEach.hh"
 #include "MinMax.hh"
 #include "PortDirection.hh"
 #include "TimingRole.hh"
@@ -213,12 +216,15 @@ GraphDelayCalc1::GraphDelayCalc1(StaState *sta) :
   observer_(nullptr),
   delays_seeded_(false),
   incremental_(false),
+  invalid_count_(0),
   search_pred_(new SearchPred1(sta)),
   search_non_latch_pred_(new SearchPredNonLatch2(sta)),
   clk_pred_(new ClkTreeSearchPred(sta)),
   iter_(new BfsFwdIterator(BfsIndex::dcalc, search_non_latch_pred_, sta)),
   multi_drvr_nets_found_(false),
-  incremental_delay_tolerance_(0.0)
+  incremental_delay_tolerance_(0.0),
+  load_caps_count_(0),
+  load_caps_exist_(false)
 {
 }
 
@@ -288,6 +294,7 @@ void
 GraphDelayCalc1::delaysInvalid()
 {
   debugPrint0(debug_, "delay_calc", 1, "delays invalid\n");
+  invalid_count_++;
   delays_exist_ = false;
   delays_seeded_ = false;
   incremental_ = false;
@@ -296,11 +303,26 @@ GraphDelayCalc1::delaysInvalid()
   // No need to keep track of incremental updates any more.
   invalid_delays_.clear();
   invalid_checks_.clear();
+  load_caps_exist_ = false;
+  invalid_load_caps_.clear();
+  // Pvts are deleted when the constraints are cleared.
+  if (arc_delay_calc_)
+    arc_delay_calc_->clearCache();
+}
+
+void
+GraphDelayCalc1::clearInvalidDelays()
+{
+  debugPrint0(debug_, "delay_calc", 1, "clear invalid delays\n");
+  iter_->clear();
+  invalid_delays_.clear();
+  invalid_checks_.clear();
 }
 
 void
 GraphDelayCalc1::delayInvalid(const Pin *pin)
 {
+  invalid_count_++;
   if (graph_
       && incremental_) {
     if (network_->isHierarchical(pin)) {
@@ -326,6 +348,9 @@ GraphDelayCalc1::delayInvalid(Vertex *vertex)
 {
   debugPrint1(debug_, "delay_calc", 2, "delays invalid %s\n",
 	      vertex->name(sdc_network_));
+  invalid_count_++;
+  if (load_caps_exist_)
+    loadCapsInvalid(vertex);
   if (graph_ && incremental_) {
     invalid_delays_.insert(vertex);
     // Invalidate driver that triggers dcalc for multi-driver nets.
@@ -341,6 +366,13 @@ GraphDelayCalc1::deleteVertexBefore(Vertex *vertex)
   iter_->deleteVertexBefore(vertex);
   if (incremental_)
     invalid_delays_.erase(vertex);
+  if (load_caps_exist_) {
+    invalid_load_caps_.erase(vertex);
+    // The driver index is not reused until the table is found again.
+    size_t vertex_index = graph_->index(vertex);
+    if (vertex_index < load_caps_drvrs_.size())
+      load_caps_drvrs_[vertex_index] = 0;
+  }
   MultiDrvrNet *multi_drvr = multiDrvrNet(vertex);
   if (multi_drvr) {
     multi_drvr->drvrs()->erase(vertex);
@@ -359,11 +391,15 @@ public:
   virtual ~FindVertexDelays();
   virtual void visit(Vertex *vertex);
   virtual VertexVisitor *copy();
+  virtual void levelFinished(Level level);
 
 protected:
   GraphDelayCalc1 *graph_delay_calc1_;
   ArcDelayCalc *arc_delay_calc_;
   bool own_arc_delay_calc_;
+  Profiler *profiler_;
+  // Timing arcs visited when profiling.
+  size_t arc_count_;
 };
 
 FindVertexDelays::FindVertexDelays(GraphDelayCalc1 *graph_delay_calc1,
@@ -372,7 +408,9 @@ FindVertexDelays::FindVertexDelays(GraphDelayCalc1 *graph_delay_calc1,
   VertexVisitor(),
   graph_delay_calc1_(graph_delay_calc1),
   arc_delay_calc_(arc_delay_calc),
-  own_arc_delay_calc_(own_arc_delay_calc)
+  own_arc_delay_calc_(own_arc_delay_calc),
+  profiler_(graph_delay_calc1->debug()->profiler()),
+  arc_count_(0)
 {
 }
 
@@ -380,6 +418,8 @@ FindVertexDelays::~FindVertexDelays()
 {
   if (own_arc_delay_calc_)
     delete arc_delay_calc_;
+  if (arc_count_ > 0)
+    profiler_->count("arcs", arc_count_);
 }
 
 VertexVisitor *
@@ -394,6 +434,19 @@ void
 FindVertexDelays::visit(Vertex *vertex)
 {
   graph_delay_calc1_->findVertexDelay(vertex, arc_delay_calc_, true);
+  if (profiler_->enabled()) {
+    VertexInEdgeIterator edge_iter(vertex, graph_delay_calc1_->graph());
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      arc_count_ += edge->timingArcSet()->arcCount();
+    }
+  }
+}
+
+void
+FindVertexDelays::levelFinished(Level level)
+{
+  arc_delay_calc_->levelFinished(level);
 }
 
 // The logical structure of incremental delay calculation closely
@@ -403,9 +456,15 @@ void
 GraphDelayCalc1::findDelays(Level level)
 {
   if (arc_delay_calc_) {
+    ProfilePhase phase(debug_, "delay_calc");
+    Profiler *profiler = debug_->profiler();
+    size_t cache_hits, cache_misses;
+    arc_delay_calc_->cacheStats(cache_hits, cache_misses);
     Stats stats(debug_);
     int dcalc_count = 0;
     debugPrint1(debug_, "delay_calc", 1, "find delays to level %d\n", level);
+    graph_->delayJournalPass();
+    ensureLoadCaps();
     if (!delays_seeded_) {
       iter_->clear();
       ensureMultiDrvrNetsFound();
@@ -417,6 +476,7 @@ GraphDelayCalc1::findDelays(Level level)
     if (incremental_)
       seedInvalidDelays();
 
+    arc_delay_calc_->findDelaysBegin(incremental_);
     FindVertexDelays visitor(this, arc_delay_calc_, false);
     dcalc_count += iter_->visitParallel(level, &visitor);
 
@@ -428,9 +488,20 @@ GraphDelayCalc1::findDelays(Level level)
       findCheckDelays(check_vertex, arc_delay_calc_);
     }
     invalid_checks_.clear();
+    arc_delay_calc_->findDelaysEnd();
 
     delays_exist_ = true;
     incremental_ = true;
+    if (profiler->enabled()) {
+      size_t cache_hits1, cache_misses1;
+      arc_delay_calc_->cacheStats(cache_hits1, cache_misses1);
+      // The counts start over when the cache is cleared.
+      if (cache_hits1 >= cache_hits && cache_misses1 >= cache_misses) {
+	profiler->count("cache_hits", cache_hits1 - cache_hits);
+	profiler->count("cache_misses", cache_misses1 - cache_misses);
+      }
+    }
+    graph_->delayJournalPass();
     debugPrint1(debug_, "delay_calc", 1, "found %d delays\n", dcalc_count);
     stats.report("Delay calc");
   }
@@ -452,6 +523,144 @@ GraphDelayCalc1::seedInvalidDelays()
   invalid_delays_.clear();
 }
 
+////////////////////////////////////////////////////////////////
+
+// The load capacitances of every driver are found before the delays so
+// netCaps is a table lookup in the delay calculation. The table is
+// found from scratch (in parallel) when the delays are invalid and the
+// drivers on edited nets are updated before incremental delay calcs.
+void
+GraphDelayCalc1::ensureLoadCaps()
+{
+  if (!load_caps_exist_) {
+    findLoadCaps();
+    load_caps_exist_ = true;
+  }
+  else if (!invalid_load_caps_.empty()) {
+    // Drivers made since the table was found are added to the end.
+    for (auto drvr_vertex : invalid_load_caps_) {
+      size_t vertex_index = graph_->index(drvr_vertex);
+      if (vertex_index >= load_caps_drvrs_.size())
+	load_caps_drvrs_.resize(vertex_index + 1, 0);
+      if (load_caps_drvrs_[vertex_index] == 0) {
+	load_caps_valid_.push_back(false);
+	load_caps_drvrs_[vertex_index] = load_caps_valid_.size();
+      }
+    }
+    load_caps_.resize(load_caps_valid_.size() * load_caps_count_);
+    for (auto drvr_vertex : invalid_load_caps_)
+      findLoadCaps(drvr_vertex);
+  }
+  invalid_load_caps_.clear();
+}
+
+void
+GraphDelayCalc1::findLoadCaps()
+{
+  load_caps_count_ = corners_->dcalcAnalysisPtCount()
+    * TransRiseFall::index_count;
+  VertexSeq drvr_vertices;
+  load_caps_drvrs_.assign(graph_->vertexIndexEnd(), 0);
+  VertexIterator vertex_iter(graph_);
+  while (vertex_iter.hasNext()) {
+    Vertex *vertex = vertex_iter.next();
+    if (vertex->isDriver(network_)) {
+      drvr_vertices.push_back(vertex);
+      load_caps_drvrs_[graph_->index(vertex)] = drvr_vertices.size();
+    }
+  }
+  load_caps_.assign(drvr_vertices.size() * load_caps_count_, NetCaps());
+  load_caps_valid_.assign(drvr_vertices.size(), false);
+  size_t thread_count = thread_count_;
+  if (thread_count > 1 && drvr_vertices.size() > thread_count) {
+    forEachChunk(drvr_vertices.size(), thread_count,
+		 [&] (size_t, size_t begin, size_t end) {
+      for (size_t j = begin; j < end; j++)
+	findLoadCaps(drvr_vertices[j]);
+    });
+  }
+  else {
+    for (auto drvr_vertex : drvr_vertices)
+      findLoadCaps(drvr_vertex);
+  }
+  debugPrint1(debug_, "delay_calc", 1, "found load caps for %lu drivers\n",
+	      drvr_vertices.size());
+}
+
+void
+GraphDelayCalc1::findLoadCaps(Vertex *drvr_vertex)
+{
+  const Pin *drvr_pin = drvr_vertex->pin();
+  size_t drvr_index = loadCapsDrvr(drvr_vertex) - 1;
+  size_t index = drvr_index * load_caps_count_;
+  for (auto dcalc_ap : corners_->dcalcAnalysisPts()) {
+    const OperatingConditions *op_cond = dcalc_ap->operatingConditions();
+    const Corner *corner = dcalc_ap->corner();
+    const MinMax *min_max = dcalc_ap->constraintMinMax();
+    for (auto tr : TransRiseFall::range()) {
+      float pin_cap, wire_cap, fanout;
+      bool has_set_load;
+      sdc_->connectedCap(drvr_pin, tr, op_cond, corner, min_max,
+			 pin_cap, wire_cap, fanout, has_set_load);
+      load_caps_[index + dcalc_ap->index() * TransRiseFall::index_count
+		 + tr->index()].init(pin_cap, wire_cap, fanout, has_set_load);
+    }
+  }
+  load_caps_valid_[drvr_index] = true;
+}
+
+size_t
+GraphDelayCalc1::loadCapsDrvr(const Vertex *drvr_vertex) const
+{
+  size_t vertex_index = graph_->index(drvr_vertex);
+  if (vertex_index < load_caps_drvrs_.size())
+    return load_caps_drvrs_[vertex_index];
+  else
+    return 0;
+}
+
+// Invalidate the load caps of the drivers on the net of vertex.
+void
+GraphDelayCalc1::loadCapsInvalid(Vertex *vertex)
+{
+  const Pin *pin = vertex->pin();
+  if (vertex->isDriver(network_)) {
+    size_t drvr = loadCapsDrvr(vertex);
+    if (drvr)
+      load_caps_valid_[drvr - 1] = false;
+    invalid_load_caps_.insert(vertex);
+  }
+  PinSet *drvrs = network_->drivers(pin);
+  if (drvrs) {
+    for (auto drvr_pin : *drvrs) {
+      Vertex *drvr_vertex = graph_->pinDrvrVertex(drvr_pin);
+      if (drvr_vertex && drvr_vertex != vertex) {
+	size_t drvr = loadCapsDrvr(drvr_vertex);
+	if (drvr)
+	  load_caps_valid_[drvr - 1] = false;
+	invalid_load_caps_.insert(drvr_vertex);
+      }
+    }
+  }
+}
+
+const NetCaps *
+GraphDelayCalc1::drvrLoadCaps(const Vertex *drvr_vertex,
+			      const TransRiseFall *tr,
+			      const DcalcAnalysisPt *dcalc_ap) const
+{
+  if (load_caps_exist_) {
+    size_t drvr = loadCapsDrvr(drvr_vertex);
+    if (drvr && load_caps_valid_[drvr - 1])
+      return &load_caps_[(drvr - 1) * load_caps_count_
+			 + dcalc_ap->index() * TransRiseFall::index_count
+			 + tr->index()];
+  }
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////
+
 class FindNetDrvrs : public PinVisitor
 {
 public:
@@ -836,6 +1045,7 @@ GraphDelayCalc1::findVertexDelay(Vertex *vertex,
 				 bool propagate)
 {
   const Pin *pin = vertex->pin();
+  traceEvent2("find_delays", graph_->index(vertex), vertex->level());
   bool ideal_clks_changed = findIdealClks(vertex);
   // Don't clobber root slews.
   if (!vertex->isRoot()) {
@@ -870,6 +1080,17 @@ GraphDelayCalc1::findVertexDelay(Vertex *vertex,
   }
 }
 
+void
+GraphDelayCalc1::findDriverDelaysUnobserved(Vertex *drvr_vertex)
+{
+  ensureLoadCaps();
+  ensureMultiDrvrNetsFound();
+  DelayCalcObserver *observer = observer_;
+  observer_ = nullptr;
+  findDriverDelays(drvr_vertex, arc_delay_calc_);
+  observer_ = observer;
+}
+
 void
 GraphDelayCalc1::enqueueTimingChecksEdges(Vertex *vertex)
 {
@@ -1110,6 +1331,16 @@ GraphDelayCalc1::netCaps(const Pin *drvr_pin,
   if (graph_) {
     Vertex *drvr_vertex = graph_->pinDrvrVertex(drvr_pin);
     multi_drvr = multiDrvrNet(drvr_vertex);
+    if (multi_drvr == nullptr && drvr_vertex) {
+      const NetCaps *net_caps = drvrLoadCaps(drvr_vertex, tr, dcalc_ap);
+      if (net_caps) {
+	pin_cap = net_caps->pinCap();
+	wire_cap = net_caps->wireCap();
+	fanout = net_caps->fanout();
+	has_set_load = net_caps->hasSetLoad();
+	return;
+      }
+    }
   }
   if (multi_drvr)
     multi_drvr->netCaps(tr, dcalc_ap,
@@ -1630,6 +1861,25 @@ GraphDelayCalc1::clearIdealClkMap()
   ideal_clks_map_.deleteContentsClear();
 }
 
+void
+GraphDelayCalc1::remapIdealClks()
+{
+  UniqueLock lock(ideal_clks_map_lock_);
+  for (auto &vertex_clks : ideal_clks_map_) {
+    ClockSet *clks = vertex_clks.second;
+    ClockSet *clks1 = new ClockSet;
+    ClockSet::ConstIterator clk_iter(clks);
+    while (clk_iter.hasNext()) {
+      Clock *clk = clk_iter.next();
+      Clock *clk1 = sdc_->findClock(clk->name());
+      if (clk1)
+	clks1->insert(clk1);
+    }
+    delete clks;
+    vertex_clks.second = clks1;
+  }
+}
+
 bool
 GraphDelayCalc1::setIdealClks(const Vertex *vertex,
 			      ClockSet *clks)
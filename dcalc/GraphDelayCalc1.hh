@@ -17,8 +17,11 @@
 #ifndef STA_GRAPH_DELAY_CALC1_H
 #define STA_GRAPH_DELAY_CALC1_H
 
+#include <atomic>
 #include <mutex>
+#include <vector>
 #include "GraphDelayCalc.hh"
+#include "NetCaps.hh"
 
 namespace sta {
 
@@ -40,9 +43,13 @@ public:
   virtual void delaysInvalid();
   virtual void delayInvalid(Vertex *vertex);
   virtual void delayInvalid(const Pin *pin);
+  virtual void clearInvalidDelays();
+  virtual size_t invalidCount() const { return invalid_count_; }
+  virtual void remapIdealClks();
   virtual void deleteVertexBefore(Vertex *vertex);
   virtual void clear();
   virtual void findDelays(Level level);
+  virtual void findDriverDelaysUnobserved(Vertex *drvr_vertex);
   virtual string *reportDelayCalc(Edge *edge,
 				  TimingArc *arc,
 				  const Corner *corner,
@@ -82,6 +89,14 @@ public:
 
 protected:
   void seedInvalidDelays();
+  void ensureLoadCaps();
+  void findLoadCaps();
+  void findLoadCaps(Vertex *drvr_vertex);
+  void loadCapsInvalid(Vertex *vertex);
+  size_t loadCapsDrvr(const Vertex *drvr_vertex) const;
+  const NetCaps *drvrLoadCaps(const Vertex *drvr_vertex,
+			      const TransRiseFall *tr,
+			      const DcalcAnalysisPt *dcalc_ap) const;
   void ensureMultiDrvrNetsFound();
   void makeMultiDrvrNet(PinSet &drvr_pins);
   void initSlew(Vertex *vertex);
@@ -219,6 +234,8 @@ protected:
   bool delays_seeded_;
   bool incremental_;
   bool delays_exist_;
+  // Incremented by delay calc threads.
+  std::atomic<size_t> invalid_count_;
   // Vertices with invalid -to delays.
   VertexSet invalid_delays_;
   // Vertices with invalid -from/-to timing checks.
@@ -235,6 +252,18 @@ protected:
   float incremental_delay_tolerance_;
   VertexIdealClksMap ideal_clks_map_;
   std::mutex ideal_clks_map_lock_;
+  // Driver index + 1 of the driver vertices in load_caps_ indexed by
+  // vertex index. Zero for vertices that are not in the table.
+  std::vector<unsigned> load_caps_drvrs_;
+  // Net capacitances of driver vertices indexed by
+  // driver index * load_caps_count_ + ap index * tr count + tr index.
+  std::vector<NetCaps> load_caps_;
+  // Indexed by driver index.
+  std::vector<char> load_caps_valid_;
+  size_t load_caps_count_;
+  bool load_caps_exist_;
+  // Drivers with load caps to update before the next delay calculation.
+  VertexSet invalid_load_caps_;
 
   friend class FindVertexDelays;
   friend class MultiDrvrNet;
@@ -17,11 +17,10 @@
 #ifndef STA_NET_CAPS_H
 #define STA_NET_CAPS_H
 
-#include "DisallowCopyAssign.hh"
-
 namespace sta {
 
 // Constraints::pinNetCap return values.
+// NetCaps are values that are copied into the driver load cap table.
 class NetCaps
 {
 public:
@@ -40,8 +39,6 @@ public:
   bool hasSetLoad() const { return has_set_load_; }
 
 private:
-  DISALLOW_COPY_AND_ASSIGN(NetCaps);
-
   float pin_cap_;
   float wire_cap_;
   float fanout_;
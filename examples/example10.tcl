@@ -0,0 +1,37 @@
+# sta_compact_delays example
+# Slacks found with compact 16 bit delays and slews are within 1ps of
+# the slacks found with full precision delays.
+read_liberty example1_slow.lib
+read_verilog example1.v
+link_design top
+create_clock -name clk -period 10 {clk1 clk2 clk3}
+set_input_delay -clock clk 0 {in1 in2}
+
+proc path_slacks {} {
+  set slacks {}
+  foreach path_end [find_timing_paths -path_delay min_max \
+		      -group_count 100 -endpoint_count 10] {
+    lappend slacks [$path_end slack]
+  }
+  return $slacks
+}
+
+set sta_compact_delays 0
+set full_slacks [path_slacks]
+set sta_compact_delays 1
+set compact_slacks [path_slacks]
+set sta_compact_delays 0
+
+set max_error 0.0
+foreach full_slack $full_slacks compact_slack $compact_slacks {
+  set error [expr abs($full_slack - $compact_slack)]
+  if { $error > $max_error } {
+    set max_error $error
+  }
+}
+if { [llength $full_slacks] == [llength $compact_slacks]
+     && $max_error <= 1e-12 } {
+  puts "sta_compact_delays matches full precision delays"
+} else {
+  puts "sta_compact_delays differs from full precision delays by [sta::format_time $max_error 3]"
+}
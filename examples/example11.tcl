@@ -0,0 +1,43 @@
+# parallel report_checks example
+# Reports formatted with multiple threads, and reports redirected to
+# a file, are the same as reports formatted with one thread.
+read_liberty example1_slow.lib
+read_verilog example1.v
+link_design top
+create_clock -name clk -period 10 {clk1 clk2 clk3}
+set_input_delay -clock clk 0 {in1 in2}
+
+proc read_report { filename } {
+  set stream [open $filename r]
+  set report [read $stream]
+  close $stream
+  file delete $filename
+  return $report
+}
+
+set match 1
+foreach format {full_clock_expanded end summary} {
+  set report_args [list -path_delay min_max -group_count 100 \
+		     -endpoint_count 10 -format $format \
+		     -fields {capacitance slew input_pin net}]
+  foreach thread_count {1 4} {
+    sta::set_thread_count $thread_count
+    # The body runs in the with_output_to_variable proc scope.
+    sta::with_output_to_variable reports($thread_count) \
+      [concat report_checks $report_args]
+    eval report_checks $report_args > example11.rpt
+    set file_reports($thread_count) [read_report example11.rpt]
+  }
+  if { !($reports(4) == $reports(1)
+	 && $file_reports(1) == $reports(1)
+	 && $file_reports(4) == $reports(1)) } {
+    puts "report_checks -format $format differs with 4 threads"
+    puts $reports(1)
+    puts $reports(4)
+    set match 0
+  }
+}
+sta::set_thread_count 1
+if { $match } {
+  puts "report_checks with 4 threads matches 1 thread"
+}
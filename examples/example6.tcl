@@ -0,0 +1,22 @@
+# read_sdc -bulk example
+# The exceptions are merged when they are all defined instead of as
+# they are defined, which must not change the timing.
+read_liberty example1_slow.lib
+read_verilog example1.v
+link_design top
+read_sdc example6.sdc
+sta::with_output_to_variable merged_report {
+  report_checks -path_delay min_max -group_count 10 -unconstrained
+}
+sta::remove_constraints
+read_sdc -bulk example6.sdc
+sta::with_output_to_variable bulk_report {
+  report_checks -path_delay min_max -group_count 10 -unconstrained
+}
+if { $bulk_report == $merged_report } {
+  puts "read_sdc -bulk matches read_sdc"
+} else {
+  puts "read_sdc -bulk differs from read_sdc"
+  puts $merged_report
+  puts $bulk_report
+}
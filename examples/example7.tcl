@@ -0,0 +1,37 @@
+# write_path_columns example
+# Files written with one and with multiple threads report the same
+# paths, in the order find_timing_paths returns them.
+read_liberty example1_slow.lib
+read_verilog example1.v
+link_design top
+create_clock -name clk -period 10 {clk1 clk2 clk3}
+set_input_delay -clock clk 0 {in1 in2}
+set path_args {-path_delay min_max -group_count 100 -endpoint_count 10}
+sta::set_thread_count 1
+write_path_columns -path_args $path_args example7_serial.col
+sta::set_thread_count 4
+write_path_columns -path_args $path_args example7_threads.col
+sta::with_output_to_variable serial_report {
+  report_path_columns example7_serial.col
+}
+sta::with_output_to_variable threads_report {
+  report_path_columns example7_threads.col
+}
+set end_pins {}
+foreach path_end [eval [concat find_timing_paths $path_args]] {
+  lappend end_pins [get_full_name [[$path_end vertex] pin]]
+}
+set file_end_pins {}
+foreach line [split $serial_report "\n"] {
+  if { [lindex $line 0] == "Path" } {
+    lappend file_end_pins [lindex $line 3]
+  }
+}
+if { $threads_report == $serial_report && $file_end_pins == $end_pins } {
+  puts "write_path_columns matches find_timing_paths"
+} else {
+  puts "write_path_columns differs from find_timing_paths"
+  puts $serial_report
+  puts $threads_report
+}
+file delete example7_serial.col example7_threads.col
@@ -0,0 +1,25 @@
+# read_vcd and read_saif example
+# example8.vcd and example8.saif have the same toggle counts and
+# times at 1, so they annotate the same activities.
+read_liberty example1_slow.lib
+read_verilog example1.v
+link_design top
+create_clock -name clk -period 10 {clk1 clk2 clk3}
+set_input_delay -clock clk 0 {in1 in2}
+sta::with_output_to_variable default_report { report_power }
+read_vcd -scope tb/dut example8.vcd
+sta::with_output_to_variable vcd_report { report_power }
+
+# Relinking discards the annotated activities.
+link_design top
+create_clock -name clk -period 10 {clk1 clk2 clk3}
+set_input_delay -clock clk 0 {in1 in2}
+read_saif -scope tb/dut example8.saif
+sta::with_output_to_variable saif_report { report_power }
+if { $vcd_report == $saif_report && $vcd_report != $default_report } {
+  puts "read_vcd matches read_saif"
+} else {
+  puts "read_vcd differs from read_saif"
+  puts $vcd_report
+  puts $saif_report
+}
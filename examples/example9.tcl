@@ -0,0 +1,53 @@
+# create_mode/current_mode example
+# Switching modes must give the same reports as timing each set of
+# constraints by itself.
+read_liberty example1_slow.lib
+read_verilog example1.v
+link_design top
+create_clock -name clk -period 10 {clk1 clk2 clk3}
+set_input_delay -clock clk 0 {in1 in2}
+sta::with_output_to_variable default_report {
+  report_checks -path_delay min_max
+}
+
+proc scan_shift_constraints {} {
+  create_clock -name clk -period 2 {clk1 clk2 clk3}
+  set_input_delay -clock clk 0.5 {in1 in2}
+  set_case_analysis 1 in1
+  set_false_path -from in2
+}
+
+create_mode scan_shift
+current_mode scan_shift
+scan_shift_constraints
+sta::with_output_to_variable scan_shift_report {
+  report_checks -path_delay min_max
+}
+current_mode default
+sta::with_output_to_variable default_report2 {
+  report_checks -path_delay min_max
+}
+current_mode scan_shift
+sta::with_output_to_variable scan_shift_report2 {
+  report_checks -path_delay min_max
+}
+
+# Baseline with one set of constraints at a time.
+current_mode default
+sta::remove_constraints
+scan_shift_constraints
+sta::with_output_to_variable single_mode_report {
+  report_checks -path_delay min_max
+}
+if { $default_report2 == $default_report
+     && $scan_shift_report2 == $scan_shift_report
+     && $scan_shift_report == $single_mode_report } {
+  puts "current_mode matches single mode timing"
+} else {
+  puts "current_mode differs from single mode timing"
+  puts $default_report
+  puts $default_report2
+  puts $scan_shift_report
+  puts $scan_shift_report2
+  puts $single_mode_report
+}
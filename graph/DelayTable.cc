@@ -0,0 +1,281 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include "Machine.hh"
+#include "Mutex.hh"
+#include "MinMax.hh"
+#include "DelayTable.hh"
+
+namespace sta {
+
+// Largest fixed point value.
+static const float fixed_max = 32767.0F;
+
+// Sigma planes of a compact table.
+// Row values are indexed by
+//  (index * plane_count + plane) * EarlyLate::index_count + early_late index
+// and share a scale like the means.
+class DelaySigmas
+{
+public:
+  std::vector<float> scales_;
+  std::vector<int16_t> values_;
+};
+
+DelayTable::DelayTable(ObjectIndex size,
+		       int plane_count,
+		       bool compact) :
+  plane_count_(plane_count),
+  compact_(compact),
+  scales_(nullptr),
+  row_count_(0),
+  sigmas_(nullptr)
+{
+  if (compact_) {
+    scales_ = new Pool<float>(size);
+    ensureRows(scales_->size());
+  }
+  else {
+    pools_.resize(plane_count);
+    for (int i = 0; i < plane_count; i++)
+      pools_[i] = new DelayPool(size);
+  }
+}
+
+DelayTable::~DelayTable()
+{
+  pools_.deleteContents();
+  delete scales_;
+  delete sigmas_.load();
+}
+
+ObjectIndex
+DelayTable::makeRows(ObjectIndex count)
+{
+  ObjectIndex index = 0;
+  if (compact_) {
+    float *scales = scales_->makeObjects(count);
+    index = scales_->index(scales);
+    ensureRows(scales_->size());
+    for (ObjectIndex i = 0; i < count; i++)
+      scales[i] = 0.0;
+    int16_t *values = &values_[index * plane_count_];
+    for (ObjectIndex i = 0; i < count * plane_count_; i++)
+      values[i] = 0;
+    // Sigmas are zero when the row scale is zero.
+    DelaySigmas *sigmas = sigmas_;
+    if (sigmas) {
+      for (ObjectIndex i = 0; i < count; i++)
+	sigmas->scales_[index + i] = 0.0;
+    }
+  }
+  else {
+    for (DelayPool *pool : pools_) {
+      Delay *delays = pool->makeObjects(count);
+      index = pool->index(delays);
+      for (ObjectIndex i = 0; i < count; i++)
+	delays[i] = 0.0;
+    }
+  }
+  return index;
+}
+
+void
+DelayTable::deleteRows(ObjectIndex index,
+		       ObjectIndex count)
+{
+  if (compact_)
+    scales_->deleteObjects(index, count);
+  else {
+    for (DelayPool *pool : pools_)
+      pool->deleteObjects(index, count);
+  }
+}
+
+// Make room for the rows of pool indices [1, row_count].
+// Rows are only made by graph edits so this is not called by
+// delay calculation threads.
+void
+DelayTable::ensureRows(ObjectIndex row_count)
+{
+  // Index 0 is reserved.
+  row_count++;
+  if (row_count > row_count_) {
+    row_count_ = row_count;
+    values_.resize(row_count * plane_count_);
+    DelaySigmas *sigmas = sigmas_;
+    if (sigmas) {
+      sigmas->scales_.resize(row_count);
+      sigmas->values_.resize(row_count * plane_count_
+			     * EarlyLate::index_count);
+    }
+  }
+}
+
+DelaySigmas *
+DelayTable::ensureSigmas()
+{
+  DelaySigmas *sigmas = sigmas_;
+  if (sigmas == nullptr) {
+    // Lock for delay calc threads.
+    UniqueLock lock(sigmas_lock_);
+    sigmas = sigmas_;
+    if (sigmas == nullptr) {
+      sigmas = new DelaySigmas;
+      sigmas->scales_.resize(row_count_, 0.0);
+      sigmas->values_.resize(row_count_ * plane_count_
+			     * EarlyLate::index_count, 0);
+      sigmas_ = sigmas;
+    }
+  }
+  return sigmas;
+}
+
+Delay
+DelayTable::value(ObjectIndex index,
+		  int plane) const
+{
+  if (compact_) {
+    float scale = *scales_->find(index);
+    float mean = values_[index * plane_count_ + plane] * scale;
+    DelaySigmas *sigmas = sigmas_;
+    if (sigmas) {
+      float sigma_scale = sigmas->scales_[index];
+      const int16_t *sigma_values =
+	&sigmas->values_[(index * plane_count_ + plane)
+			 * EarlyLate::index_count];
+      float sigma_early =
+	sigma_values[EarlyLate::early()->index()] * sigma_scale;
+      float sigma_late =
+	sigma_values[EarlyLate::late()->index()] * sigma_scale;
+      return makeDelay2(mean, sigma_early * sigma_early,
+			sigma_late * sigma_late);
+    }
+    else
+      return makeDelay2(mean, 0.0, 0.0);
+  }
+  else
+    return *pools_[plane]->find(index);
+}
+
+void
+DelayTable::setValue(ObjectIndex index,
+		     int plane,
+		     const Delay &value)
+{
+  if (compact_) {
+    float &scale = *scales_->find(index);
+    setRowValue(&values_[index * plane_count_], plane_count_, plane,
+		delayAsFloat(value), scale);
+    float sigma2_early = delaySigma2(value, EarlyLate::early());
+    float sigma2_late = delaySigma2(value, EarlyLate::late());
+    DelaySigmas *sigmas = sigmas_;
+    if (sigmas == nullptr
+	&& (sigma2_early != 0.0 || sigma2_late != 0.0))
+      sigmas = ensureSigmas();
+    if (sigmas) {
+      int row_length = plane_count_ * EarlyLate::index_count;
+      int16_t *row = &sigmas->values_[index * row_length];
+      float &sigma_scale = sigmas->scales_[index];
+      int column = plane * EarlyLate::index_count;
+      setRowValue(row, row_length, column + EarlyLate::early()->index(),
+		  sqrt(sigma2_early), sigma_scale);
+      setRowValue(row, row_length, column + EarlyLate::late()->index(),
+		  sqrt(sigma2_late), sigma_scale);
+    }
+  }
+  else
+    *pools_[plane]->find(index) = value;
+}
+
+// Set one value of a row of fixed point values and rescale the
+// rest of the row if the largest value in the row changes its scale.
+// Scales are powers of two so scaling the row down is exact.
+void
+DelayTable::setRowValue(int16_t *row,
+			int row_length,
+			int column,
+			float value,
+			float &scale)
+{
+  value = std::max(std::min(value, FLT_MAX), -FLT_MAX);
+  float max_value = std::abs(value);
+  for (int i = 0; i < row_length; i++) {
+    if (i != column)
+      max_value = std::max(max_value, std::abs(row[i] * scale));
+  }
+  float scale1 = rowScale(max_value);
+  if (scale1 != scale) {
+    for (int i = 0; i < row_length; i++) {
+      if (i != column)
+	row[i] = quantize(row[i] * scale, scale1);
+    }
+    scale = scale1;
+  }
+  row[column] = quantize(value, scale);
+}
+
+// Smallest power of two scale that fits max_value in 16 bits.
+float
+DelayTable::rowScale(float max_value)
+{
+  if (max_value == 0.0)
+    return 0.0;
+  else {
+    int exp;
+    // max_value = fraction * 2^exp, 0.5 <= fraction < 1
+    frexpf(max_value, &exp);
+    return ldexpf(1.0F, exp - 15);
+  }
+}
+
+int16_t
+DelayTable::quantize(float value,
+		     float scale)
+{
+  if (scale == 0.0)
+    return 0;
+  else {
+    float fixed = std::round(value / scale);
+    return static_cast<int16_t>(std::max(std::min(fixed, fixed_max),
+					 -fixed_max));
+  }
+}
+
+size_t
+DelayTable::memoryBytes() const
+{
+  size_t bytes = 0;
+  if (compact_) {
+    bytes += scales_->size() * sizeof(float);
+    bytes += values_.capacity() * sizeof(int16_t);
+    DelaySigmas *sigmas = sigmas_;
+    if (sigmas) {
+      bytes += sigmas->scales_.capacity() * sizeof(float);
+      bytes += sigmas->values_.capacity() * sizeof(int16_t);
+    }
+  }
+  else {
+    for (DelayPool *pool : pools_)
+      bytes += pool->size() * sizeof(Delay);
+  }
+  return bytes;
+}
+
+} // namespace
@@ -0,0 +1,99 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_DELAY_TABLE_H
+#define STA_DELAY_TABLE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+#include "Vector.hh"
+#include "Pool.hh"
+#include "Delay.hh"
+
+namespace sta {
+
+class DelaySigmas;
+
+typedef Pool<Delay> DelayPool;
+typedef Vector<DelayPool*> DelayPoolSeq;
+
+// Rows of plane_count delay values (one per analysis point or
+// analysis point/transition) used for graph arc delays and slews.
+// Row indices are allocated like Pool indices, so a table that makes
+// and deletes rows in step with the graph vertex pool has the vertex
+// indices as row indices.
+//
+// Full tables keep a Delay per value.
+// Compact tables keep each mean as a 16 bit fixed point value relative
+// to a power of two scale shared by the row, so a value is accurate to
+// 1 part in 2^15 of the largest value in its row. Sigmas are kept the
+// same way in planes that are only allocated when a non-zero sigma is
+// stored.
+class DelayTable
+{
+public:
+  DelayTable(ObjectIndex size,
+	     int plane_count,
+	     bool compact);
+  ~DelayTable();
+  bool compact() const { return compact_; }
+  // Make count consecutive rows of zero values.
+  // Return the index of the first row.
+  ObjectIndex makeRows(ObjectIndex count);
+  void deleteRows(ObjectIndex index,
+		  ObjectIndex count);
+  Delay value(ObjectIndex index,
+	      int plane) const;
+  void setValue(ObjectIndex index,
+		int plane,
+		const Delay &value);
+  // Bytes used to store the values.
+  size_t memoryBytes() const;
+
+protected:
+  void ensureRows(ObjectIndex row_count);
+  DelaySigmas *ensureSigmas();
+  static float rowScale(float max_value);
+  static int16_t quantize(float value,
+			  float scale);
+  static void setRowValue(int16_t *row,
+			  int row_length,
+			  int column,
+			  float value,
+			  float &scale);
+
+  int plane_count_;
+  bool compact_;
+  // Full values indexed by [plane][index].
+  DelayPoolSeq pools_;
+  // Compact row scales indexed by row index.
+  // The pool also allocates the row indices.
+  Pool<float> *scales_;
+  // Compact means indexed by index * plane_count + plane.
+  std::vector<int16_t> values_;
+  ObjectIndex row_count_;
+  std::atomic<DelaySigmas*> sigmas_;
+  std::mutex sigmas_lock_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(DelayTable);
+};
+
+} // namespace
+#endif
@@ -14,12 +14,14 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <atomic>
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
 #include "Stats.hh"
 #include "Error.hh"
 #include "Debug.hh"
 #include "Pool.hh"
+#include "Mutex.hh"
 #include "MinMax.hh"
 #include "PortDirection.hh"
 #include "Transition.hh"
@@ -51,8 +53,13 @@ Graph::Graph(StaState *sta,
   slew_tr_count_(slew_tr_count),
   have_arc_delays_(have_arc_delays),
   ap_count_(ap_count),
+  compact_delays_(false),
+  slews_(nullptr),
+  arc_delays_(nullptr),
   width_check_annotations_(nullptr),
-  period_check_annotations_(nullptr)
+  period_check_annotations_(nullptr),
+  journal_delays_(false),
+  delay_journal_pass_(0)
 {
 }
 
@@ -60,10 +67,11 @@ Graph::~Graph()
 {
   delete vertices_;
   delete edges_;
-  deleteSlewPools();
-  deleteArcDelayPools();
+  deleteSlewTable();
+  deleteArcDelayTable();
   removeWidthCheckAnnotations();
   removePeriodCheckAnnotations();
+  clearJournalDelays();
 }
 
 void
@@ -88,8 +96,8 @@ Graph::makeVerticesAndEdges()
   vertexAndEdgeCounts(vertex_count, edge_count, arc_count);
   vertices_ = new VertexPool(vertex_count);
   edges_ = new EdgePool(edge_count);
-  makeSlewPools(vertex_count, ap_count_);
-  makeArcDelayPools(arc_count, ap_count_);
+  makeSlewTable(vertex_count, ap_count_);
+  makeArcDelayTable(arc_count, ap_count_);
 
   LeafInstanceIterator *leaf_iter = network_->leafInstanceIterator();
   while (leaf_iter->hasNext()) {
@@ -458,6 +466,13 @@ Graph::index(const Vertex *vertex) const
   return vertices_->index(vertex);
 }
 
+VertexIndex
+Graph::vertexIndexEnd() const
+{
+  // Index==0 is reserved so pool indices are 1..size.
+  return vertices_->size() + 1;
+}
+
 void
 Graph::makePinVertices(Pin *pin)
 {
@@ -600,22 +615,17 @@ Graph::deleteOutEdge(Vertex *vertex,
     Graph::edge(next)->vertex_out_prev_ = prev;
 }
 
-const Slew &
+Slew
 Graph::slew(const Vertex *vertex,
 	    const TransRiseFall *tr,
 	    DcalcAPIndex ap_index)
 {
   if (slew_tr_count_) {
-    int pool_index =
-      (slew_tr_count_ == 1) ? ap_index : ap_index*slew_tr_count_+tr->index();
-    DelayPool *pool = slew_pools_[pool_index];
     VertexIndex vertex_index = index(vertex);
-    return *pool->find(vertex_index);
-  }
-  else {
-    static Slew slew(0.0);
-    return slew;
+    return slews_->value(vertex_index, slewPlane(tr, ap_index));
   }
+  else
+    return 0.0;
 }
 
 void
@@ -625,15 +635,21 @@ Graph::setSlew(Vertex *vertex,
 	       const Slew &slew)
 {
   if (slew_tr_count_) {
-    int pool_index =
-      (slew_tr_count_ == 1) ? ap_index : ap_index*slew_tr_count_+tr->index();
-    DelayPool *pool = slew_pools_[pool_index];
     VertexIndex vertex_index = index(vertex);
-    Slew &vertex_slew = *pool->find(vertex_index);
-    vertex_slew = slew;
+    int plane = slewPlane(tr, ap_index);
+    if (journal_delays_)
+      journalDelay(slews_, vertex_index, plane);
+    slews_->setValue(vertex_index, plane, slew);
   }
 }
 
+int
+Graph::slewPlane(const TransRiseFall *tr,
+		 DcalcAPIndex ap_index) const
+{
+  return (slew_tr_count_ == 1) ? ap_index : ap_index*slew_tr_count_+tr->index();
+}
+
 ////////////////////////////////////////////////////////////////
 
 Edge *
@@ -688,15 +704,11 @@ Graph::deleteEdge(Edge *edge)
 }
 
 void
-Graph::makeArcDelayPools(ArcIndex arc_count,
+Graph::makeArcDelayTable(ArcIndex arc_count,
 			 DcalcAPIndex ap_count)
 {
   if (have_arc_delays_) {
-    arc_delays_.resize(ap_count);
-    for (DcalcAPIndex i = 0; i < ap_count; i++) {
-      DelayPool *pool = new DelayPool(arc_count);
-      arc_delays_[i] = pool;
-    }
+    arc_delays_ = new DelayTable(arc_count, ap_count, compact_delays_);
 
     // Leave some room for edits.
     unsigned annot_size = arc_count * 1.2;
@@ -705,15 +717,10 @@ Graph::makeArcDelayPools(ArcIndex arc_count,
 }
 
 void
-Graph::deleteArcDelayPools()
+Graph::deleteArcDelayTable()
 {
-  if (have_arc_delays_) {
-    for (DcalcAPIndex i = 0; i < ap_count_; i++) {
-      DelayPool *pool = arc_delays_[i];
-      delete pool;
-    }
-    arc_delays_.clear();
-  }
+  delete arc_delays_;
+  arc_delays_ = nullptr;
 }
 
 void
@@ -721,14 +728,7 @@ Graph::makeEdgeArcDelays(Edge *edge)
 {
   if (have_arc_delays_) {
     int arc_count = edge->timingArcSet()->arcCount();
-    ArcIndex arc_index = 0;
-    for (DcalcAPIndex i = 0; i < ap_count_; i++) {
-      DelayPool *pool = arc_delays_[i];
-      ArcDelay *arc_delays = pool->makeObjects(arc_count);
-      arc_index = pool->index(arc_delays);
-      for (int j = 0; j < arc_count; j++)
-	*arc_delays++ = 0.0;
-    }
+    ArcIndex arc_index = arc_delays_->makeRows(arc_count);
     edge->setArcDelays(arc_index);
     // Make sure there is room for delay_annotated flags.
     unsigned max_annot_index = (arc_index + arc_count) * ap_count_;
@@ -746,10 +746,7 @@ Graph::deleteEdgeArcDelays(Edge *edge)
   if (have_arc_delays_) {
     ArcIndex arc_count = edge->timingArcSet()->arcCount();
     ArcIndex arc_index = edge->arcDelays();
-    for (DcalcAPIndex i = 0; i < ap_count_; i++) {
-      DelayPool *pool = arc_delays_[i];
-      pool->deleteObjects(arc_index, arc_count);
-    }
+    arc_delays_->deleteRows(arc_index, arc_count);
   }
 }
 
@@ -759,10 +756,8 @@ Graph::arcDelay(const Edge *edge,
 		DcalcAPIndex ap_index) const
 {
   if (have_arc_delays_) {
-    DelayPool *pool = arc_delays_[ap_index];
     ArcIndex arc_index = edge->arcDelays() + arc->index();
-    ArcDelay &arc_delay = *pool->find(arc_index);
-    return arc_delay;
+    return arc_delays_->value(arc_index, ap_index);
   }
   else
     return delay_zero;
@@ -775,23 +770,21 @@ Graph::setArcDelay(Edge *edge,
 		   ArcDelay delay)
 {
   if (have_arc_delays_) {
-    DelayPool *pool = arc_delays_[ap_index];
     ArcIndex arc_index = edge->arcDelays() + arc->index();
-    ArcDelay &arc_delay = *pool->find(arc_index);
-    arc_delay = delay;
+    if (journal_delays_)
+      journalDelay(arc_delays_, arc_index, ap_index);
+    arc_delays_->setValue(arc_index, ap_index, delay);
   }
 }
 
-const ArcDelay &
+ArcDelay
 Graph::wireArcDelay(const Edge *edge,
 		    const TransRiseFall *tr,
 		    DcalcAPIndex ap_index)
 {
   if (have_arc_delays_) {
-    DelayPool *pool = arc_delays_[ap_index];
     ArcIndex arc_index = edge->arcDelays() + tr->index();
-    const ArcDelay &arc_delay = *pool->find(arc_index);
-    return arc_delay;
+    return arc_delays_->value(arc_index, ap_index);
   }
   else
     return delay_zero;
@@ -804,10 +797,10 @@ Graph::setWireArcDelay(Edge *edge,
 		       const ArcDelay &delay)
 {
   if (have_arc_delays_) {
-    DelayPool *pool = arc_delays_[ap_index];
     ArcIndex arc_index = edge->arcDelays() + tr->index();
-    ArcDelay &arc_delay = *pool->find(arc_index);
-    arc_delay = delay;
+    if (journal_delays_)
+      journalDelay(arc_delays_, arc_index, ap_index);
+    arc_delays_->setValue(arc_index, ap_index, delay);
   }
 }
 
@@ -870,17 +863,44 @@ Graph::setDelayCount(DcalcAPIndex ap_count)
 {
   if (ap_count != ap_count_) {
     // Discard any existing delays.
-    deleteSlewPools();
-    deleteArcDelayPools();
+    deleteSlewTable();
+    deleteArcDelayTable();
     removeWidthCheckAnnotations();
     removePeriodCheckAnnotations();
-    makeSlewPools(vertex_count_, ap_count);
-    makeArcDelayPools(arc_count_, ap_count);
+    makeSlewTable(vertex_count_, ap_count);
+    makeArcDelayTable(arc_count_, ap_count);
     ap_count_ = ap_count;
     removeDelays();
   }
 }
 
+void
+Graph::setCompactDelays(bool compact)
+{
+  if (compact != compact_delays_) {
+    compact_delays_ = compact;
+    if (vertices_) {
+      // Discard any existing delays.
+      deleteSlewTable();
+      deleteArcDelayTable();
+      makeSlewTable(vertex_count_, ap_count_);
+      makeArcDelayTable(arc_count_, ap_count_);
+      removeDelays();
+    }
+  }
+}
+
+size_t
+Graph::delayMemoryBytes() const
+{
+  size_t bytes = 0;
+  if (slews_)
+    bytes += slews_->memoryBytes();
+  if (arc_delays_)
+    bytes += arc_delays_->memoryBytes();
+  return bytes;
+}
+
 void
 Graph::removeDelays()
 {
@@ -926,52 +946,114 @@ Graph::delayAnnotated(Edge *edge)
   return false;
 }
 
+// Journal passes are numbered across graphs so a thread never adds to
+// the journal of a previous pass or another graph.
+static std::atomic<uint64_t> delay_journal_pass_next(1);
+static thread_local uint64_t thread_delay_journal_pass = 0;
+static thread_local DelayJournal *thread_delay_journal = nullptr;
+
 void
-Graph::makeSlewPools(VertexIndex vertex_count,
-		     DcalcAPIndex ap_count)
+Graph::setJournalDelays(bool journal)
 {
-  DcalcAPIndex tr_ap_count = slew_tr_count_ * ap_count;
-  slew_pools_.resize(tr_ap_count);
-  for (DcalcAPIndex i = 0; i < tr_ap_count; i++) {
-    DelayPool *pool = new DelayPool(vertex_count);
-    slew_pools_[i] = pool;
-  }
+  journal_delays_ = journal;
+  delayJournalPass();
 }
 
 void
-Graph::deleteSlewPools()
+Graph::delayJournalPass()
 {
-  if (slew_tr_count_) {
-    DcalcAPIndex tr_ap_count = slew_tr_count_ * ap_count_;
-    for (DcalcAPIndex i = 0; i < tr_ap_count; i++) {
-      DelayPool *pool = slew_pools_[i];
-      delete pool;
+  delay_journal_pass_ = delay_journal_pass_next++;
+}
+
+void
+Graph::journalDelay(DelayTable *table,
+		    ObjectIndex index,
+		    int plane)
+{
+  if (thread_delay_journal_pass != delay_journal_pass_) {
+    // First value saved by this thread in the pass.
+    DelayJournal *journal = new DelayJournal;
+    {
+      // Lock for delay calc threads.
+      UniqueLock lock(delay_journal_lock_);
+      delay_journals_.push_back(journal);
     }
-    slew_pools_.clear();
+    thread_delay_journal = journal;
+    thread_delay_journal_pass = delay_journal_pass_;
   }
+  Delay delay = table->value(index, plane);
+  thread_delay_journal->push_back(DelayJournalEntry(table, index, plane,
+						     delay));
+}
+
+void
+Graph::restoreJournalDelays()
+{
+  // Restore in reverse order so the value saved first is the one
+  // that is left. Journals of threads in the same pass save
+  // different values, so only the order of the passes matters.
+  for (auto journal_iter = delay_journals_.rbegin();
+       journal_iter != delay_journals_.rend();
+       journal_iter++) {
+    DelayJournal *journal = *journal_iter;
+    for (auto entry_iter = journal->rbegin();
+	 entry_iter != journal->rend();
+	 entry_iter++) {
+      DelayJournalEntry &entry = *entry_iter;
+      entry.table_->setValue(entry.index_, entry.plane_, entry.delay_);
+    }
+  }
+  clearJournalDelays();
+}
+
+void
+Graph::clearJournalDelays()
+{
+  delay_journals_.deleteContentsClear();
+  // Forget the thread journals.
+  delayJournalPass();
+}
+
+DelayJournalEntry::DelayJournalEntry(DelayTable *table,
+				     ObjectIndex index,
+				     int plane,
+				     const Delay &delay) :
+  table_(table),
+  index_(index),
+  plane_(plane),
+  delay_(delay)
+{
+}
+
+void
+Graph::makeSlewTable(VertexIndex vertex_count,
+		     DcalcAPIndex ap_count)
+{
+  if (slew_tr_count_)
+    slews_ = new DelayTable(vertex_count, slew_tr_count_ * ap_count,
+			    compact_delays_);
+}
+
+void
+Graph::deleteSlewTable()
+{
+  delete slews_;
+  slews_ = nullptr;
 }
 
 void
 Graph::makeVertexSlews()
 {
-  DcalcAPIndex tr_ap_count = slew_tr_count_ * ap_count_;
-  slew_pools_.resize(tr_ap_count);
-  for (DcalcAPIndex i = 0; i < tr_ap_count; i++) {
-    DelayPool *pool = slew_pools_[i];
-    Slew *slew = pool->makeObject();
-    *slew = 0.0;
-  }
+  if (slews_)
+    slews_->makeRows(1);
 }
 
 void
 Graph::deleteVertexSlews(Vertex *vertex)
 {
-  VertexIndex vertex_index = index(vertex);
-  DcalcAPIndex tr_ap_count = slew_tr_count_ * ap_count_;
-  slew_pools_.resize(tr_ap_count);
-  for (DcalcAPIndex i = 0; i < tr_ap_count; i++) {
-    DelayPool *pool = slew_pools_[i];
-    pool->deleteObject(vertex_index);
+  if (slews_) {
+    VertexIndex vertex_index = index(vertex);
+    slews_->deleteRows(vertex_index, 1);
   }
 }
 
@@ -17,6 +17,8 @@
 #ifndef STA_GRAPH_H
 #define STA_GRAPH_H
 
+#include <stdint.h>
+#include <mutex>
 #include "DisallowCopyAssign.hh"
 #include "Iterator.hh"
 #include "Map.hh"
@@ -26,6 +28,7 @@
 #include "LibertyClass.hh"
 #include "NetworkClass.hh"
 #include "Delay.hh"
+#include "DelayTable.hh"
 #include "GraphClass.hh"
 
 namespace sta {
@@ -36,14 +39,30 @@ class PathVertexRep;
 
 enum class LevelColor { white, gray, black };
 
-typedef Pool<Delay> DelayPool;
 typedef Pool<Vertex> VertexPool;
 typedef Pool<Edge> EdgePool;
 typedef Map<const Pin*, Vertex*> PinVertexMap;
 typedef Iterator<Edge*> VertexEdgeIterator;
 typedef Map<const Pin*, float*> WidthCheckAnnotations;
 typedef Map<const Pin*, float*> PeriodCheckAnnotations;
-typedef Vector<DelayPool*> DelayPoolSeq;
+
+// Slew or arc delay value saved by the delay journal.
+class DelayJournalEntry
+{
+public:
+  DelayJournalEntry(DelayTable *table,
+		    ObjectIndex index,
+		    int plane,
+		    const Delay &delay);
+
+  DelayTable *table_;
+  ObjectIndex index_;
+  int plane_;
+  Delay delay_;
+};
+
+typedef Vector<DelayJournalEntry> DelayJournal;
+typedef Vector<DelayJournal*> DelayJournalSeq;
 
 // The graph acts as a BUILDER for the graph vertices and edges.
 class Graph : public StaState
@@ -63,6 +82,13 @@ public:
 
   // Number of arc delays and slews from sdf or delay calculation.
   virtual void setDelayCount(DcalcAPIndex ap_count);
+  // Compact delays keep arc delays and slews in 16 bits relative to
+  // a scale shared by the analysis points of an arc or vertex.
+  bool compactDelays() const { return compact_delays_; }
+  // Changing the delay storage discards any existing delays.
+  void setCompactDelays(bool compact);
+  // Bytes used to store arc delays and slews.
+  size_t delayMemoryBytes() const;
 
   // Vertex functions.
   // Bidirect pins have two vertices.
@@ -84,11 +110,13 @@ public:
   virtual void deleteVertex(Vertex *vertex);
   bool hasFaninOne(Vertex *vertex) const;
   VertexIndex vertexCount() { return vertex_count_; }
+  // Greater than the index of every vertex.
+  VertexIndex vertexIndexEnd() const;
   // Slews are reported slews in seconds.
   // Reported slew are the same as those in the liberty tables.
   //  reported_slews = measured_slews / slew_derate_from_library
   // Measured slews are between slew_lower_threshold and slew_upper_threshold.
-  virtual const Slew &slew(const Vertex *vertex,
+  virtual Slew slew(const Vertex *vertex,
 			   const TransRiseFall *tr,
 			   DcalcAPIndex ap_index);
   virtual void setSlew(Vertex *vertex,
@@ -118,7 +146,7 @@ public:
 			   DcalcAPIndex ap_index,
 			   ArcDelay delay);
   // Alias for arcDelays using library wire arcs.
-  virtual const ArcDelay &wireArcDelay(const Edge *edge,
+  virtual ArcDelay wireArcDelay(const Edge *edge,
 				       const TransRiseFall *tr,
 				       DcalcAPIndex ap_index);
   virtual void setWireArcDelay(Edge *edge,
@@ -142,6 +170,17 @@ public:
 			     bool annotated);
   // True if any edge arc is annotated.
   bool delayAnnotated(Edge *edge);
+  // While journaling, slew and arc delay values are saved before
+  // they are changed so they can be restored (Sta::ecoRollback).
+  // Journaled values are only valid while the graph edges and
+  // vertices are unchanged.
+  void setJournalDelays(bool journal);
+  // Each thread saves values in its own journal for the pass.
+  // Threads in a pass (a delay calculation) must set different values.
+  void delayJournalPass();
+  // Restore the journaled values and clear the journal.
+  void restoreJournalDelays();
+  void clearJournalDelays();
   EdgeIndex edgeCount() { return edge_count_; }
   virtual ArcIndex arcCount() { return arc_count_; }
 
@@ -202,14 +241,14 @@ protected:
                                      LibertyPort *from_to_port);
   void removeWidthCheckAnnotations();
   void removePeriodCheckAnnotations();
-  void makeSlewPools(VertexIndex vertex_count,
+  void makeSlewTable(VertexIndex vertex_count,
 		     DcalcAPIndex count);
-  void deleteSlewPools();
+  void deleteSlewTable();
   void makeVertexSlews();
   void deleteVertexSlews(Vertex *vertex);
-  void makeArcDelayPools(ArcIndex arc_count,
+  void makeArcDelayTable(ArcIndex arc_count,
 			 DcalcAPIndex ap_count);
-  void deleteArcDelayPools();
+  void deleteArcDelayTable();
   virtual void deleteEdgeArcDelays(Edge *edge);
   void deleteInEdge(Vertex *vertex,
 		    Edge *edge);
@@ -219,6 +258,11 @@ protected:
   void removeDelayAnnotated(Edge *edge);
   // User defined predicate to filter graph edges for liberty timing arcs.
   virtual bool filterEdge(TimingArcSet *) const { return true; }
+  int slewPlane(const TransRiseFall *tr,
+		DcalcAPIndex ap_index) const;
+  void journalDelay(DelayTable *table,
+		    ObjectIndex index,
+		    int plane);
 
   VertexPool *vertices_;
   EdgePool *edges_;
@@ -234,15 +278,21 @@ protected:
   int slew_tr_count_;
   bool have_arc_delays_;
   DcalcAPIndex ap_count_;
-  DelayPoolSeq slew_pools_;	      // [ap_index][tr_index][vertex_index]
+  bool compact_delays_;
+  DelayTable *slews_;		      // [vertex_index][ap_index][tr_index]
   VertexIndex slew_count_;
-  DelayPoolSeq arc_delays_;	      // [ap_index][edge_arc_index]
+  DelayTable *arc_delays_;	      // [edge_arc_index][ap_index]
   // Sdf width check annotations.
   WidthCheckAnnotations *width_check_annotations_;
   // Sdf period check annotations.
   PeriodCheckAnnotations *period_check_annotations_;
   // Register/latch clock vertices to search from.
   VertexSet reg_clk_vertices_;
+  bool journal_delays_;
+  // Thread journals in the order they were started.
+  DelayJournalSeq delay_journals_;
+  uint64_t delay_journal_pass_;
+  std::mutex delay_journal_lock_;
   friend class Vertex;
   friend class VertexIterator;
   friend class VertexInEdgeIterator;
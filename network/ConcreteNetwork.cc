@@ -935,6 +935,21 @@ ConcreteNetwork::findPin(const Instance *instance,
   return reinterpret_cast<Pin*>(inst->findPin(port));
 }
 
+Pin *
+ConcreteNetwork::findPin(const Instance *instance,
+			 const LibertyPort *port) const
+{
+  const ConcreteInstance *inst =
+    reinterpret_cast<const ConcreteInstance*>(instance);
+  const ConcretePort *cport = port;
+  if (cport->cell() == inst->cell()
+      && !cport->hasMembers())
+    return reinterpret_cast<Pin*>(inst->findPin(reinterpret_cast<const Port*>
+						(cport)));
+  else
+    return reinterpret_cast<Pin*>(inst->findPin(port->name()));
+}
+
 Net *
 ConcreteNetwork::findNet(const Instance *instance,
 			 const char *net_name) const
@@ -118,6 +118,10 @@ public:
 		       const char *port_name) const;
   virtual Pin *findPin(const Instance *instance,
 		       const Port *port) const;
+  // Index the instance pins directly when port belongs to the
+  // instance cell instead of looking it up by name.
+  virtual Pin *findPin(const Instance *instance,
+		       const LibertyPort *port) const;
 
   virtual InstanceChildIterator *
   childIterator(const Instance *instance) const;
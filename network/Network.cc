@@ -14,10 +14,13 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
+#include <vector>
 #include "Machine.hh"
 #include "DisallowCopyAssign.hh"
 #include "StringUtil.hh"
 #include "PatternMatch.hh"
+#include "ThreadForEach.hh"
 #include "PortDirection.hh"
 #include "Liberty.hh"
 #include "Network.hh"
@@ -605,17 +608,37 @@ Network::findInstanceRelative(const Instance *inst,
     return findChild(inst, path_name);
 }
 
+// Hierarchy levels with at least this many children are searched
+// with multiple threads.
+static const size_t find_instances_parallel_min = 1000;
+
+// Length of the glob pattern up to the first wildcard.
+// Every string that matches the pattern starts with this literal prefix.
+static size_t
+patternLiteralLength(const PatternMatch *pattern)
+{
+  if (pattern->isRegexp()
+      // The prefix is compared case sensitively.
+      || pattern->nocase())
+    return 0;
+  else
+    return strcspn(pattern->pattern(), "*?");
+}
+
 void
 Network::findInstancesMatching(const Instance *context,
 			       const PatternMatch *pattern,
 			       InstanceSeq *insts) const
 {
   if (pattern->hasWildcards()) {
-    size_t context_name_length = 0;
-    if (context != topInstance())
-      // Add one for the trailing divider.
-      context_name_length = strlen(pathName(context)) + 1;
-    findInstancesMatching1(context, context_name_length, pattern, insts);
+    // Child path names relative to context are built in a single
+    // buffer as the hierarchy is descended rather than calling
+    // pathName for each instance.
+    string path;
+    // Tcl regexps keep match state so they cannot be shared by threads.
+    bool parallel = threadCount() > 1 && !pattern->isRegexp();
+    findInstancesMatching1(context, path, patternLiteralLength(pattern),
+			   pattern, parallel, insts);
   }
   else {
     Instance *inst = findInstanceRelative(context, pattern->pattern());
@@ -624,24 +647,84 @@ Network::findInstancesMatching(const Instance *context,
   }
 }
 
+// path is the path name of parent relative to the search context
+// with a trailing divider.
 void
-Network::findInstancesMatching1(const Instance *context,
-				size_t context_name_length,
+Network::findInstancesMatching1(const Instance *parent,
+				string &path,
+				size_t literal_length,
 				const PatternMatch *pattern,
+				bool parallel,
 				InstanceSeq *insts) const
 {
-  InstanceChildIterator *child_iter = childIterator(context);
-  while (child_iter->hasNext()) {
-    Instance *child = child_iter->next();
-    const char *child_name = pathName(child);
-    // Remove context prefix from the name.
-    const char *child_context_name = &child_name[context_name_length];
-    if (pattern->match(child_context_name))
-      insts->push_back(child);
-    if (!isLeaf(child))
-      findInstancesMatching1(child, context_name_length, pattern, insts);
+  if (parallel) {
+    InstanceSeq children;
+    InstanceChildIterator *child_iter = childIterator(parent);
+    while (child_iter->hasNext())
+      children.push_back(child_iter->next());
+    delete child_iter;
+
+    if (children.size() >= find_instances_parallel_min) {
+      // Each thread searches a contiguous range of children into its
+      // own result sequence so the merged order matches the serial search.
+      size_t thread_count = threadCount();
+      std::vector<InstanceSeq> thread_insts(thread_count);
+      forEachChunk(children.size(), thread_count,
+		   [&] (size_t i, size_t begin, size_t end) {
+	string thread_path = path;
+	for (size_t j = begin; j < end; j++)
+	  findInstancesMatching2(children[j], thread_path, literal_length,
+				 pattern, false, &thread_insts[i]);
+      });
+      for (InstanceSeq &insts1 : thread_insts)
+	insts->insert(insts->end(), insts1.begin(), insts1.end());
+    }
+    else {
+      for (Instance *child : children)
+	findInstancesMatching2(child, path, literal_length, pattern,
+			       true, insts);
+    }
   }
-  delete child_iter;
+  else {
+    InstanceChildIterator *child_iter = childIterator(parent);
+    while (child_iter->hasNext()) {
+      Instance *child = child_iter->next();
+      findInstancesMatching2(child, path, literal_length, pattern,
+			     false, insts);
+    }
+    delete child_iter;
+  }
+}
+
+void
+Network::findInstancesMatching2(const Instance *child,
+				string &path,
+				size_t literal_length,
+				const PatternMatch *pattern,
+				bool parallel,
+				InstanceSeq *insts) const
+{
+  size_t parent_length = path.size();
+  path += name(child);
+  size_t path_length = path.size();
+  const char *literal = pattern->pattern();
+  // Prune the child and its subtree unless the child path name is
+  // consistent with the literal prefix of the pattern.
+  if (path.compare(0, std::min(path_length, literal_length),
+		   literal, std::min(path_length, literal_length)) == 0) {
+    if (path_length >= literal_length) {
+      if (pattern->match(path.c_str()))
+	insts->push_back(const_cast<Instance*>(child));
+    }
+    if (!isLeaf(child)
+	&& (path_length >= literal_length
+	    || literal[path_length] == divider_)) {
+      path += divider_;
+      findInstancesMatching1(child, path, literal_length, pattern,
+			     parallel, insts);
+    }
+  }
+  path.resize(parent_length);
 }
 
 void
@@ -667,13 +750,41 @@ Network::findChildrenMatching(const Instance *parent,
 			      InstanceSeq *insts) const
 {
   if (pattern->hasWildcards()) {
+    InstanceSeq children;
     InstanceChildIterator *child_iter = childIterator(parent);
-    while (child_iter->hasNext()) {
-      Instance *child = child_iter->next();
-      if (pattern->match(name(child)))
-	insts->push_back(child);
-    }
+    while (child_iter->hasNext())
+      children.push_back(child_iter->next());
     delete child_iter;
+
+    const char *literal = pattern->pattern();
+    size_t literal_length = patternLiteralLength(pattern);
+    auto find_matches = [=, &children] (size_t begin,
+					size_t end,
+					InstanceSeq *matches) {
+      for (size_t i = begin; i < end; i++) {
+	Instance *child = children[i];
+	const char *child_name = name(child);
+	// Skip the glob match for names without the literal prefix.
+	if (strncmp(child_name, literal, literal_length) == 0
+	    && pattern->match(child_name))
+	  matches->push_back(child);
+      }
+    };
+    // Tcl regexps keep match state so they cannot be shared by threads.
+    if (threadCount() > 1
+	&& !pattern->isRegexp()
+	&& children.size() >= find_instances_parallel_min) {
+      size_t thread_count = threadCount();
+      std::vector<InstanceSeq> thread_insts(thread_count);
+      forEachChunk(children.size(), thread_count,
+		   [&] (size_t i, size_t begin, size_t end) {
+	find_matches(begin, end, &thread_insts[i]);
+      });
+      for (InstanceSeq &insts1 : thread_insts)
+	insts->insert(insts->end(), insts1.begin(), insts1.end());
+    }
+    else
+      find_matches(0, children.size(), insts);
   }
   else {
     Instance *child = findChild(parent, pattern->pattern());
@@ -922,7 +1033,9 @@ Network::findInstPinsMatching(const Instance *instance,
     InstancePinIterator *pin_iter = pinIterator(instance);
     while (pin_iter->hasNext()) {
       Pin *pin = pin_iter->next();
-      if (pattern->match(name(pin)))
+      // Match the port name, which is what findPin matches without
+      // wildcards, rather than building the pin path name.
+      if (pattern->match(portName(pin)))
 	pins->push_back(pin);
     }
     delete pin_iter;
@@ -430,9 +430,18 @@ public:
 protected:
   Pin *findPinLinear(const Instance *instance,
 		     const char *port_name) const;
-  void findInstancesMatching1(const Instance *context,
-			      size_t context_name_length,
+  void findInstancesMatching1(const Instance *parent,
+			      string &path,
+			      size_t literal_length,
 			      const PatternMatch *pattern,
+			      bool parallel,
+			      // Return value.
+			      InstanceSeq *insts) const;
+  void findInstancesMatching2(const Instance *child,
+			      string &path,
+			      size_t literal_length,
+			      const PatternMatch *pattern,
+			      bool parallel,
 			      // Return value.
 			      InstanceSeq *insts) const;
   bool isConnected(const Net *net,
@@ -35,11 +35,13 @@ thrusIntersectPts(ExceptionThruSeq *thrus1,
 static void
 insertPinPairsThruHierPin(const Pin *hpin,
 			  const Network *network,
-			  PinPairSet *pairs);
+			  PinPairSet *pairs,
+			  PinSet *new_loads);
 static void
 insertPinPairsThruNet(Net *net,
 		      const Network *network,
-		      PinPairSet *pairs);
+		      PinPairSet *pairs,
+		      PinSet *new_loads);
 static void
 deletePinPairsThruHierPin(const Pin *hpin, 
 			  const Network *network,
@@ -313,6 +315,24 @@ ExceptionPath::hash(ExceptionPt *missing_pt) const
   return hash;
 }
 
+void
+ExceptionPath::mergeHashes(HashSeq &hashes) const
+{
+  hashes.clear();
+  Hash hash = typePriority();
+  int pot = 32;
+  ExceptionPtIterator pt_iter(this);
+  while (pt_iter.hasNext()) {
+    ExceptionPt *pt = pt_iter.next();
+    Hash pt_hash = pt->hash() * (pot - 1);
+    hash += pt_hash;
+    hashes.push_back(pt_hash);
+    pot *= 2;
+  }
+  for (Hash &pt_hash : hashes)
+    pt_hash = hash - pt_hash;
+}
+
 bool
 ExceptionPath::mergeablePts(ExceptionPath *exception) const
 {
@@ -1551,7 +1571,7 @@ ExceptionThru::makePinEdges(const Network *network)
   while (pin_iter.hasNext()) {
     Pin *pin = pin_iter.next();
     if (network->isHierarchical(pin))
-      makeHpinEdges(pin, network);
+      makeHpinEdges(pin, network, nullptr);
   }
 }
 
@@ -1597,12 +1617,13 @@ ExceptionThru::deletePinEdges(Pin *pin,
 
 void
 ExceptionThru::makeHpinEdges(const Pin *pin,
-			     const Network *network)
+			     const Network *network,
+			     PinSet *new_loads)
 {
   if (edges_ == nullptr)
     edges_ = new EdgePinsSet;
   // Add edges thru pin to edges_.
-  insertPinPairsThruHierPin(pin, network, edges_);
+  insertPinPairsThruHierPin(pin, network, edges_, new_loads);
 }
 
 void
@@ -1614,18 +1635,19 @@ ExceptionThru::makeNetEdges(const Network *network)
     if (edges_ == nullptr)
       edges_ = new EdgePinsSet;
     // Add edges thru pin to edges_.
-    insertPinPairsThruNet(net, network, edges_);
+    insertPinPairsThruNet(net, network, edges_, nullptr);
   }
 }
 
 void
 ExceptionThru::makeNetEdges(Net *net,
-			    const Network *network)
+			    const Network *network,
+			    PinSet *new_loads)
 {
   if (edges_ == nullptr)
     edges_ = new EdgePinsSet;
   // Add edges thru pin to edges_.
-  insertPinPairsThruNet(net, network, edges_);
+  insertPinPairsThruNet(net, network, edges_, new_loads);
 }
 
 void
@@ -1638,7 +1660,7 @@ ExceptionThru::makeInstEdges(const Network *network)
       InstancePinIterator *pin_iter = network->pinIterator(inst);
       while (pin_iter->hasNext()) {
 	Pin *pin = pin_iter->next();
-	makeHpinEdges(pin, network);
+	makeHpinEdges(pin, network, nullptr);
       }
       delete pin_iter;
     }
@@ -1653,7 +1675,7 @@ ExceptionThru::makeInstEdges(Instance *inst,
     InstancePinIterator *pin_iter = network->pinIterator(inst);
     while (pin_iter->hasNext()) {
       Pin *pin = pin_iter->next();
-      makeHpinEdges(pin, network);
+      makeHpinEdges(pin, network, nullptr);
     }
     delete pin_iter;
   }
@@ -2092,7 +2114,8 @@ ExceptionThru::objectCount() const
 
 void
 ExceptionThru::connectPinAfter(PinSet *drvrs,
-			       Network *network)
+			       Network *network,
+			       PinSet *new_loads)
 {
   //  - Tricky to detect exactly what needs to be updated. In theory,
   //    at most, only edges starting/ending (pin is leaf) or spanning
@@ -2118,7 +2141,7 @@ ExceptionThru::connectPinAfter(PinSet *drvrs,
       if (network->isHierarchical(thru_pin)) {
 	PinSet *thru_pin_drvrs = network->drivers(thru_pin);
 	if (PinSet::intersects(drvrs, thru_pin_drvrs))
-	  makePinEdges(thru_pin, network);
+	  makePinEdges(thru_pin, network, new_loads);
       }
     }
     InstanceSet::Iterator inst_iter(insts_);
@@ -2130,7 +2153,7 @@ ExceptionThru::connectPinAfter(PinSet *drvrs,
 	  Pin *inst_pin = inst_pin_iter->next();
 	  PinSet *inst_pin_drvrs = network->drivers(inst_pin);
 	  if (PinSet::intersects(drvrs, inst_pin_drvrs))
-	    makePinEdges(inst_pin, network);
+	    makePinEdges(inst_pin, network, new_loads);
 	}
 	delete inst_pin_iter;
       }
@@ -2140,17 +2163,18 @@ ExceptionThru::connectPinAfter(PinSet *drvrs,
       Net *net = net_iter.next();
       PinSet *net_drvrs = network->drivers(net);
       if (PinSet::intersects(drvrs, net_drvrs))
-	makeNetEdges(net, network);
+	makeNetEdges(net, network, new_loads);
     }
   }
 }
 
 void
 ExceptionThru::makePinEdges(Pin *pin,
-			    const Network *network)
+			    const Network *network,
+			    PinSet *new_loads)
 {
   if (network->isHierarchical(pin))
-    makeHpinEdges(pin, network);
+    makeHpinEdges(pin, network, new_loads);
 }
 
 void
@@ -2439,6 +2463,7 @@ class InsertPinPairsThru : public HierPinThruVisitor
 {
 public:
   InsertPinPairsThru(PinPairSet *pairs,
+		     PinSet *new_loads,
 		     const Network *network);
 
 protected:
@@ -2446,6 +2471,8 @@ protected:
 		     Pin *load);
 
   PinPairSet *pairs_;
+  // Loads of the inserted pairs (optional).
+  PinSet *new_loads_;
   const Network *network_;
 
 private:
@@ -2453,9 +2480,11 @@ private:
 };
 
 InsertPinPairsThru::InsertPinPairsThru(PinPairSet *pairs,
+				       PinSet *new_loads,
 				       const Network *network) :
   HierPinThruVisitor(),
   pairs_(pairs),
+  new_loads_(new_loads),
   network_(network)
 {
 }
@@ -2468,24 +2497,28 @@ InsertPinPairsThru::visit(Pin *drvr,
   if (!pairs_->hasKey(&probe)) {
     PinPair *pair = new PinPair(drvr, load);
     pairs_->insert(pair);
+    if (new_loads_)
+      new_loads_->insert(load);
   }
 }
 
 static void
 insertPinPairsThruHierPin(const Pin *hpin,
 			  const Network *network,
-			  PinPairSet *pairs)
+			  PinPairSet *pairs,
+			  PinSet *new_loads)
 {
-  InsertPinPairsThru visitor(pairs, network);
+  InsertPinPairsThru visitor(pairs, new_loads, network);
   visitDrvrLoadsThruHierPin(hpin, network, &visitor);
 }
 
 static void
 insertPinPairsThruNet(Net *net,
 		      const Network *network,
-		      PinPairSet *pairs)
+		      PinPairSet *pairs,
+		      PinSet *new_loads)
 {
-  InsertPinPairsThru visitor(pairs, network);
+  InsertPinPairsThru visitor(pairs, new_loads, network);
   visitDrvrLoadsThruNet(net, network, &visitor);
 }
 
@@ -20,6 +20,7 @@
 #include "DisallowCopyAssign.hh"
 #include "Error.hh"
 #include "Set.hh"
+#include "Vector.hh"
 #include "Hash.hh"
 #include "SdcCmdComment.hh"
 #include "SdcClass.hh"
@@ -39,7 +40,7 @@ class ExceptionThru;
 class ExceptionTo;
 class ExceptionState;
 
-typedef Vector<ExceptionPath*> ExceptionPathSeq;
+typedef Vector<Hash> HashSeq;
 
 class ExceptionPath : public SdcCmdComment
 {
@@ -97,6 +98,9 @@ public:
 				ExceptionTo *to);
   Hash hash() const;
   Hash hash(ExceptionPt *missing_pt) const;
+  // hash(missing_pt) for each exception point in ExceptionPtIterator
+  // order, found with one pass over the points.
+  void mergeHashes(HashSeq &hashes) const;
   // Mergeable properties (independent of exception points).
   virtual bool mergeable(ExceptionPath *exception) const = 0;
   bool mergeablePts(ExceptionPath *exception) const;
@@ -350,8 +354,11 @@ public:
   virtual void addInstance(Instance *inst) = 0;
   virtual void addNet(Net *net) = 0;
   virtual void addEdge(EdgePins *edge) = 0;
-  virtual void connectPinAfter(PinSet *,
-			       Network *network) = 0;
+  // Make the edges thru the pins connected to drvrs.
+  // The loads of new edges are added to new_loads if it is not null.
+  virtual void connectPinAfter(PinSet *drvrs,
+			       Network *network,
+			       PinSet *new_loads) = 0;
   virtual void disconnectPinBefore(Pin *pin,
 				   Network *network) = 0;
 
@@ -407,7 +414,8 @@ public:
   virtual void addNet(Net *) {}
   virtual void addEdge(EdgePins *) {}
   virtual void connectPinAfter(PinSet *,
-			       Network *) {}
+			       Network *,
+			       PinSet *) {}
   virtual void disconnectPinBefore(Pin *,
 				   Network *) {}
 
@@ -526,7 +534,8 @@ public:
   virtual int typePriority() const { return 2; }
   virtual size_t objectCount() const;
   virtual void connectPinAfter(PinSet *drvrs,
-			       Network *network);
+			       Network *network,
+			       PinSet *new_loads);
   virtual void disconnectPinBefore(Pin *pin,
 				   Network *network);
 
@@ -546,11 +555,14 @@ protected:
   void makeNetEdges(const Network *network);
   void makeInstEdges(const Network *network);
   void makeHpinEdges(const Pin *pin,
-		     const Network *network);
+		     const Network *network,
+		     PinSet *new_loads);
   void makePinEdges(Pin *pin,
-		    const Network *network);
+		    const Network *network,
+		    PinSet *new_loads);
   void makeNetEdges(Net *net,
-		    const Network *network);
+		    const Network *network,
+		    PinSet *new_loads);
   void makeInstEdges(Instance *inst,
 		     Network *network);
   void deletePinEdges(Pin *pin,
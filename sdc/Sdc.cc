@@ -20,6 +20,7 @@
 #include "Stats.hh"
 #include "Debug.hh"
 #include "Mutex.hh"
+#include "ThreadForEach.hh"
 #include "Report.hh"
 #include "PatternMatch.hh"
 #include "MinMax.hh"
@@ -100,6 +101,7 @@ Sdc::Sdc(StaState *sta) :
   port_cap_map_(nullptr),
   net_wire_cap_map_(nullptr),
   drvr_pin_wire_cap_map_(nullptr),
+  exceptions_serial_(0),
   first_from_pin_exceptions_(nullptr),
   first_from_clk_exceptions_(nullptr),
   first_from_inst_exceptions_(nullptr),
@@ -110,6 +112,7 @@ Sdc::Sdc(StaState *sta) :
   first_to_clk_exceptions_(nullptr),
   first_to_inst_exceptions_(nullptr),
   first_thru_edge_exceptions_(nullptr),
+  exceptions_bulk_(false),
   path_delay_internal_startpoints_(nullptr),
   path_delay_internal_endpoints_(nullptr)
 {
@@ -138,6 +141,91 @@ Sdc::~Sdc()
   deleteConstraints();
 }
 
+void
+Sdc::copyState(const StaState *sta)
+{
+  StaState::copyState(sta);
+  sdc_ = this;
+}
+
+static bool
+instancePvtMapsEqual(const InstancePvtMap *map1,
+		     const InstancePvtMap *map2)
+{
+  size_t size1 = map1 ? map1->size() : 0;
+  size_t size2 = map2 ? map2->size() : 0;
+  if (size1 != size2)
+    return false;
+  if (size1 == 0)
+    return true;
+  InstancePvtMap::ConstIterator pvt_iter(map1);
+  while (pvt_iter.hasNext()) {
+    Instance *inst;
+    Pvt *pvt1;
+    pvt_iter.next(inst, pvt1);
+    Pvt *pvt2 = map2->findKey(inst);
+    if (pvt2 == nullptr
+	|| pvt1->process() != pvt2->process()
+	|| pvt1->voltage() != pvt2->voltage()
+	|| pvt1->temperature() != pvt2->temperature())
+      return false;
+  }
+  return true;
+}
+
+static bool
+netWireCapMapEqual(const NetWireCapMap &map1,
+		   const NetWireCapMap &map2)
+{
+  if (map1.size() != map2.size())
+    return false;
+  for (auto &net_caps1 : map1) {
+    auto net_caps2 = map2.find(net_caps1.first);
+    if (net_caps2 == map2.end()
+	|| !MinMaxFloatValues::equal(const_cast<MinMaxFloatValues*>
+				     (&net_caps1.second),
+				     const_cast<MinMaxFloatValues*>
+				     (&net_caps2->second)))
+      return false;
+  }
+  return true;
+}
+
+// set_load on nets is not written by write_sdc, so it is compared here.
+bool
+Sdc::delayCalcVarsEqual(const Sdc *sdc) const
+{
+  if (net_wire_cap_map_ || sdc->net_wire_cap_map_) {
+    NetWireCapMap empty;
+    for (int i = 0; i < corners_->count(); i++) {
+      if (!netWireCapMapEqual(net_wire_cap_map_
+			      ? net_wire_cap_map_[i] : empty,
+			      sdc->net_wire_cap_map_
+			      ? sdc->net_wire_cap_map_[i] : empty))
+	return false;
+    }
+  }
+  for (auto mm_index : MinMax::rangeIndex()) {
+    if (operating_conditions_[mm_index] != sdc->operating_conditions_[mm_index]
+	|| wireload_[mm_index] != sdc->wireload_[mm_index]
+	|| wireload_selection_[mm_index] != sdc->wireload_selection_[mm_index]
+	|| !instancePvtMapsEqual(instance_pvt_maps_[mm_index],
+				 sdc->instance_pvt_maps_[mm_index]))
+      return false;
+  }
+  return analysis_type_ == sdc->analysis_type_
+    && wireload_mode_ == sdc->wireload_mode_
+    && preset_clr_arcs_enabled_ == sdc->preset_clr_arcs_enabled_
+    && cond_default_arcs_enabled_ == sdc->cond_default_arcs_enabled_
+    && bidirect_net_paths_enabled_ == sdc->bidirect_net_paths_enabled_
+    && bidirect_inst_paths_enabled_ == sdc->bidirect_inst_paths_enabled_
+    && recovery_removal_checks_enabled_==sdc->recovery_removal_checks_enabled_
+    && gated_clk_checks_enabled_ == sdc->gated_clk_checks_enabled_
+    && clk_thru_tristate_enabled_ == sdc->clk_thru_tristate_enabled_
+    && dynamic_loop_breaking_ == sdc->dynamic_loop_breaking_
+    && propagate_all_clks_ == sdc->propagate_all_clks_;
+}
+
 // This does NOT call initVariables() because those variable values
 // survive linking a new design.
 void
@@ -4571,7 +4659,8 @@ Sdc::addException2(ExceptionPath *exception)
   if (exception->isMultiCycle() || exception->isPathDelay())
     deleteMatchingExceptions(exception);
   recordException(exception);
-  mergeException(exception);
+  if (!exceptions_bulk_)
+    mergeException(exception);
 }
 
 // If a path delay/multicycle exception is redefined with a different
@@ -4887,25 +4976,39 @@ void
 Sdc::recordException(ExceptionPath *exception)
 {
   exceptions_.insert(exception);
-  recordMergeHashes(exception);
+  exceptions_serial_++;
+  if (exceptions_bulk_) {
+    // Merge hashes are recorded by exceptionsBulkEnd.
+    if (!bulk_live_.hasKey(exception)) {
+      bulk_exceptions_.push_back(exception);
+      bulk_live_.insert(exception);
+    }
+  }
+  else
+    recordMergeHashes(exception);
+  // First points are needed to find overridden exceptions.
   recordExceptionFirstPts(exception);
 }
 
 void
-Sdc::recordMergeHashes(ExceptionPath *exception)
+Sdc::recordMergeHashes(ExceptionPath *exception,
+		       ExceptionPt *skip_pt)
 {
+  HashSeq hashes;
+  exception->mergeHashes(hashes);
   ExceptionPtIterator missing_pt_iter(exception);
-  while (missing_pt_iter.hasNext()) {
+  for (size_t i = 0; missing_pt_iter.hasNext(); i++) {
     ExceptionPt *missing_pt = missing_pt_iter.next();
-    recordMergeHash(exception, missing_pt);
+    if (missing_pt != skip_pt)
+      recordMergeHash(exception, missing_pt, hashes[i]);
   }
 }
 
 void
 Sdc::recordMergeHash(ExceptionPath *exception,
-		     ExceptionPt *missing_pt)
+		     ExceptionPt *missing_pt,
+		     Hash hash)
 {
-  Hash hash = exception->hash(missing_pt);
   debugPrint3(debug_, "exception_merge", 3,
 	      "record merge hash %u %s missing %s\n",
 	      hash,
@@ -5116,11 +5219,13 @@ Sdc::mergeException(ExceptionPath *exception)
 ExceptionPath *
 Sdc::findMergeMatch(ExceptionPath *exception)
 {
+  HashSeq hashes;
+  exception->mergeHashes(hashes);
   bool first_pt = true;
   ExceptionPtIterator missing_pt_iter(exception);
-  while (missing_pt_iter.hasNext()) {
+  for (size_t i = 0; missing_pt_iter.hasNext(); i++) {
     ExceptionPt *missing_pt = missing_pt_iter.next();
-    Hash hash = exception->hash(missing_pt);
+    Hash hash = hashes[i];
     ExceptionPathSet *matches = exception_merge_hash_.findKey(hash);
     if (matches) {
       ExceptionPathSet::Iterator match_iter(matches);
@@ -5139,13 +5244,20 @@ Sdc::findMergeMatch(ExceptionPath *exception)
 		      match->asString(network_));
 	  // Unrecord the exception that is being merged away.
 	  unrecordException(exception);
-	  unrecordMergeHashes(match);
+	  // The match hash missing the point that is merged into
+	  // does not change.
+	  unrecordMergeHashes(match, match_missing_pt);
 	  missing_pt->mergeInto(match_missing_pt);
-	  recordMergeHashes(match);
+	  recordMergeHashes(match, match_missing_pt);
 	  // First point maps only change if the exception point that
 	  // is being merged is the first exception point.
-	  if (first_pt)
-	    recordExceptionFirstPts(match);
+	  if (first_pt) {
+	    if (exceptions_bulk_)
+	      // Record once after all merges.
+	      bulk_first_pts_.insert(match);
+	    else
+	      recordExceptionFirstPts(match);
+	  }
           // Have to wait until after exception point merge to delete
           // the exception.
 	  delete exception;
@@ -5160,6 +5272,96 @@ Sdc::findMergeMatch(ExceptionPath *exception)
 
 ////////////////////////////////////////////////////////////////
 
+void
+Sdc::exceptionsBulkBegin()
+{
+  exceptions_bulk_ = true;
+}
+
+// Merging exceptions one at a time as they are defined re-records
+// the first points of the merged exception for every merge.
+// Merging them all at once records the first points of each merged
+// exception once.
+void
+Sdc::exceptionsBulkEnd()
+{
+  if (exceptions_bulk_) {
+    Stats stats(debug_);
+    size_t bulk_count = bulk_live_.size();
+    for (ExceptionPath *exception : bulk_exceptions_) {
+      if (bulk_live_.hasKey(exception))
+	recordMergeHashes(exception);
+    }
+    for (ExceptionPath *exception : bulk_exceptions_) {
+      // Exceptions merged into another exception are deleted.
+      if (bulk_live_.hasKey(exception))
+	mergeException(exception);
+    }
+    recordBulkFirstPts();
+    debugPrint2(debug_, "exception_merge", 1,
+		"bulk merged %lu exceptions into %lu\n",
+		bulk_count,
+		bulk_live_.size());
+    exceptions_bulk_ = false;
+    bulk_exceptions_.clear();
+    bulk_live_.clear();
+    bulk_first_pts_.clear();
+    stats.report("Merge bulk exceptions");
+  }
+}
+
+// The from, thru and to first point maps are disjoint, so they are
+// recorded by separate threads.
+void
+Sdc::recordBulkFirstPts()
+{
+  ExceptionPathSeq from_exceptions;
+  ExceptionPathSeq thru_exceptions;
+  ExceptionPathSeq to_exceptions;
+  for (ExceptionPath *exception : bulk_first_pts_) {
+    if (exception->from())
+      from_exceptions.push_back(exception);
+    else if (exception->thrus())
+      thru_exceptions.push_back(exception);
+    else if (exception->to())
+      to_exceptions.push_back(exception);
+  }
+  auto record_from = [&] () {
+    for (ExceptionPath *exception : from_exceptions)
+      recordExceptionFirstFrom(exception);
+  };
+  auto record_thru = [&] () {
+    for (ExceptionPath *exception : thru_exceptions)
+      recordExceptionFirstThru(exception);
+  };
+  auto record_to = [&] () {
+    for (ExceptionPath *exception : to_exceptions)
+      recordExceptionFirstTo(exception);
+  };
+  if (thread_count_ > 1) {
+    forEachThread(3, [&] (size_t i) {
+      switch (i) {
+      case 0:
+	record_from();
+	break;
+      case 1:
+	record_thru();
+	break;
+      default:
+	record_to();
+	break;
+      }
+    });
+  }
+  else {
+    record_from();
+    record_thru();
+    record_to();
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
 void
 Sdc::deleteExceptions()
 {
@@ -5168,6 +5370,7 @@ Sdc::deleteExceptions()
     delete except_iter.next();
   }
   exceptions_.clear();
+  exceptions_serial_++;
 
   deleteExceptionMap(first_from_pin_exceptions_);
   deleteExceptionMap(first_from_clk_exceptions_);
@@ -5188,6 +5391,10 @@ Sdc::deleteExceptions()
 
   deleteExceptionPtHashMapSets(exception_merge_hash_);
   exception_merge_hash_.clear();
+
+  bulk_exceptions_.clear();
+  bulk_live_.clear();
+  bulk_first_pts_.clear();
 }
 
 void
@@ -5325,23 +5532,32 @@ Sdc::unrecordException(ExceptionPath *exception)
   unrecordMergeHashes(exception);
   unrecordExceptionFirstPts(exception);
   exceptions_.erase(exception);
+  exceptions_serial_++;
+  if (exceptions_bulk_) {
+    bulk_live_.erase(exception);
+    bulk_first_pts_.erase(exception);
+  }
 }
 
 void
-Sdc::unrecordMergeHashes(ExceptionPath *exception)
+Sdc::unrecordMergeHashes(ExceptionPath *exception,
+			 ExceptionPt *skip_pt)
 {
+  HashSeq hashes;
+  exception->mergeHashes(hashes);
   ExceptionPtIterator missing_pt_iter(exception);
-  while (missing_pt_iter.hasNext()) {
+  for (size_t i = 0; missing_pt_iter.hasNext(); i++) {
     ExceptionPt *missing_pt = missing_pt_iter.next();
-    unrecordMergeHash(exception, missing_pt);
+    if (missing_pt != skip_pt)
+      unrecordMergeHash(exception, missing_pt, hashes[i]);
   }
 }
 
 void
 Sdc::unrecordMergeHash(ExceptionPath *exception,
-		       ExceptionPt *missing_pt)
+		       ExceptionPt *missing_pt,
+		       Hash hash)
 {
-  Hash hash = exception->hash(missing_pt);
   debugPrint3(debug_, "exception_merge", 3,
 	      "unrecord merge hash %u %s missing %s\n",
 	      hash,
@@ -6124,7 +6340,8 @@ Sdc::setUseDefaultArrivalClock(bool enable)
 ////////////////////////////////////////////////////////////////
 
 void
-Sdc::connectPinAfter(Pin *pin)
+Sdc::connectPinAfter(Pin *pin,
+		     PinSet *thru_edge_loads)
 {
   PinSet *drvrs = network_->drivers(pin);
   ExceptionPathSet::Iterator except_iter(exceptions_);
@@ -6135,7 +6352,7 @@ Sdc::connectPinAfter(Pin *pin)
     while (thru_iter.hasNext()) {
       ExceptionThru *thru = thru_iter.next();
       if (thru->edges()) {
-	thru->connectPinAfter(drvrs, network_);
+	thru->connectPinAfter(drvrs, network_, thru_edge_loads);
 	if (first_pt == thru)
 	  recordExceptionEdges(exception, thru->edges(),
 			       first_thru_edge_exceptions_);
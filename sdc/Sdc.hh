@@ -181,6 +181,8 @@ class Sdc : public StaState
 public:
   explicit Sdc(StaState *sta);
   ~Sdc();
+  // Keeps sdc_ pointing at this sdc for the modes that are not current.
+  virtual void copyState(const StaState *sta);
   // Note that Search may reference a Filter exception removed by clear().
   void clear();
   // Return true if pin is referenced by any constraint.
@@ -193,6 +195,10 @@ public:
   bool isConstrained(const Net *net) const;
   // Build data structures for search.
   void searchPreamble();
+  // Return true if the analysis type, operating conditions, pvts,
+  // wireloads, net wire caps and variables used by delay calculation
+  // and levelization are the same in sdc. See also delayCalcSdcEqual.
+  bool delayCalcVarsEqual(const Sdc *sdc) const;
 
   // SWIG sdc interface.
   AnalysisType analysisType() { return analysis_type_; }
@@ -1012,8 +1018,16 @@ public:
   PinSet *pathDelayInternalStartpoints() const;
   bool isPathDelayInternalEndpoint(const Pin *pin) const;
   ExceptionPathSet *exceptions() { return &exceptions_; }
+  // Incremented when exceptions change.
+  unsigned exceptionsSerial() const { return exceptions_serial_; }
   void deleteExceptions();
   void deleteException(ExceptionPath *exception);
+  // Exceptions defined between exceptionsBulkBegin and exceptionsBulkEnd
+  // are not merged until exceptionsBulkEnd, which merges them in one pass.
+  // Use for reading sdc files with large numbers of exceptions.
+  void exceptionsBulkBegin();
+  void exceptionsBulkEnd();
+  bool exceptionsBulk() const { return exceptions_bulk_; }
   void recordException(ExceptionPath *exception);
   void unrecordException(ExceptionPath *exception);
   // Annotate graph from constraints.  If the graph exists when the
@@ -1024,7 +1038,10 @@ public:
 
   // Network edit before/after methods.
   void disconnectPinBefore(Pin *pin);
-  void connectPinAfter(Pin *pin);
+  // The loads of exception -thru edges made by the connection are
+  // added to thru_edge_loads if it is not null.
+  void connectPinAfter(Pin *pin,
+		       PinSet *thru_edge_loads = nullptr);
   void clkHpinDisablesChanged(Pin *pin);
   void makeClkHpinDisable(Clock *clk,
 			  Pin *drvr,
@@ -1110,8 +1127,12 @@ protected:
   void recordExceptionEdges(ExceptionPath *exception,
 			    EdgePinsSet *edges,
 			    EdgeExceptionsMap *&exception_map);
-  void recordMergeHash(ExceptionPath *exception, ExceptionPt *missing_pt);
-  void recordMergeHashes(ExceptionPath *exception);
+  void recordMergeHash(ExceptionPath *exception,
+		       ExceptionPt *missing_pt,
+		       Hash hash);
+  // Record the merge hashes for the exception points other than skip_pt.
+  void recordMergeHashes(ExceptionPath *exception,
+			 ExceptionPt *skip_pt = nullptr);
   void unrecordExceptionFirstPts(ExceptionPath *exception);
   void unrecordExceptionClks(ExceptionPath *exception,
 			     ClockSet *clks,
@@ -1131,10 +1152,13 @@ protected:
   void unrecordExceptionHpin(ExceptionPath *exception,
 			     Pin *pin,
 			     PinExceptionsMap *&exception_map);
-  void unrecordMergeHashes(ExceptionPath *exception);
+  void unrecordMergeHashes(ExceptionPath *exception,
+			   ExceptionPt *skip_pt = nullptr);
   void unrecordMergeHash(ExceptionPath *exception,
-			 ExceptionPt *missing_pt);
+			 ExceptionPt *missing_pt,
+			 Hash hash);
   void mergeException(ExceptionPath *exception);
+  void recordBulkFirstPts();
   void expandException(ExceptionPath *exception,
 		       ExceptionPathSet &expansions);
   bool exceptionFromStates(const ExceptionPathSet *exceptions,
@@ -1363,6 +1387,7 @@ protected:
   InstanceSet disabled_clk_gating_checks_inst_;
   PinSet disabled_clk_gating_checks_pin_;
   ExceptionPathSet exceptions_;
+  unsigned exceptions_serial_;
 
   // First pin/clock/instance/net/edge exception point to exception set map.
   PinExceptionsMap *first_from_pin_exceptions_;
@@ -1380,6 +1405,13 @@ protected:
 
   // Exception hash with one missing from/thru/to point, used for merging.
   ExceptionPathPtHash exception_merge_hash_;
+  bool exceptions_bulk_;
+  // Exceptions recorded since exceptionsBulkBegin in the order they
+  // were defined. Deleted exceptions are removed from bulk_live_.
+  ExceptionPathSeq bulk_exceptions_;
+  ExceptionPathSet bulk_live_;
+  // Merged exceptions with first points that have not been recorded.
+  ExceptionPathSet bulk_first_pts_;
   // Path delay -from pin internal startpoints.
   PinSet *path_delay_internal_startpoints_;
   // Path delay -to pin internal endpoints.
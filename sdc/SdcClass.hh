@@ -80,6 +80,7 @@ typedef Map<Instance*, DisabledInstancePorts*> DisabledInstancePortsMap;
 typedef Map<LibertyCell*, DisabledCellPorts*> DisabledCellPortsMap;
 typedef MinMaxValues<float> ClockUncertainties;
 typedef Set<ExceptionPath*> ExceptionPathSet;
+typedef Vector<ExceptionPath*> ExceptionPathSeq;
 typedef PinPair EdgePins;
 typedef PinPairSet EdgePinsSet;
 typedef Map<const Pin*, LogicValue> LogicValueMap;
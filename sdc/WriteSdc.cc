@@ -326,6 +326,60 @@ WriteSdc::write()
   closeFile();
 }
 
+void
+WriteSdc::writeDelayCalcInputs(FILE *stream)
+{
+  stream_ = stream;
+  writeClocks();
+  writePropagatedClkPins();
+  writeDisables();
+  writeOperatingConditions();
+  writeWireload();
+  writePinLoads();
+  writeDriveResistances();
+  writeDrivingCells();
+  writeInputTransitions();
+  writeNetResistances();
+  // Constants and case analysis are not included because simulation
+  // invalidates the delays of the pins with values that change.
+  writeVariables();
+}
+
+static bool
+writeDelayCalcInputs(Instance *instance,
+		     Sdc *sdc,
+		     // Return value.
+		     string &text)
+{
+  FILE *stream = tmpfile();
+  if (stream == nullptr)
+    return false;
+  // Enough digits that values that differ are written differently.
+  WriteSdc writer(instance, nullptr, "", false, 12, true, sdc);
+  writer.writeDelayCalcInputs(stream);
+  long size = ftell(stream);
+  bool written = false;
+  if (size >= 0) {
+    text.resize(size);
+    rewind(stream);
+    written = fread(&text[0], 1, size, stream) == static_cast<size_t>(size);
+  }
+  fclose(stream);
+  return written;
+}
+
+bool
+delayCalcSdcEqual(Instance *instance,
+		  Sdc *sdc1,
+		  Sdc *sdc2)
+{
+  string text1, text2;
+  return sdc1->delayCalcVarsEqual(sdc2)
+    && writeDelayCalcInputs(instance, sdc1, text1)
+    && writeDelayCalcInputs(instance, sdc2, text2)
+    && text1 == text2;
+}
+
 void
 WriteSdc::openFile(const char *filename)
 {
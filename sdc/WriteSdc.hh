@@ -33,5 +33,14 @@ writeSdc(Instance *instance,
 	 int digits,
 	 Sdc *sdc);
 
+// Return true if sdc1 and sdc2 have the same constraints used by
+// delay calculation (clocks, disables, loads, drives and slews) so
+// delays found with one are valid for the other once the constants
+// and case analysis of the other are propagated.
+bool
+delayCalcSdcEqual(Instance *instance,
+		  Sdc *sdc1,
+		  Sdc *sdc2);
+
 } // namespace
 #endif
@@ -35,6 +35,8 @@ public:
 	   Sdc *sdc);
   virtual ~WriteSdc();
   void write();
+  // Write the constraints used by delay calculation to stream.
+  void writeDelayCalcInputs(FILE *stream);
 
   void openFile(const char *filename);
   void closeFile();
@@ -20,6 +20,7 @@
 #include "DisallowCopyAssign.hh"
 #include "Error.hh"
 #include "Report.hh"
+#include "Profiler.hh"
 #include "MinMax.hh"
 #include "TimingArc.hh"
 #include "Network.hh"
@@ -166,6 +167,7 @@ SdfReader::read()
   // Use zlib to uncompress gzip'd files automagically.
   stream_ = gzopen(filename_, "rb");
   if (stream_) {
+    ProfilePhase phase(debug_, "read_sdf");
     // yyparse returns 0 on success.
     bool success = (::SdfParse_parse() == 0);
     gzclose(stream_);
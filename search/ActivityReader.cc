@@ -0,0 +1,300 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <ctype.h>
+#include <stdlib.h>
+#include "Machine.hh"
+#include "Error.hh"
+#include "Report.hh"
+#include "Debug.hh"
+#include "Network.hh"
+#include "Clock.hh"
+#include "Sdc.hh"
+#include "Power.hh"
+#include "ActivityReader.hh"
+
+namespace sta {
+
+using std::string;
+
+static string
+unescapeName(const string &name);
+
+ActivityReader::ActivityReader(const char *filename,
+			       const char *scope,
+			       Power *power) :
+  StaState(power),
+  filename_(filename),
+  power_(power),
+  stream_(nullptr),
+  line_(1),
+  paren_tokens_(false),
+  annotates_activities_(true),
+  time_scale_(1.0),
+  annotated_count_(0),
+  next_(buffer_),
+  unget_char_(EOF),
+  scope_match_(0),
+  clk_period_(0.0)
+{
+  buffer_[0] = '\0';
+  if (scope) {
+    const char *s = scope;
+    while (*s) {
+      const char *divider = strchr(s, '/');
+      size_t length = divider ? divider - s : strlen(s);
+      if (length > 0)
+	scope_names_.push_back(string(s, length));
+      s += length;
+      if (*s == '/')
+	s++;
+    }
+  }
+}
+
+ActivityReader::~ActivityReader()
+{
+  if (stream_)
+    gzclose(stream_);
+}
+
+bool
+ActivityReader::read()
+{
+  if (annotates_activities_ && !findClkPeriod())
+    return false;
+  // Use zlib to uncompress gzip'd files automagically.
+  stream_ = gzopen(filename_, "rb");
+  if (stream_ == nullptr)
+    throw FileNotReadable(filename_);
+  readFile();
+  debugPrint1(debug_, "read_activities", 1, "annotated %lu pins\n",
+	      annotated_count_);
+  return true;
+}
+
+// Pins without a clock use the clock with the smallest period.
+bool
+ActivityReader::findClkPeriod()
+{
+  clk_period_ = 0.0;
+  for (Clock *clk : sdc_->clks()) {
+    float period = clk->period();
+    if (period > 0.0
+	&& (clk_period_ == 0.0 || period < clk_period_))
+      clk_period_ = period;
+  }
+  if (clk_period_ == 0.0) {
+    report_->error("%s: no clocks to find activities per cycle.\n",
+		   filename_);
+    return false;
+  }
+  else
+    return true;
+}
+
+int
+ActivityReader::getChar()
+{
+  if (unget_char_ != EOF) {
+    int ch = unget_char_;
+    unget_char_ = EOF;
+    return ch;
+  }
+  if (*next_ == '\0') {
+    if (gzgets(stream_, buffer_, buffer_size_) == Z_NULL)
+      return EOF;
+    next_ = buffer_;
+  }
+  char ch = *next_++;
+  if (ch == '\n')
+    line_++;
+  return ch;
+}
+
+void
+ActivityReader::ungetChar(int ch)
+{
+  unget_char_ = ch;
+}
+
+bool
+ActivityReader::readToken(string &token)
+{
+  token.clear();
+  int ch = getChar();
+  while (ch != EOF && isspace(ch))
+    ch = getChar();
+  if (ch == EOF)
+    return false;
+  if (paren_tokens_ && (ch == '(' || ch == ')')) {
+    token += ch;
+    return true;
+  }
+  while (ch != EOF
+	 && !isspace(ch)
+	 && !(paren_tokens_ && (ch == '(' || ch == ')'))) {
+    token += ch;
+    // Escaped characters do not end the token.
+    if (ch == '\\') {
+      ch = getChar();
+      if (ch == EOF)
+	break;
+      token += ch;
+    }
+    ch = getChar();
+  }
+  if (ch != EOF && !isspace(ch))
+    ungetChar(ch);
+  return true;
+}
+
+void
+ActivityReader::pushScope(const string &name)
+{
+  size_t depth = scope_insts_.size();
+  // An empty scope makes the outermost scope the top instance.
+  size_t scope_length = scope_names_.empty() ? 1 : scope_names_.size();
+  Instance *inst = nullptr;
+  if (depth < scope_length) {
+    if (depth == scope_match_
+	&& (scope_names_.empty() || name == scope_names_[depth])) {
+      scope_match_++;
+      if (scope_match_ == scope_length)
+	inst = network_->topInstance();
+    }
+  }
+  else {
+    Instance *parent = scope_insts_.back();
+    if (parent)
+      inst = network_->findChild(parent, unescapeName(name).c_str());
+  }
+  scope_insts_.push_back(inst);
+}
+
+void
+ActivityReader::popScope()
+{
+  if (!scope_insts_.empty()) {
+    if (scope_insts_.size() == scope_match_)
+      scope_match_--;
+    scope_insts_.pop_back();
+  }
+}
+
+Instance *
+ActivityReader::scopeInstance() const
+{
+  if (scope_insts_.empty())
+    return nullptr;
+  else
+    return scope_insts_.back();
+}
+
+void
+ActivityReader::findPins(Instance *inst,
+			 const string &name,
+			 // Return value.
+			 PinSeq &pins)
+{
+  string name1 = unescapeName(name);
+  Pin *pin = network_->findPin(inst, name1.c_str());
+  if (pin && !network_->isHierarchical(pin))
+    pins.push_back(pin);
+  else {
+    Net *net = pin
+      ? network_->net(pin)
+      : network_->findNet(inst, name1.c_str());
+    if (net) {
+      PinSet::Iterator drvr_iter(network_->drivers(net));
+      while (drvr_iter.hasNext())
+	pins.push_back(drvr_iter.next());
+    }
+  }
+}
+
+// Remove SAIF backslash escapes ("a\[3\]") and verilog escaped
+// identifier backslashes ("\a[3]").
+static string
+unescapeName(const string &name)
+{
+  string name1;
+  for (size_t i = 0; i < name.size(); i++) {
+    char ch = name[i];
+    if (ch == '\\' && i + 1 < name.size())
+      name1 += name[++i];
+    else if (ch != '\\')
+      name1 += ch;
+  }
+  return name1;
+}
+
+bool
+ActivityReader::parseTimescale(const string &timescale)
+{
+  const char *str = timescale.c_str();
+  char *unit;
+  double value = strtod(str, &unit);
+  if (unit == str)
+    value = 1.0;
+  while (isspace(*unit))
+    unit++;
+  double scale;
+  if (strcmp(unit, "s") == 0)
+    scale = 1.0;
+  else if (strcmp(unit, "ms") == 0)
+    scale = 1e-3;
+  else if (strcmp(unit, "us") == 0)
+    scale = 1e-6;
+  else if (strcmp(unit, "ns") == 0)
+    scale = 1e-9;
+  else if (strcmp(unit, "ps") == 0)
+    scale = 1e-12;
+  else if (strcmp(unit, "fs") == 0)
+    scale = 1e-15;
+  else {
+    report_->fileWarn(filename_, line_, "unknown timescale %s.\n", str);
+    return false;
+  }
+  time_scale_ = value * scale;
+  return true;
+}
+
+void
+ActivityReader::annotate(const Pin *pin,
+			 double toggles,
+			 double high_time,
+			 double duration)
+{
+  if (duration > 0.0) {
+    // Activities are per cycle of the clock that
+    // Power::findClkedActivity divides them by.
+    float clk_period = clk_period_;
+    const Clock *clk = power_->findActivityClk(pin);
+    if (clk && clk->period() > 0.0)
+      clk_period = clk->period();
+    float activity = toggles / (duration * time_scale_) * clk_period;
+    float duty = high_time / duration;
+    debugPrint3(debug_, "read_activities", 2, "%s %.2e %.2f\n",
+		network_->pathName(pin),
+		activity,
+		duty);
+    power_->setPinActivity(pin, activity, duty, PwrActivityOrigin::user);
+    annotated_count_++;
+  }
+}
+
+} // namespace
@@ -0,0 +1,119 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_ACTIVITY_READER_H
+#define STA_ACTIVITY_READER_H
+
+#include <string>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+#include "Zlib.hh"
+#include "NetworkClass.hh"
+#include "StaState.hh"
+
+namespace sta {
+
+class Power;
+
+// Annotate pin activities from simulation toggle counts.
+//
+// scope is the '/' separated path of the design top instance in the
+// file, for example "tb/dut". If scope is nullptr or empty the
+// outermost scope in the file is the top instance.
+//
+// Signals are annotated on the leaf pins with the same name in the
+// scope instance, or on the drivers of the net with the same name.
+// Toggle rates are converted to activities per cycle of the clock
+// of each pin, or of the clock with the smallest period for pins
+// without a clock. Clocks are found from arrivals, so they must be
+// searched before the file is read (Sta::readSaif, Sta::readVcd).
+//
+// Return true if the file was read.
+bool
+readSaif(const char *filename,
+	 const char *scope,
+	 Power *power);
+bool
+readVcd(const char *filename,
+	const char *scope,
+	Power *power);
+
+// Stream and scope handling shared by the SAIF and VCD readers.
+// The file is read through a fixed size buffer and activities are
+// annotated as they are found so memory use does not depend on the
+// length of the file.
+class ActivityReader : public StaState
+{
+public:
+  ActivityReader(const char *filename,
+		 const char *scope,
+		 Power *power);
+  virtual ~ActivityReader();
+  bool read();
+
+protected:
+  virtual void readFile() = 0;
+  int getChar();
+  void ungetChar(int ch);
+  // Read a whitespace delimited token.
+  // Parens are single character tokens if paren_tokens_ is true.
+  // Return false at the end of the file.
+  bool readToken(std::string &token);
+  void pushScope(const std::string &name);
+  void popScope();
+  // Design instance for the current scope, or nullptr if it is not
+  // inside the design.
+  Instance *scopeInstance() const;
+  void findPins(Instance *inst,
+		const std::string &name,
+		// Return value.
+		PinSeq &pins);
+  // Parse "1ns", "10 ps" and the like into seconds.
+  bool parseTimescale(const std::string &timescale);
+  // toggles, high_time and duration are in timescale units.
+  void annotate(const Pin *pin,
+		double toggles,
+		double high_time,
+		double duration);
+
+  const char *filename_;
+  Power *power_;
+  gzFile stream_;
+  int line_;
+  bool paren_tokens_;
+  // Activities per cycle need a clock period to annotate.
+  bool annotates_activities_;
+  double time_scale_;
+  size_t annotated_count_;
+
+private:
+  bool findClkPeriod();
+
+  static const int buffer_size_ = 4096;
+  char buffer_[buffer_size_];
+  char *next_;
+  int unget_char_;
+  std::vector<std::string> scope_names_;
+  // Number of leading scopes matching scope_names_.
+  size_t scope_match_;
+  std::vector<Instance*> scope_insts_;
+  float clk_period_;
+
+  DISALLOW_COPY_AND_ASSIGN(ActivityReader);
+};
+
+} // namespace
+#endif
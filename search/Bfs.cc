@@ -18,6 +18,7 @@
 #include "Machine.hh"
 #include "Report.hh"
 #include "Debug.hh"
+#include "Profiler.hh"
 #include "Mutex.hh"
 #include "ThreadForEach.hh"
 #include "Network.hh"
@@ -81,6 +82,24 @@ BfsIterator::clear()
   init();
 }
 
+void
+BfsIterator::clear(VertexSet &queued)
+{
+  Level level = first_level_;
+  while (levelLessOrEqual(level, last_level_)) {
+    VertexSeq &level_vertices = queue_[level];
+    for (auto vertex : level_vertices) {
+      if (vertex) {
+	vertex->setBfsInQueue(bfs_index_, false);
+	queued.insert(vertex);
+      }
+    }
+    level_vertices.clear();
+    incrLevel(level);
+  }
+  init();
+}
+
 void
 BfsIterator::reportEntries(const Network *network)
 {
@@ -142,7 +161,8 @@ BfsIterator::visit(Level to_level,
   int visit_count = 0;
   while (levelLessOrEqual(first_level_, last_level_)
 	 && levelLessOrEqual(first_level_, to_level)) {
-    VertexSeq &level_vertices = queue_[first_level_];
+    Level level = first_level_;
+    VertexSeq &level_vertices = queue_[level];
     incrLevel(first_level_);
     if (!level_vertices.empty()) {
       for (auto vertex : level_vertices) {
@@ -153,6 +173,7 @@ BfsIterator::visit(Level to_level,
 	}
       }
       level_vertices.clear();
+      visitor->levelFinished(level);
     }
   }
   return visit_count;
@@ -203,16 +224,29 @@ QueueIterator::next()
   return next;
 }
 
+// Visit the vertices of a level and note when the thread runs out of
+// vertices so the profiler can find how long it waits for the others.
+static void
+visitLevelTimed(ForEachArg<QueueIterator, VertexVisitor> arg,
+		double *end_time)
+{
+  forEachBegin<QueueIterator, VertexVisitor, Vertex*>(std::move(arg));
+  *end_time = elapsedRunTime();
+}
+
 int
 BfsIterator::visitParallel(Level to_level,
 			   VertexVisitor *visitor)
 {
   int visit_count = 0;
+  Profiler *profiler = debug_->profiler();
+  bool profile = profiler->enabled();
   if (!empty()) {
     if (thread_count_ <= 1)
       visit_count = visit(to_level, visitor);
     else {
       std::mutex lock;
+      std::vector<double> thread_ends(thread_count_);
       Level level = first_level_;
       while (levelLessOrEqual(level, last_level_)
 	     && levelLessOrEqual(level, to_level)) {
@@ -221,18 +255,31 @@ BfsIterator::visitParallel(Level to_level,
 	  incrLevel(first_level_);
 	  QueueIterator iter(level_vertices, bfs_index_);
 	  std::vector<std::thread> threads;
+	  double level_begin = profile ? elapsedRunTime() : 0.0;
 
 	  for (int i = 0; i < thread_count_; i++) {
 	    ForEachArg<QueueIterator, VertexVisitor> arg(&iter, lock,
 							 visitor->copy());
 	    // Missing check for null vertex.
-	    threads.push_back(std::thread(forEachBegin<QueueIterator,
-					  VertexVisitor, Vertex*>, arg));
+	    if (profile)
+	      threads.push_back(std::thread(visitLevelTimed, arg,
+					    &thread_ends[i]));
+	    else
+	      threads.push_back(std::thread(forEachBegin<QueueIterator,
+					    VertexVisitor, Vertex*>, arg));
 	  }
 
 	  // Wait for all threads working on this level before moving on.
 	  for (auto &thread : threads)
 	    thread.join();
+	  visitor->levelFinished(level);
+
+	  if (profile) {
+	    double level_end = elapsedRunTime();
+	    for (int i = 0; i < thread_count_; i++)
+	      profiler->threadTime(i, thread_ends[i] - level_begin,
+				   level_end - thread_ends[i]);
+	  }
 
 	  visit_count += iter.count();
 	  level = first_level_;
@@ -244,6 +291,8 @@ BfsIterator::visitParallel(Level to_level,
       }
     }
   }
+  if (profile)
+    profiler->count("vertices", visit_count);
   return visit_count;
 }
 
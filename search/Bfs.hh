@@ -51,6 +51,8 @@ public:
   void ensureSize();
   // Reset to virgin state.
   void clear();
+  // Reset to virgin state, adding the queued vertices to queued.
+  void clear(VertexSet &queued);
   bool empty() const;
   // Enqueue a vertex to search from.
   void enqueue(Vertex *vertex);
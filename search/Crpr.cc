@@ -18,6 +18,8 @@
 #include <stdio.h>
 #include "Machine.hh"
 #include "Debug.hh"
+#include "Hash.hh"
+#include "Mutex.hh"
 #include "Vector.hh"
 #include "Network.hh"
 #include "Graph.hh"
@@ -45,6 +47,23 @@ CheckCrpr::CheckCrpr(StaState *sta) :
 {
 }
 
+void
+CheckCrpr::clear()
+{
+  for (int i = 0; i < common_path_shard_count_; i++) {
+    CrprCommonPathShard &shard = common_path_shards_[i];
+    UniqueLock lock(shard.lock);
+    shard.common_paths.clear();
+  }
+}
+
+CrprCommonPathShard &
+CheckCrpr::commonPathShard(const CrprPathPair &pair)
+{
+  CrprPathPairHash hash;
+  return common_path_shards_[hash(pair) % common_path_shard_count_];
+}
+
 PathVertex *
 CheckCrpr::clkPathPrev(const PathVertex *path,
 		       PathVertex &tmp)
@@ -239,31 +258,67 @@ CheckCrpr::findCrpr(const PathVertex *src_clk_path,
 	break;
     }
   }
-  const PathVertex *src_clk_path2 = src_clk_path1;
-  const PathVertex *tgt_clk_path2 = tgt_clk_path1;
-  PathVertex tmp1, tmp2;
   // src_clk_path and tgt_clk_path are now in the same (gen)clk src path.
-  // Use the vertex levels to back up the deeper path to see if they
-  // overlap.
-  while (src_clk_path2 && tgt_clk_path2
-	 && src_clk_path2->pin(this) != tgt_clk_path2->pin(this)) {
-    Level src_level = src_clk_path2->vertex(this)->level();
-    Level tgt_level = tgt_clk_path2->vertex(this)->level();
-    if (src_level >= tgt_level)
-      src_clk_path2 = clkPathPrev(src_clk_path2, tmp1);
-    if (tgt_level >= src_level)
-      tgt_clk_path2 = clkPathPrev(tgt_clk_path2, tmp2);
-  }
-  if (src_clk_path2 && tgt_clk_path2
-      && (src_clk_path2->transition(this) == tgt_clk_path2->transition(this)
+  PathVertex src_common_path, tgt_common_path;
+  findCommonPaths(src_clk_path1, tgt_clk_path1,
+		  src_common_path, tgt_common_path);
+  if (!src_common_path.isNull() && !tgt_common_path.isNull()
+      && (src_common_path.transition(this)
+	  == tgt_common_path.transition(this)
 	  || same_pin)) {
     debugPrint1(debug_, "crpr", 2, "crpr pin %s\n",
-		network_->pathName(src_clk_path2->pin(this)));
-    crpr = findCrpr1(src_clk_path2, tgt_clk_path2);
-    crpr_pin = src_clk_path2->pin(this);
+		network_->pathName(src_common_path.pin(this)));
+    crpr = findCrpr1(&src_common_path, &tgt_common_path);
+    crpr_pin = src_common_path.pin(this);
   }
 }
 
+// Use the vertex levels to back up the deeper path to see if they
+// overlap. The common paths only depend on the src/tgt paths so the
+// answer is remembered for the pair. The memo is consulted once per
+// query; the walk itself only compares levels and pins.
+void
+CheckCrpr::findCommonPaths(const PathVertex *src_clk_path,
+			   const PathVertex *tgt_clk_path,
+			   // Return values.
+			   PathVertex &src_common_path,
+			   PathVertex &tgt_common_path)
+{
+  CrprPathPair query(PathVertexRep(src_clk_path, this),
+		     PathVertexRep(tgt_clk_path, this));
+  CrprCommonPathShard &shard = commonPathShard(query);
+  CrprPathPair common;
+  bool exists;
+  {
+    UniqueLock lock(shard.lock);
+    shard.common_paths.findKey(query, common, exists);
+  }
+  if (!exists) {
+    const PathVertex *src_path = src_clk_path;
+    const PathVertex *tgt_path = tgt_clk_path;
+    PathVertex tmp1, tmp2;
+    while (src_path && tgt_path) {
+      if (src_path->pin(this) == tgt_path->pin(this)) {
+	common = CrprPathPair(PathVertexRep(src_path, this),
+			      PathVertexRep(tgt_path, this));
+	break;
+      }
+      Level src_level = src_path->vertex(this)->level();
+      Level tgt_level = tgt_path->vertex(this)->level();
+      if (src_level >= tgt_level)
+	src_path = clkPathPrev(src_path, tmp1);
+      if (tgt_level >= src_level)
+	tgt_path = clkPathPrev(tgt_path, tmp2);
+    }
+    UniqueLock lock(shard.lock);
+    if (shard.common_paths.size() >= common_path_shard_size_)
+      shard.common_paths.clear();
+    shard.common_paths[query] = common;
+  }
+  src_common_path.init(common.first, this);
+  tgt_common_path.init(common.second, this);
+}
+
 void
 CheckCrpr::genClkSrcPaths(const PathVertex *path,
 			  PathVertexSeq &gclk_paths)
@@ -395,4 +450,25 @@ CheckCrpr::crprArrivalDiff(const PathVertex *path)
   return crpr_diff;
 }
 
+////////////////////////////////////////////////////////////////
+
+size_t
+CrprPathPairHash::operator()(const CrprPathPair &pair) const
+{
+  Hash hash = hash_init_value;
+  hashIncr(hash, pair.first.vertexIndex());
+  hashIncr(hash, pair.first.tagIndex());
+  hashIncr(hash, pair.second.vertexIndex());
+  hashIncr(hash, pair.second.tagIndex());
+  return hash;
+}
+
+bool
+CrprPathPairEqual::operator()(const CrprPathPair &pair1,
+			      const CrprPathPair &pair2) const
+{
+  return PathVertexRep::equal(pair1.first, pair2.first)
+    && PathVertexRep::equal(pair1.second, pair2.second);
+}
+
 } // namespace
@@ -17,19 +17,54 @@
 #ifndef STA_CRPR_H
 #define STA_CRPR_H
 
+#include <mutex>
 #include "DisallowCopyAssign.hh"
+#include "UnorderedMap.hh"
 #include "SdcClass.hh"
 #include "SearchClass.hh"
+#include "PathVertexRep.hh"
 
 namespace sta {
 
 class CrprPaths;
 
+// Source/target clock path pair.
+typedef std::pair<PathVertexRep, PathVertexRep> CrprPathPair;
+
+class CrprPathPairHash
+{
+public:
+  size_t operator()(const CrprPathPair &pair) const;
+};
+
+class CrprPathPairEqual
+{
+public:
+  bool operator()(const CrprPathPair &pair1,
+		  const CrprPathPair &pair2) const;
+};
+
+// Map from src/tgt clock path pair to the src/tgt paths at their
+// common pin (null paths if they do not share a pin).
+typedef UnorderedMap<CrprPathPair, CrprPathPair,
+		     CrprPathPairHash, CrprPathPairEqual> CrprCommonPathMap;
+
+// One slice of the common path memo with its own lock so threads
+// checking different endpoint pairs rarely contend.
+class CrprCommonPathShard
+{
+public:
+  CrprCommonPathMap common_paths;
+  std::mutex lock;
+};
+
 // Clock Reconvergence Pessimism Removal.
 class CheckCrpr : public StaState
 {
 public:
   explicit CheckCrpr(StaState *sta);
+  // Forget common clock paths when clock arrivals/tags change.
+  void clear();
 
   // Find the maximum possible crpr (clock min/max delta delay) for path.
   Arrival maxCrpr(ClkInfo *clk_info);
@@ -83,6 +118,11 @@ private:
 		// Return values.
 		Crpr &crpr,
 		Pin *&common_pin);
+  void findCommonPaths(const PathVertex *src_clk_path,
+		       const PathVertex *tgt_clk_path,
+		       // Return values.
+		       PathVertex &src_common_path,
+		       PathVertex &tgt_common_path);
   void portClkPath(const ClockEdge *clk_edge,
 		   const Pin *clk_src_pin,
 		   const PathAnalysisPt *path_ap,
@@ -91,6 +131,16 @@ private:
   Crpr findCrpr1(const PathVertex *src_clk_path,
 		 const PathVertex *tgt_clk_path);
   float crprArrivalDiff(const PathVertex *path);
+
+  CrprCommonPathShard &commonPathShard(const CrprPathPair &pair);
+
+  // Common paths are shared by every endpoint pair below the clock
+  // tree branches where they diverge, so they are found once.
+  // Each shard is emptied when it reaches common_path_shard_size_
+  // entries to bound the memory.
+  static const int common_path_shard_count_ = 16;
+  static const size_t common_path_shard_size_ = 16384;
+  CrprCommonPathShard common_path_shards_[common_path_shard_count_];
 };
 
 } // namespace
@@ -0,0 +1,124 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Machine.hh"
+#include "EcoJournal.hh"
+
+namespace sta {
+
+EcoEdit::EcoEdit(EcoEditType type,
+		 Instance *inst,
+		 Cell *cell,
+		 Port *port,
+		 Net *net) :
+  type_(type),
+  inst_(inst),
+  cell_(cell),
+  port_(port),
+  net_(net)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
+EcoJournal::EcoJournal() :
+  reversible_(true),
+  graph_unchanged_(true),
+  invalid_count_(0)
+{
+}
+
+void
+EcoJournal::setInvalidCount(size_t invalid_count)
+{
+  invalid_count_ = invalid_count;
+}
+
+void
+EcoJournal::editInvalid(size_t invalid_count)
+{
+  invalid_count_ += invalid_count;
+}
+
+bool
+EcoJournal::onlyEditsInvalid(size_t invalid_count) const
+{
+  return invalid_count == invalid_count_;
+}
+
+void
+EcoJournal::replaceCell(Instance *inst,
+			Cell *from_cell,
+			bool equiv_cells)
+{
+  edits_.push_back(EcoEdit(EcoEditType::replace_cell, inst, from_cell,
+			   nullptr, nullptr));
+  // Equivalent cell replacement swaps the edge timing arc sets in place.
+  if (!equiv_cells)
+    graph_unchanged_ = false;
+}
+
+void
+EcoJournal::makeInstance(Instance *inst)
+{
+  edits_.push_back(EcoEdit(EcoEditType::make_instance, inst, nullptr,
+			   nullptr, nullptr));
+  graph_unchanged_ = false;
+}
+
+void
+EcoJournal::makeNet(Net *net)
+{
+  // Nets without pins are not in the timing graph.
+  edits_.push_back(EcoEdit(EcoEditType::make_net, nullptr, nullptr,
+			   nullptr, net));
+}
+
+void
+EcoJournal::connectPin(Instance *inst,
+		       Port *port,
+		       Net *prev_net)
+{
+  edits_.push_back(EcoEdit(EcoEditType::connect_pin, inst, nullptr,
+			   port, prev_net));
+  graph_unchanged_ = false;
+}
+
+void
+EcoJournal::disconnectPin(Instance *inst,
+			  Port *port,
+			  Net *net)
+{
+  edits_.push_back(EcoEdit(EcoEditType::disconnect_pin, inst, nullptr,
+			   port, net));
+  graph_unchanged_ = false;
+}
+
+void
+EcoJournal::deleteInstance()
+{
+  reversible_ = false;
+  graph_unchanged_ = false;
+}
+
+void
+EcoJournal::deleteNet()
+{
+  reversible_ = false;
+  graph_unchanged_ = false;
+}
+
+} // namespace
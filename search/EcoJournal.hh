@@ -0,0 +1,108 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_ECO_JOURNAL_H
+#define STA_ECO_JOURNAL_H
+
+#include "DisallowCopyAssign.hh"
+#include "Vector.hh"
+#include "NetworkClass.hh"
+
+namespace sta {
+
+class EcoEdit;
+
+typedef Vector<EcoEdit> EcoEditSeq;
+
+enum class EcoEditType { replace_cell,
+			 make_instance,
+			 make_net,
+			 connect_pin,
+			 disconnect_pin };
+
+// Netlist edit made after Sta::ecoBegin and the data required to undo it.
+class EcoEdit
+{
+public:
+  EcoEdit(EcoEditType type,
+	  Instance *inst,
+	  Cell *cell,
+	  Port *port,
+	  Net *net);
+  EcoEditType type() const { return type_; }
+  Instance *instance() const { return inst_; }
+  // replace_cell cell before the edit.
+  Cell *cell() const { return cell_; }
+  Port *port() const { return port_; }
+  // make_net net.
+  // connect_pin/disconnect_pin net before the edit.
+  Net *net() const { return net_; }
+
+protected:
+  EcoEditType type_;
+  Instance *inst_;
+  Cell *cell_;
+  Port *port_;
+  Net *net_;
+};
+
+// Journal of the netlist edits in an ECO (Sta::ecoBegin/ecoRollback).
+class EcoJournal
+{
+public:
+  EcoJournal();
+  void replaceCell(Instance *inst,
+		   Cell *from_cell,
+		   bool equiv_cells);
+  void makeInstance(Instance *inst);
+  void makeNet(Net *net);
+  void connectPin(Instance *inst,
+		  Port *port,
+		  Net *prev_net);
+  void disconnectPin(Instance *inst,
+		     Port *port,
+		     Net *net);
+  // Deleted instances and nets cannot be restored.
+  void deleteInstance();
+  void deleteNet();
+  // Edits in the order they were made.
+  const EcoEditSeq &edits() const { return edits_; }
+  // All edits can be undone.
+  bool reversible() const { return reversible_; }
+  // The timing graph vertices and edges are unchanged by the edits,
+  // so journaled delays and arrivals can be restored on rollback.
+  bool graphUnchanged() const { return graph_unchanged_; }
+  // Delay calc and search invalidation count when the journal began.
+  void setInvalidCount(size_t invalid_count);
+  // Invalidations made by an edit.
+  void editInvalid(size_t invalid_count);
+  // True if the edits made all of the invalidations since the journal
+  // began. Other invalidations (sdc, parasitics) change timing the
+  // journal cannot restore.
+  bool onlyEditsInvalid(size_t invalid_count) const;
+
+protected:
+  EcoEditSeq edits_;
+  bool reversible_;
+  bool graph_unchanged_;
+  size_t invalid_count_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(EcoJournal);
+};
+
+} // namespace
+#endif
@@ -0,0 +1,82 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "Machine.hh"
+#include "EditBatch.hh"
+
+namespace sta {
+
+EditBatch::EditBatch()
+{
+}
+
+void
+EditBatch::arrivalInvalid(Vertex *vertex)
+{
+  arrivals_invalid_.insert(vertex);
+}
+
+void
+EditBatch::requiredInvalid(Vertex *vertex)
+{
+  requireds_invalid_.insert(vertex);
+}
+
+void
+EditBatch::delayInvalid(Vertex *vertex)
+{
+  delays_invalid_.insert(vertex);
+}
+
+void
+EditBatch::connectPin(Pin *pin)
+{
+  connected_pins_.insert(pin);
+}
+
+void
+EditBatch::deletePinBefore(Pin *pin)
+{
+  connected_pins_.erase(pin);
+}
+
+void
+EditBatch::deleteVertexBefore(Vertex *vertex)
+{
+  arrivals_invalid_.erase(vertex);
+  requireds_invalid_.erase(vertex);
+  delays_invalid_.erase(vertex);
+}
+
+bool
+EditBatch::empty() const
+{
+  return connected_pins_.empty()
+    && arrivals_invalid_.empty()
+    && requireds_invalid_.empty()
+    && delays_invalid_.empty();
+}
+
+void
+EditBatch::clear()
+{
+  connected_pins_.clear();
+  arrivals_invalid_.clear();
+  requireds_invalid_.clear();
+  delays_invalid_.clear();
+}
+
+} // namespace
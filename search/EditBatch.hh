@@ -0,0 +1,59 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_EDIT_BATCH_H
+#define STA_EDIT_BATCH_H
+
+#include "DisallowCopyAssign.hh"
+#include "NetworkClass.hh"
+#include "GraphClass.hh"
+
+namespace sta {
+
+// Graph edits and invalidations deferred by network edits
+// between Sta::editBatchBegin and Sta::editBatchEnd.
+// Invalidations are collected in sets so each vertex is only
+// invalidated once when the batch is flushed.
+class EditBatch
+{
+public:
+  EditBatch();
+  void arrivalInvalid(Vertex *vertex);
+  void requiredInvalid(Vertex *vertex);
+  void delayInvalid(Vertex *vertex);
+  // Wire edges to/from/thru pin are made when the batch is flushed.
+  void connectPin(Pin *pin);
+  void deletePinBefore(Pin *pin);
+  void deleteVertexBefore(Vertex *vertex);
+  bool empty() const;
+  void clear();
+  PinSet &connectedPins() { return connected_pins_; }
+  VertexSet &arrivalsInvalid() { return arrivals_invalid_; }
+  VertexSet &requiredsInvalid() { return requireds_invalid_; }
+  VertexSet &delaysInvalid() { return delays_invalid_; }
+
+protected:
+  PinSet connected_pins_;
+  VertexSet arrivals_invalid_;
+  VertexSet requireds_invalid_;
+  VertexSet delays_invalid_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(EditBatch);
+};
+
+} // namespace
+#endif
@@ -15,10 +15,12 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
+#include <vector>
 #include "Machine.hh"
 #include "Report.hh"
 #include "Debug.hh"
 #include "Stats.hh"
+#include "Profiler.hh"
 #include "TimingRole.hh"
 #include "PortDirection.hh"
 #include "Network.hh"
@@ -38,6 +40,7 @@ Levelize::Levelize(StaState *sta) :
   max_level_(0),
   level_space_(10),
   loops_(nullptr),
+  latch_d_to_q_edges_exist_(false),
   observer_(nullptr)
 {
 }
@@ -69,6 +72,8 @@ Levelize::clear()
   levels_valid_ = false;
   roots_.clear();
   relevelize_from_.clear();
+  prev_disabled_loop_edges_.clear();
+  latch_d_to_q_edges_exist_ = false;
   clearLoopEdges();
   deleteLoops();
 }
@@ -111,9 +116,30 @@ Levelize::ensureLevelized()
 void
 Levelize::levelize()
 {
+  ProfilePhase phase(debug_, "levelize");
   Stats stats(debug_);
   debugPrint0(debug_, "levelize", 1, "levelize\n");
+  // All levels are reset before they are found, so the observer is
+  // only notified of the vertices that end up with different levels
+  // or loop breaking edges.
+  LevelizeObserver *observer = observer_;
+  std::vector<Level> prev_levels;
+  if (observer) {
+    observer->levelsChangedBefore();
+    prev_levels.resize(graph_->vertexCount() + 1, 0);
+    VertexIterator vertex_iter(graph_);
+    while (vertex_iter.hasNext()) {
+      Vertex *vertex = vertex_iter.next();
+      VertexIndex index = graph_->index(vertex);
+      if (index >= prev_levels.size())
+	prev_levels.resize(index + 1, 0);
+      prev_levels[index] = vertex->level();
+    }
+    prev_disabled_loop_edges_.insertSet(&disabled_loop_edges_);
+  }
+  observer_ = nullptr;
   max_level_ = 0;
+  latch_d_to_q_edges_exist_ = false;
   clearLoopEdges();
   deleteLoops();
   loops_ = new GraphLoopSeq;
@@ -129,6 +155,26 @@ Levelize::levelize()
   ensureLatchLevels();
   // Find vertices in cycles that are were not accessible from roots.
   levelizeCycles();
+  observer_ = observer;
+  if (observer) {
+    VertexIterator vertex_iter(graph_);
+    while (vertex_iter.hasNext()) {
+      Vertex *vertex = vertex_iter.next();
+      VertexIndex index = graph_->index(vertex);
+      if (index >= prev_levels.size()
+	  || prev_levels[index] != vertex->level())
+	observer->levelChangedAfter(vertex);
+    }
+    for (Edge *edge : disabled_loop_edges_) {
+      if (!prev_disabled_loop_edges_.hasKey(edge))
+	observer->levelChangedAfter(edge->to(graph_));
+    }
+    for (Edge *edge : prev_disabled_loop_edges_) {
+      if (!disabled_loop_edges_.hasKey(edge))
+	observer->levelChangedAfter(edge->to(graph_));
+    }
+  }
+  prev_disabled_loop_edges_.clear();
   levelized_ = true;
   levels_valid_ = true;
   stats.report("Levelize");
@@ -231,8 +277,10 @@ Levelize::visit(Vertex *vertex,
 	  path.pop_back();
 	}
       }
-      if (edge->role() == TimingRole::latchDtoQ())
-	  latch_d_to_q_edges_.insert(edge);
+      if (edge->role() == TimingRole::latchDtoQ()) {
+	latch_d_to_q_edges_.insert(edge);
+	latch_d_to_q_edges_exist_ = true;
+      }
     }
     // Levelize bidirect driver as if it was a fanout of the bidirect load.
     if (sdc_->bidirectDrvrSlewFromLoad(from_pin)
@@ -353,7 +401,12 @@ void
 Levelize::invalid()
 {
   debugPrint0(debug_, "levelize", 1, "levels invalid\n");
+  // Remember the loop breaking edges to notify the observer of the
+  // edges that change when the levels are found again.
+  EdgeSet prev_disabled_loop_edges(prev_disabled_loop_edges_);
+  prev_disabled_loop_edges.insertSet(&disabled_loop_edges_);
   clear();
+  prev_disabled_loop_edges_ = prev_disabled_loop_edges;
 }
 
 void
@@ -397,6 +450,7 @@ Levelize::deleteEdgeBefore(Edge *edge)
     // Prevent refererence to deleted edge by clearLoopEdges().
     disabled_loop_edges_.erase(edge);
   }
+  prev_disabled_loop_edges_.erase(edge);
 }
 
 // Incremental relevelization.
@@ -54,6 +54,10 @@ public:
   bool isDisabledLoop(Edge *edge) const;
   // Only valid when levels are valid.
   GraphLoopSeq *loops() { return loops_; }
+  // True if latch D->Q edges, which are not levelized, have been found
+  // since the graph was levelized from scratch. The Q level can be
+  // lower than the D level.
+  bool latchDtoQEdgesExist() const { return latch_d_to_q_edges_exist_; }
   // Set the observer for level changes.
   void setObserver(LevelizeObserver *observer);
 
@@ -83,7 +87,10 @@ protected:
   GraphLoopSeq *loops_;
   EdgeSet loop_edges_;
   EdgeSet disabled_loop_edges_;
+  // Disabled loop edges before the levels were invalidated.
+  EdgeSet prev_disabled_loop_edges_;
   EdgeSet latch_d_to_q_edges_;
+  bool latch_d_to_q_edges_exist_;
   LevelizeObserver *observer_;
 
 private:
@@ -116,6 +123,11 @@ public:
   LevelizeObserver() {}
   virtual ~LevelizeObserver() {}
   virtual void levelChangedBefore(Vertex *vertex) = 0;
+  // Called before the levels of all vertices are found again.
+  virtual void levelsChangedBefore() {}
+  // Called after the levels of all vertices are found again for the
+  // vertices with a different level or loop breaking fanin edge.
+  virtual void levelChangedAfter(Vertex *) {}
 
 private:
   DISALLOW_COPY_AND_ASSIGN(LevelizeObserver);
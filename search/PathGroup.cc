@@ -18,6 +18,7 @@
 #include <limits>
 #include "Machine.hh"
 #include "Stats.hh"
+#include "Profiler.hh"
 #include "Debug.hh"
 #include "Mutex.hh"
 #include "Fuzzy.hh"
@@ -492,6 +493,7 @@ PathGroups::makePathEnds(ExceptionTo *to,
 			 const MinMaxAll *min_max,
 			 bool sort_by_slack)
 {
+  ProfilePhase phase(this->debug(), "make_path_ends");
   Stats stats(this->debug());
   makeGroupPathEnds(to, group_count_, endpoint_count_, unique_pins_,
 		    corner, min_max);
@@ -16,7 +16,10 @@
 
 #include <algorithm> // max
 #include "Machine.hh"
+#include "Mutex.hh"
+#include "ThreadForEach.hh"
 #include "Debug.hh"
+#include "Stats.hh"
 #include "EnumNameMap.hh"
 #include "Units.hh"
 #include "Transition.hh"
@@ -35,6 +38,7 @@
 #include "Corner.hh"
 #include "Sdc.hh"
 #include "DcalcAnalysisPt.hh"
+#include "ArcDelayCalc.hh"
 #include "GraphDelayCalc.hh"
 #include "PathVertex.hh"
 #include "Levelize.hh"
@@ -67,6 +71,27 @@ Power::Power(Sta *sta) :
 {
 }
 
+Power::~Power()
+{
+  cell_plans_.deleteContents();
+}
+
+void
+Power::clear()
+{
+  activity_map_.clear();
+  vertex_activities_.clear();
+  invalid_activity_pins_.clear();
+  activities_valid_ = false;
+  cell_plans_.deleteContentsClear();
+}
+
+void
+Power::activitiesInvalid()
+{
+  activities_valid_ = false;
+}
+
 void
 Power::setGlobalActivity(float activity,
 			 float duty)
@@ -92,7 +117,7 @@ Power::setInputPortActivity(const Port *input_port,
   const Pin *pin = network_->findPin(top_inst, input_port);
   if (pin) {
     activity_map_[pin] = {activity, duty, PwrActivityOrigin::user};
-    activities_valid_ = false;
+    activityInvalid(pin);
   }
 }
 
@@ -113,7 +138,7 @@ Power::setPinActivity(const Pin *pin,
 		      PwrActivity &activity)
 {
   activity_map_[pin] = activity;
-  activities_valid_ = false;
+  activityInvalid(pin);
 }
 
 void
@@ -123,9 +148,353 @@ Power::setPinActivity(const Pin *pin,
 		      PwrActivityOrigin origin)
 {
   activity_map_[pin] = {activity, duty, origin};
-  activities_valid_ = false;
+  activityInvalid(pin);
+}
+
+void
+Power::activityInvalid(const Pin *pin)
+{
+  // Until activities are propagated everything is invalid.
+  if (activities_valid_)
+    invalid_activity_pins_.insert(const_cast<Pin*>(pin));
 }
 
+// Mark the loads of drvr_pin before its wire edges are deleted.
+void
+Power::fanoutActivityInvalid(const Pin *drvr_pin)
+{
+  if (activities_valid_
+      && graph_
+      && network_->isDriver(drvr_pin)) {
+    Vertex *vertex = graph_->pinDrvrVertex(drvr_pin);
+    if (vertex) {
+      VertexOutEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	if (edge->isWire())
+	  activityInvalid(edge->to(graph_)->pin());
+      }
+    }
+  }
+}
+
+void
+Power::connectPinAfter(const Pin *pin)
+{
+  activityInvalid(pin);
+}
+
+void
+Power::disconnectPinBefore(const Pin *pin)
+{
+  activityInvalid(pin);
+  fanoutActivityInvalid(pin);
+}
+
+void
+Power::pinSetFuncAfter(const Pin *pin)
+{
+  activityInvalid(pin);
+}
+
+void
+Power::deletePinBefore(const Pin *pin)
+{
+  fanoutActivityInvalid(pin);
+  activity_map_.erase(pin);
+  invalid_activity_pins_.erase(const_cast<Pin*>(pin));
+  if (graph_) {
+    // Vertex indices are reused so forget the propagated activities.
+    Vertex *vertex, *bidirect_drvr_vertex;
+    graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+    if (vertex)
+      setVertexActivity(vertex, PwrActivity());
+    if (bidirect_drvr_vertex)
+      setVertexActivity(bidirect_drvr_vertex, PwrActivity());
+  }
+}
+
+// Supply voltage of a cell pg pin from the library voltage map.
+// Pins without a voltage use the operating conditions voltage.
+class PwrPgVoltage
+{
+public:
+  PwrPgVoltage(LibertyCell *cell,
+	       const char *pg_port_name);
+  float voltage(LibertyCell *cell,
+		const DcalcAnalysisPt *dcalc_ap) const;
+
+private:
+  float voltage_;
+  bool exists_;
+};
+
+PwrPgVoltage::PwrPgVoltage(LibertyCell *cell,
+			   const char *pg_port_name) :
+  voltage_(0.0),
+  exists_(false)
+{
+  if (pg_port_name) {
+    auto pg_port = cell->findPgPort(pg_port_name);
+    if (pg_port) {
+      auto volt_name = pg_port->voltageName();
+      auto library = cell->libertyLibrary();
+      library->supplyVoltage(volt_name, voltage_, exists_);
+    }
+  }
+}
+
+float
+PwrPgVoltage::voltage(LibertyCell *cell,
+		      const DcalcAnalysisPt *dcalc_ap) const
+{
+  if (exists_)
+    return voltage_;
+  else {
+    const Pvt *pvt = dcalc_ap->operatingConditions();
+    if (pvt == nullptr)
+      pvt = cell->libertyLibrary()->defaultOperatingConditions();
+    if (pvt)
+      return pvt->voltage();
+    else
+      return 0.0;
+  }
+}
+
+// Internal power group of a port with the related port, infered "when"
+// and supply voltage resolved.
+class PwrInternalPlan
+{
+public:
+  PwrInternalPlan(InternalPower *pwr,
+		  const LibertyPort *from_port,
+		  FuncExpr *infered_when,
+		  bool missing_when,
+		  LibertyCell *cell);
+  ~PwrInternalPlan();
+  InternalPower *internalPower() const { return pwr_; }
+  const LibertyPort *fromPort() const { return from_port_; }
+  FuncExpr *inferedWhen() const { return infered_when_; }
+  bool missingWhen() const { return missing_when_; }
+  const PwrPgVoltage &pgVoltage() const { return pg_voltage_; }
+  // If all the "when" clauses exist VSS internal power is ignored.
+  bool hasPower(LibertyCell *cell,
+		const DcalcAnalysisPt *dcalc_ap) const;
+
+private:
+  InternalPower *pwr_;
+  const LibertyPort *from_port_;
+  FuncExpr *infered_when_;
+  bool missing_when_;
+  PwrPgVoltage pg_voltage_;
+
+  DISALLOW_COPY_AND_ASSIGN(PwrInternalPlan);
+};
+
+PwrInternalPlan::PwrInternalPlan(InternalPower *pwr,
+				 const LibertyPort *from_port,
+				 FuncExpr *infered_when,
+				 bool missing_when,
+				 LibertyCell *cell) :
+  pwr_(pwr),
+  from_port_(from_port),
+  infered_when_(infered_when),
+  missing_when_(missing_when),
+  pg_voltage_(cell, pwr->relatedPgPin())
+{
+}
+
+PwrInternalPlan::~PwrInternalPlan()
+{
+  if (infered_when_)
+    infered_when_->deleteSubexprs();
+}
+
+bool
+PwrInternalPlan::hasPower(LibertyCell *cell,
+			  const DcalcAnalysisPt *dcalc_ap) const
+{
+  return (pwr_->when() && missing_when_)
+    || pg_voltage_.voltage(cell, dcalc_ap) != 0.0;
+}
+
+class PwrPortPlan
+{
+public:
+  PwrPortPlan(const LibertyPort *port,
+	      LibertyCell *cell);
+  ~PwrPortPlan();
+  const LibertyPort *port() const { return port_; }
+  const PwrPgVoltage &pgVoltage() const { return pg_voltage_; }
+  const PwrInternalPlanSeq &internalPowers() const { return internal_powers_; }
+  void addInternalPower(PwrInternalPlan *pwr_plan);
+
+private:
+  const LibertyPort *port_;
+  PwrPgVoltage pg_voltage_;
+  PwrInternalPlanSeq internal_powers_;
+
+  DISALLOW_COPY_AND_ASSIGN(PwrPortPlan);
+};
+
+PwrPortPlan::PwrPortPlan(const LibertyPort *port,
+			 LibertyCell *cell) :
+  port_(port),
+  pg_voltage_(cell, port->relatedPowerPin())
+{
+}
+
+PwrPortPlan::~PwrPortPlan()
+{
+  internal_powers_.deleteContents();
+}
+
+void
+PwrPortPlan::addInternalPower(PwrInternalPlan *pwr_plan)
+{
+  internal_powers_.push_back(pwr_plan);
+}
+
+// Power models of a liberty cell resolved once so instance power
+// only evaluates activities and table lookups.
+class PwrCellPlan
+{
+public:
+  explicit PwrCellPlan(float leakage);
+  ~PwrCellPlan();
+  float leakage() const { return leakage_; }
+  const PwrPortPlanSeq &ports() const { return ports_; }
+  PwrPortPlan *findPort(const LibertyPort *port) const;
+  void addPort(PwrPortPlan *port_plan);
+
+private:
+  float leakage_;
+  PwrPortPlanSeq ports_;
+
+  DISALLOW_COPY_AND_ASSIGN(PwrCellPlan);
+};
+
+PwrCellPlan::PwrCellPlan(float leakage) :
+  leakage_(leakage)
+{
+}
+
+PwrCellPlan::~PwrCellPlan()
+{
+  ports_.deleteContents();
+}
+
+PwrPortPlan *
+PwrCellPlan::findPort(const LibertyPort *port) const
+{
+  for (PwrPortPlan *port_plan : ports_) {
+    if (port_plan->port() == port)
+      return port_plan;
+  }
+  return nullptr;
+}
+
+void
+PwrCellPlan::addPort(PwrPortPlan *port_plan)
+{
+  ports_.push_back(port_plan);
+}
+
+PwrCellPlan *
+Power::cellPlan(LibertyCell *cell)
+{
+  PwrCellPlan *plan = cell_plans_.findKey(cell);
+  if (plan == nullptr) {
+    plan = makeCellPlan(cell);
+    cell_plans_[cell] = plan;
+  }
+  return plan;
+}
+
+PwrCellPlan *
+Power::makeCellPlan(LibertyCell *cell)
+{
+  PwrCellPlan *plan = new PwrCellPlan(findLeakagePower(cell));
+  LibertyCellPortBitIterator port_iter(cell);
+  while (port_iter.hasNext()) {
+    LibertyPort *to_port = port_iter.next();
+    PwrPortPlan *port_plan = new PwrPortPlan(to_port, cell);
+    LibertyCellInternalPowerIterator pwr_iter(cell);
+    while (pwr_iter.hasNext()) {
+      InternalPower *pwr = pwr_iter.next();
+      if (pwr->port() == to_port) {
+	const char *related_pg_pin = pwr->relatedPgPin();
+	const LibertyPort *from_port = pwr->relatedPort();
+	FuncExpr *when = pwr->when();
+	FuncExpr *infered_when = nullptr;
+	if (from_port) {
+	  if (when == nullptr) {
+	    FuncExpr *func = to_port->function();
+	    if (func)
+	      infered_when = inferedWhen(func, from_port);
+	  }
+	}
+	else
+	  from_port = to_port;
+	bool missing_when = when
+	  && internalPowerMissingWhen(cell, to_port, related_pg_pin);
+	port_plan->addInternalPower(new PwrInternalPlan(pwr, from_port,
+							infered_when,
+							missing_when,
+							cell));
+      }
+    }
+    plan->addPort(port_plan);
+  }
+  return plan;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Instance power sums by cell category.
+class PowerSums
+{
+public:
+  void incr(LibertyCell *cell,
+	    PowerResult &inst_power);
+  void incr(PowerSums &sums);
+
+  PowerResult total;
+  PowerResult sequential;
+  PowerResult combinational;
+  PowerResult macro;
+  PowerResult pad;
+};
+
+void
+PowerSums::incr(LibertyCell *cell,
+		PowerResult &inst_power)
+{
+  if (cell->isMacro())
+    macro.incr(inst_power);
+  else if (cell->isPad())
+    pad.incr(inst_power);
+  else if (cell->hasSequentials())
+    sequential.incr(inst_power);
+  else
+    combinational.incr(inst_power);
+  total.incr(inst_power);
+}
+
+void
+PowerSums::incr(PowerSums &sums)
+{
+  total.incr(sums.total);
+  sequential.incr(sums.sequential);
+  combinational.incr(sums.combinational);
+  macro.incr(sums.macro);
+  pad.incr(sums.pad);
+}
+
+// Designs with at least this many instances find instance power
+// with multiple threads.
+static const size_t power_parallel_min = 1000;
+
 void
 Power::power(const Corner *corner,
 	     // Return values.
@@ -135,32 +504,65 @@ Power::power(const Corner *corner,
 	     PowerResult &macro,
 	     PowerResult &pad)
 {
-  total.clear();
-  sequential.clear();
-  combinational.clear();
-  macro.clear();
-  pad.clear();
-
   preamble();
+  Stats stats(debug_);
+  // Power plans for the cells are made here so the threads below
+  // only read them.
+  InstanceSeq insts;
   LeafInstanceIterator *inst_iter = network_->leafInstanceIterator();
   while (inst_iter->hasNext()) {
     Instance *inst = inst_iter->next();
     LibertyCell *cell = network_->libertyCell(inst);
     if (cell) {
-      PowerResult inst_power;
-      power(inst, corner, inst_power);
-      if (cell->isMacro())
-	macro.incr(inst_power);
-      else if (cell->isPad())
-	pad.incr(inst_power);
-      else if (cell->hasSequentials())
-	sequential.incr(inst_power);
-      else
-	combinational.incr(inst_power);
-      total.incr(inst_power);
+      cellPlan(cell);
+      insts.push_back(inst);
     }
   }
   delete inst_iter;
+
+  PowerSums sums;
+  size_t thread_count = threadCount();
+  if (thread_count > 1
+      && insts.size() >= power_parallel_min) {
+    // Each thread sums a contiguous range of instances with its own
+    // delay calculator because finding parasitics is not thread safe.
+    std::vector<PowerSums> thread_sums(thread_count);
+    forEachChunk(insts.size(), thread_count,
+		 [&] (size_t i, size_t begin, size_t end) {
+      ArcDelayCalc *arc_delay_calc = arc_delay_calc_->copy();
+      power(insts, begin, end, corner, arc_delay_calc, thread_sums[i]);
+      delete arc_delay_calc;
+    });
+    for (PowerSums &sums1 : thread_sums)
+      sums.incr(sums1);
+  }
+  else
+    power(insts, 0, insts.size(), corner, arc_delay_calc_, sums);
+  total = sums.total;
+  sequential = sums.sequential;
+  combinational = sums.combinational;
+  macro = sums.macro;
+  pad = sums.pad;
+  stats.report("Find power");
+}
+
+void
+Power::power(const InstanceSeq &insts,
+	     size_t begin,
+	     size_t end,
+	     const Corner *corner,
+	     ArcDelayCalc *arc_delay_calc,
+	     // Return value.
+	     PowerSums &sums)
+{
+  for (size_t i = begin; i < end; i++) {
+    const Instance *inst = insts[i];
+    LibertyCell *cell = network_->libertyCell(inst);
+    PwrCellPlan *plan = cell_plans_.findKey(cell);
+    PowerResult inst_power;
+    power(inst, cell, plan, corner, arc_delay_calc, inst_power);
+    sums.incr(cell, inst_power);
+  }
 }
 
 void
@@ -172,7 +574,7 @@ Power::power(const Instance *inst,
   LibertyCell *cell = network_->libertyCell(inst);
   if (cell) {
     preamble();
-    power(inst, cell, corner, result);
+    power(inst, cell, cellPlan(cell), corner, arc_delay_calc_, result);
   }
 }
 
@@ -218,21 +620,18 @@ ActivitySrchPred::searchTo(const Vertex *)
 
 ////////////////////////////////////////////////////////////////
 
+// Thread safe visitor that propagates activities through the fanout
+// of the vertices that changed. Registers with changed input activities
+// are collected by Power so they can be seeded after the visit.
 class PropActivityVisitor : public VertexVisitor, StaState
 {
 public:
   PropActivityVisitor(Power *power,
 		      BfsFwdIterator *bfs);
-  ~PropActivityVisitor();
   virtual VertexVisitor *copy();
   virtual void visit(Vertex *vertex);
-  void init();
-  bool foundRegWithoutActivity() const;
-  InstanceSet *stealVisitedRegs();
 
 private:
-  InstanceSet *visited_regs_;
-  bool found_reg_without_activity_;
   Power *power_;
   BfsFwdIterator *bfs_;
 };
@@ -240,90 +639,78 @@ private:
 PropActivityVisitor::PropActivityVisitor(Power *power,
 					 BfsFwdIterator *bfs) :
   StaState(power),
-  visited_regs_(nullptr),
   power_(power),
   bfs_(bfs)
 {
 }
 
-PropActivityVisitor::~PropActivityVisitor()
-{
-  delete visited_regs_;
-}
-
 VertexVisitor *
 PropActivityVisitor::copy()
 {
   return new PropActivityVisitor(power_, bfs_);
 }
 
-void
-PropActivityVisitor::init()
-{
-  visited_regs_ = new InstanceSet;
-  found_reg_without_activity_ = false;
-}
-
-InstanceSet *
-PropActivityVisitor::stealVisitedRegs()
-{
-  InstanceSet *visited_regs = visited_regs_;
-  visited_regs_ = nullptr;
-  return visited_regs;
-}
-
-bool
-PropActivityVisitor::foundRegWithoutActivity() const
-{
-  return found_reg_without_activity_;
-}
-
 void
 PropActivityVisitor::visit(Vertex *vertex)
 {
   auto pin = vertex->pin();
   debugPrint1(debug_, "power_activity", 3, "visit %s\n",
 	      vertex->name(network_));
-  bool input_without_activity = false;
-  if (network_->isLoad(pin)) {
-    VertexInEdgeIterator edge_iter(vertex, graph_);
-    if (edge_iter.hasNext()) {
-      Edge *edge = edge_iter.next();
-      if (edge->isWire()) {
-	Vertex *from_vertex = edge->from(graph_);
-	const Pin *from_pin = from_vertex->pin();
-	PwrActivity &from_activity = power_->pinActivity(from_pin);
-	PwrActivity to_activity(from_activity.activity(),
-				from_activity.duty(),
-				PwrActivityOrigin::propagated);
-	if (!power_->hasPinActivity(pin))
-	  input_without_activity = true;
-	power_->setPinActivity(pin, to_activity);
+  bool changed = false;
+  bool evaled = false;
+  bool is_load = network_->isLoad(pin) && !vertex->isBidirectDriver();
+  PwrActivity user_activity;
+  if (power_->findUserActivity(pin, user_activity)) {
+    // Annotated activities are not overridden by propagation.
+    changed = power_->setVertexActivity(vertex, user_activity);
+    evaled = true;
+  }
+  else {
+    if (is_load) {
+      VertexInEdgeIterator edge_iter(vertex, graph_);
+      if (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	if (edge->isWire()) {
+	  Vertex *from_vertex = edge->from(graph_);
+	  PwrActivity from_activity = power_->vertexActivity(from_vertex);
+	  PwrActivity to_activity(from_activity.activity(),
+				  from_activity.duty(),
+				  PwrActivityOrigin::propagated);
+	  changed = power_->setVertexActivity(vertex, to_activity);
+	  evaled = true;
+	}
+      }
+    }
+    if (vertex->isDriver(network_)) {
+      LibertyPort *port = network_->libertyPort(pin);
+      if (port) {
+	FuncExpr *func = port->function();
+	if (func) {
+	  Instance *inst = network_->instance(pin);
+	  PwrActivity activity = power_->evalActivity(func, inst);
+	  changed |= power_->setVertexActivity(vertex, activity);
+	  evaled = true;
+	  debugPrint3(debug_, "power_activity", 3, "set %s %.2e %.2f\n",
+		      vertex->name(network_),
+		      activity.activity(),
+		      activity.duty());
+	}
       }
     }
+  }
+  if (is_load && changed) {
     Instance *inst = network_->instance(pin);
     auto cell = network_->libertyCell(inst);
     if (cell && cell->hasSequentials()) {
       debugPrint1(debug_, "power_activity", 3, "pending reg %s\n",
 		  network_->pathName(inst));
-      visited_regs_->insert(inst);
-      found_reg_without_activity_ = input_without_activity;
+      power_->regActivityChanged(inst);
     }
   }
-  if (network_->isDriver(pin)) {
-    LibertyPort *port = network_->libertyPort(pin);
-    if (port) {
-      FuncExpr *func = port->function();
-      Instance *inst = network_->instance(pin);
-      PwrActivity activity = power_->evalActivity(func, inst);
-      power_->setPinActivity(pin, activity);
-      debugPrint3(debug_, "power_activity", 3, "set %s %.2e %.2f\n",
-		  vertex->name(network_),
-		  activity.activity(),
-		  activity.duty());
-    }
-  }
-  bfs_->enqueueAdjacentVertices(vertex);
+  // Vertices without activities of their own pass the visit through
+  // to their fanout.
+  if (changed || !evaled)
+    bfs_->enqueueAdjacentVertices(vertex);
 }
 
 PwrActivity
@@ -332,7 +719,7 @@ Power::evalActivity(FuncExpr *expr,
 {
   switch (expr->op()) {
   case FuncExpr::op_port: {
-    Pin *pin = network_->findPin(inst, expr->port()->name());
+    Pin *pin = network_->findPin(inst, expr->port());
     if (pin)
       return findActivity(pin);
     else
@@ -393,46 +780,127 @@ Power::ensureActivities()
 {
   if (!global_activity_.isSet()) {
     if (!activities_valid_) {
+      Stats stats(debug_);
+      invalid_activity_pins_.clear();
+      vertex_activities_.clear();
+      ensureVertexActivities();
       ActivitySrchPred activity_srch_pred(this);
       BfsFwdIterator bfs(BfsIndex::other, &activity_srch_pred, this);
       seedActivities(bfs);
-      PropActivityVisitor visitor(this, &bfs);
-      visitor.init();
-      bfs.visit(levelize_->maxLevel(), &visitor);
-      while (visitor.foundRegWithoutActivity()) {
-	InstanceSet *regs = visitor.stealVisitedRegs();
-	InstanceSet::Iterator reg_iter(regs);
-	while (reg_iter.hasNext()) {
-	  auto reg = reg_iter.next();
-	  // Propagate activiities across register D->Q.
-	  seedRegOutputActivities(reg, bfs);
-	}
-	delete regs;
-	visitor.init();
-	bfs.visit(levelize_->maxLevel(), &visitor);
-      }
+      propagateActivities(bfs);
       activities_valid_ = true;
+      stats.report("Propagate activities");
+    }
+    else if (!invalid_activity_pins_.empty()) {
+      // Only re-propagate the fanout of the pins that changed.
+      Stats stats(debug_);
+      debugPrint1(debug_, "power_activity", 1, "incremental %lu pins\n",
+		  invalid_activity_pins_.size());
+      ensureVertexActivities();
+      ActivitySrchPred activity_srch_pred(this);
+      BfsFwdIterator bfs(BfsIndex::other, &activity_srch_pred, this);
+      seedInvalidActivities(bfs);
+      invalid_activity_pins_.clear();
+      propagateActivities(bfs);
+      stats.report("Propagate incremental activities");
+    }
+  }
+}
+
+// Size vertex_activities_ for all of the graph vertices so the
+// propagation threads never have to grow it.
+void
+Power::ensureVertexActivities()
+{
+  size_t index_end = graph_->vertexIndexEnd();
+  if (index_end > vertex_activities_.size())
+    vertex_activities_.resize(index_end);
+}
+
+void
+Power::propagateActivities(BfsFwdIterator &bfs)
+{
+  PropActivityVisitor visitor(this, &bfs);
+  bfs.visitParallel(levelize_->maxLevel(), &visitor);
+  // Propagate activities across register D->Q. Each register is seeded
+  // at most once so loops through registers terminate.
+  while (!activity_regs_.empty()) {
+    InstanceSet regs;
+    regs.swap(activity_regs_);
+    InstanceSet::Iterator reg_iter(regs);
+    while (reg_iter.hasNext()) {
+      auto reg = reg_iter.next();
+      if (!seeded_regs_.hasKey(reg)) {
+	seeded_regs_.insert(reg);
+	seedRegOutputActivities(reg, bfs);
+      }
     }
+    bfs.visitParallel(levelize_->maxLevel(), &visitor);
   }
+  seeded_regs_.clear();
+}
+
+void
+Power::regActivityChanged(const Instance *reg)
+{
+  UniqueLock lock(activity_regs_lock_);
+  activity_regs_.insert(const_cast<Instance*>(reg));
 }
 
 void
 Power::seedActivities(BfsFwdIterator &bfs)
 {
-  for (auto vertex : levelize_->roots()) {
-    const Pin *pin = vertex->pin();
-    // Clock activities are baked in.
-    if (!sdc_->isVertexPinClock(pin)
-	&& network_->direction(pin) != PortDirection::internal()) {
-      debugPrint1(debug_, "power_activity", 3, "seed %s\n",
-		  vertex->name(network_));
-      PwrActivity &activity = pinActivity(pin);
-      PwrActivityOrigin origin = activity.origin();
-      // Default inputs without explicit activities to the input default.
-      if (origin != PwrActivityOrigin::user)
-	setPinActivity(pin, input_activity_);
-      Vertex *vertex = graph_->pinDrvrVertex(pin);
-      bfs.enqueueAdjacentVertices(vertex);
+  for (auto vertex : levelize_->roots())
+    seedRootActivity(vertex, bfs);
+}
+
+void
+Power::seedRootActivity(Vertex *vertex,
+			BfsFwdIterator &bfs)
+{
+  const Pin *pin = vertex->pin();
+  // Clock activities are baked in.
+  if (!sdc_->isVertexPinClock(pin)
+      && network_->direction(pin) != PortDirection::internal()) {
+    debugPrint1(debug_, "power_activity", 3, "seed %s\n",
+		vertex->name(network_));
+    // Default inputs without explicit activities to the input default.
+    PwrActivity activity = input_activity_;
+    bool exists;
+    PwrActivity user_activity;
+    activity_map_.findKey(pin, user_activity, exists);
+    if (exists && user_activity.origin() == PwrActivityOrigin::user)
+      activity = user_activity;
+    Vertex *drvr_vertex = graph_->pinDrvrVertex(pin);
+    setVertexActivity(drvr_vertex, activity);
+    bfs.enqueueAdjacentVertices(drvr_vertex);
+  }
+}
+
+void
+Power::seedInvalidActivities(BfsFwdIterator &bfs)
+{
+  PinSet::Iterator pin_iter(invalid_activity_pins_);
+  while (pin_iter.hasNext()) {
+    const Pin *pin = pin_iter.next();
+    Vertex *vertex, *bidirect_drvr_vertex;
+    graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+    if (vertex) {
+      Vertex *drvr_vertex = bidirect_drvr_vertex
+	? bidirect_drvr_vertex
+	: vertex;
+      if (drvr_vertex->isRoot())
+	seedRootActivity(drvr_vertex, bfs);
+      else {
+	debugPrint1(debug_, "power_activity", 3, "seed invalid %s\n",
+		    network_->pathName(pin));
+	bfs.enqueue(vertex);
+	bfs.enqueueAdjacentVertices(vertex);
+	if (bidirect_drvr_vertex) {
+	  bfs.enqueue(bidirect_drvr_vertex);
+	  bfs.enqueueAdjacentVertices(bidirect_drvr_vertex);
+	}
+      }
     }
   }
 }
@@ -445,8 +913,8 @@ Power::seedRegOutputActivities(const Instance *inst,
   LibertyCellSequentialIterator seq_iter(cell);
   while (seq_iter.hasNext()) {
     Sequential *seq = seq_iter.next();
-    seedRegOutputActivities(inst, seq, seq->output(), false);
-    seedRegOutputActivities(inst, seq, seq->outputInv(), true);
+    seedRegOutputActivities(inst, seq, seq->output(), false, bfs);
+    seedRegOutputActivities(inst, seq, seq->outputInv(), true, bfs);
     // Enqueue register output pins with functions that reference
     // the sequential internal pins (IQ, IQN).
     InstancePinIterator *pin_iter = network_->pinIterator(inst);
@@ -472,17 +940,65 @@ void
 Power::seedRegOutputActivities(const Instance *reg,
 			       Sequential *seq,
 			       LibertyPort *output,
-			       bool invert)
+			       bool invert,
+			       BfsFwdIterator &bfs)
 {
   const Pin *pin = network_->findPin(reg, output);
-  if (pin) {
+  PwrActivity user_activity;
+  if (pin
+      && !findUserActivity(pin, user_activity)) {
     PwrActivity activity = evalActivity(seq->data(), reg);
     if (invert)
       activity.set(activity.activity(),
 		   1.0 - activity.duty(),
 		   activity.origin());
-    setPinActivity(pin, activity);
+    Vertex *vertex = graph_->pinDrvrVertex(pin);
+    if (vertex
+	&& setVertexActivity(vertex, activity))
+      bfs.enqueueAdjacentVertices(vertex);
+  }
+}
+
+bool
+Power::findUserActivity(const Pin *pin,
+			 // Return value.
+			 PwrActivity &activity)
+{
+  bool exists;
+  activity_map_.findKey(pin, activity, exists);
+  return exists && activity.isSet();
+}
+
+PwrActivity
+Power::vertexActivity(Vertex *vertex)
+{
+  VertexIndex index = graph_->index(vertex);
+  if (index < vertex_activities_.size()) {
+    const PwrActivity &activity = vertex_activities_[index];
+    if (activity.isSet())
+      return activity;
+  }
+  PwrActivity activity;
+  bool exists;
+  activity_map_.findKey(vertex->pin(), activity, exists);
+  return activity;
+}
+
+bool
+Power::setVertexActivity(Vertex *vertex,
+			 const PwrActivity &activity)
+{
+  VertexIndex index = graph_->index(vertex);
+  if (index < vertex_activities_.size()) {
+    PwrActivity &prev = vertex_activities_[index];
+    bool changed = activity.activity() != prev.activity()
+      || activity.duty() != prev.duty()
+      || activity.origin() != prev.origin();
+    prev = activity;
+    return changed;
   }
+  else
+    return false;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -490,29 +1006,143 @@ Power::seedRegOutputActivities(const Instance *reg,
 void
 Power::power(const Instance *inst,
 	     LibertyCell *cell,
+	     PwrCellPlan *plan,
 	     const Corner *corner,
+	     ArcDelayCalc *arc_delay_calc,
 	     // Return values.
 	     PowerResult &result)
 {
   MinMax *mm = MinMax::max();
   const DcalcAnalysisPt *dcalc_ap = corner->findDcalcAnalysisPt(mm);
   const Clock *inst_clk = findInstClk(inst);
-  InstancePinIterator *pin_iter = network_->pinIterator(inst);
-  while (pin_iter->hasNext()) {
-    const Pin *to_pin = pin_iter->next();
-    const LibertyPort *to_port = network_->libertyPort(to_pin);
-    float load_cap = to_port->direction()->isAnyOutput()
-      ? graph_delay_calc_->loadCap(to_pin, dcalc_ap)
-      : 0.0;
-    PwrActivity activity = findClkedActivity(to_pin, inst_clk);
-    if (to_port->direction()->isAnyOutput())
-      findSwitchingPower(cell, to_port, activity, load_cap,
-			 dcalc_ap, result);
-    findInternalPower(to_pin, to_port, inst, cell, activity,
-		      load_cap, dcalc_ap, result);
+  for (PwrPortPlan *port_plan : plan->ports()) {
+    const LibertyPort *to_port = port_plan->port();
+    const Pin *to_pin = network_->findPin(inst, to_port);
+    if (to_pin) {
+      bool is_output = to_port->direction()->isAnyOutput();
+      float load_cap = is_output
+	? loadCap(to_pin, dcalc_ap, arc_delay_calc)
+	: 0.0;
+      PwrActivity activity = findClkedActivity(to_pin, inst_clk);
+      if (is_output)
+	findSwitchingPower(cell, port_plan, activity, load_cap,
+			   dcalc_ap, result);
+      findInternalPower(to_pin, port_plan, inst, cell, activity,
+			load_cap, dcalc_ap, result);
+    }
+  }
+  debugPrint2(debug_, "power", 2, "leakage %s %.3e\n",
+	      cell->name(),
+	      plan->leakage());
+  result.setLeakage(result.leakage() + plan->leakage());
+}
+
+// Load cap of to_pin using arc_delay_calc to find the parasitics
+// (GraphDelayCalc::loadCap uses the shared delay calculator).
+float
+Power::loadCap(const Pin *to_pin,
+	       const DcalcAnalysisPt *dcalc_ap,
+	       ArcDelayCalc *arc_delay_calc)
+{
+  const MinMax *min_max = dcalc_ap->constraintMinMax();
+  float load_cap = 0.0;
+  for (auto drvr_tr : TransRiseFall::range()) {
+    Parasitic *parasitic = arc_delay_calc->findParasitic(to_pin, drvr_tr,
+							 dcalc_ap);
+    float cap = graph_delay_calc_->loadCap(to_pin, parasitic, drvr_tr,
+					   dcalc_ap);
+    if (min_max->compare(cap, load_cap))
+      load_cap = cap;
+  }
+  arc_delay_calc->finishDrvrPin();
+  return load_cap;
+}
+
+void
+Power::transitionEnergies(const PinSeq &drvr_pins,
+			  const Corner *corner,
+			  // Return value.
+			  std::vector<float> &energies)
+{
+  preamble();
+  Stats stats(debug_);
+  const DcalcAnalysisPt *dcalc_ap =
+    corner->findDcalcAnalysisPt(MinMax::max());
+  for (const Pin *pin : drvr_pins) {
+    LibertyCell *cell = network_->libertyCell(network_->instance(pin));
+    if (cell)
+      cellPlan(cell);
+  }
+  energies.assign(drvr_pins.size() * TransRiseFall::index_count, 0.0);
+  size_t thread_count = threadCount();
+  if (thread_count > 1
+      && drvr_pins.size() >= power_parallel_min) {
+    forEachChunk(drvr_pins.size(), thread_count,
+		 [&] (size_t, size_t begin, size_t end) {
+      ArcDelayCalc *arc_delay_calc = arc_delay_calc_->copy();
+      transitionEnergies(drvr_pins, begin, end, dcalc_ap,
+			 arc_delay_calc, energies);
+      delete arc_delay_calc;
+    });
+  }
+  else
+    transitionEnergies(drvr_pins, 0, drvr_pins.size(), dcalc_ap,
+		       arc_delay_calc_, energies);
+  stats.report("Find transition energies");
+}
+
+void
+Power::transitionEnergies(const PinSeq &drvr_pins,
+			  size_t begin,
+			  size_t end,
+			  const DcalcAnalysisPt *dcalc_ap,
+			  ArcDelayCalc *arc_delay_calc,
+			  // Return value.
+			  std::vector<float> &energies)
+{
+  for (size_t i = begin; i < end; i++)
+    transitionEnergy(drvr_pins[i], dcalc_ap, arc_delay_calc,
+		     &energies[i * TransRiseFall::index_count]);
+}
+
+// The internal power tables are energy per transition. Duty weights
+// each rise/fall table by 1/2 in the average power, so the energy
+// of a single transition is twice the duty weighted table energy.
+void
+Power::transitionEnergy(const Pin *drvr_pin,
+			const DcalcAnalysisPt *dcalc_ap,
+			ArcDelayCalc *arc_delay_calc,
+			// Return values.
+			float *energy)
+{
+  const Instance *inst = network_->instance(drvr_pin);
+  LibertyCell *cell = network_->libertyCell(inst);
+  LibertyPort *to_port = network_->libertyPort(drvr_pin);
+  PwrCellPlan *plan = cell ? cell_plans_.findKey(cell) : nullptr;
+  PwrPortPlan *port_plan = plan ? plan->findPort(to_port) : nullptr;
+  if (port_plan) {
+    const Pvt *pvt = dcalc_ap->operatingConditions();
+    float load_cap = loadCap(drvr_pin, dcalc_ap, arc_delay_calc);
+    float volt = port_plan->pgVoltage().voltage(cell, dcalc_ap);
+    float switching = .5 * load_cap * volt * volt;
+    for (auto tr : TransRiseFall::range())
+      energy[tr->index()] = switching;
+    for (PwrInternalPlan *pwr_plan : port_plan->internalPowers()) {
+      const Pin *from_pin = network_->findPin(inst, pwr_plan->fromPort());
+      if (from_pin
+	  && pwr_plan->hasPower(cell, dcalc_ap)) {
+	Vertex *from_vertex = graph_->pinLoadVertex(from_pin);
+	float duty = internalDuty(pwr_plan, from_pin, from_vertex,
+				  drvr_pin, inst);
+	InternalPower *pwr = pwr_plan->internalPower();
+	for (auto tr : TransRiseFall::range()) {
+	  float slew = delayAsFloat(graph_->slew(from_vertex, tr,
+						 dcalc_ap->index()));
+	  energy[tr->index()] += 2.0 * pwr->power(tr, pvt, slew, load_cap) * duty;
+	}
+      }
+    }
   }
-  delete pin_iter;
-  findLeakagePower(inst, cell, result);
 }
 
 const Clock *
@@ -532,7 +1162,7 @@ Power::findInstClk(const Instance *inst)
 
 void
 Power::findInternalPower(const Pin *to_pin,
-			 const LibertyPort *to_port,
+			 PwrPortPlan *port_plan,
 			 const Instance *inst,
 			 LibertyCell *cell,
 			 PwrActivity &to_activity,
@@ -541,6 +1171,7 @@ Power::findInternalPower(const Pin *to_pin,
 			 // Return values.
 			 PowerResult &result)
 {
+  const LibertyPort *to_port = port_plan->port();
   debugPrint3(debug_, "power", 2, "internal %s/%s (%s)\n",
 	      network_->pathName(inst),
 	      to_port->name(),
@@ -550,80 +1181,76 @@ Power::findInternalPower(const Pin *to_pin,
 	      units_->capacitanceUnit()->asString(load_cap));
   debugPrint0(debug_, "power", 2, "       when act/ns duty  energy    power\n");
   float internal = 0.0;
-  LibertyCellInternalPowerIterator pwr_iter(cell);
-  while (pwr_iter.hasNext()) {
-    InternalPower *pwr = pwr_iter.next();
-    if (pwr->port() == to_port) {
-      const char *related_pg_pin = pwr->relatedPgPin();
-      const LibertyPort *from_port = pwr->relatedPort();
-      FuncExpr *when = pwr->when();
-      FuncExpr *infered_when = nullptr;
-      if (from_port) {
-	if (when == nullptr) {
-	  FuncExpr *func = to_port->function();
-	  if (func)
-	    infered_when = inferedWhen(func, from_port);
-	}
-      }
-      else
-	from_port = to_port;
-      // If all the "when" clauses exist VSS internal power is ignored.
-      const Pin *from_pin = network_->findPin(inst, from_port);
-      if (from_pin
-	  && ((when && internalPowerMissingWhen(cell, to_port, related_pg_pin))
-	      || pgNameVoltage(cell, related_pg_pin, dcalc_ap) != 0.0)) {
-	Vertex *from_vertex = graph_->pinLoadVertex(from_pin);
-	float duty;
-	if (infered_when) {
-	  PwrActivity from_activity = findActivity(from_pin);
-	  PwrActivity to_activity = findActivity(to_pin);
-	  float duty1 = evalActivity(infered_when, inst).duty();
-	  if (to_activity.activity() == 0.0)
-	    duty = 0.0;
-	  else
-	    duty = from_activity.activity() / to_activity.activity() * duty1;
-	}
-	else if (when)
-	  duty = evalActivity(when, inst).duty();
-	else if (search_->isClock(from_vertex))
-	  duty = 1.0;
-	else
-	  duty = 0.5;
-	float port_energy = 0.0;
-	for (auto to_tr : TransRiseFall::range()) {
-	  // Should use unateness to find from_tr.
-	  TransRiseFall *from_tr = to_tr;
-	  float slew = delayAsFloat(graph_->slew(from_vertex,
-						 from_tr,
-						 dcalc_ap->index()));
-	  float table_energy = pwr->power(to_tr, pvt, slew, load_cap);
-	  float tr_energy = table_energy * duty;
-	  debugPrint4(debug_, "power", 3,  " %s energy = %9.2e * %.2f = %9.2e\n",
-		      to_tr->shortName(),
-		      table_energy,
-		      duty,
-		      tr_energy);
-	  port_energy += tr_energy;
-	}
-	float port_internal = port_energy * to_activity.activity();
-	debugPrint8(debug_, "power", 2,  " %s -> %s %s  %.2f %.2f %9.2e %9.2e %s\n",
-		    from_port->name(),
-		    to_port->name(),
-		    when ? when->asString() : (infered_when ? infered_when->asString() : "    "),
-		    to_activity.activity() * 1e-9,
+  for (PwrInternalPlan *pwr_plan : port_plan->internalPowers()) {
+    InternalPower *pwr = pwr_plan->internalPower();
+    const char *related_pg_pin = pwr->relatedPgPin();
+    const LibertyPort *from_port = pwr_plan->fromPort();
+    FuncExpr *when = pwr->when();
+    FuncExpr *infered_when = pwr_plan->inferedWhen();
+    const Pin *from_pin = network_->findPin(inst, from_port);
+    if (from_pin
+	&& pwr_plan->hasPower(cell, dcalc_ap)) {
+      Vertex *from_vertex = graph_->pinLoadVertex(from_pin);
+      float duty = internalDuty(pwr_plan, from_pin, from_vertex, to_pin, inst);
+      float port_energy = 0.0;
+      for (auto to_tr : TransRiseFall::range()) {
+	// Should use unateness to find from_tr.
+	TransRiseFall *from_tr = to_tr;
+	float slew = delayAsFloat(graph_->slew(from_vertex,
+					       from_tr,
+					       dcalc_ap->index()));
+	float table_energy = pwr->power(to_tr, pvt, slew, load_cap);
+	float tr_energy = table_energy * duty;
+	debugPrint4(debug_, "power", 3,  " %s energy = %9.2e * %.2f = %9.2e\n",
+		    to_tr->shortName(),
+		    table_energy,
 		    duty,
-		    port_energy,
-		    port_internal,
-		    related_pg_pin ? related_pg_pin : "no pg_pin");
-	internal += port_internal;
+		    tr_energy);
+	port_energy += tr_energy;
       }
-      if (infered_when)
-	infered_when->deleteSubexprs();
+      float port_internal = port_energy * to_activity.activity();
+      debugPrint8(debug_, "power", 2,  " %s -> %s %s  %.2f %.2f %9.2e %9.2e %s\n",
+		  from_port->name(),
+		  to_port->name(),
+		  when ? when->asString() : (infered_when ? infered_when->asString() : "    "),
+		  to_activity.activity() * 1e-9,
+		  duty,
+		  port_energy,
+		  port_internal,
+		  related_pg_pin ? related_pg_pin : "no pg_pin");
+      internal += port_internal;
     }
   }
   result.setInternal(result.internal() + internal);
 }
 
+// Fraction of the to_pin transitions that use the internal power group.
+float
+Power::internalDuty(PwrInternalPlan *pwr_plan,
+		    const Pin *from_pin,
+		    Vertex *from_vertex,
+		    const Pin *to_pin,
+		    const Instance *inst)
+{
+  FuncExpr *when = pwr_plan->internalPower()->when();
+  FuncExpr *infered_when = pwr_plan->inferedWhen();
+  if (infered_when) {
+    PwrActivity from_activity = findActivity(from_pin);
+    PwrActivity to_activity = findActivity(to_pin);
+    float duty1 = evalActivity(infered_when, inst).duty();
+    if (to_activity.activity() == 0.0)
+      return 0.0;
+    else
+      return from_activity.activity() / to_activity.activity() * duty1;
+  }
+  else if (when)
+    return evalActivity(when, inst).duty();
+  else if (search_->isClock(from_vertex))
+    return 1.0;
+  else
+    return 0.5;
+}
+
 ////////////////////////////////////////////////////////////////
 
 static bool
@@ -718,11 +1345,8 @@ funcExprPortCount(FuncExpr *expr)
   return port_count;
 }
 
-void
-Power::findLeakagePower(const Instance *,
-			LibertyCell *cell,
-			// Return values.
-			PowerResult &result)
+float
+Power::findLeakagePower(LibertyCell *cell)
 {
   float cond_leakage = 0.0;
   bool found_cond = false;
@@ -772,19 +1396,20 @@ Power::findLeakagePower(const Instance *,
     leakage = cond_leakage;
   else if (found_default)
     leakage = default_leakage;
-  result.setLeakage(result.leakage() + leakage);
+  return leakage;
 }
 
 void
 Power::findSwitchingPower(LibertyCell *cell,
-			  const LibertyPort *to_port,
+			  PwrPortPlan *port_plan,
 			  PwrActivity &activity,
 			  float load_cap,
 			  const DcalcAnalysisPt *dcalc_ap,
 			  // Return values.
 			  PowerResult &result)
 {
-  float volt = portVoltage(cell, to_port, dcalc_ap);
+  const LibertyPort *to_port = port_plan->port();
+  float volt = port_plan->pgVoltage().voltage(cell, dcalc_ap);
   float switching = .5 * load_cap * volt * volt * activity.activity();
   debugPrint5(debug_, "power", 2, "switching %s/%s activity = %.2e volt = %.2f %.3e\n",
 	      cell->name(),
@@ -803,6 +1428,15 @@ Power::findClkedActivity(const Pin *pin)
   return findClkedActivity(pin, inst_clk);
 }
 
+const Clock *
+Power::findActivityClk(const Pin *pin)
+{
+  const Clock *clk = findClk(pin);
+  if (clk == nullptr)
+    clk = findInstClk(network_->instance(pin));
+  return clk;
+}
+
 PwrActivity
 Power::findClkedActivity(const Pin *pin,
 			 const Clock *inst_clk)
@@ -833,51 +1467,18 @@ Power::findActivity(const Pin *pin)
     return PwrActivity(2.0, 0.5, PwrActivityOrigin::clock);
   else if (global_activity_.isSet())
     return global_activity_;
-  else {
-    if (activity_map_.hasKey(pin)) {
-      PwrActivity &activity = activity_map_[pin];
-      if (activity.origin() != PwrActivityOrigin::unknown)
-	return activity;
-    }
+  else if (vertex) {
+    // Bidirect pin activities are found by their driver vertex.
+    PwrActivity activity = vertexActivity(graph_->pinDrvrVertex(pin));
+    if (activity.isSet())
+      return activity;
+    activity = vertexActivity(vertex);
+    if (activity.isSet())
+      return activity;
   }
   return input_activity_;
 }
 
-float
-Power::portVoltage(LibertyCell *cell,
-		   const LibertyPort *port,
-		   const DcalcAnalysisPt *dcalc_ap)
-{
-  return pgNameVoltage(cell, port->relatedPowerPin(), dcalc_ap);
-}
-
-float
-Power::pgNameVoltage(LibertyCell *cell,
-		     const char *pg_port_name,
-		     const DcalcAnalysisPt *dcalc_ap)
-{
-  if (pg_port_name) {
-    auto pg_port = cell->findPgPort(pg_port_name);
-    if (pg_port) {
-      auto volt_name = pg_port->voltageName();
-      auto library = cell->libertyLibrary();
-      float voltage;
-      bool exists;
-      library->supplyVoltage(volt_name, voltage, exists);
-      if (exists)
-	return voltage;
-    }
-  }
-
-  const Pvt *pvt = dcalc_ap->operatingConditions();
-  if (pvt == nullptr)
-    pvt = cell->libertyLibrary()->defaultOperatingConditions();
-  if (pvt)
-    return pvt->voltage();
-  else
-    return 0.0;
-}
-
 const Clock *
 Power::findClk(const Pin *to_pin)
 {
@@ -17,6 +17,8 @@
 #ifndef STA_POWER_H
 #define STA_POWER_H
 
+#include <mutex>
+#include <vector>
 #include "Sta.hh"
 
 namespace sta {
@@ -25,8 +27,16 @@ class PowerResult;
 class PwrActivity;
 class PropActivityVisitor;
 class BfsFwdIterator;
+class PwrCellPlan;
+class PwrPortPlan;
+class PwrInternalPlan;
+class PowerSums;
 
 typedef UnorderedMap<const Pin*,PwrActivity> PwrActivityMap;
+typedef std::vector<PwrActivity> PwrActivitySeq;
+typedef UnorderedMap<const LibertyCell*,PwrCellPlan*> PwrCellPlanMap;
+typedef Vector<PwrPortPlan*> PwrPortPlanSeq;
+typedef Vector<PwrInternalPlan*> PwrInternalPlanSeq;
 
 enum class PwrActivityOrigin
 {
@@ -49,7 +59,7 @@ public:
 		PwrActivityOrigin origin);
   float activity() const { return activity_; }
   float duty() const { return duty_; }
-  PwrActivityOrigin origin() { return origin_; }
+  PwrActivityOrigin origin() const { return origin_; }
   const char *originName() const;
   void set(float activity,
 	   float duty,
@@ -69,6 +79,8 @@ class Power : public StaState
 {
 public:
   Power(Sta *sta);
+  ~Power();
+  void clear();
   void power(const Corner *corner,
 	     // Return values.
 	     PowerResult &total,
@@ -97,18 +109,88 @@ public:
 		      PwrActivityOrigin origin);
   // Activity is toggles per second.
   PwrActivity findClkedActivity(const Pin *pin);
+  // Clock that pin activity is per cycle of, or nullptr if there is
+  // none. Requires arrivals.
+  const Clock *findActivityClk(const Pin *pin);
+  // Netlist edit notifications so only the fanout of the changed
+  // pins is re-propagated.
+  void connectPinAfter(const Pin *pin);
+  void disconnectPinBefore(const Pin *pin);
+  void deletePinBefore(const Pin *pin);
+  void pinSetFuncAfter(const Pin *pin);
+  // Clock activities depend on the constraints so everything is
+  // propagated again when they change.
+  void activitiesInvalid();
+  // Energy in joules of one rise and one fall transition of each
+  // driver pin, switching plus internal energy. The energy of the
+  // transitions summed over a run gives the same power as power()
+  // with the toggle rate of the run.
+  void transitionEnergies(const PinSeq &drvr_pins,
+			  const Corner *corner,
+			  // Return value indexed by
+			  // pin index * TransRiseFall::index_count + tr index.
+			  std::vector<float> &energies);
 
 protected:
   void preamble();
   void ensureActivities();
+  void activityInvalid(const Pin *pin);
+  void fanoutActivityInvalid(const Pin *drvr_pin);
+  void ensureVertexActivities();
+  void propagateActivities(BfsFwdIterator &bfs);
+  void seedInvalidActivities(BfsFwdIterator &bfs);
+  void seedRootActivity(Vertex *vertex,
+			BfsFwdIterator &bfs);
+  // Activity set with setPinActivity/setInputPortActivity.
+  bool findUserActivity(const Pin *pin,
+			// Return value.
+			PwrActivity &activity);
+  // Propagated activity of vertex, falling back to the user activity
+  // of the vertex pin.
+  PwrActivity vertexActivity(Vertex *vertex);
+  // Return true if the activity changed.
+  bool setVertexActivity(Vertex *vertex,
+			 const PwrActivity &activity);
+  void regActivityChanged(const Instance *reg);
 
+  void power(const InstanceSeq &insts,
+	     size_t begin,
+	     size_t end,
+	     const Corner *corner,
+	     ArcDelayCalc *arc_delay_calc,
+	     // Return value.
+	     PowerSums &sums);
   void power(const Instance *inst,
 	     LibertyCell *cell,
+	     PwrCellPlan *plan,
 	     const Corner *corner,
+	     ArcDelayCalc *arc_delay_calc,
 	     // Return values.
 	     PowerResult &result);
+  void transitionEnergies(const PinSeq &drvr_pins,
+			  size_t begin,
+			  size_t end,
+			  const DcalcAnalysisPt *dcalc_ap,
+			  ArcDelayCalc *arc_delay_calc,
+			  // Return value.
+			  std::vector<float> &energies);
+  void transitionEnergy(const Pin *drvr_pin,
+			const DcalcAnalysisPt *dcalc_ap,
+			ArcDelayCalc *arc_delay_calc,
+			// Return values indexed by tr index.
+			float *energy);
+  float internalDuty(PwrInternalPlan *pwr_plan,
+		     const Pin *from_pin,
+		     Vertex *from_vertex,
+		     const Pin *to_pin,
+		     const Instance *inst);
+  float loadCap(const Pin *to_pin,
+		const DcalcAnalysisPt *dcalc_ap,
+		ArcDelayCalc *arc_delay_calc);
+  PwrCellPlan *cellPlan(LibertyCell *cell);
+  PwrCellPlan *makeCellPlan(LibertyCell *cell);
   void findInternalPower(const Pin *to_pin,
-			 const LibertyPort *to_port,
+			 PwrPortPlan *port_plan,
 			 const Instance *inst,
 			 LibertyCell *cell,
 			 PwrActivity &to_activity,
@@ -116,12 +198,9 @@ protected:
 			 const DcalcAnalysisPt *dcalc_ap,
 			 // Return values.
 			 PowerResult &result);
-  void findLeakagePower(const Instance *inst,
-			LibertyCell *cell,
-			// Return values.
-			PowerResult &result);
+  float findLeakagePower(LibertyCell *cell);
   void findSwitchingPower(LibertyCell *cell,
-			  const LibertyPort *to_port,
+			  PwrPortPlan *port_plan,
 			  PwrActivity &activity,
 			  float load_cap,
 			  const DcalcAnalysisPt *dcalc_ap,
@@ -132,17 +211,12 @@ protected:
   PwrActivity findClkedActivity(const Pin *pin,
 				const Clock *inst_clk);
   PwrActivity findActivity(const Pin *pin);
-  float portVoltage(LibertyCell *cell,
-		    const LibertyPort *port,
-		    const DcalcAnalysisPt *dcalc_ap);
-  float pgNameVoltage(LibertyCell *cell,
-		      const char *pg_port_name,
-		      const DcalcAnalysisPt *dcalc_ap);
   void seedActivities(BfsFwdIterator &bfs);
   void seedRegOutputActivities(const Instance *reg,
 			       Sequential *seq,
 			       LibertyPort *output,
-			       bool invert);
+			       bool invert,
+			       BfsFwdIterator &bfs);
   void seedRegOutputActivities(const Instance *inst,
 			       BfsFwdIterator &bfs);
   PwrActivity evalActivity(FuncExpr *expr,
@@ -156,8 +230,20 @@ protected:
 private:
   PwrActivity global_activity_;
   PwrActivity input_activity_;
+  // User and input port activities.
   PwrActivityMap activity_map_;
+  // Propagated activities indexed by graph vertex index.
+  PwrActivitySeq vertex_activities_;
   bool activities_valid_;
+  // Pins with activities that changed since they were propagated.
+  PinSet invalid_activity_pins_;
+  // Registers with changed data input activities waiting to have
+  // their outputs seeded, and the ones already seeded by this propagation.
+  InstanceSet activity_regs_;
+  InstanceSet seeded_regs_;
+  std::mutex activity_regs_lock_;
+  // Power models resolved per liberty cell.
+  PwrCellPlanMap cell_plans_;
 
   friend class PropActivityVisitor;
 };
@@ -0,0 +1,491 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <limits>
+#include "Machine.hh"
+#include "Debug.hh"
+#include "Report.hh"
+#include "Stats.hh"
+#include "ThreadForEach.hh"
+#include "Units.hh"
+#include "Transition.hh"
+#include "Clock.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "PathAnalysisPt.hh"
+#include "PathVertex.hh"
+#include "Power.hh"
+#include "PowerWindows.hh"
+
+namespace sta {
+
+// Transition of a driver pin read from the VCD.
+class PwrWindowEvent
+{
+public:
+  PwrWindowEvent(double time,
+		 size_t pin_index,
+		 const TransRiseFall *tr);
+  // Seconds after the start of the run.
+  double time() const { return time_; }
+  size_t pinIndex() const { return pin_index_; }
+  // Index into the pin energies and arrivals.
+  size_t pinTrIndex() const
+  { return pin_index_ * TransRiseFall::index_count + tr_index_; }
+
+private:
+  // Scaled when the event is made so the window loop does not convert
+  // 64 bit integers, which has no AVX2 vector instruction.
+  double time_;
+  unsigned pin_index_;
+  unsigned tr_index_;
+};
+
+PwrWindowEvent::PwrWindowEvent(double time,
+			       size_t pin_index,
+			       const TransRiseFall *tr) :
+  time_(time),
+  pin_index_(pin_index),
+  tr_index_(tr->index())
+{
+}
+
+// Events are binned in batches of this size.
+static const size_t event_batch_size = 1 << 20;
+// Batches with at least this many events are binned with multiple threads.
+static const size_t event_parallel_min = 1 << 14;
+// Largest per thread window array used for a batch.
+static const size_t thread_energies_max = 1 << 22;
+// Event times past this many windows are binned in the last one.
+static const double window_index_max = std::numeric_limits<int>::max();
+
+// VCD reader that turns the value changes of bits mapped onto driver
+// pins into transition events.
+class PowerWindowsReader : public VcdReader
+{
+public:
+  PowerWindowsReader(const char *filename,
+		     const char *scope,
+		     PowerWindows *windows,
+		     Power *power);
+
+protected:
+  virtual void readFile();
+  virtual void setBitValue(VcdBit &bit,
+			   char value);
+  void mapBits();
+  void binEvents();
+
+  PowerWindows *windows_;
+  // Driver pin indices of bit index from bit_pin_starts_[index]
+  // to bit_pin_starts_[index + 1].
+  std::vector<size_t> bit_pin_starts_;
+  std::vector<size_t> bit_pins_;
+  PwrWindowEventSeq events_;
+};
+
+PowerWindowsReader::PowerWindowsReader(const char *filename,
+				       const char *scope,
+				       PowerWindows *windows,
+				       Power *power) :
+  VcdReader(filename, scope, power),
+  windows_(windows)
+{
+  annotates_activities_ = false;
+}
+
+void
+PowerWindowsReader::readFile()
+{
+  if (readHeader()) {
+    mapBits();
+    events_.reserve(event_batch_size);
+    readValueChanges();
+    binEvents();
+  }
+}
+
+// Number the driver pins of the bits and find their energies.
+void
+PowerWindowsReader::mapBits()
+{
+  PinSeq drvr_pins;
+  UnorderedMap<const Pin*, size_t> pin_index_map;
+  for (auto id_var : vars_) {
+    VcdVar *var = id_var.second;
+    for (int i = 0; i < var->width(); i++) {
+      VcdBit &bit = var->bit(i);
+      bit.setIndex(bit_pin_starts_.size());
+      bit_pin_starts_.push_back(bit_pins_.size());
+      for (Pin *pin : bit.pins()) {
+	if (network_->isDriver(pin)
+	    && network_->libertyPort(pin)) {
+	  size_t pin_index;
+	  bool exists;
+	  pin_index_map.findKey(pin, pin_index, exists);
+	  if (!exists) {
+	    pin_index = drvr_pins.size();
+	    pin_index_map[pin] = pin_index;
+	    drvr_pins.push_back(pin);
+	  }
+	  bit_pins_.push_back(pin_index);
+	}
+      }
+    }
+  }
+  bit_pin_starts_.push_back(bit_pins_.size());
+  debugPrint1(debug_, "power_windows", 1, "%lu driver pins\n",
+	      drvr_pins.size());
+  windows_->findPinData(drvr_pins);
+}
+
+void
+PowerWindowsReader::setBitValue(VcdBit &bit,
+				char value)
+{
+  char prev_value = bit.value();
+  bit.setValue(value, time_);
+  value = bit.value();
+  if (value != prev_value
+      && prev_value != 'x'
+      && value != 'x') {
+    const TransRiseFall *tr = (value == '1')
+      ? TransRiseFall::rise()
+      : TransRiseFall::fall();
+    size_t bit_index = bit.index();
+    for (size_t i = bit_pin_starts_[bit_index];
+	 i < bit_pin_starts_[bit_index + 1];
+	 i++) {
+      events_.push_back(PwrWindowEvent((time_ - start_time_) * time_scale_,
+				       bit_pins_[i], tr));
+      if (events_.size() == event_batch_size)
+	binEvents();
+    }
+  }
+}
+
+void
+PowerWindowsReader::binEvents()
+{
+  windows_->binEvents(events_);
+  events_.clear();
+}
+
+////////////////////////////////////////////////////////////////
+
+PowerWindows::PowerWindows(Power *power) :
+  StaState(power),
+  power_(power),
+  corner_(nullptr),
+  window_width_(0.0),
+  hier_depth_(0)
+{
+}
+
+PowerWindows::~PowerWindows()
+{
+}
+
+bool
+PowerWindows::findPower(const char *vcd_filename,
+			const char *scope,
+			float window_width,
+			int hier_depth,
+			const Corner *corner)
+{
+  Stats stats(debug_);
+  corner_ = corner;
+  window_width_ = window_width;
+  hier_depth_ = hier_depth;
+  groups_.clear();
+  group_map_.clear();
+  energies_.clear();
+  PowerWindowsReader reader(vcd_filename, scope, this, power_);
+  bool read = reader.read();
+  stats.report("Find power windows");
+  return read;
+}
+
+// The group of a pin is the hierarchical instance hier_depth_ levels
+// below the top instance above the pin, or the parent of the pin
+// instance if it is not that deep.
+size_t
+PowerWindows::findGroup(const Pin *pin)
+{
+  InstanceSeq path;
+  const Instance *inst = network_->instance(pin);
+  Instance *parent = network_->parent(inst);
+  while (parent) {
+    path.push_back(parent);
+    parent = network_->parent(parent);
+  }
+  // path is from the pin instance parent up to the top instance.
+  size_t depth = std::min(static_cast<size_t>(hier_depth_), path.size() - 1);
+  const Instance *group = path[path.size() - 1 - depth];
+  size_t group_index;
+  bool exists;
+  group_map_.findKey(group, group_index, exists);
+  if (!exists) {
+    group_index = groups_.size();
+    group_map_[group] = group_index;
+    groups_.push_back(const_cast<Instance*>(group));
+  }
+  return group_index;
+}
+
+void
+PowerWindows::findPinData(const PinSeq &pins)
+{
+  power_->transitionEnergies(pins, corner_, pin_energies_);
+  pin_arrivals_.assign(pins.size() * TransRiseFall::index_count, 0.0);
+  pin_groups_.resize(pins.size());
+  for (size_t i = 0; i < pins.size(); i++) {
+    const Pin *pin = pins[i];
+    pin_groups_[i] = findGroup(pin);
+    // Latest arrival after the launching clock edge.
+    Vertex *vertex = graph_->pinDrvrVertex(pin);
+    VertexPathIterator path_iter(vertex, this);
+    while (path_iter.hasNext()) {
+      PathVertex *path = path_iter.next();
+      if (path->minMax(this) == MinMax::max()
+	  && path->pathAnalysisPt(this)->corner() == corner_) {
+	ClockEdge *clk_edge = path->clkEdge(this);
+	float arrival = delayAsFloat(path->arrival(this));
+	if (clk_edge)
+	  arrival -= clk_edge->time();
+	float &pin_arrival =
+	  pin_arrivals_[i * TransRiseFall::index_count
+			+ path->transition(this)->index()];
+	pin_arrival = std::max(pin_arrival, arrival);
+      }
+    }
+  }
+}
+
+// Smallest and largest event window. The reduction is on locals so it
+// vectorizes.
+static void
+windowRange(const int *windows,
+	    size_t count,
+	    // Return values.
+	    int &window_min,
+	    int &window_max)
+{
+  int min = windows[0];
+  int max = min;
+  for (size_t i = 0; i < count; i++) {
+    int window = windows[i];
+    min = std::min(min, window);
+    max = std::max(max, window);
+  }
+  window_min = min;
+  window_max = max;
+}
+
+// Events are in time order, so the windows of a batch are a narrow
+// band. Each thread sums a contiguous range of the events into its
+// own copy of the band and the copies are added to the series.
+//
+// The window of every event is found first in a loop without branches
+// or 64 bit integer conversions that the compiler vectorizes. Adding the
+// energies to the band is a scatter with conflicting indices, so that
+// loop stays scalar.
+void
+PowerWindows::binEvents(const PwrWindowEventSeq &events)
+{
+  if (events.empty())
+    return;
+  size_t event_count = events.size();
+  size_t group_count = groups_.size();
+  size_t thread_count = threadCount();
+  bool parallel = thread_count > 1 && event_count >= event_parallel_min;
+  event_windows_.resize(event_count);
+  if (parallel)
+    forEachChunk(event_count, thread_count,
+		 [&] (size_t, size_t begin, size_t end) {
+      findEventWindows(events, begin, end);
+    });
+  else
+    findEventWindows(events, 0, event_count);
+
+  int window_min, window_max;
+  windowRange(event_windows_.data(), event_count, window_min, window_max);
+  size_t energy_count = (static_cast<size_t>(window_max) + 1) * group_count;
+  if (energies_.size() < energy_count)
+    energies_.resize(energy_count, 0.0);
+  size_t band_size = (window_max - window_min + 1) * group_count;
+  if (parallel
+      && band_size * thread_count <= thread_energies_max) {
+    std::vector<std::vector<double>> thread_energies(thread_count);
+    forEachChunk(event_count, thread_count,
+		 [&] (size_t i, size_t begin, size_t end) {
+      thread_energies[i].assign(band_size, 0.0);
+      binEvents(events, begin, end, window_min, thread_energies[i]);
+    });
+    float *band = &energies_[window_min * group_count];
+    for (std::vector<double> &energies : thread_energies) {
+      if (!energies.empty()) {
+	for (size_t i = 0; i < band_size; i++)
+	  band[i] += energies[i];
+      }
+    }
+  }
+  else {
+    std::vector<double> energies(band_size, 0.0);
+    binEvents(events, 0, event_count, window_min, energies);
+    float *band = &energies_[window_min * group_count];
+    for (size_t i = 0; i < band_size; i++)
+      band[i] += energies[i];
+  }
+}
+
+// Event time plus the pin arrival divided by the window width.
+void
+PowerWindows::findEventWindows(const PwrWindowEventSeq &events,
+			       size_t begin,
+			       size_t end)
+{
+  const float *arrivals = pin_arrivals_.data();
+  int *windows = event_windows_.data();
+  for (size_t i = begin; i < end; i++) {
+    const PwrWindowEvent &event = events[i];
+    double time = event.time() + arrivals[event.pinTrIndex()];
+    windows[i] = static_cast<int>(std::min(std::max(time, 0.0) / window_width_,
+					   window_index_max));
+  }
+}
+
+void
+PowerWindows::binEvents(const PwrWindowEventSeq &events,
+			size_t begin,
+			size_t end,
+			int window_min,
+			// Return value.
+			std::vector<double> &energies)
+{
+  size_t group_count = groups_.size();
+  const int *windows = event_windows_.data();
+  for (size_t i = begin; i < end; i++) {
+    const PwrWindowEvent &event = events[i];
+    size_t group = pin_groups_[event.pinIndex()];
+    energies[(windows[i] - window_min) * group_count + group] +=
+      pin_energies_[event.pinTrIndex()];
+  }
+}
+
+size_t
+PowerWindows::windowCount() const
+{
+  if (groups_.empty())
+    return 0;
+  else
+    return energies_.size() / groups_.size();
+}
+
+const Instance *
+PowerWindows::group(size_t group_index) const
+{
+  return groups_[group_index];
+}
+
+float
+PowerWindows::windowTime(size_t window_index) const
+{
+  return window_index * window_width_;
+}
+
+float
+PowerWindows::power(size_t group_index,
+		    size_t window_index) const
+{
+  return energies_[window_index * groups_.size() + group_index]
+    / window_width_;
+}
+
+float
+PowerWindows::power(size_t window_index) const
+{
+  float power = 0.0;
+  for (size_t i = 0; i < groups_.size(); i++)
+    power += this->power(i, window_index);
+  return power;
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+PowerWindows::report(int digits,
+		     bool series)
+{
+  Unit *time_unit = units_->timeUnit();
+  size_t window_count = windowCount();
+  report_->print("Window %s, %lu windows\n",
+		 time_unit->asString(window_width_, digits),
+		 window_count);
+  if (window_count == 0)
+    return;
+  int field_width = std::max(digits + 6, 10);
+  report_->print("%-30s %*s %*s %*s\n",
+		 "Group",
+		 field_width, "Average",
+		 field_width, "Peak",
+		 field_width, "Peak Time");
+  report_->print("%s\n", std::string(30 + (field_width + 1) * 3, '-').c_str());
+  for (size_t g = 0; g <= groups_.size(); g++) {
+    // The last row is the sum of the groups.
+    bool is_total = (g == groups_.size());
+    float sum = 0.0;
+    float peak = 0.0;
+    size_t peak_window = 0;
+    for (size_t w = 0; w < window_count; w++) {
+      float pwr = is_total ? power(w) : power(g, w);
+      sum += pwr;
+      if (pwr > peak) {
+	peak = pwr;
+	peak_window = w;
+      }
+    }
+    const char *name = is_total
+      ? "Total"
+      : (network_->isTopInstance(groups_[g])
+	 ? network_->name(groups_[g])
+	 : network_->pathName(groups_[g]));
+    report_->print("%-30s %*.*e %*.*e %*s\n",
+		   name,
+		   field_width, digits, sum / window_count,
+		   field_width, digits, peak,
+		   field_width,
+		   time_unit->asString(windowTime(peak_window), digits));
+  }
+  if (series) {
+    report_->print("\n%*s", field_width, "Time");
+    for (size_t g = 0; g < groups_.size(); g++)
+      report_->print(" %s", network_->isTopInstance(groups_[g])
+		     ? network_->name(groups_[g])
+		     : network_->pathName(groups_[g]));
+    report_->print(" Total\n");
+    for (size_t w = 0; w < window_count; w++) {
+      report_->print("%*s", field_width,
+		     time_unit->asString(windowTime(w), digits));
+      for (size_t g = 0; g < groups_.size(); g++)
+	report_->print(" %.*e", digits, power(g, w));
+      report_->print(" %.*e\n", digits, power(w));
+    }
+  }
+}
+
+} // namespace
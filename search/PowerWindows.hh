@@ -0,0 +1,113 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_POWER_WINDOWS_H
+#define STA_POWER_WINDOWS_H
+
+#include <vector>
+#include "DisallowCopyAssign.hh"
+#include "UnorderedMap.hh"
+#include "NetworkClass.hh"
+#include "StaState.hh"
+#include "VcdReader.hh"
+
+namespace sta {
+
+class Power;
+class Corner;
+class PowerWindowsReader;
+class PwrWindowEvent;
+
+typedef std::vector<PwrWindowEvent> PwrWindowEventSeq;
+typedef UnorderedMap<const Instance*, size_t> PwrWindowGroupMap;
+
+// Power in consecutive time windows of a VCD simulation run.
+//
+// Every driver pin transition in the VCD adds the switching and
+// internal energy of the transition to the window it falls in.
+// Transitions are delayed by the arrival of the pin relative to its
+// clock edge so zero delay (RTL) simulation events land where the
+// pin switches in the cycle. Energy is summed by the hierarchical
+// instance hier_depth levels below the top instance, so the result is
+// a series of window powers per hierarchy group.
+//
+// Value changes are binned in fixed size batches as they are read so
+// memory use is bounded by the window series and not the length of
+// the run.
+class PowerWindows : public StaState
+{
+public:
+  explicit PowerWindows(Power *power);
+  ~PowerWindows();
+  // Return true if the file was read.
+  bool findPower(const char *vcd_filename,
+		 const char *scope,
+		 float window_width,
+		 int hier_depth,
+		 const Corner *corner);
+  void report(int digits,
+	      bool series);
+  size_t windowCount() const;
+  size_t groupCount() const { return groups_.size(); }
+  // Hierarchical instance of group_index.
+  const Instance *group(size_t group_index) const;
+  // Start time of window_index relative to the start of the run.
+  float windowTime(size_t window_index) const;
+  // Average power of a group in a window (watts).
+  float power(size_t group_index,
+	      size_t window_index) const;
+  // Power of all groups in a window.
+  float power(size_t window_index) const;
+
+protected:
+  size_t findGroup(const Pin *pin);
+  void findPinData(const PinSeq &pins);
+  void binEvents(const PwrWindowEventSeq &events,
+		 size_t begin,
+		 size_t end,
+		 int window_min,
+		 // Return value indexed by
+		 // (window index - window_min) * group count + group index.
+		 std::vector<double> &energies);
+  void binEvents(const PwrWindowEventSeq &events);
+  void findEventWindows(const PwrWindowEventSeq &events,
+			size_t begin,
+			size_t end);
+
+  Power *power_;
+  const Corner *corner_;
+  float window_width_;
+  int hier_depth_;
+  InstanceSeq groups_;
+  PwrWindowGroupMap group_map_;
+  // Pin energy and arrival indexed by
+  // pin index * TransRiseFall::index_count + tr index.
+  std::vector<float> pin_energies_;
+  std::vector<float> pin_arrivals_;
+  std::vector<size_t> pin_groups_;
+  // Energy in joules indexed by window index * group count + group index.
+  std::vector<float> energies_;
+  // Window index of each event in the batch being binned.
+  std::vector<int> event_windows_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(PowerWindows);
+
+  friend class PowerWindowsReader;
+};
+
+} // namespace
+#endif
@@ -0,0 +1,810 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include "Machine.hh"
+#include "Debug.hh"
+#include "Fuzzy.hh"
+#include "TimingRole.hh"
+#include "TimingArc.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "Corner.hh"
+#include "DcalcAnalysisPt.hh"
+#include "GraphDelayCalc.hh"
+#include "PathVertex.hh"
+#include "PathVertexRep.hh"
+#include "PathEnumed.hh"
+#include "PathAnalysisPt.hh"
+#include "Tag.hh"
+#include "TagGroup.hh"
+#include "SearchPred.hh"
+#include "Latches.hh"
+#include "Levelize.hh"
+#include "Search.hh"
+#include "RegionTiming.hh"
+
+namespace sta {
+
+static void
+setTagArrival(TagGroupBldr *tag_bldr,
+	      Tag *to_tag,
+	      const Arrival &to_arrival,
+	      const MinMax *min_max);
+
+// Find arrivals for region vertices from arrivals in the region
+// and search arrivals outside of it.
+class RegionArrivalVisitor : public PathVisitor
+{
+public:
+  RegionArrivalVisitor(RegionTiming *region,
+		       const MinMax *min_max,
+		       const StaState *sta);
+  virtual VertexVisitor *copy();
+  virtual void visit(Vertex *vertex);
+
+protected:
+  virtual bool visitEdge(const Pin *from_pin,
+			 Vertex *from_vertex,
+			 Edge *edge,
+			 const Pin *to_pin,
+			 Vertex *to_vertex);
+  void visitRegionArc(Vertex *from_vertex,
+		      Tag *from_tag,
+		      const Arrival &from_arrival,
+		      Edge *edge,
+		      TimingArc *arc,
+		      Vertex *to_vertex);
+  virtual bool visitFromToPath(const Pin *from_pin,
+			       Vertex *from_vertex,
+			       const TransRiseFall *from_tr,
+			       Tag *from_tag,
+			       PathVertex *from_path,
+			       Edge *edge,
+			       TimingArc *arc,
+			       ArcDelay arc_delay,
+			       Vertex *to_vertex,
+			       const TransRiseFall *to_tr,
+			       Tag *to_tag,
+			       Arrival &to_arrival,
+			       const MinMax *min_max,
+			       const PathAnalysisPt *path_ap);
+  void setArrival(Tag *to_tag,
+		  const Arrival &to_arrival,
+		  const MinMax *min_max);
+
+  RegionTiming *region_;
+  const MinMax *min_max_;
+  TagGroupBldr *tag_bldr_;
+};
+
+RegionArrivalVisitor::RegionArrivalVisitor(RegionTiming *region,
+					   const MinMax *min_max,
+					   const StaState *sta) :
+  PathVisitor(sta),
+  region_(region),
+  min_max_(min_max),
+  tag_bldr_(nullptr)
+{
+}
+
+VertexVisitor *
+RegionArrivalVisitor::copy()
+{
+  return new RegionArrivalVisitor(region_, min_max_, sta_);
+}
+
+void
+RegionArrivalVisitor::visit(Vertex *vertex)
+{
+  tag_bldr_ = region_->regionArrivals(vertex);
+  visitFaninPaths(vertex);
+}
+
+bool
+RegionArrivalVisitor::visitEdge(const Pin *from_pin,
+				Vertex *from_vertex,
+				Edge *edge,
+				const Pin *to_pin,
+				Vertex *to_vertex)
+{
+  TagGroupBldr *from_bldr = region_->regionArrivals(from_vertex);
+  if (from_bldr) {
+    TimingArcSet *arc_set = edge->timingArcSet();
+    ArrivalMap::Iterator arrival_iter(from_bldr->arrivalMap());
+    while (arrival_iter.hasNext()) {
+      Tag *from_tag;
+      int arrival_index;
+      arrival_iter.next(from_tag, arrival_index);
+      Arrival from_arrival = from_bldr->arrival(arrival_index);
+      TimingArc *arc1, *arc2;
+      arc_set->arcsFrom(from_tag->transition(), arc1, arc2);
+      visitRegionArc(from_vertex, from_tag, from_arrival, edge, arc1,
+		     to_vertex);
+      visitRegionArc(from_vertex, from_tag, from_arrival, edge, arc2,
+		     to_vertex);
+    }
+    return true;
+  }
+  else
+    // Search arrivals outside the region are not changed.
+    return PathVisitor::visitEdge(from_pin, from_vertex, edge,
+				  to_pin, to_vertex);
+}
+
+// Clock vertices are removed from the region (findArrivals) so region
+// arrivals only propagate thru data edges.
+void
+RegionArrivalVisitor::visitRegionArc(Vertex *from_vertex,
+				     Tag *from_tag,
+				     const Arrival &from_arrival,
+				     Edge *edge,
+				     TimingArc *arc,
+				     Vertex *to_vertex)
+{
+  if (arc) {
+    const TimingRole *role = edge->role();
+    const TransRiseFall *from_tr = from_tag->transition();
+    TransRiseFall *to_tr = arc->toTrans()->asRiseFall();
+    if (!from_tag->isClock()
+	&& !from_tag->isGenClkSrcPath()
+	&& role->genericRole() != TimingRole::regClkToQ()
+	&& searchThru(from_vertex, from_tr, edge, to_vertex, to_tr)) {
+      Search *search = sta_->search();
+      PathAnalysisPt *path_ap = from_tag->pathAnalysisPt(sta_);
+      const MinMax *min_max = path_ap->pathMinMax();
+      if (role == TimingRole::latchDtoQ()) {
+	// Same as PathVisitor::visitFromPath with the region D arrival.
+	if (min_max == MinMax::max()) {
+	  PathEnumed from_path(sta_->graph()->index(from_vertex),
+			       from_tag->index(), from_arrival,
+			       nullptr, nullptr);
+	  Tag *to_tag = nullptr;
+	  ArcDelay arc_delay;
+	  Arrival to_arrival;
+	  sta_->latches()->latchOutArrival(&from_path, arc, edge, path_ap,
+					   to_tag, arc_delay, to_arrival);
+	  if (to_tag) {
+	    to_tag = search->thruTag(to_tag, edge, to_tr, min_max, path_ap);
+	    if (to_tag)
+	      setArrival(to_tag, to_arrival, min_max);
+	  }
+	}
+      }
+      else {
+	ArcDelay arc_delay = search->deratedDelay(from_vertex, arc, edge,
+						  false, path_ap);
+	if (!fuzzyEqual(arc_delay, min_max->initValue())) {
+	  Tag *to_tag = search->thruTag(from_tag, edge, to_tr, min_max,
+					path_ap);
+	  if (to_tag)
+	    setArrival(to_tag, from_arrival + arc_delay, min_max);
+	}
+      }
+    }
+  }
+}
+
+bool
+RegionArrivalVisitor::visitFromToPath(const Pin *,
+				      Vertex *,
+				      const TransRiseFall *,
+				      Tag *,
+				      PathVertex *,
+				      Edge *,
+				      TimingArc *,
+				      ArcDelay,
+				      Vertex *,
+				      const TransRiseFall *,
+				      Tag *to_tag,
+				      Arrival &to_arrival,
+				      const MinMax *min_max,
+				      const PathAnalysisPt *)
+{
+  setArrival(to_tag, to_arrival, min_max);
+  return true;
+}
+
+void
+RegionArrivalVisitor::setArrival(Tag *to_tag,
+				 const Arrival &to_arrival,
+				 const MinMax *min_max)
+{
+  if (min_max == min_max_)
+    setTagArrival(tag_bldr_, to_tag, to_arrival, min_max);
+}
+
+static void
+setTagArrival(TagGroupBldr *tag_bldr,
+	      Tag *to_tag,
+	      const Arrival &to_arrival,
+	      const MinMax *min_max)
+{
+  Tag *tag_match;
+  Arrival arrival;
+  int arrival_index;
+  tag_bldr->tagMatchArrival(to_tag, tag_match, arrival, arrival_index);
+  if (tag_match == nullptr
+      || fuzzyGreater(to_arrival, arrival, min_max))
+    tag_bldr->setMatchArrival(to_tag, tag_match, to_arrival,
+			      arrival_index, nullptr);
+}
+
+////////////////////////////////////////////////////////////////
+
+// Find the clock arrivals of a vertex from the search arrivals of its
+// fanin and the current delays.
+class RegionClkArrivalVisitor : public PathVisitor
+{
+public:
+  RegionClkArrivalVisitor(TagGroupBldr *tag_bldr,
+			  const MinMax *min_max,
+			  const StaState *sta);
+  virtual VertexVisitor *copy();
+  virtual void visit(Vertex *vertex);
+
+protected:
+  virtual bool visitFromToPath(const Pin *from_pin,
+			       Vertex *from_vertex,
+			       const TransRiseFall *from_tr,
+			       Tag *from_tag,
+			       PathVertex *from_path,
+			       Edge *edge,
+			       TimingArc *arc,
+			       ArcDelay arc_delay,
+			       Vertex *to_vertex,
+			       const TransRiseFall *to_tr,
+			       Tag *to_tag,
+			       Arrival &to_arrival,
+			       const MinMax *min_max,
+			       const PathAnalysisPt *path_ap);
+
+  TagGroupBldr *tag_bldr_;
+  const MinMax *min_max_;
+};
+
+RegionClkArrivalVisitor::RegionClkArrivalVisitor(TagGroupBldr *tag_bldr,
+						 const MinMax *min_max,
+						 const StaState *sta) :
+  PathVisitor(sta),
+  tag_bldr_(tag_bldr),
+  min_max_(min_max)
+{
+}
+
+VertexVisitor *
+RegionClkArrivalVisitor::copy()
+{
+  return new RegionClkArrivalVisitor(tag_bldr_, min_max_, sta_);
+}
+
+void
+RegionClkArrivalVisitor::visit(Vertex *vertex)
+{
+  visitFaninPaths(vertex);
+}
+
+bool
+RegionClkArrivalVisitor::visitFromToPath(const Pin *,
+					 Vertex *,
+					 const TransRiseFall *,
+					 Tag *,
+					 PathVertex *,
+					 Edge *,
+					 TimingArc *,
+					 ArcDelay,
+					 Vertex *,
+					 const TransRiseFall *,
+					 Tag *to_tag,
+					 Arrival &to_arrival,
+					 const MinMax *min_max,
+					 const PathAnalysisPt *)
+{
+  if (min_max == min_max_
+      && to_tag->isClock())
+    setTagArrival(tag_bldr_, to_tag, to_arrival, min_max);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////
+
+class VertexLevelLess
+{
+public:
+  bool operator()(const Vertex *vertex1,
+		  const Vertex *vertex2) const;
+};
+
+bool
+VertexLevelLess::operator()(const Vertex *vertex1,
+			    const Vertex *vertex2) const
+{
+  return vertex1->level() < vertex2->level();
+}
+
+////////////////////////////////////////////////////////////////
+
+RegionSavedSlew::RegionSavedSlew(Vertex *vertex,
+				 const TransRiseFall *tr,
+				 DcalcAPIndex ap_index,
+				 const Slew &slew) :
+  vertex_(vertex),
+  tr_(tr),
+  ap_index_(ap_index),
+  slew_(slew)
+{
+}
+
+RegionSavedDelay::RegionSavedDelay(Edge *edge,
+				   const TimingArc *arc,
+				   DcalcAPIndex ap_index,
+				   const ArcDelay &delay) :
+  edge_(edge),
+  arc_(arc),
+  ap_index_(ap_index),
+  delay_(delay)
+{
+}
+
+////////////////////////////////////////////////////////////////
+
+RegionTiming::RegionTiming(const StaState *sta) :
+  StaState(sta)
+{
+}
+
+RegionTiming::~RegionTiming()
+{
+  clear();
+}
+
+void
+RegionTiming::clear()
+{
+  region_.deleteContentsClear();
+  region_vertices_.clear();
+}
+
+TagGroupBldr *
+RegionTiming::regionArrivals(Vertex *vertex) const
+{
+  return region_.findKey(vertex);
+}
+
+bool
+RegionTiming::findSlacks(InstanceSeq *changed_insts,
+			 VertexSeq *endpoints,
+			 const MinMax *min_max,
+			 // Return value.
+			 SlackSeq &slacks)
+{
+  findRegion(changed_insts, endpoints);
+  debugPrint1(debug_, "region", 1, "region vertices %lu\n",
+	      region_vertices_.size());
+  bool found = findArrivals(min_max);
+  if (found) {
+    slacks.resize(endpoints->size());
+    for (size_t i = 0; i < endpoints->size(); i++)
+      slacks[i] = endpointSlack((*endpoints)[i], min_max);
+  }
+  restoreDelays();
+  return found;
+}
+
+// The region is the intersection of the changed instance fanout and
+// the endpoint fanin. The fanin of the endpoints is found first so the
+// fanout is only followed inside of it.
+void
+RegionTiming::findRegion(InstanceSeq *changed_insts,
+			 VertexSeq *endpoints)
+{
+  clear();
+  VertexSet seeds;
+  for (auto inst : *changed_insts)
+    findSeeds(inst, seeds);
+  // The fanout of the seeds is at or above the lowest seed level unless
+  // it goes thru a latch D->Q edge, which is not levelized.
+  Level min_level = 0;
+  if (!levelize_->latchDtoQEdgesExist()) {
+    bool first = true;
+    for (auto seed : seeds) {
+      if (first || seed->level() < min_level)
+	min_level = seed->level();
+      first = false;
+    }
+  }
+  VertexSet fanin;
+  findFanin(endpoints, min_level, fanin);
+
+  SearchPred *pred = search_->evalPred();
+  VertexSeq queue;
+  for (auto seed : seeds) {
+    if (fanin.hasKey(seed)) {
+      region_[seed] = new TagGroupBldr(true, this);
+      queue.push_back(seed);
+    }
+  }
+  while (!queue.empty()) {
+    Vertex *vertex = queue.back();
+    queue.pop_back();
+    region_vertices_.push_back(vertex);
+    if (pred->searchFrom(vertex)) {
+      VertexOutEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *to_vertex = edge->to(graph_);
+	if (fanin.hasKey(to_vertex)
+	    && !region_.hasKey(to_vertex)
+	    && pred->searchThru(edge)
+	    && pred->searchTo(to_vertex)) {
+	  region_[to_vertex] = new TagGroupBldr(true, this);
+	  queue.push_back(to_vertex);
+	}
+      }
+    }
+  }
+  sort(region_vertices_, VertexLevelLess());
+}
+
+// Changed instance input pin capacitance changes the delays from the
+// drivers of the input nets, so they are seeds along with the instance
+// pins.
+void
+RegionTiming::findSeeds(Instance *inst,
+			VertexSet &seeds)
+{
+  InstancePinIterator *pin_iter = network_->pinIterator(inst);
+  while (pin_iter->hasNext()) {
+    Pin *pin = pin_iter->next();
+    Vertex *vertex, *bidirect_drvr_vertex;
+    graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
+    if (vertex)
+      seeds.insert(vertex);
+    if (bidirect_drvr_vertex)
+      seeds.insert(bidirect_drvr_vertex);
+    if (vertex && network_->isLoad(pin)) {
+      VertexInEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	if (edge->isWire())
+	  seeds.insert(edge->from(graph_));
+      }
+    }
+  }
+  delete pin_iter;
+}
+
+// Fanin of the endpoints at or above min_level.
+void
+RegionTiming::findFanin(VertexSeq *endpoints,
+			Level min_level,
+			VertexSet &fanin)
+{
+  SearchPred *pred = search_->evalPred();
+  VertexSeq queue;
+  for (auto end : *endpoints) {
+    if (end->level() >= min_level
+	&& !fanin.hasKey(end)) {
+      fanin.insert(end);
+      queue.push_back(end);
+    }
+  }
+  while (!queue.empty()) {
+    Vertex *vertex = queue.back();
+    queue.pop_back();
+    if (pred->searchTo(vertex)) {
+      VertexInEdgeIterator edge_iter(vertex, graph_);
+      while (edge_iter.hasNext()) {
+	Edge *edge = edge_iter.next();
+	Vertex *from_vertex = edge->from(graph_);
+	if (from_vertex->level() >= min_level
+	    && !fanin.hasKey(from_vertex)
+	    && pred->searchThru(edge)
+	    && pred->searchFrom(from_vertex)) {
+	  fanin.insert(from_vertex);
+	  queue.push_back(from_vertex);
+	}
+      }
+    }
+  }
+}
+
+void
+RegionTiming::removeRegionVertex(Vertex *vertex)
+{
+  delete region_.findKey(vertex);
+  region_.erase(vertex);
+}
+
+// Region vertices are visited in level order, so the fanin of a vertex
+// has region arrivals or unchanged search arrivals when it is visited.
+// The delays of a vertex are found from the region slews before its
+// arrivals.
+bool
+RegionTiming::findArrivals(const MinMax *min_max)
+{
+  RegionArrivalVisitor visitor(this, min_max, this);
+  VertexSet latch_outputs;
+  for (auto vertex : region_vertices_) {
+    if (search_->isGenClkSrc(vertex))
+      return false;
+    findDelays(vertex);
+    VertexInEdgeIterator edge_iter(vertex, graph_);
+    if (!edge_iter.hasNext())
+      // Arrivals at graph roots (ports) are seeded, so the delays in
+      // the region do not change them.
+      removeRegionVertex(vertex);
+    else if (search_->isClock(vertex)) {
+      // Clock pins of changed registers are in the region.
+      // Use their search arrivals if they are unchanged.
+      if (clkArrivalsUnchanged(vertex, min_max))
+	removeRegionVertex(vertex);
+      else
+	return false;
+    }
+    else {
+      regionArrivals(vertex)->init(vertex);
+      visitor.visit(vertex);
+      enqueueLatchOutputs(vertex, latch_outputs);
+    }
+  }
+  findLatchArrivals(visitor, latch_outputs);
+  return true;
+}
+
+// Latch D->Q edges are not levelized, so a latch Q with a lower level
+// than D is visited before the D arrivals are found. Like the arrival
+// search, the latch outputs and the region above them are visited
+// again until the latch D arrivals stop changing.
+void
+RegionTiming::findLatchArrivals(RegionArrivalVisitor &visitor,
+				VertexSet &latch_outputs)
+{
+  for (int pass = 2; !latch_outputs.empty(); pass++) {
+    Level first_level = 0;
+    bool first = true;
+    for (auto latch_output : latch_outputs) {
+      if (first || latch_output->level() < first_level)
+	first_level = latch_output->level();
+      first = false;
+    }
+    latch_outputs.clear();
+    debugPrint2(debug_, "region", 1, "latch pass %d from level %d\n",
+		pass, first_level);
+    for (auto vertex : region_vertices_) {
+      TagGroupBldr *prev_bldr = regionArrivals(vertex);
+      if (prev_bldr
+	  && vertex->level() >= first_level) {
+	findDelays(vertex);
+	TagGroupBldr *tag_bldr = new TagGroupBldr(true, this);
+	region_[vertex] = tag_bldr;
+	tag_bldr->init(vertex);
+	visitor.visit(vertex);
+	if (!regionArrivalsEqual(prev_bldr, tag_bldr))
+	  enqueueLatchOutputs(vertex, latch_outputs);
+	delete prev_bldr;
+      }
+    }
+  }
+}
+
+// Region latch outputs of the latch data vertex that are visited before it.
+void
+RegionTiming::enqueueLatchOutputs(Vertex *vertex,
+				  VertexSet &latch_outputs)
+{
+  if (network_->isLatchData(vertex->pin())) {
+    VertexOutEdgeIterator edge_iter(vertex, graph_);
+    while (edge_iter.hasNext()) {
+      Edge *edge = edge_iter.next();
+      Vertex *to_vertex = edge->to(graph_);
+      if (edge->role() == TimingRole::latchDtoQ()
+	  && to_vertex->level() < vertex->level()
+	  && region_.hasKey(to_vertex))
+	latch_outputs.insert(to_vertex);
+    }
+  }
+}
+
+bool
+RegionTiming::regionArrivalsEqual(TagGroupBldr *tag_bldr1,
+				  TagGroupBldr *tag_bldr2)
+{
+  if (tag_bldr1->arrivalMap()->size() != tag_bldr2->arrivalMap()->size())
+    return false;
+  ArrivalMap::Iterator arrival_iter(tag_bldr1->arrivalMap());
+  while (arrival_iter.hasNext()) {
+    Tag *tag;
+    int arrival_index;
+    arrival_iter.next(tag, arrival_index);
+    Tag *tag_match;
+    Arrival arrival2;
+    int arrival_index2;
+    tag_bldr2->tagMatchArrival(tag, tag_match, arrival2, arrival_index2);
+    if (tag_match == nullptr
+	|| !fuzzyEqual(tag_bldr1->arrival(arrival_index), arrival2))
+      return false;
+  }
+  return true;
+}
+
+// True if vertex only has clock arrivals and the clock arrivals found
+// with the current delays match the search arrivals.
+bool
+RegionTiming::clkArrivalsUnchanged(Vertex *vertex,
+				   const MinMax *min_max)
+{
+  TagGroupBldr clk_bldr(true, this);
+  clk_bldr.init(vertex);
+  RegionClkArrivalVisitor visitor(&clk_bldr, min_max, this);
+  visitor.visit(vertex);
+  size_t clk_path_count = 0;
+  VertexPathIterator path_iter(vertex, this);
+  while (path_iter.hasNext()) {
+    PathVertex *path = path_iter.next();
+    if (path->minMax(this) == min_max) {
+      Tag *tag = path->tag(this);
+      // Clock used as data.
+      if (!tag->isClock())
+	return false;
+      Tag *tag_match;
+      Arrival arrival;
+      int arrival_index;
+      clk_bldr.tagMatchArrival(tag, tag_match, arrival, arrival_index);
+      if (tag_match == nullptr
+	  || !fuzzyEqual(arrival, path->arrival(this)))
+	return false;
+      clk_path_count++;
+    }
+  }
+  return clk_path_count == clk_bldr.arrivalMap()->size();
+}
+
+Slack
+RegionTiming::endpointSlack(Vertex *vertex,
+			    const MinMax *min_max)
+{
+  TagGroupBldr *tag_bldr = regionArrivals(vertex);
+  Slack slack = MinMax::min()->initValue();
+  VertexPathIterator path_iter(vertex, this);
+  while (path_iter.hasNext()) {
+    PathVertex *path = path_iter.next();
+    if (path->minMax(this) == min_max
+	&& !path->requiredIsInitValue(this)) {
+      Arrival arrival = path->arrival(this);
+      if (tag_bldr) {
+	Tag *tag_match;
+	int arrival_index;
+	tag_bldr->tagMatchArrival(path->tag(this), tag_match,
+				  arrival, arrival_index);
+	if (tag_match == nullptr)
+	  continue;
+      }
+      Required required = path->required(this);
+      Slack path_slack = (min_max == MinMax::max())
+	? required - arrival
+	: arrival - required;
+      if (path_slack < slack)
+	slack = path_slack;
+    }
+  }
+  return slack;
+}
+
+////////////////////////////////////////////////////////////////
+
+// Find the delays of a driver in the region without notifying the
+// search, saving the slews and delays it changes so they can be
+// restored.
+void
+RegionTiming::findDelays(Vertex *vertex)
+{
+  const Pin *pin = vertex->pin();
+  if (!vertex->isRoot()
+      && network_->isLeaf(pin)
+      && vertex->isDriver(network_)) {
+    PinSet *drvrs = network_->drivers(pin);
+    if (drvrs && drvrs->size() > 1) {
+      // The delays of the drivers of a net with multiple drivers are
+      // found together.
+      for (auto drvr_pin : *drvrs) {
+	Vertex *drvr_vertex = graph_->pinDrvrVertex(drvr_pin);
+	if (drvr_vertex)
+	  saveDrvrDelays(drvr_vertex);
+      }
+      for (auto drvr_pin : *drvrs) {
+	Vertex *drvr_vertex = graph_->pinDrvrVertex(drvr_pin);
+	if (drvr_vertex)
+	  graph_delay_calc_->findDriverDelaysUnobserved(drvr_vertex);
+      }
+    }
+    else {
+      saveDrvrDelays(vertex);
+      graph_delay_calc_->findDriverDelaysUnobserved(vertex);
+    }
+  }
+}
+
+void
+RegionTiming::saveDrvrDelays(Vertex *drvr_vertex)
+{
+  if (!delays_saved_.hasKey(drvr_vertex)) {
+    delays_saved_.insert(drvr_vertex);
+    saveSlews(drvr_vertex);
+    VertexInEdgeIterator in_edge_iter(drvr_vertex, graph_);
+    while (in_edge_iter.hasNext()) {
+      Edge *edge = in_edge_iter.next();
+      saveArcDelays(edge);
+    }
+    VertexOutEdgeIterator out_edge_iter(drvr_vertex, graph_);
+    while (out_edge_iter.hasNext()) {
+      Edge *edge = out_edge_iter.next();
+      if (edge->isWire()) {
+	saveArcDelays(edge);
+	saveSlews(edge->to(graph_));
+      }
+    }
+  }
+}
+
+void
+RegionTiming::saveSlews(Vertex *vertex)
+{
+  for (auto dcalc_ap : corners_->dcalcAnalysisPts()) {
+    DcalcAPIndex ap_index = dcalc_ap->index();
+    for (auto tr : TransRiseFall::range())
+      saved_slews_.push_back(RegionSavedSlew(vertex, tr, ap_index,
+					     graph_->slew(vertex, tr,
+							  ap_index)));
+  }
+}
+
+void
+RegionTiming::saveArcDelays(Edge *edge)
+{
+  TimingArcSetArcIterator arc_iter(edge->timingArcSet());
+  while (arc_iter.hasNext()) {
+    TimingArc *arc = arc_iter.next();
+    for (auto dcalc_ap : corners_->dcalcAnalysisPts()) {
+      DcalcAPIndex ap_index = dcalc_ap->index();
+      saved_delays_.push_back(RegionSavedDelay(edge, arc, ap_index,
+					       graph_->arcDelay(edge, arc,
+								ap_index)));
+    }
+  }
+}
+
+// Restore in reverse order so the first saved value of a slew is the
+// one that is left.
+void
+RegionTiming::restoreDelays()
+{
+  for (auto iter = saved_delays_.rbegin();
+       iter != saved_delays_.rend();
+       iter++)
+    graph_->setArcDelay(iter->edge_, iter->arc_, iter->ap_index_,
+			iter->delay_);
+  for (auto iter = saved_slews_.rbegin();
+       iter != saved_slews_.rend();
+       iter++)
+    graph_->setSlew(iter->vertex_, iter->tr_, iter->ap_index_,
+		    iter->slew_);
+  saved_delays_.clear();
+  saved_slews_.clear();
+  delays_saved_.clear();
+}
+
+} // namespace
@@ -0,0 +1,139 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_REGION_TIMING_H
+#define STA_REGION_TIMING_H
+
+#include "DisallowCopyAssign.hh"
+#include "Vector.hh"
+#include "UnorderedMap.hh"
+#include "MinMax.hh"
+#include "Delay.hh"
+#include "NetworkClass.hh"
+#include "GraphClass.hh"
+#include "SearchClass.hh"
+#include "StaState.hh"
+
+namespace sta {
+
+class TagGroupBldr;
+class RegionArrivalVisitor;
+
+typedef UnorderedMap<Vertex*, TagGroupBldr*> VertexTagGroupBldrMap;
+
+// Vertex slew changed by the region delay calculation.
+class RegionSavedSlew
+{
+public:
+  RegionSavedSlew(Vertex *vertex,
+		  const TransRiseFall *tr,
+		  DcalcAPIndex ap_index,
+		  const Slew &slew);
+
+  Vertex *vertex_;
+  const TransRiseFall *tr_;
+  DcalcAPIndex ap_index_;
+  Slew slew_;
+};
+
+// Arc delay changed by the region delay calculation.
+class RegionSavedDelay
+{
+public:
+  RegionSavedDelay(Edge *edge,
+		   const TimingArc *arc,
+		   DcalcAPIndex ap_index,
+		   const ArcDelay &delay);
+
+  Edge *edge_;
+  const TimingArc *arc_;
+  DcalcAPIndex ap_index_;
+  ArcDelay delay_;
+};
+
+typedef Vector<RegionSavedSlew> RegionSavedSlewSeq;
+typedef Vector<RegionSavedDelay> RegionSavedDelaySeq;
+
+// What-if slacks for a set of endpoints after changing instances
+// (for example with Sta::replaceCell).
+// Delays and arrivals are only found for the region of vertices in the
+// fanout of the changed instances and the fanin of the endpoints.
+// Region arrivals are kept in the RegionTiming object. The slews and
+// delays of the region are restored after the slacks are found, and
+// the search and delay calculator are not notified of the changes,
+// so the next timing update still finds the effect of the change.
+// Arrivals outside the region and required times are the ones found
+// by the last update before the change.
+class RegionTiming : public StaState
+{
+public:
+  explicit RegionTiming(const StaState *sta);
+  ~RegionTiming();
+  // Return false if the change affects clock arrivals in the region,
+  // which requires a full arrival update. Clock pins of changed
+  // registers are in the region but do not need an update unless
+  // the clock network delays to them change.
+  // slacks is indexed by the endpoints index.
+  bool findSlacks(InstanceSeq *changed_insts,
+		  VertexSeq *endpoints,
+		  const MinMax *min_max,
+		  // Return value.
+		  SlackSeq &slacks);
+  // Number of vertices in the last region.
+  size_t regionVertexCount() const { return region_.size(); }
+  // Arrivals for vertex in the region (nullptr if not in region).
+  TagGroupBldr *regionArrivals(Vertex *vertex) const;
+
+protected:
+  void clear();
+  void findRegion(InstanceSeq *changed_insts,
+		  VertexSeq *endpoints);
+  void findSeeds(Instance *inst,
+		 VertexSet &seeds);
+  void findFanin(VertexSeq *endpoints,
+		 Level min_level,
+		 VertexSet &fanin);
+  bool findArrivals(const MinMax *min_max);
+  void findLatchArrivals(RegionArrivalVisitor &visitor,
+			 VertexSet &latch_outputs);
+  void enqueueLatchOutputs(Vertex *vertex,
+			   VertexSet &latch_outputs);
+  bool regionArrivalsEqual(TagGroupBldr *tag_bldr1,
+			   TagGroupBldr *tag_bldr2);
+  bool clkArrivalsUnchanged(Vertex *vertex,
+			    const MinMax *min_max);
+  void removeRegionVertex(Vertex *vertex);
+  Slack endpointSlack(Vertex *vertex,
+		      const MinMax *min_max);
+  void findDelays(Vertex *vertex);
+  void saveDrvrDelays(Vertex *drvr_vertex);
+  void saveSlews(Vertex *vertex);
+  void saveArcDelays(Edge *edge);
+  void restoreDelays();
+
+  VertexTagGroupBldrMap region_;
+  VertexSeq region_vertices_;
+  // Values to restore after the region delays are found.
+  RegionSavedSlewSeq saved_slews_;
+  RegionSavedDelaySeq saved_delays_;
+  VertexSet delays_saved_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(RegionTiming);
+};
+
+} // namespace
+#endif
@@ -14,10 +14,12 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include "Machine.hh"
 #include "Report.hh"
 #include "Error.hh"
 #include "StringUtil.hh"
+#include "ThreadForEach.hh"
 #include "Units.hh"
 #include "Fuzzy.hh"
 #include "TimingRole.hh"
@@ -117,26 +119,54 @@ ReportPath::ReportPath(StaState *sta) :
   no_split_(false),
   start_end_pt_width_(80),
   plus_zero_(nullptr),
-  minus_zero_(nullptr)
+  minus_zero_(nullptr),
+  own_fields_(true)
 {
   setDigits(2);
   makeFields();
   setReportFields(false, false, false, false);
 }
 
+ReportPath::ReportPath(const ReportPath *report,
+		       ArcDelayCalc *arc_delay_calc) :
+  StaState(report),
+  format_(report->format_),
+  fields_(report->fields_),
+  report_input_pin_(report->report_input_pin_),
+  report_net_(report->report_net_),
+  no_split_(report->no_split_),
+  digits_(report->digits_),
+  start_end_pt_width_(report->start_end_pt_width_),
+  field_description_(report->field_description_),
+  field_total_(report->field_total_),
+  field_incr_(report->field_incr_),
+  field_capacitance_(report->field_capacitance_),
+  field_slew_(report->field_slew_),
+  field_fanout_(report->field_fanout_),
+  field_edge_(report->field_edge_),
+  field_case_(report->field_case_),
+  plus_zero_(report->plus_zero_),
+  minus_zero_(report->minus_zero_),
+  own_fields_(false)
+{
+  arc_delay_calc_ = arc_delay_calc;
+}
+
 ReportPath::~ReportPath()
 {
-  delete field_description_;
-  delete field_total_;
-  delete field_incr_;
-  delete field_capacitance_;
-  delete field_slew_;
-  delete field_fanout_;
-  delete field_edge_;
-  delete field_case_;
+  if (own_fields_) {
+    delete field_description_;
+    delete field_total_;
+    delete field_incr_;
+    delete field_capacitance_;
+    delete field_slew_;
+    delete field_fanout_;
+    delete field_edge_;
+    delete field_case_;
 
-  stringDelete(plus_zero_);
-  stringDelete(minus_zero_);
+    stringDelete(plus_zero_);
+    stringDelete(minus_zero_);
+  }
 }
 
 void
@@ -317,31 +347,35 @@ ReportPath::reportPathEnd(PathEnd *end,
 			  PathEnd *prev_end)
 {
   string result;
+  reportPathEnd(end, prev_end, result);
+  report_->print(result);
+}
+
+void
+ReportPath::reportPathEnd(PathEnd *end,
+			  PathEnd *prev_end,
+			  string &result)
+{
   switch (format_) {
   case ReportPathFormat::full:
   case ReportPathFormat::full_clock:
   case ReportPathFormat::full_clock_expanded:
     end->reportFull(this, result);
-    report_->print(result);
-    report_->print("\n\n");
+    result += "\n\n";
     break;
   case ReportPathFormat::shorter:
     end->reportShort(this, result);
-    report_->print(result);
-    report_->print("\n\n");
+    result += "\n\n";
     break;
   case ReportPathFormat::endpoint:
-    reportEndpointHeader(end, prev_end);
+    reportEndpointHeader(end, prev_end, result);
     reportEndLine(end, result);
-    report_->print(result);
     break;
   case ReportPathFormat::summary:
     reportSummaryLine(end, result);
-    report_->print(result);
     break;
   case ReportPathFormat::slack_only:
     reportSlackOnly(end, result);
-    report_->print(result);
     break;
   default:
     internalError("unsupported path type");
@@ -349,27 +383,99 @@ ReportPath::reportPathEnd(PathEnd *end,
   }
 }
 
+const size_t ReportPath::report_batch_ends_ = 256;
+
 void
 ReportPath::reportPathEnds(PathEndSeq *ends)
+{
+  reportPathEnds(ends, false);
+}
+
+void
+ReportPath::reportPathEndsFormatted(PathEndSeq *ends)
+{
+  reportPathEnds(ends, true);
+}
+
+void
+ReportPath::reportPathEnds(PathEndSeq *ends,
+			   bool use_format)
 {
   reportPathEndHeader();
-  PathEndSeq::Iterator end_iter(ends);
-  PathEnd *prev_end = nullptr;
-  while (end_iter.hasNext()) {
-    PathEnd *end = end_iter.next();
-    reportEndpointHeader(end, prev_end);
-    string result;
-    end->reportFull(this, result);
-    report_->print(result);
-    report_->print("\n\n");
-    prev_end = end;
+  size_t end_count = ends->size();
+  size_t thread_count = std::max(thread_count_, 1);
+  // Bound the formatted text waiting to be printed.
+  size_t batch_size = report_batch_ends_ * thread_count;
+  std::vector<string> results;
+  string batch_text;
+  for (size_t batch_begin = 0; batch_begin < end_count;
+       batch_begin += batch_size) {
+    size_t batch_end = std::min(batch_begin + batch_size, end_count);
+    results.clear();
+    results.resize(batch_end - batch_begin);
+    // Format every thread_count'th end from first so long and short
+    // paths are spread over the threads.
+    auto report_ends = [=, &results] (ReportPath *report,
+				      size_t first) {
+      for (size_t i = first; i < batch_end; i += thread_count) {
+	PathEnd *prev_end = (i > 0) ? (*ends)[i - 1] : nullptr;
+	if (use_format)
+	  report->reportPathEnd((*ends)[i], prev_end,
+				results[i - batch_begin]);
+	else
+	  report->reportPathEndFull((*ends)[i], prev_end,
+				    results[i - batch_begin]);
+      }
+    };
+    if (thread_count > 1 && results.size() > 1) {
+      forEachThread(thread_count, [&] (size_t i) {
+	// Finding parasitics for load caps is not thread safe, so
+	// each thread reports with its own delay calculator.
+	ArcDelayCalc *arc_delay_calc =
+	  arc_delay_calc_ ? arc_delay_calc_->copy() : nullptr;
+	ReportPath thread_report(this, arc_delay_calc);
+	report_ends(&thread_report, batch_begin + i);
+	delete arc_delay_calc;
+      });
+    }
+    else
+      report_ends(this, batch_begin);
+    // Print the batch with one write.
+    size_t length = 0;
+    for (const string &result : results)
+      length += result.size();
+    batch_text.clear();
+    batch_text.reserve(length);
+    for (const string &result : results)
+      batch_text += result;
+    report_->print(batch_text);
   }
   reportPathEndFooter();
 }
 
+void
+ReportPath::reportPathEndFull(PathEnd *end,
+			      PathEnd *prev_end,
+			      string &result)
+{
+  reportEndpointHeader(end, prev_end, result);
+  end->reportFull(this, result);
+  result += "\n\n";
+}
+
 void
 ReportPath::reportEndpointHeader(PathEnd *end,
 				 PathEnd *prev_end)
+{
+  string result;
+  reportEndpointHeader(end, prev_end, result);
+  report_->print(result);
+}
+
+void
+ReportPath::reportEndpointHeader(PathEnd *end,
+				 PathEnd *prev_end,
+				 string &result)
 {
   PathGroup *prev_group = nullptr;
   if (prev_end)
@@ -377,16 +483,15 @@ ReportPath::reportEndpointHeader(PathEnd *end,
   PathGroup *group = search_->pathGroup(end);
   if (group != prev_group) {
     if (prev_group)
-      report_->print("\n");
+      result += "\n";
     const char *setup_hold = (end->minMax(this) == MinMax::min())
       ? "min_delay/hold"
       : "max_delay/setup";
-    report_->print("%s group %s\n\n",
-		   setup_hold,
-		   group->name());
-    string header;
-    reportEndHeader(header);
-    report_->print(header);
+    result += setup_hold;
+    result += " group ";
+    result += group->name();
+    result += "\n\n";
+    reportEndHeader(result);
   }
 }
 
@@ -2711,7 +2816,7 @@ ReportPath::reportPath5(const Path *path,
 	    else
 	      what2 = "(unconnected)";
 	  }
-	  float fanout = drvrFanout(vertex, min_max);
+	  float fanout = drvrFanout(vertex, min_max, this);
 	  reportLine(what2.c_str(), cap, field_blank_, fanout,
 		     field_blank_, field_blank_, false, min_max, nullptr,
 		     line_case, result);
@@ -2765,26 +2870,6 @@ ReportPath::descriptionField(Vertex *vertex)
   return stdstrPrint("%s (%s)", pin_name, name2);
 }
 
-float
-ReportPath::drvrFanout(Vertex *drvr,
-		       const MinMax *min_max)
-{
-  float fanout = 0.0;
-  VertexOutEdgeIterator iter(drvr, graph_);
-  while (iter.hasNext()) {
-    Edge *edge = iter.next();
-    Pin *pin = edge->to(graph_)->pin();
-    if (network_->isTopLevelPort(pin)) {
-      // Output port counts as a fanout.
-      Port *port = network_->port(pin);
-      fanout += sdc_->portExtFanout(port, min_max) + 1;
-    }
-    else
-      fanout++;
-  }
-  return fanout;
-}
-
 bool
 ReportPath::hasExtInputDriver(const Pin *pin,
 			      const TransRiseFall *tr,
@@ -2868,11 +2953,44 @@ float
 ReportPath::loadCap(Pin *drvr_pin,
 		    const TransRiseFall *tr,
 		    DcalcAnalysisPt *dcalc_ap)
+{
+  return drvrLoadCap(drvr_pin, tr, dcalc_ap, arc_delay_calc_, this);
+}
+
+float
+drvrLoadCap(const Pin *drvr_pin,
+	    const TransRiseFall *tr,
+	    const DcalcAnalysisPt *dcalc_ap,
+	    ArcDelayCalc *arc_delay_calc,
+	    const StaState *sta)
 {
   Parasitic *parasitic = nullptr;
-  if (arc_delay_calc_)
-    parasitic = arc_delay_calc_->findParasitic(drvr_pin, tr, dcalc_ap);
-  return graph_delay_calc_->loadCap(drvr_pin, parasitic, tr, dcalc_ap);
+  if (arc_delay_calc)
+    parasitic = arc_delay_calc->findParasitic(drvr_pin, tr, dcalc_ap);
+  return sta->graphDelayCalc()->loadCap(drvr_pin, parasitic, tr, dcalc_ap);
+}
+
+float
+drvrFanout(Vertex *drvr,
+	   const MinMax *min_max,
+	   const StaState *sta)
+{
+  const Graph *graph = sta->graph();
+  const Network *network = sta->network();
+  float fanout = 0.0;
+  VertexOutEdgeIterator iter(drvr, graph);
+  while (iter.hasNext()) {
+    Edge *edge = iter.next();
+    Pin *pin = edge->to(graph)->pin();
+    if (network->isTopLevelPort(pin)) {
+      // Output port counts as a fanout.
+      Port *port = network->port(pin);
+      fanout += sta->sdc()->portExtFanout(port, min_max) + 1;
+    }
+    else
+      fanout++;
+  }
+  return fanout;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -38,6 +38,11 @@ class ReportPath : public StaState
 {
 public:
   explicit ReportPath(StaState *sta);
+  // Copy of report used by a thread formatting path ends with its own
+  // copy of the delay calculator. The fields and options are shared
+  // with report.
+  ReportPath(const ReportPath *report,
+	     ArcDelayCalc *arc_delay_calc);
   virtual ~ReportPath();
   void setPathFormat(ReportPathFormat format);
   void setReportFieldOrder(StringSeq *field_names);
@@ -60,7 +65,14 @@ public:
   //   so headers are reported by group.
   void reportPathEnd(PathEnd *end,
 		     PathEnd *prev_end);
+  void reportPathEnd(PathEnd *end,
+		     PathEnd *prev_end,
+		     string &result);
+  // Header, group header and full report of each end and footer.
+  // The report format is not used.
   void reportPathEnds(PathEndSeq *ends);
+  // Header, reportPathEnd of each end and footer.
+  void reportPathEndsFormatted(PathEndSeq *ends);
   void reportPath(const Path *path);
 
   void reportShort(const PathEndUnconstrained *end,
@@ -174,6 +186,15 @@ protected:
 			 bool enabled);
   void reportEndpointHeader(PathEnd *end,
 			    PathEnd *prev_end);
+  void reportEndpointHeader(PathEnd *end,
+			    PathEnd *prev_end,
+			    string &result);
+  // Path ends are formatted by threadCount() threads and printed in order.
+  void reportPathEnds(PathEndSeq *ends,
+		      bool use_format);
+  void reportPathEndFull(PathEnd *end,
+			 PathEnd *prev_end,
+			 string &result);
   void reportShort(const PathEndUnconstrained *end,
 		   PathExpanded &expanded,
 		   string &result);
@@ -465,8 +486,6 @@ protected:
   float loadCap(Pin *drvr_pin,
 		const TransRiseFall *tr,
 		DcalcAnalysisPt *dcalc_ap);
-  float drvrFanout(Vertex *drvr,
-		   const MinMax *min_max);
   const char *mpwCheckHiLow(MinPulseWidthCheck *check);
   void reportSkewClkPath(const char *arrival_msg,
 			 const PathVertex *clk_path,
@@ -527,14 +546,33 @@ protected:
 
   const char *plus_zero_;
   const char *minus_zero_;
+  // False for the thread copies that share the fields and zero strings.
+  bool own_fields_;
 
   static const float field_blank_;
   static const float field_skip_;
+  // Path ends formatted by each thread before printing.
+  static const size_t report_batch_ends_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ReportPath);
 };
 
+// Load capacitance of drvr_pin including the parasitic found by
+// arc_delay_calc. Finding parasitics is not thread safe, so each
+// thread uses its own copy of the delay calculator.
+float
+drvrLoadCap(const Pin *drvr_pin,
+	    const TransRiseFall *tr,
+	    const DcalcAnalysisPt *dcalc_ap,
+	    ArcDelayCalc *arc_delay_calc,
+	    const StaState *sta);
+// Fanout of drvr. Top level output ports add their external fanout.
+float
+drvrFanout(Vertex *drvr,
+	   const MinMax *min_max,
+	   const StaState *sta);
+
 class ReportField
 {
 public:
@@ -0,0 +1,203 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Network.hh"
+#include "Power.hh"
+#include "ActivityReader.hh"
+
+namespace sta {
+
+using std::string;
+
+// SAIF (Switching Activity Interchange Format) reader.
+// Only the T1 (time at 1) and TC (toggle count) values of NET and PORT
+// signals are used.
+class SaifReader : public ActivityReader
+{
+public:
+  SaifReader(const char *filename,
+	     const char *scope,
+	     Power *power);
+
+protected:
+  virtual void readFile();
+  void readGroups();
+  void readGroup();
+  void readInstance();
+  void readSignals();
+  void readSignal(Instance *inst,
+		  const string &name);
+  void skipGroup();
+
+  string token_;
+  double duration_;
+};
+
+bool
+readSaif(const char *filename,
+	 const char *scope,
+	 Power *power)
+{
+  SaifReader reader(filename, scope, power);
+  return reader.read();
+}
+
+SaifReader::SaifReader(const char *filename,
+		       const char *scope,
+		       Power *power) :
+  ActivityReader(filename, scope, power),
+  duration_(0.0)
+{
+  paren_tokens_ = true;
+}
+
+void
+SaifReader::readFile()
+{
+  if (readToken(token_) && token_ == "("
+      && readToken(token_) && token_ == "SAIFILE")
+    readGroups();
+  else
+    report_->fileError(filename_, line_, "SAIFILE expected.\n");
+}
+
+// Read groups up to the paren closing the enclosing group.
+void
+SaifReader::readGroups()
+{
+  while (readToken(token_)) {
+    if (token_ == ")")
+      break;
+    else if (token_ == "(")
+      readGroup();
+  }
+}
+
+// Read a group following its open paren.
+void
+SaifReader::readGroup()
+{
+  if (readToken(token_)) {
+    if (token_ == "TIMESCALE") {
+      string timescale;
+      while (readToken(token_) && token_ != ")")
+	timescale += token_;
+      parseTimescale(timescale);
+    }
+    else if (token_ == "DURATION") {
+      if (readToken(token_) && token_ != ")") {
+	duration_ = strtod(token_.c_str(), nullptr);
+	skipGroup();
+      }
+    }
+    else if (token_ == "INSTANCE")
+      readInstance();
+    else if (token_ == "NET" || token_ == "PORT")
+      readSignals();
+    else if (token_ == "(") {
+      readGroup();
+      skipGroup();
+    }
+    else if (token_ != ")")
+      skipGroup();
+  }
+}
+
+// (INSTANCE ["design_name"] instance_name groups...)
+void
+SaifReader::readInstance()
+{
+  if (readToken(token_)
+      && token_[0] == '"')
+    readToken(token_);
+  if (token_ == ")")
+    return;
+  pushScope(token_);
+  readGroups();
+  popScope();
+}
+
+// (NET (name (T0 n) (T1 n) (TX n) (TC n) ...) ...)
+void
+SaifReader::readSignals()
+{
+  Instance *inst = scopeInstance();
+  while (readToken(token_)) {
+    if (token_ == ")")
+      break;
+    else if (token_ == "(") {
+      if (readToken(token_) && token_ != ")") {
+	string name = token_;
+	readSignal(inst, name);
+      }
+    }
+  }
+}
+
+void
+SaifReader::readSignal(Instance *inst,
+		       const string &name)
+{
+  double high_time = 0.0;
+  double toggles = 0.0;
+  bool has_toggles = false;
+  while (readToken(token_)) {
+    if (token_ == ")")
+      break;
+    else if (token_ == "(") {
+      if (readToken(token_) && token_ != ")") {
+	string key = token_;
+	if (readToken(token_) && token_ != ")") {
+	  double value = strtod(token_.c_str(), nullptr);
+	  if (key == "T1")
+	    high_time = value;
+	  else if (key == "TC") {
+	    toggles = value;
+	    has_toggles = true;
+	  }
+	  skipGroup();
+	}
+      }
+    }
+  }
+  if (inst && has_toggles) {
+    PinSeq pins;
+    findPins(inst, name, pins);
+    for (Pin *pin : pins)
+      annotate(pin, toggles, high_time, duration_);
+  }
+}
+
+// Skip to the paren closing the current group.
+void
+SaifReader::skipGroup()
+{
+  int depth = 0;
+  while (readToken(token_)) {
+    if (token_ == "(")
+      depth++;
+    else if (token_ == ")") {
+      if (depth == 0)
+	break;
+      depth--;
+    }
+  }
+}
+
+} // namespace
@@ -24,6 +24,8 @@
 #include "Debug.hh"
 #include "Error.hh"
 #include "Stats.hh"
+#include "Profiler.hh"
+#include "Trace.hh"
 #include "Fuzzy.hh"
 #include "TimingRole.hh"
 #include "FuncExpr.hh"
@@ -36,6 +38,7 @@
 #include "Graph.hh"
 #include "GraphCmp.hh"
 #include "Levelize.hh"
+#include "GraphDelayCalc.hh"
 #include "PortDelay.hh"
 #include "Clock.hh"
 #include "CycleAccting.hh"
@@ -252,6 +255,20 @@ Search::init(StaState *sta)
   filter_from_ = nullptr;
   filter_to_ = nullptr;
   found_downstream_clk_pins_ = false;
+  crpr_dominated_count_ = 0;
+  crpr_limit_count_ = 0;
+  crpr_limit_error_ = 0.0;
+  crpr_search_begin_ = 0.0;
+  crpr_search_time_ = 0.0;
+  journal_paths_ = false;
+  journal_paths_restorable_ = false;
+  invalid_count_ = 0;
+  propagated_invalid_count_ = 0;
+  propagate_invalid_depth_ = 0;
+  propagate_invalid_begin_ = 0;
+  exception_thru_vertices_valid_ = false;
+  exception_thru_serial_ = 0;
+  mode_paths_saved_ = false;
 }
 
 // Init "options".
@@ -261,6 +278,7 @@ Search::initVars()
   unconstrained_paths_ = false;
   crpr_path_pruning_enabled_ = true;
   crpr_approx_missing_requireds_ = true;
+  crpr_arrival_limit_ = 0;
 }
 
 Search::~Search()
@@ -286,6 +304,8 @@ Search::~Search()
   delete genclks_;
   deleteFilter();
   deletePathGroups();
+  journal_paths_map_.deleteContentsClear();
+  mode_paths_.deleteContentsClear();
 }
 
 void
@@ -313,6 +333,13 @@ Search::clear()
   deleteFilter();
   genclks_->clear();
   found_downstream_clk_pins_ = false;
+  journal_paths_ = false;
+  clearJournalPaths();
+  exception_thru_vertices_.clear();
+  exception_thru_pins_.clear();
+  exception_thru_insts_.clear();
+  exception_thru_nets_.clear();
+  exception_thru_vertices_valid_ = false;
 }
 
 bool
@@ -339,6 +366,46 @@ Search::setCrprApproxMissingRequireds(bool enabled)
   crpr_approx_missing_requireds_ = enabled;
 }
 
+int
+Search::crprArrivalLimit() const
+{
+  return crpr_arrival_limit_;
+}
+
+void
+Search::setCrprArrivalLimit(int limit)
+{
+  crpr_arrival_limit_ = limit;
+}
+
+void
+Search::crprArrivalsPruned(int dominated_count,
+			   int limit_count,
+			   float limit_error)
+{
+  UniqueLock lock(crpr_pruned_lock_);
+  crpr_dominated_count_ += dominated_count;
+  crpr_limit_count_ += limit_count;
+  crpr_limit_error_ = max(crpr_limit_error_, limit_error);
+}
+
+// Revisits of an incremental update prune the same arrivals again, so
+// the counts are reset for each arrival search.
+void
+Search::crprSearchBegin()
+{
+  crpr_dominated_count_ = 0;
+  crpr_limit_count_ = 0;
+  crpr_limit_error_ = 0.0;
+  crpr_search_begin_ = elapsedRunTime();
+}
+
+void
+Search::crprSearchEnd()
+{
+  crpr_search_time_ = elapsedRunTime() - crpr_search_begin_;
+}
+
 void
 Search::deleteTags()
 {
@@ -355,6 +422,9 @@ Search::deleteTags()
   tag_free_indices_.clear();
 
   clk_info_set_->deleteContentsClear();
+  check_crpr_->clear();
+  // Journaled paths reference the deleted tag groups.
+  journal_paths_restorable_ = false;
 }
 
 void
@@ -401,11 +471,17 @@ Search::deletePaths()
     }
     arrivals_exist_ = false;
   }
+  crpr_dominated_count_ = 0;
+  crpr_limit_count_ = 0;
+  crpr_limit_error_ = 0.0;
+  crpr_search_time_ = 0.0;
 }
 
 void
-Search::deletePaths1(Vertex *vertex)
+Search::deletePaths1(Vertex *vertex,
+		     VertexPathsSaveMap *thread_journal)
 {
+  journalPaths(vertex, thread_journal);
   Arrival *arrivals = vertex->arrivals();
   delete [] arrivals;
   vertex->setArrivals(nullptr);
@@ -418,12 +494,13 @@ Search::deletePaths1(Vertex *vertex)
 }
 
 void
-Search::deletePaths(Vertex *vertex)
+Search::deletePaths(Vertex *vertex,
+		    VertexPathsSaveMap *thread_journal)
 {
   tnsNotifyBefore(vertex);
   if (worst_slacks_)
     worst_slacks_->worstSlackNotifyBefore(vertex);
-  deletePaths1(vertex);
+  deletePaths1(vertex, thread_journal);
 }
 
 ////////////////////////////////////////////////////////////////
@@ -568,6 +645,8 @@ Search::deleteFilterClkInfos()
 void
 Search::findFilteredArrivals()
 {
+  propagateInvalidBegin();
+  crprSearchBegin();
   findArrivals1();
   seedFilterStarts();
   Level max_level = levelize_->maxLevel();
@@ -583,6 +662,8 @@ Search::findFilteredArrivals()
     debugPrint1(debug_, "search", 1, "found %d arrivals\n", arrival_count);
   }
   arrivals_exist_ = true;
+  crprSearchEnd();
+  propagateInvalidEnd();
 }
 
 class SeedFaninsThruHierPin : public HierPinThruVisitor
@@ -661,11 +742,298 @@ Search::deleteVertexBefore(Vertex *vertex)
     endpoints_->erase(vertex);
   if (invalid_endpoints_)
     invalid_endpoints_->erase(vertex);
+  // The vertex index can be reused by a new vertex.
+  if (exceptionThruVerticesValid()
+      && !exception_thru_vertices_.empty()) {
+    VertexIndex index = graph_->index(vertex);
+    if (index < exception_thru_vertices_.size())
+      exception_thru_vertices_[index] = true;
+  }
+}
+
+// Connecting a pin can add exception -thru edges to the loads on its
+// net and changes the net of leaf pins, so the -thru marks of the
+// pins connected to it are updated.
+void
+Search::connectPinAfter(Pin *pin,
+			const PinSet *thru_edge_loads)
+{
+  if (graph_
+      && exceptionThruVerticesValid()
+      && !exception_thru_vertices_.empty()) {
+    if (thru_edge_loads)
+      exception_thru_pins_.insertSet(thru_edge_loads);
+    PinConnectedPinIterator *pin_iter = network_->connectedPinIterator(pin);
+    while (pin_iter->hasNext()) {
+      Pin *pin1 = pin_iter->next();
+      if (network_->isLeaf(pin1))
+	setExceptionThruPin(pin1, network_->net(pin1));
+    }
+    delete pin_iter;
+    if (network_->isLeaf(pin))
+      setExceptionThruPin(pin, network_->net(pin));
+  }
+}
+
+// Disconnecting a pin only removes exception -thru edges, so other
+// pins on the net keep their (possibly conservative) marks.
+void
+Search::disconnectPinBefore(Pin *pin)
+{
+  if (graph_
+      && exceptionThruVerticesValid()
+      && !exception_thru_vertices_.empty()
+      && network_->isLeaf(pin))
+    setExceptionThruPin(pin, nullptr);
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+Search::setJournalPaths(bool journal)
+{
+  if (journal && !journal_paths_) {
+    clearJournalPaths();
+    journal_paths_restorable_ = true;
+  }
+  journal_paths_ = journal;
+}
+
+// The journal is only changed between levels so search threads can
+// look in it without locking.
+void
+Search::journalPaths(Vertex *vertex,
+		     VertexPathsSaveMap *thread_journal)
+{
+  // Saving paths is pointless once they cannot be restored.
+  if (journal_paths_ && journal_paths_restorable_
+      && !journal_paths_map_.hasKey(vertex)) {
+    if (thread_journal) {
+      if (!thread_journal->hasKey(vertex))
+	(*thread_journal)[vertex] = new VertexPathsSave(vertex, this);
+    }
+    else
+      journal_paths_map_[vertex] = new VertexPathsSave(vertex, this);
+  }
+}
+
+void
+Search::handJournalPaths(VertexPathsSaveMap *thread_journal)
+{
+  UniqueLock lock(thread_journals_lock_);
+  thread_journals_.push_back(thread_journal);
+}
+
+// A vertex is only visited by one thread in a level, so the first
+// journal to save it has the paths from before the pass.
+void
+Search::mergeJournalPaths()
+{
+  for (auto thread_journal : thread_journals_) {
+    for (auto vertex_save : *thread_journal) {
+      Vertex *vertex = vertex_save.first;
+      VertexPathsSave *save = vertex_save.second;
+      if (journal_paths_map_.hasKey(vertex))
+	delete save;
+      else
+	journal_paths_map_[vertex] = save;
+    }
+    delete thread_journal;
+  }
+  thread_journals_.clear();
+}
+
+void
+Search::restoreJournalPaths()
+{
+  bool journal = journal_paths_;
+  // Do not journal the restored paths.
+  journal_paths_ = false;
+  mergeJournalPaths();
+  for (auto vertex_save : journal_paths_map_) {
+    Vertex *vertex = vertex_save.first;
+    VertexPathsSave *save = vertex_save.second;
+    deletePaths(vertex);
+    save->restore(vertex);
+    tnsInvalid(vertex);
+  }
+  journal_paths_map_.deleteContentsClear();
+  journal_paths_ = journal;
+
+  // The restored arrivals and requireds are up to date.
+  arrival_iter_->clear();
+  required_iter_->clear();
+  invalid_arrivals_.clear();
+  invalid_requireds_.clear();
+  clearPendingLatchOutputs();
+  // Common clock paths were found for the discarded arrivals.
+  check_crpr_->clear();
+}
+
+void
+Search::clearJournalPaths()
+{
+  mergeJournalPaths();
+  journal_paths_map_.deleteContentsClear();
+}
+
+VertexPathsSave::VertexPathsSave(Vertex *vertex,
+				 const Search *search) :
+  tag_group_index_(vertex->tagGroupIndex()),
+  arrivals_(nullptr),
+  prev_paths_(nullptr),
+  has_requireds_(vertex->hasRequireds()),
+  crpr_path_pruning_disabled_(vertex->crprPathPruningDisabled()),
+  requireds_pruned_(vertex->requiredsPruned())
+{
+  TagGroup *tag_group = search->tagGroup(vertex);
+  Arrival *arrivals = vertex->arrivals();
+  if (tag_group && arrivals) {
+    int arrival_count = tag_group->arrivalCount();
+    int arrivals_size = has_requireds_ ? arrival_count * 2 : arrival_count;
+    arrivals_ = new Arrival[arrivals_size];
+    for (int i = 0; i < arrivals_size; i++)
+      arrivals_[i] = arrivals[i];
+    PathVertexRep *prev_paths = vertex->prevPaths();
+    if (prev_paths) {
+      prev_paths_ = new PathVertexRep[arrival_count];
+      for (int i = 0; i < arrival_count; i++)
+	prev_paths_[i] = prev_paths[i];
+    }
+  }
+}
+
+VertexPathsSave::VertexPathsSave(Vertex *vertex) :
+  tag_group_index_(vertex->tagGroupIndex()),
+  arrivals_(vertex->arrivals()),
+  prev_paths_(vertex->prevPaths()),
+  has_requireds_(vertex->hasRequireds()),
+  crpr_path_pruning_disabled_(vertex->crprPathPruningDisabled()),
+  requireds_pruned_(vertex->requiredsPruned())
+{
+  vertex->setArrivals(nullptr);
+  vertex->setPrevPaths(nullptr);
+  vertex->setTagGroupIndex(tag_group_index_max);
+  vertex->setHasRequireds(false);
+  vertex->setCrprPathPruningDisabled(false);
+  vertex->setRequiredsPruned(false);
+}
+
+VertexPathsSave::~VertexPathsSave()
+{
+  delete [] arrivals_;
+  delete [] prev_paths_;
+}
+
+void
+VertexPathsSave::restore(Vertex *vertex)
+{
+  vertex->setTagGroupIndex(tag_group_index_);
+  vertex->setArrivals(arrivals_);
+  vertex->setPrevPaths(prev_paths_);
+  vertex->setHasRequireds(has_requireds_);
+  vertex->setCrprPathPruningDisabled(crpr_path_pruning_disabled_);
+  vertex->setRequiredsPruned(requireds_pruned_);
+  // The vertex owns the arrays now.
+  arrivals_ = nullptr;
+  prev_paths_ = nullptr;
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+Search::saveModePaths()
+{
+  if (arrivals_exist_) {
+    // The vertices queued for the next pass are marked by flags on the
+    // vertices that the search of the new mode uses, so they are
+    // invalidated instead.
+    arrival_iter_->clear(invalid_arrivals_);
+    required_iter_->clear(invalid_requireds_);
+    VertexIterator vertex_iter(graph_);
+    while (vertex_iter.hasNext()) {
+      Vertex *vertex = vertex_iter.next();
+      if (vertex->arrivals()
+	  || vertex->tagGroupIndex() != tag_group_index_max)
+	mode_paths_[vertex] = new VertexPathsSave(vertex);
+    }
+    mode_paths_saved_ = true;
+    debugPrint1(debug_, "search", 1, "save mode paths %lu\n",
+		mode_paths_.size());
+  }
+  journal_paths_ = false;
+  clearJournalPaths();
+}
+
+void
+Search::restoreModePaths()
+{
+  if (mode_paths_saved_) {
+    debugPrint2(debug_, "search", 1,
+		"restore mode paths %lu delay changes %lu\n",
+		mode_paths_.size(),
+		mode_delay_changed_.size());
+    for (auto vertex_save : mode_paths_) {
+      Vertex *vertex = vertex_save.first;
+      VertexPathsSave *save = vertex_save.second;
+      save->restore(vertex);
+      delete save;
+    }
+    mode_paths_.clear();
+    mode_paths_saved_ = false;
+    for (auto vertex : mode_delay_changed_) {
+      arrivalInvalid(vertex);
+      requiredInvalid(vertex);
+    }
+    mode_delay_changed_.clear();
+  }
+}
+
+void
+Search::modeDelayChanged(Vertex *vertex)
+{
+  if (mode_paths_saved_) {
+    // Lock for StaDelayCalcObserver called by delay calc threads.
+    UniqueLock lock(mode_delay_changed_lock_);
+    mode_delay_changed_.insert(vertex);
+  }
+}
+
+void
+Search::deleteModePaths()
+{
+  if (arrivals_exist_) {
+    mode_paths_.deleteContentsClear();
+    mode_delay_changed_.clear();
+    mode_paths_saved_ = false;
+    // The vertices do not have the paths so only the search state
+    // is cleared.
+    arrivals_exist_ = false;
+    clk_arrivals_valid_ = false;
+    arrivals_at_endpoints_exist_ = false;
+    arrivals_seeded_ = false;
+    requireds_exist_ = false;
+    requireds_seeded_ = false;
+    invalid_arrivals_.clear();
+    invalid_requireds_.clear();
+    tns_exists_ = false;
+    clearWorstSlack();
+    invalid_tns_.clear();
+    endpointsInvalid();
+    deletePathGroups();
+    deleteTags();
+    clearPendingLatchOutputs();
+    deleteFilter();
+    genclks_->clear();
+    exception_thru_vertices_.clear();
+    exception_thru_vertices_valid_ = false;
+  }
 }
 
 void
 Search::arrivalsInvalid()
 {
+  invalid_count_++;
   if (arrivals_exist_) {
     debugPrint0(debug_, "search", 1, "arrivals invalid\n");
     // Delete paths to make sure no state is left over.
@@ -695,17 +1063,20 @@ void
 Search::requiredsInvalid()
 {
   debugPrint0(debug_, "search", 1, "requireds invalid\n");
+  invalid_count_++;
   requireds_exist_ = false;
   requireds_seeded_ = false;
   invalid_requireds_.clear();
   tns_exists_ = false;
   clearWorstSlack();
   invalid_tns_.clear();
+  journal_paths_restorable_ = false;
 }
 
 void
 Search::arrivalInvalid(Vertex *vertex)
 {
+  invalid_count_++;
   if (arrivals_exist_) {
     debugPrint1(debug_, "search", 2, "arrival invalid %s\n",
 		vertex->name(sdc_network_));
@@ -736,9 +1107,30 @@ Search::levelChangedBefore(Vertex *vertex)
   }
 }
 
+// The BFS queues are by level, so the queued vertices are invalidated
+// before all of the levels are found again.
+void
+Search::levelsChangedBefore()
+{
+  if (arrivals_exist_) {
+    arrival_iter_->clear(invalid_arrivals_);
+    required_iter_->clear(invalid_requireds_);
+  }
+}
+
+void
+Search::levelChangedAfter(Vertex *vertex)
+{
+  if (arrivals_exist_) {
+    arrivalInvalid(vertex);
+    requiredInvalid(vertex);
+  }
+}
+
 void
 Search::arrivalInvalid(const Pin *pin)
 {
+  invalid_count_++;
   if (graph_) {
     Vertex *vertex, *bidirect_drvr_vertex;
     graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
@@ -751,6 +1143,7 @@ Search::arrivalInvalid(const Pin *pin)
 void
 Search::requiredInvalid(Instance *inst)
 {
+  invalid_count_++;
   if (graph_) {
     InstancePinIterator *pin_iter = network_->pinIterator(inst);
     while (pin_iter->hasNext()) {
@@ -764,6 +1157,7 @@ Search::requiredInvalid(Instance *inst)
 void
 Search::requiredInvalid(const Pin *pin)
 {
+  invalid_count_++;
   if (graph_) {
     Vertex *vertex, *bidirect_drvr_vertex;
     graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
@@ -776,6 +1170,7 @@ Search::requiredInvalid(const Pin *pin)
 void
 Search::requiredInvalid(Vertex *vertex)
 {
+  invalid_count_++;
   if (requireds_exist_) {
     debugPrint1(debug_, "search", 2, "required invalid %s\n",
 		vertex->name(sdc_network_));
@@ -788,22 +1183,48 @@ Search::requiredInvalid(Vertex *vertex)
   }
 }
 
+void
+Search::propagateInvalidBegin()
+{
+  if (propagate_invalid_depth_++ == 0)
+    propagate_invalid_begin_ = timingInvalidCount();
+}
+
+void
+Search::propagateInvalidEnd()
+{
+  if (--propagate_invalid_depth_ == 0)
+    propagated_invalid_count_ += timingInvalidCount()
+      - propagate_invalid_begin_;
+}
+
+size_t
+Search::timingInvalidCount() const
+{
+  return graph_delay_calc_->invalidCount() + invalid_count_;
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
 Search::findClkArrivals()
 {
   if (!clk_arrivals_valid_) {
+    propagateInvalidBegin();
     genclks_->ensureInsertionDelays();
+    ProfilePhase phase(debug_, "clk_arrivals");
     Stats stats(debug_);
     debugPrint0(debug_, "search", 1, "find clk arrivals\n");
     arrival_iter_->clear();
+    check_crpr_->clear();
+    ensureExceptionThruVertices();
     seedClkVertexArrivals();
     ClkArrivalSearchPred search_clk(this);
     arrival_visitor_->init(false, &search_clk);
     arrival_iter_->visitParallel(levelize_->maxLevel(), arrival_visitor_);
     arrivals_exist_ = true;
     stats.report("Find clk arrivals");
+    propagateInvalidEnd();
   }
   clk_arrivals_valid_ = true;
 }
@@ -928,12 +1349,14 @@ Search::findAllArrivals()
 void
 Search::findAllArrivals(VertexVisitor *arrival_visitor)
 {
+  crprSearchBegin();
   // Iterate until data arrivals at all latches stop changing.
   for (int pass = 1; pass == 1 || havePendingLatchOutputs(); pass++) {
     enqueuePendingLatchOutputs();
     debugPrint1(debug_, "search", 1, "find arrivals pass %d\n", pass);
     findArrivals(levelize_->maxLevel(), arrival_visitor);
   }
+  crprSearchEnd();
 }
 
 bool
@@ -965,8 +1388,10 @@ Search::findArrivals()
 void
 Search::findArrivals(Level level)
 {
+  crprSearchBegin();
   arrival_visitor_->init(false);
   findArrivals(level, arrival_visitor_);
+  crprSearchEnd();
 }
 
 void
@@ -974,7 +1399,9 @@ Search::findArrivals(Level level,
 		     VertexVisitor *arrival_visitor)
 {
   debugPrint1(debug_, "search", 1, "find arrivals to level %d\n", level);
+  propagateInvalidBegin();
   findArrivals1();
+  ProfilePhase phase(debug_, "arrivals");
   Stats stats(debug_);
   int arrival_count = arrival_iter_->visitParallel(level, arrival_visitor);
   stats.report("Find arrivals");
@@ -985,11 +1412,13 @@ Search::findArrivals(Level level,
   }
   arrivals_exist_ = true;
   debugPrint1(debug_, "search", 1, "found %u arrivals\n", arrival_count);
+  propagateInvalidEnd();
 }
 
 void
 Search::findArrivals1()
 {
+  ensureExceptionThruVertices();
   if (!arrivals_seeded_) {
     genclks_->ensureInsertionDelays();
     arrival_iter_->clear();
@@ -1001,6 +1430,8 @@ Search::findArrivals1()
     arrival_iter_->ensureSize();
     required_iter_->ensureSize();
   }
+  // Clock paths may change so common crpr paths have to be re-found.
+  check_crpr_->clear();
   seedInvalidArrivals();
 }
 
@@ -1029,6 +1460,7 @@ ArrivalVisitor::init0()
   tag_bldr_ = new TagGroupBldr(true, sta_);
   tag_bldr_no_crpr_ = new TagGroupBldr(false, sta_);
   adj_pred_ = new SearchThru(tag_bldr_, sta_);
+  thread_journal_ = nullptr;
 }
 
 void
@@ -1051,7 +1483,10 @@ ArrivalVisitor::init(bool always_to_endpoints,
 VertexVisitor *
 ArrivalVisitor::copy()
 {
-  return new ArrivalVisitor(always_to_endpoints_, pred_, sta_);
+  ArrivalVisitor *visitor = new ArrivalVisitor(always_to_endpoints_,
+					       pred_, sta_);
+  visitor->thread_journal_ = new VertexPathsSaveMap;
+  return visitor;
 }
 
 ArrivalVisitor::~ArrivalVisitor()
@@ -1059,6 +1494,18 @@ ArrivalVisitor::~ArrivalVisitor()
   delete tag_bldr_;
   delete tag_bldr_no_crpr_;
   delete adj_pred_;
+  if (thread_journal_) {
+    if (thread_journal_->empty())
+      delete thread_journal_;
+    else
+      sta_->search()->handJournalPaths(thread_journal_);
+  }
+}
+
+void
+ArrivalVisitor::levelFinished(Level)
+{
+  sta_->search()->mergeJournalPaths();
 }
 
 void
@@ -1078,6 +1525,7 @@ ArrivalVisitor::visit(Vertex *vertex)
   Search *search = sta_->search();
   debugPrint1(debug, "search", 2, "find arrivals %s\n",
 	      vertex->name(sdc_network));
+  traceEvent2("find_arrivals", graph->index(vertex), vertex->level());
   Pin *pin = vertex->pin();
   // Don't clobber clock sources.
   if (!sdc->isVertexPinClock(pin)
@@ -1140,7 +1588,7 @@ ArrivalVisitor::visit(Vertex *vertex)
       debugPrint0(debug, "search", 4, "arrival changed\n");
       // Only update arrivals when delays change by more than
       // fuzzyEqual can distinguish.
-      search->setVertexArrivals(vertex, tag_bldr_);
+      search->setVertexArrivals(vertex, tag_bldr_, thread_journal_);
       search->tnsInvalid(vertex);
       constrainedRequiredsInvalid(vertex, is_clk);
     }
@@ -1287,8 +1735,12 @@ void
 ArrivalVisitor::pruneCrprArrivals()
 {
   const Debug *debug = sta_->debug();
+  Search *search = sta_->search();
   ArrivalMap::Iterator arrival_iter(tag_bldr_->arrivalMap());
-  CheckCrpr *crpr = sta_->search()->checkCrpr();
+  CheckCrpr *crpr = search->checkCrpr();
+  int arrival_limit = search->crprArrivalLimit();
+  CrprArrivalSeq crpr_arrivals;
+  int dominated_count = 0;
   while (arrival_iter.hasNext()) {
     Tag *tag;
     int arrival_index;
@@ -1319,10 +1771,83 @@ ArrivalVisitor::pruneCrprArrivals()
 	  debugPrint1(debug, "search", 3, "  pruned %s\n",
 		      tag->asString(sta_));
 	  tag_bldr_->deleteArrival(tag);
+	  dominated_count++;
 	}
+	else if (arrival_limit > 0)
+	  crpr_arrivals.push_back({tag, tag_no_crpr, arrival,
+				   max_arrival_max_crpr, min_max});
       }
     }
   }
+  int limit_count = 0;
+  float limit_error = 0.0;
+  if (static_cast<int>(crpr_arrivals.size()) > arrival_limit)
+    limit_count = limitCrprArrivals(crpr_arrivals, arrival_limit,
+				    limit_error);
+  if (dominated_count > 0 || limit_count > 0)
+    search->crprArrivalsPruned(dominated_count, limit_count, limit_error);
+}
+
+class CrprArrivalLess
+{
+public:
+  bool operator()(const CrprArrival &arrival1,
+		  const CrprArrival &arrival2) const;
+};
+
+// Sort by tag ignoring crpr, most pessimistic arrival first.
+bool
+CrprArrivalLess::operator()(const CrprArrival &arrival1,
+			    const CrprArrival &arrival2) const
+{
+  TagIndex index1 = arrival1.tag_no_crpr_->index();
+  TagIndex index2 = arrival2.tag_no_crpr_->index();
+  if (index1 == index2) {
+    float value1 = delayAsFloat(arrival1.arrival_);
+    float value2 = delayAsFloat(arrival2.arrival_);
+    if (value1 == value2)
+      return arrival1.tag_->index() < arrival2.tag_->index();
+    else
+      return arrival1.min_max_->compare(value1, value2);
+  }
+  else
+    return index1 < index2;
+}
+
+// Keep the arrival_limit most pessimistic arrivals that differ only
+// by crpr clock path. The slack error of a pruned arrival is bounded
+// by how much it exceeds the most pessimistic arrival less its max crpr.
+// Return the number of arrivals pruned.
+int
+ArrivalVisitor::limitCrprArrivals(CrprArrivalSeq &crpr_arrivals,
+				  int arrival_limit,
+				  // Return value.
+				  float &limit_error)
+{
+  const Debug *debug = sta_->debug();
+  sort(crpr_arrivals, CrprArrivalLess());
+  int limit_count = 0;
+  limit_error = 0.0;
+  Tag *group_tag = nullptr;
+  int group_count = 0;
+  for (auto &crpr_arrival : crpr_arrivals) {
+    if (crpr_arrival.tag_no_crpr_ != group_tag) {
+      group_tag = crpr_arrival.tag_no_crpr_;
+      group_count = 0;
+    }
+    if (group_count >= arrival_limit) {
+      Tag *tag = crpr_arrival.tag_;
+      debugPrint1(debug, "search", 3, "  limit pruned %s\n",
+		  tag->asString(sta_));
+      tag_bldr_->deleteArrival(tag);
+      float error = abs(delayAsFloat(crpr_arrival.arrival_)
+			- delayAsFloat(crpr_arrival.max_arrival_max_crpr_));
+      limit_error = max(limit_error, error);
+      limit_count++;
+    }
+    group_count++;
+  }
+  return limit_count;
 }
 
 // Enqueue pins with input delays that use ref_pin as the clock
@@ -2551,6 +3076,9 @@ Search::mutateTag(Tag *from_tag,
 {
   ExceptionStateSet *new_states = nullptr;
   ExceptionStateSet *from_states = from_tag->states();
+  // Exception states can only start or advance at pins that match
+  // an exception -thru point.
+  bool to_is_thru = isExceptionThruPin(to_pin);
   if (from_states) {
     // Check for state changes in from_tag (but postpone copying state set).
     bool state_change = false;
@@ -2562,7 +3090,8 @@ Search::mutateTag(Tag *from_tag,
 	// Don't propagate a completed false path -thru unless it is a
 	// clock (which ignores exceptions).
 	return nullptr;
-      if (state->matchesNextThru(from_pin,to_pin,to_tr,min_max,network_)) {
+      if (to_is_thru
+	  && state->matchesNextThru(from_pin,to_pin,to_tr,min_max,network_)) {
 	// Found a -thru that we've been waiting for.
 	if (state->nextState()->isComplete()
 	    && exception->isLoop())
@@ -2578,7 +3107,8 @@ Search::mutateTag(Tag *from_tag,
       }
     }
     // Get the set of -thru exceptions starting at to_pin/edge.
-    sdc_->exceptionThruStates(from_pin, to_pin, to_tr, min_max, new_states);
+    if (to_is_thru)
+      sdc_->exceptionThruStates(from_pin, to_pin, to_tr, min_max, new_states);
     if (new_states || state_change) {
       // Second pass to apply state changes and add updated existing
       // states to new states.
@@ -2596,7 +3126,8 @@ Search::mutateTag(Tag *from_tag,
 	  return nullptr;
 	}
 	// One edge may traverse multiple hierarchical thru pins.
-	while (state->matchesNextThru(from_pin,to_pin,to_tr,min_max,network_))
+	while (to_is_thru
+	       && state->matchesNextThru(from_pin,to_pin,to_tr,min_max,network_))
 	  // Found a -thru that we've been waiting for.
 	  state = state->nextState();
 
@@ -2614,7 +3145,7 @@ Search::mutateTag(Tag *from_tag,
       }
     }
   }
-  else
+  else if (to_is_thru)
     // Get the set of -thru exceptions starting at to_pin/edge.
     sdc_->exceptionThruStates(from_pin, to_pin, to_tr, min_max, new_states);
 
@@ -2637,6 +3168,131 @@ Search::mutateTag(Tag *from_tag,
   }
 }
 
+// Mark the vertices that can match an exception -thru point so
+// mutateTag can skip the exception state checks everywhere else.
+void
+Search::ensureExceptionThruVertices()
+{
+  if (graph_
+      && !(exception_thru_vertices_valid_
+	   && exception_thru_serial_ == sdc_->exceptionsSerial())) {
+    Stats stats(debug_);
+    exception_thru_pins_.clear();
+    exception_thru_insts_.clear();
+    exception_thru_nets_.clear();
+    ExceptionPathSet::Iterator except_iter(sdc_->exceptions());
+    while (except_iter.hasNext()) {
+      ExceptionPath *exception = except_iter.next();
+      ExceptionThruSeq *thrus = exception->thrus();
+      if (thrus) {
+	for (ExceptionThru *thru : *thrus) {
+	  if (thru->pins())
+	    exception_thru_pins_.insertSet(thru->pins());
+	  if (thru->nets())
+	    exception_thru_nets_.insertSet(thru->nets());
+	  if (thru->instances())
+	    exception_thru_insts_.insertSet(thru->instances());
+	}
+      }
+    }
+    findExceptionThruEdgePins();
+
+    exception_thru_vertices_.clear();
+    size_t thru_count = 0;
+    if (!(exception_thru_pins_.empty()
+	  && exception_thru_insts_.empty()
+	  && exception_thru_nets_.empty())) {
+      // Unused vertex indices are marked so vertices made after this
+      // are treated as possible -thru matches.
+      exception_thru_vertices_.resize(graph_->vertexCount() + 1, true);
+      VertexIterator vertex_iter(graph_);
+      while (vertex_iter.hasNext()) {
+	Vertex *vertex = vertex_iter.next();
+	Pin *pin = vertex->pin();
+	VertexIndex index = graph_->index(vertex);
+	bool is_thru = isExceptionThruPin(pin, network_->net(pin));
+	if (index >= exception_thru_vertices_.size())
+	  exception_thru_vertices_.resize(index + 1, true);
+	exception_thru_vertices_[index] = is_thru;
+	if (is_thru)
+	  thru_count++;
+      }
+    }
+    exception_thru_vertices_valid_ = true;
+    exception_thru_serial_ = sdc_->exceptionsSerial();
+    debugPrint1(debug_, "search", 1, "exception thru vertices %lu\n",
+		thru_count);
+    stats.report("Find exception thru vertices");
+  }
+}
+
+// Add the to pins of exception -thru edges to the -thru pins.
+// Pins of deleted edges are kept, which only makes their marks
+// conservative.
+void
+Search::findExceptionThruEdgePins()
+{
+  ExceptionPathSet::Iterator except_iter(sdc_->exceptions());
+  while (except_iter.hasNext()) {
+    ExceptionPath *exception = except_iter.next();
+    ExceptionThruSeq *thrus = exception->thrus();
+    if (thrus) {
+      for (ExceptionThru *thru : *thrus) {
+	if (thru->edges()) {
+	  for (EdgePins *edge_pins : *thru->edges())
+	    exception_thru_pins_.insert(edge_pins->second);
+	}
+      }
+    }
+  }
+}
+
+bool
+Search::isExceptionThruPin(const Pin *pin,
+			   const Net *net) const
+{
+  return exception_thru_pins_.hasKey(const_cast<Pin*>(pin))
+    || exception_thru_insts_.hasKey(network_->instance(pin))
+    || (net && exception_thru_nets_.hasKey(const_cast<Net*>(net)));
+}
+
+void
+Search::setExceptionThruPin(const Pin *pin,
+			    const Net *net)
+{
+  Vertex *vertex = graph_->pinLoadVertex(pin);
+  if (vertex) {
+    VertexIndex index = graph_->index(vertex);
+    if (index < exception_thru_vertices_.size())
+      exception_thru_vertices_[index] = isExceptionThruPin(pin, net);
+  }
+}
+
+bool
+Search::exceptionThruVerticesValid() const
+{
+  return exception_thru_vertices_valid_
+    && exception_thru_serial_ == sdc_->exceptionsSerial();
+}
+
+// Return false if pin cannot match any exception -thru point.
+bool
+Search::isExceptionThruPin(const Pin *pin) const
+{
+  if (exceptionThruVerticesValid()) {
+    if (exception_thru_vertices_.empty())
+      return false;
+    Vertex *vertex = graph_->pinLoadVertex(pin);
+    if (vertex) {
+      VertexIndex index = graph_->index(vertex);
+      return index >= exception_thru_vertices_.size()
+	|| exception_thru_vertices_[index];
+    }
+  }
+  // Stale or missing map.
+  return true;
+}
+
 TagGroup *
 Search::findTagGroup(TagGroupBldr *tag_bldr)
 {
@@ -2682,11 +3338,13 @@ Search::findTagGroup(TagGroupBldr *tag_bldr)
 
 void
 Search::setVertexArrivals(Vertex *vertex,
-			  TagGroupBldr *tag_bldr)
+			  TagGroupBldr *tag_bldr,
+			  VertexPathsSaveMap *thread_journal)
 {
   if (tag_bldr->empty())
-    deletePaths(vertex);
+    deletePaths(vertex, thread_journal);
   else {
+    journalPaths(vertex, thread_journal);
     TagGroup *prev_tag_group = tagGroup(vertex);
     Arrival *prev_arrivals = vertex->arrivals();
     PathVertexRep *prev_paths = vertex->prevPaths();
@@ -2833,12 +3491,30 @@ Search::reportArrivalCountHistogram() const
     }
   }
 
+  size_t arrival_total = 0;
   for (int arrival_count = 0;
        arrival_count < static_cast<int>(vertex_counts.size());
        arrival_count++) {
     int vertex_count = vertex_counts[arrival_count];
-    if (vertex_count > 0)
+    if (vertex_count > 0) {
       report_->print("%6d %6d\n", arrival_count, vertex_count);
+      arrival_total += arrival_count * vertex_count;
+    }
+  }
+  size_t arrival_bytes = arrival_total * (sizeof(Arrival)
+					  + sizeof(PathVertexRep));
+  report_->print("Arrivals %lu (%.1fMb)\n",
+		 arrival_total,
+		 arrival_bytes * 1e-6);
+  if (sdc_->crprActive()) {
+    report_->print("Crpr last arrival search %.2fs\n", crpr_search_time_);
+    report_->print("Crpr dominated arrivals pruned %d\n",
+		   crpr_dominated_count_);
+    if (crpr_arrival_limit_ > 0)
+      report_->print("Crpr arrival limit %d pruned %d max slack error %s\n",
+		     crpr_arrival_limit_,
+		     crpr_limit_count_,
+		     units_->timeUnit()->asString(crpr_limit_error_));
   }
 }
 
@@ -3098,8 +3774,10 @@ Search::findRequireds()
 void
 Search::findRequireds(Level level)
 {
+  ProfilePhase phase(debug_, "requireds");
   Stats stats(debug_);
   debugPrint1(debug_, "search", 1, "find requireds to level %d\n", level);
+  propagateInvalidBegin();
   RequiredVisitor req_visitor(this);
   if (!requireds_seeded_)
     seedRequireds();
@@ -3108,6 +3786,7 @@ Search::findRequireds(Level level)
   requireds_exist_ = true;
   debugPrint1(debug_, "search", 1, "found %d requireds\n", required_count);
   stats.report("Find requireds");
+  propagateInvalidEnd();
 }
 
 void
@@ -3158,6 +3837,7 @@ Search::endpoints()
 void
 Search::endpointInvalid(Vertex *vertex)
 {
+  invalid_count_++;
   if (invalid_endpoints_) {
     debugPrint1(debug_, "endpoint", 2, "invalid %s\n",
 		vertex->name(sdc_network_));
@@ -3204,6 +3884,7 @@ Search::hasEnabledChecks(Vertex *vertex) const
 void
 Search::endpointsInvalid()
 {
+  invalid_count_++;
   delete endpoints_;
   delete invalid_endpoints_;
   endpoints_ = nullptr;
@@ -3349,10 +4030,12 @@ RequiredCmp::requiredSet(int arrival_index,
 
 bool
 RequiredCmp::requiredsSave(Vertex *vertex,
-			   const StaState *sta)
+			   const StaState *sta,
+			   VertexPathsSaveMap *thread_journal)
 {
   bool requireds_changed = false;
   bool prev_reqs = vertex->hasRequireds();
+  sta->search()->journalPaths(vertex, thread_journal);
   if (have_requireds_) {
     if (!prev_reqs)
       requireds_changed = true;
@@ -3399,7 +4082,8 @@ RequiredCmp::required(int arrival_index)
 RequiredVisitor::RequiredVisitor(const StaState *sta) :
   PathVisitor(sta),
   required_cmp_(new RequiredCmp),
-  visit_path_ends_(new VisitPathEnds(sta))
+  visit_path_ends_(new VisitPathEnds(sta)),
+  thread_journal_(nullptr)
 {
 }
 
@@ -3407,12 +4091,26 @@ RequiredVisitor::~RequiredVisitor()
 {
   delete required_cmp_;
   delete visit_path_ends_;
+  if (thread_journal_) {
+    if (thread_journal_->empty())
+      delete thread_journal_;
+    else
+      sta_->search()->handJournalPaths(thread_journal_);
+  }
 }
 
 VertexVisitor *
 RequiredVisitor::copy()
 {
-  return new RequiredVisitor(sta_);
+  RequiredVisitor *visitor = new RequiredVisitor(sta_);
+  visitor->thread_journal_ = new VertexPathsSaveMap;
+  return visitor;
+}
+
+void
+RequiredVisitor::levelFinished(Level)
+{
+  sta_->search()->mergeJournalPaths();
 }
 
 void
@@ -3431,7 +4129,8 @@ RequiredVisitor::visit(Vertex *vertex)
     FindEndRequiredVisitor seeder(required_cmp_, sta_);
     visit_path_ends_->visitPathEnds(vertex, &seeder);
   }
-  bool changed = required_cmp_->requiredsSave(vertex, sta_);
+  bool changed = required_cmp_->requiredsSave(vertex, sta_,
+					      thread_journal_);
   search->tnsInvalid(vertex);
 
   if (changed)
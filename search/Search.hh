@@ -17,10 +17,13 @@
 #ifndef STA_SEARCH_H
 #define STA_SEARCH_H
 
+#include <atomic>
 #include <mutex>
+#include <vector>
 #include "MinMax.hh"
 #include "StaState.hh"
 #include "HashSet.hh"
+#include "UnorderedMap.hh"
 #include "Transition.hh"
 #include "LibertyClass.hh"
 #include "NetworkClass.hh"
@@ -53,6 +56,7 @@ class GatedClk;
 class CheckCrpr;
 class Genclks;
 class Corner;
+class VertexPathsSave;
 
 typedef Set<ClkInfo*, ClkInfoLess> ClkInfoSet;
 typedef HashSet<Tag*, TagHash, TagEqual> TagHashSet;
@@ -60,6 +64,8 @@ typedef HashSet<TagGroup*, TagGroupHash, TagGroupEqual> TagGroupSet;
 typedef Map<Vertex*, Slack> VertexSlackMap;
 typedef Vector<VertexSlackMap> VertexSlackMapSeq;
 typedef Vector<WorstSlacks> WorstSlacksSeq;
+typedef UnorderedMap<Vertex*, VertexPathsSave*> VertexPathsSaveMap;
+typedef Vector<VertexPathsSaveMap*> VertexPathsSaveMapSeq;
 
 class Search : public StaState
 {
@@ -78,6 +84,16 @@ public:
   // disables additional search to returns approximate required times.
   bool crprApproxMissingRequireds() const;
   void setCrprApproxMissingRequireds(bool enabled);
+  // Maximum number of arrivals that differ only by crpr clock path
+  // kept per vertex after pruning dominated arrivals (0 is no limit).
+  // Arrivals beyond the limit with the least pessimistic arrival are
+  // pruned even though their crpr may change an endpoint slack.
+  int crprArrivalLimit() const;
+  void setCrprArrivalLimit(int limit);
+  // Record arrivals pruned by ArrivalVisitor::pruneCrprArrivals.
+  void crprArrivalsPruned(int dominated_count,
+			  int limit_count,
+			  float limit_error);
 
   bool unconstrainedPaths() const { return unconstrained_paths_; }
   // from/thrus/to are owned and deleted by Search.
@@ -117,6 +133,50 @@ public:
   void requiredInvalid(const Pin *pin);
   // Vertex will be deleted.
   void deleteVertexBefore(Vertex *vertex);
+  // thru_edge_loads are the loads of the exception -thru edges made
+  // by Sdc::connectPinAfter.
+  void connectPinAfter(Pin *pin,
+		       const PinSet *thru_edge_loads);
+  void disconnectPinBefore(Pin *pin);
+  // While journaling, vertex arrivals and requireds are saved before
+  // they are changed so they can be restored (Sta::ecoRollback).
+  void setJournalPaths(bool journal);
+  // Journaled paths cannot be restored if the tags have been deleted
+  // or all arrivals/requireds were invalidated since journaling began.
+  bool journalPathsRestorable() const { return journal_paths_restorable_; }
+  // Number of arrival/required/endpoint invalidations.
+  size_t invalidCount() const { return invalid_count_; }
+  // Number of delay calc and search invalidations made while finding
+  // delays, arrivals and requireds. They follow from the invalidations
+  // made before the pass.
+  size_t propagatedInvalidCount() const { return propagated_invalid_count_; }
+  // Bracket delay calc and search passes so the invalidations they
+  // make are counted as propagated.
+  void propagateInvalidBegin();
+  void propagateInvalidEnd();
+  // Modes share the graph, so when another mode is made current the
+  // vertex paths of the current mode are moved into its search and
+  // moved back to the vertices when it is current again.
+  void saveModePaths();
+  void restoreModePaths();
+  // While the mode is not current, delay changes at vertex are recorded
+  // to invalidate its paths when they are restored.
+  void modeDelayChanged(Vertex *vertex);
+  // Discard the saved paths of a mode that is not current after graph
+  // edits that cannot be recorded.
+  void deleteModePaths();
+  // Restore the journaled paths, forget pending incremental updates
+  // and clear the journal.
+  void restoreJournalPaths();
+  void clearJournalPaths();
+  // Save vertex paths before they are changed.
+  // Search threads save them in their own thread_journal and hand it
+  // over with handJournalPaths when they are done with a level.
+  void journalPaths(Vertex *vertex,
+		    VertexPathsSaveMap *thread_journal = nullptr);
+  void handJournalPaths(VertexPathsSaveMap *thread_journal);
+  // Merge the journals handed over by search threads.
+  void mergeJournalPaths();
   // Find all arrival times (propatating thru latches).
   void findAllArrivals();
   // Find all arrivals (without latch propagation).
@@ -129,6 +189,7 @@ public:
   void findRequireds(Level level);
   bool requiredsSeeded() const { return requireds_seeded_; }
   bool requiredsExist() const { return requireds_exist_; }
+  bool arrivalsExist() const { return arrivals_exist_; }
   // The sum of all negative endpoints slacks.
   // Incrementally updated.
   Slack totalNegativeSlack(const MinMax *min_max);
@@ -255,7 +316,8 @@ public:
 		       Vertex *vertex,
 		       TagGroupBldr *tag_bldr);
   void setVertexArrivals(Vertex *vertex,
-			 TagGroupBldr *group_bldr);
+			 TagGroupBldr *group_bldr,
+			 VertexPathsSaveMap *thread_journal = nullptr);
   void tnsInvalid(Vertex *vertex);
   bool arrivalsChanged(Vertex *vertex,
 		       TagGroupBldr *tag_bldr);
@@ -331,6 +393,8 @@ public:
   Slack wnsSlack(Vertex *vertex,
 		 PathAPIndex path_ap_index);
   void levelChangedBefore(Vertex *vertex);
+  void levelsChangedBefore();
+  void levelChangedAfter(Vertex *vertex);
   void seedInputArrival(const Pin *pin,
  			Vertex *vertex,
  			TagGroupBldr *tag_bldr);
@@ -461,6 +525,14 @@ protected:
 		 InputDelay *to_input_delay,
 		 const MinMax *min_max,
 		 const PathAnalysisPt *path_ap);
+  void ensureExceptionThruVertices();
+  bool isExceptionThruPin(const Pin *pin) const;
+  bool isExceptionThruPin(const Pin *pin,
+			  const Net *net) const;
+  void setExceptionThruPin(const Pin *pin,
+			   const Net *net);
+  void findExceptionThruEdgePins();
+  bool exceptionThruVerticesValid() const;
   ExceptionPath *exceptionTo(const Path *path,
 			     const Pin *pin,
 			     const TransRiseFall *tr,
@@ -473,6 +545,8 @@ protected:
   void enqueuePendingLatchOutputs();
   void findFilteredArrivals();
   void findArrivals1();
+  void crprSearchBegin();
+  void crprSearchEnd();
   void seedFilterStarts();
   bool hasEnabledChecks(Vertex *vertex) const;
   virtual float timingDerate(Vertex *from_vertex,
@@ -481,8 +555,11 @@ protected:
 			     bool is_clk,
 			     const PathAnalysisPt *path_ap);
   void deletePaths();
-  void deletePaths(Vertex *vertex);
-  void deletePaths1(Vertex *vertex);
+  void deletePaths(Vertex *vertex,
+		   VertexPathsSaveMap *thread_journal = nullptr);
+  void deletePaths1(Vertex *vertex,
+		    VertexPathsSaveMap *thread_journal = nullptr);
+  size_t timingInvalidCount() const;
   TagGroup *findTagGroup(TagGroupBldr *group_bldr);
   void deleteFilterTags();
   void deleteFilterTagGroups();
@@ -532,6 +609,17 @@ protected:
   bool unconstrained_paths_;
   bool crpr_path_pruning_enabled_;
   bool crpr_approx_missing_requireds_;
+  int crpr_arrival_limit_;
+  // Arrivals pruned because they are dominated by crpr.
+  int crpr_dominated_count_;
+  // Arrivals pruned by crpr_arrival_limit_.
+  int crpr_limit_count_;
+  // Max slack error of the arrivals pruned by crpr_arrival_limit_.
+  float crpr_limit_error_;
+  std::mutex crpr_pruned_lock_;
+  // The crpr pruned counts and run time are for the last arrival search.
+  double crpr_search_begin_;
+  double crpr_search_time_;
   // Search predicates.
   SearchPred *search_adj_;
   SearchPred *search_clk_;
@@ -586,6 +674,16 @@ protected:
   // Capacity of tag_groups_.
   TagGroupIndex tag_group_capacity_;
   std::mutex tag_group_lock_;
+  // Vertices that can match an exception -thru point, indexed by
+  // graph vertex index. Valid while exception_thru_serial_ matches
+  // the sdc exceptions serial.
+  std::vector<bool> exception_thru_vertices_;
+  // Pins, instances and nets of exception -thru points.
+  PinSet exception_thru_pins_;
+  InstanceSet exception_thru_insts_;
+  NetSet exception_thru_nets_;
+  bool exception_thru_vertices_valid_;
+  unsigned exception_thru_serial_;
   // Latches data outputs to queue on the next search pass.
   VertexSet pending_latch_outputs_;
   std::mutex pending_latch_outputs_lock_;
@@ -604,6 +702,23 @@ protected:
   GatedClk *gated_clk_;
   CheckCrpr *check_crpr_;
   Genclks *genclks_;
+  bool journal_paths_;
+  bool journal_paths_restorable_;
+  // Incremented by delay calc and search threads.
+  std::atomic<size_t> invalid_count_;
+  size_t propagated_invalid_count_;
+  int propagate_invalid_depth_;
+  size_t propagate_invalid_begin_;
+  VertexPathsSaveMap journal_paths_map_;
+  // Journals handed over by search threads.
+  VertexPathsSaveMapSeq thread_journals_;
+  std::mutex thread_journals_lock_;
+  // Vertex paths while the mode is not current.
+  VertexPathsSaveMap mode_paths_;
+  bool mode_paths_saved_;
+  // Vertices with delay changes while the mode is not current.
+  VertexSet mode_delay_changed_;
+  std::mutex mode_delay_changed_lock_;
 };
 
 // Eval across latch D->Q edges.
@@ -693,6 +808,48 @@ protected:
   const StaState *sta_;
 };
 
+// Arrival that differs from other vertex arrivals only by its crpr
+// clock path.
+class CrprArrival
+{
+public:
+  Tag *tag_;
+  // Tag matching tag_ ignoring the crpr clock path.
+  Tag *tag_no_crpr_;
+  Arrival arrival_;
+  // Most pessimistic arrival matching tag_no_crpr_ less its max crpr.
+  Arrival max_arrival_max_crpr_;
+  const MinMax *min_max_;
+};
+
+typedef Vector<CrprArrival> CrprArrivalSeq;
+
+// Vertex arrivals, requireds and prev paths saved by the path journal
+// or while the mode is not current.
+class VertexPathsSave
+{
+public:
+  // Copy the vertex paths.
+  VertexPathsSave(Vertex *vertex,
+		  const Search *search);
+  // Take the vertex paths, leaving the vertex without paths.
+  explicit VertexPathsSave(Vertex *vertex);
+  ~VertexPathsSave();
+  // Transfer the saved paths to vertex.
+  void restore(Vertex *vertex);
+
+protected:
+  TagGroupIndex tag_group_index_;
+  Arrival *arrivals_;
+  PathVertexRep *prev_paths_;
+  bool has_requireds_;
+  bool crpr_path_pruning_disabled_;
+  bool requireds_pruned_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(VertexPathsSave);
+};
+
 // Visitor called during forward search to record an
 // arrival at an path.
 class ArrivalVisitor : public PathVisitor
@@ -707,6 +864,7 @@ public:
 	    SearchPred *pred);
   virtual void visit(Vertex *vertex);
   virtual VertexVisitor *copy();
+  virtual void levelFinished(Level level);
   // Return false to stop visiting.
   virtual bool visitFromToPath(const Pin *from_pin,
 			       Vertex *from_vertex,
@@ -735,6 +893,10 @@ protected:
 			     Vertex *vertex,
 			     InputDelay *input_delay);
   void pruneCrprArrivals();
+  int limitCrprArrivals(CrprArrivalSeq &crpr_arrivals,
+			int arrival_limit,
+			// Return value.
+			float &limit_error);
   void constrainedRequiredsInvalid(Vertex *vertex,
 				   bool is_clk);
   bool always_to_endpoints_;
@@ -743,6 +905,8 @@ protected:
   SearchPred *adj_pred_;
   bool crpr_active_;
   bool has_fanin_one_;
+  // Path journal of the thread using a copy of the visitor.
+  VertexPathsSaveMap *thread_journal_;
 };
 
 class RequiredCmp
@@ -756,7 +920,8 @@ public:
 		   const MinMax *min_max);
   // Return true if the requireds changed.
   bool requiredsSave(Vertex *vertex,
-		     const StaState *sta);
+		     const StaState *sta,
+		     VertexPathsSaveMap *thread_journal = nullptr);
   Required required(int arrival_index);
 
 protected:
@@ -773,6 +938,7 @@ public:
   virtual ~RequiredVisitor();
   virtual VertexVisitor *copy();
   virtual void visit(Vertex *vertex);
+  virtual void levelFinished(Level level);
 
 protected:
   // Return false to stop visiting.
@@ -793,6 +959,8 @@ protected:
 
   RequiredCmp *required_cmp_;
   VisitPathEnds *visit_path_ends_;
+  // Path journal of the thread using a copy of the visitor.
+  VertexPathsSaveMap *thread_journal_;
 };
 
 // This does not use SearchPred as a base class to avoid getting
@@ -14,10 +14,12 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include "Machine.hh"
 #include "StaConfig.hh"  // CUDD
 #include "Error.hh"
 #include "Mutex.hh"
+#include "ThreadForEach.hh"
 #include "Debug.hh"
 #include "Report.hh"
 #include "Stats.hh"
@@ -26,6 +28,7 @@
 #include "TimingRole.hh"
 #include "TimingArc.hh"
 #include "Liberty.hh"
+#include "Sequential.hh"
 #include "Network.hh"
 #include "Sdc.hh"
 #include "Graph.hh"
@@ -49,6 +52,7 @@ Sim::Sim(StaState *sta) :
   valid_(false),
   incremental_(false),
   const_func_pins_valid_(false),
+  truth_tables_valid_(false),
   // cacheSize = 2^15
   cudd_manager_(Cudd_Init(0, 0, CUDD_UNIQUE_SLOTS, 32768, 0))
 {
@@ -57,13 +61,14 @@ Sim::Sim(StaState *sta) :
 Sim::~Sim()
 {
   delete observer_;
+  deleteTruthTables();
   if (Cudd_CheckZeroRef(cudd_manager_) > 0)
     internalErrorNoThrow("non-zero cudd reference counts");
   Cudd_Quit(cudd_manager_);
 }
 
 TimingSense
-Sim::functionSense(const FuncExpr *expr,
+Sim::funcExprSense(const FuncExpr *expr,
 		   const Pin *input_pin,
 		   const Instance *inst)
 {
@@ -109,8 +114,8 @@ Sim::clearSymtab() const
 }
 
 LogicValue
-Sim::evalExpr(const FuncExpr *expr,
-	      const Instance *inst) const
+Sim::evalFuncExpr(const FuncExpr *expr,
+		  const Instance *inst) const
 {
   UniqueLock lock(cudd_lock_);
   DdNode *bdd = funcBdd(expr, inst);
@@ -324,17 +329,19 @@ Sim::Sim(StaState *sta) :
   observer_(nullptr),
   valid_(false),
   incremental_(false),
-  const_func_pins_valid_(false)
+  const_func_pins_valid_(false),
+  truth_tables_valid_(false)
 {
 }
 
 Sim::~Sim()
 {
   delete observer_;
+  deleteTruthTables();
 }
 
 TimingSense
-Sim::functionSense(const FuncExpr *expr,
+Sim::funcExprSense(const FuncExpr *expr,
 		   const Pin *input_pin,
 		   const Instance *inst)
 {
@@ -481,12 +488,12 @@ Sim::functionSense(const FuncExpr *expr,
 }
 
 LogicValue
-Sim::evalExpr(const FuncExpr *expr,
-	      const Instance *inst) const
+Sim::evalFuncExpr(const FuncExpr *expr,
+		  const Instance *inst) const
 {
   switch (expr->op()) {
   case FuncExpr::op_port: {
-    Pin *pin = network_->findPin(inst, expr->port()->name());
+    Pin *pin = network_->findPin(inst, expr->port());
     if (pin)
       return logicValue(pin);
     else
@@ -494,16 +501,16 @@ Sim::evalExpr(const FuncExpr *expr,
       return LogicValue::unknown;
   }
   case FuncExpr::op_not:
-    return logicNot(evalExpr(expr->left(), inst));
+    return logicNot(evalFuncExpr(expr->left(), inst));
   case FuncExpr::op_or:
-    return logicOr(evalExpr(expr->left(),inst),
-		   evalExpr(expr->right(),inst));
+    return logicOr(evalFuncExpr(expr->left(),inst),
+		   evalFuncExpr(expr->right(),inst));
   case FuncExpr::op_and:
-    return logicAnd(evalExpr(expr->left(),inst),
-		    evalExpr(expr->right(),inst));
+    return logicAnd(evalFuncExpr(expr->left(),inst),
+		    evalFuncExpr(expr->right(),inst));
   case FuncExpr::op_xor:
-    return  logicXor(evalExpr(expr->left(),inst),
-		     evalExpr(expr->right(),inst));
+    return  logicXor(evalFuncExpr(expr->left(),inst),
+		     evalFuncExpr(expr->right(),inst));
   case FuncExpr::op_one:
     return LogicValue::one;
   case FuncExpr::op_zero:
@@ -515,6 +522,368 @@ Sim::evalExpr(const FuncExpr *expr,
 
 #endif // CUDD
 
+////////////////////////////////////////////////////////////////
+
+// Functions with at most this many ports are compiled to truth tables.
+static const int truth_table_port_max = 8;
+static const int truth_table_words = (1 << truth_table_port_max) / 64;
+
+typedef uint64_t TruthTableBits[truth_table_words];
+
+// Function of up to truth_table_port_max ports as a bit per minterm of
+// the port values (port i is bit i of the minterm index). Tables for
+// functions with fewer ports ignore the unused minterm bits, so all
+// operations are on the whole table and there are no partial words.
+//
+// Constant port values select the minterms that are still possible,
+// so evaluation and timing sense are a few word wide bit operations.
+class SimTruthTable
+{
+public:
+  SimTruthTable(const FuncExpr *expr,
+		const LibertyPortSeq &ports);
+  // Value of the function given the possible minterms.
+  LogicValue value(const TruthTableBits &care) const;
+  // Timing sense of the function for port_index given the possible
+  // minterms of the other ports.
+  TimingSense sense(int port_index,
+		    const TruthTableBits &care) const;
+  // Possible minterms of the instance pin values, skipping skip_port.
+  void findCare(const Instance *inst,
+		const LibertyPort *skip_port,
+		const Network *network,
+		const Sim *sim,
+		// Return value.
+		TruthTableBits &care) const;
+  int portIndex(const LibertyPort *port) const;
+
+private:
+  bool evalMinterm(const FuncExpr *expr,
+		   unsigned minterm) const;
+  static void portMask(int port_index,
+		       // Return value.
+		       TruthTableBits &mask);
+  // Shift the minterms with the port at zero to the matching minterms
+  // with the port at one (up) or the reverse (down).
+  static void shift(const TruthTableBits &bits,
+		    int port_index,
+		    bool up,
+		    // Return value.
+		    TruthTableBits &result);
+
+  LibertyPortSeq ports_;
+  TruthTableBits bits_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimTruthTable);
+};
+
+SimTruthTable::SimTruthTable(const FuncExpr *expr,
+			     const LibertyPortSeq &ports) :
+  ports_(ports)
+{
+  for (int w = 0; w < truth_table_words; w++) {
+    uint64_t word = 0;
+    for (int b = 0; b < 64; b++) {
+      if (evalMinterm(expr, w * 64 + b))
+	word |= uint64_t(1) << b;
+    }
+    bits_[w] = word;
+  }
+}
+
+bool
+SimTruthTable::evalMinterm(const FuncExpr *expr,
+			   unsigned minterm) const
+{
+  switch (expr->op()) {
+  case FuncExpr::op_port:
+    return (minterm >> portIndex(expr->port())) & 1;
+  case FuncExpr::op_not:
+    return !evalMinterm(expr->left(), minterm);
+  case FuncExpr::op_or:
+    return evalMinterm(expr->left(), minterm)
+      || evalMinterm(expr->right(), minterm);
+  case FuncExpr::op_and:
+    return evalMinterm(expr->left(), minterm)
+      && evalMinterm(expr->right(), minterm);
+  case FuncExpr::op_xor:
+    return evalMinterm(expr->left(), minterm)
+      != evalMinterm(expr->right(), minterm);
+  case FuncExpr::op_one:
+    return true;
+  case FuncExpr::op_zero:
+    return false;
+  }
+  return false;
+}
+
+int
+SimTruthTable::portIndex(const LibertyPort *port) const
+{
+  for (size_t i = 0; i < ports_.size(); i++) {
+    if (ports_[i] == port)
+      return i;
+  }
+  return -1;
+}
+
+void
+SimTruthTable::portMask(int port_index,
+			// Return value.
+			TruthTableBits &mask)
+{
+  static const uint64_t word_masks[6] = {0xaaaaaaaaaaaaaaaaULL,
+					 0xccccccccccccccccULL,
+					 0xf0f0f0f0f0f0f0f0ULL,
+					 0xff00ff00ff00ff00ULL,
+					 0xffff0000ffff0000ULL,
+					 0xffffffff00000000ULL};
+  for (int w = 0; w < truth_table_words; w++) {
+    if (port_index < 6)
+      mask[w] = word_masks[port_index];
+    else
+      mask[w] = ((w >> (port_index - 6)) & 1) ? ~uint64_t(0) : 0;
+  }
+}
+
+void
+SimTruthTable::shift(const TruthTableBits &bits,
+		     int port_index,
+		     bool up,
+		     // Return value.
+		     TruthTableBits &result)
+{
+  if (port_index < 6) {
+    int bit_shift = 1 << port_index;
+    for (int w = 0; w < truth_table_words; w++)
+      result[w] = up ? bits[w] << bit_shift : bits[w] >> bit_shift;
+  }
+  else {
+    int word_shift = 1 << (port_index - 6);
+    for (int w = 0; w < truth_table_words; w++) {
+      int from = up ? w - word_shift : w + word_shift;
+      result[w] = (from >= 0 && from < truth_table_words) ? bits[from] : 0;
+    }
+  }
+}
+
+void
+SimTruthTable::findCare(const Instance *inst,
+			const LibertyPort *skip_port,
+			const Network *network,
+			const Sim *sim,
+			// Return value.
+			TruthTableBits &care) const
+{
+  for (int w = 0; w < truth_table_words; w++)
+    care[w] = ~uint64_t(0);
+  for (size_t i = 0; i < ports_.size(); i++) {
+    const LibertyPort *port = ports_[i];
+    if (port != skip_port) {
+      // Internal ports don't have instance pins.
+      const Pin *pin = network->findPin(inst, port);
+      if (pin) {
+	LogicValue value = sim->logicValue(pin);
+	if (logicValueZeroOne(value)) {
+	  TruthTableBits mask;
+	  portMask(i, mask);
+	  bool one = (value == LogicValue::one);
+	  for (int w = 0; w < truth_table_words; w++)
+	    care[w] &= one ? mask[w] : ~mask[w];
+	}
+      }
+    }
+  }
+}
+
+LogicValue
+SimTruthTable::value(const TruthTableBits &care) const
+{
+  bool all_ones = true;
+  bool all_zeros = true;
+  for (int w = 0; w < truth_table_words; w++) {
+    uint64_t ones = bits_[w] & care[w];
+    all_ones &= (ones == care[w]);
+    all_zeros &= (ones == 0);
+  }
+  if (all_ones)
+    return LogicValue::one;
+  else if (all_zeros)
+    return LogicValue::zero;
+  else
+    return LogicValue::unknown;
+}
+
+TimingSense
+SimTruthTable::sense(int port_index,
+		     const TruthTableBits &care) const
+{
+  TruthTableBits mask, zero_ones, one_ones, shifted;
+  portMask(port_index, mask);
+  for (int w = 0; w < truth_table_words; w++) {
+    uint64_t ones = bits_[w] & care[w];
+    // Ones with the port at zero and at one.
+    zero_ones[w] = ones & ~mask[w];
+    one_ones[w] = ones & mask[w];
+  }
+  // Increasing if every one with the port at zero is still a one with
+  // the port at one, decreasing if the reverse.
+  bool increasing = true;
+  shift(zero_ones, port_index, true, shifted);
+  for (int w = 0; w < truth_table_words; w++)
+    increasing &= ((shifted[w] & ~bits_[w]) == 0);
+  bool decreasing = true;
+  shift(one_ones, port_index, false, shifted);
+  for (int w = 0; w < truth_table_words; w++)
+    decreasing &= ((shifted[w] & ~bits_[w]) == 0);
+  if (increasing && decreasing)
+    return TimingSense::none;
+  else if (increasing)
+    return TimingSense::positive_unate;
+  else if (decreasing)
+    return TimingSense::negative_unate;
+  else
+    return TimingSense::non_unate;
+}
+
+static void
+findFuncPorts(const FuncExpr *expr,
+	      // Return value.
+	      LibertyPortSeq &ports)
+{
+  switch (expr->op()) {
+  case FuncExpr::op_port: {
+    LibertyPort *port = expr->port();
+    if (std::find(ports.begin(), ports.end(), port) == ports.end())
+      ports.push_back(port);
+    break;
+  }
+  case FuncExpr::op_not:
+    findFuncPorts(expr->left(), ports);
+    break;
+  case FuncExpr::op_or:
+  case FuncExpr::op_and:
+  case FuncExpr::op_xor:
+    findFuncPorts(expr->left(), ports);
+    findFuncPorts(expr->right(), ports);
+    break;
+  case FuncExpr::op_one:
+  case FuncExpr::op_zero:
+    break;
+  }
+}
+
+LogicValue
+Sim::evalExpr(const FuncExpr *expr,
+	      const Instance *inst) const
+{
+  SimTruthTable *table = truth_tables_.findKey(expr);
+  if (table) {
+    TruthTableBits care;
+    table->findCare(inst, nullptr, network_, this, care);
+    return table->value(care);
+  }
+  else
+    return evalFuncExpr(expr, inst);
+}
+
+TimingSense
+Sim::functionSense(const FuncExpr *expr,
+		   const Pin *input_pin,
+		   const Instance *inst)
+{
+  SimTruthTable *table = truth_tables_.findKey(expr);
+  if (table) {
+    const LibertyPort *input_port = network_->libertyPort(input_pin);
+    int port_index = table->portIndex(input_port);
+    if (port_index < 0)
+      return TimingSense::none;
+    TruthTableBits care;
+    table->findCare(inst, input_port, network_, this, care);
+    return table->sense(port_index, care);
+  }
+  else
+    return funcExprSense(expr, input_pin, inst);
+}
+
+// Truth tables are made for all of the cells in the network once and
+// then for cells as they are added by network edits.
+void
+Sim::ensureTruthTables()
+{
+  if (!truth_tables_valid_) {
+    LeafInstanceIterator *inst_iter = network_->leafInstanceIterator();
+    while (inst_iter->hasNext()) {
+      Instance *inst = inst_iter->next();
+      LibertyCell *cell = network_->libertyCell(inst);
+      if (cell)
+	makeTruthTables(cell);
+    }
+    delete inst_iter;
+    truth_tables_valid_ = true;
+  }
+}
+
+// Port functions, tristate enables, sequential functions and timing
+// arc conditions of cell.
+void
+Sim::makeTruthTables(LibertyCell *cell)
+{
+  if (!truth_table_cells_.hasKey(cell)) {
+    truth_table_cells_.insert(cell);
+    LibertyCellPortBitIterator port_iter(cell);
+    while (port_iter.hasNext()) {
+      LibertyPort *port = port_iter.next();
+      makeTruthTable(port->function());
+      makeTruthTable(port->tristateEnable());
+    }
+    LibertyCellSequentialIterator seq_iter(cell);
+    while (seq_iter.hasNext()) {
+      Sequential *seq = seq_iter.next();
+      makeTruthTable(seq->clock());
+      makeTruthTable(seq->data());
+      makeTruthTable(seq->clear());
+      makeTruthTable(seq->preset());
+    }
+    LibertyCellTimingArcSetIterator arc_set_iter(cell);
+    while (arc_set_iter.hasNext()) {
+      TimingArcSet *arc_set = arc_set_iter.next();
+      makeTruthTable(arc_set->cond());
+      const char *mode_name = arc_set->modeName();
+      if (mode_name) {
+	ModeDef *mode_def = cell->findModeDef(mode_name);
+	if (mode_def) {
+	  ModeValueMap::Iterator value_iter(mode_def->values());
+	  while (value_iter.hasNext()) {
+	    ModeValueDef *value_def = value_iter.next();
+	    if (value_def)
+	      makeTruthTable(value_def->cond());
+	  }
+	}
+      }
+    }
+  }
+}
+
+void
+Sim::makeTruthTable(const FuncExpr *expr)
+{
+  if (expr && !truth_tables_.hasKey(expr)) {
+    LibertyPortSeq ports;
+    findFuncPorts(expr, ports);
+    if (ports.size() <= static_cast<size_t>(truth_table_port_max))
+      truth_tables_[expr] = new SimTruthTable(expr, ports);
+  }
+}
+
+void
+Sim::deleteTruthTables()
+{
+  truth_tables_.deleteContents();
+  truth_table_cells_.clear();
+  truth_tables_valid_ = false;
+}
+
 void
 Sim::clear()
 {
@@ -527,6 +896,7 @@ Sim::clear()
   invalid_insts_.clear();
   invalid_drvr_pins_.clear();
   invalid_load_pins_.clear();
+  deleteTruthTables();
 }
 
 void
@@ -542,6 +912,7 @@ Sim::ensureConstantsPropagated()
   if (!valid_) {
     Stats stats(debug_);
     ensureConstantFuncPins();
+    ensureTruthTables();
     instances_to_annotate_.clear();
     if (incremental_) {
       seedInvalidConstants();
@@ -672,6 +1043,7 @@ Sim::makePinAfter(Pin *pin)
 {
   // Incrementally update const_func_pins_.
   recordConstPinFunc(pin);
+  makePinTruthTables(pin);
 }
 
 void
@@ -718,6 +1090,17 @@ Sim::pinSetFuncAfter(Pin *pin)
   // Incrementally update const_func_pins_.
   const_func_pins_.erase(pin);
   recordConstPinFunc(pin);
+  makePinTruthTables(pin);
+}
+
+void
+Sim::makePinTruthTables(const Pin *pin)
+{
+  if (truth_tables_valid_) {
+    LibertyCell *cell = network_->libertyCell(network_->instance(pin));
+    if (cell)
+      makeTruthTables(cell);
+  }
 }
 
 void
@@ -733,13 +1116,66 @@ Sim::seedConstants()
   setConstFuncPins(true);
 }
 
+// Queues with at least this many instances are evaluated with
+// multiple threads.
+static const size_t sim_parallel_min = 1000;
+
 void
 Sim::propagateConstants()
 {
+  if (threadCount() > 1)
+    propagateConstantsParallel();
+  else {
+    while (!eval_queue_.empty()) {
+      const Instance *inst = eval_queue_.front();
+      eval_queue_.pop();
+      evalInstance(inst);
+    }
+  }
+}
+
+// Propagate in waves of the instances in the queue. The output values
+// of a wave are found by multiple threads without changing any pin
+// values, and then set in queue order, which queues the next wave.
+// Propagation is monotone, so the values converge to the same fixed
+// point as evaluating one instance at a time.
+void
+Sim::propagateConstantsParallel()
+{
+  size_t thread_count = threadCount();
+  InstanceSeq wave;
+  InstanceSet wave_insts;
   while (!eval_queue_.empty()) {
-    const Instance *inst = eval_queue_.front();
-    eval_queue_.pop();
-    evalInstance(inst);
+    wave.clear();
+    wave_insts.clear();
+    while (!eval_queue_.empty()) {
+      Instance *inst = const_cast<Instance*>(eval_queue_.front());
+      eval_queue_.pop();
+      if (!wave_insts.hasKey(inst)) {
+	wave_insts.insert(inst);
+	wave.push_back(inst);
+      }
+    }
+    if (wave.size() >= sim_parallel_min) {
+      std::vector<PinValueSeq> thread_values(thread_count);
+      forEachChunk(wave.size(), thread_count,
+		   [&] (size_t i, size_t begin, size_t end) {
+	for (size_t j = begin; j < end; j++)
+	  findOutputValues(wave[j], thread_values[i]);
+      });
+      for (PinValueSeq &values : thread_values) {
+	for (auto &pin_value : values) {
+	  const Pin *pin = pin_value.first;
+	  LogicValue value = pin_value.second;
+	  if (value != logicValue(pin))
+	    setPinValue(pin, value, true);
+	}
+      }
+    }
+    else {
+      for (const Instance *inst : wave)
+	evalInstance(inst);
+    }
   }
 }
 
@@ -895,6 +1331,23 @@ Sim::setPinValue(const Pin *pin,
 
 void
 Sim::evalInstance(const Instance *inst)
+{
+  PinValueSeq values;
+  findOutputValues(inst, values);
+  for (auto &pin_value : values) {
+    const Pin *pin = pin_value.first;
+    LogicValue value = pin_value.second;
+    if (value != logicValue(pin))
+      setPinValue(pin, value, true);
+  }
+}
+
+// Output pin values of inst that differ from the current pin values.
+// Thread safe because no values are changed.
+void
+Sim::findOutputValues(const Instance *inst,
+		      // Return value.
+		      PinValueSeq &values) const
 {
   debugPrint1(debug_, "sim", 2, "eval %s\n", network_->pathName(inst));
   InstancePinIterator *pin_iter = network_->pinIterator(inst);
@@ -915,7 +1368,7 @@ Sim::evalInstance(const Instance *inst)
 			expr->asString(),
 			logicValueString(value));
 	    if (value != logicValue(pin))
-	      setPinValue(pin, value, true);
+	      values.push_back(PinValue(pin, value));
 	  }
 	}
       }
@@ -1029,7 +1482,9 @@ Sim::clearSimValues()
     const Instance *inst = inst_iter.next();
     // Clear sim values on all pins before evaling functions.
     clearInstSimValues(inst);
-    annotateVertexEdges(inst, false);
+    VertexSeq fanin_changed, fanout_changed;
+    annotateVertexEdges(inst, false, fanin_changed, fanout_changed);
+    edgesChangeAfter(fanin_changed, fanout_changed);
   }
   instances_with_const_pins_.clear();
 }
@@ -1053,19 +1508,59 @@ Sim::clearInstSimValues(const Instance *inst)
 }
 
 // Annotate graph edges disabled by constant values.
+// The edges annotated for an instance are the timing arcs between its
+// pins so instances are annotated by multiple threads. The observer
+// is notified of the changed edges after the threads finish.
 void
 Sim::annotateGraphEdges()
 {
-  InstanceSet::Iterator inst_iter(instances_to_annotate_);
-  while (inst_iter.hasNext()) {
-    const Instance *inst = inst_iter.next();
-    annotateVertexEdges(inst, true);
+  size_t thread_count = threadCount();
+  if (thread_count > 1
+      && instances_to_annotate_.size() >= sim_parallel_min) {
+    InstanceSeq insts;
+    InstanceSet::Iterator inst_iter(instances_to_annotate_);
+    while (inst_iter.hasNext())
+      insts.push_back(const_cast<Instance*>(inst_iter.next()));
+    std::vector<VertexSeq> fanin_changed(thread_count);
+    std::vector<VertexSeq> fanout_changed(thread_count);
+    forEachChunk(insts.size(), thread_count,
+		 [&] (size_t i, size_t begin, size_t end) {
+      for (size_t j = begin; j < end; j++)
+	annotateVertexEdges(insts[j], true, fanin_changed[i],
+			    fanout_changed[i]);
+    });
+    for (size_t i = 0; i < thread_count; i++)
+      edgesChangeAfter(fanin_changed[i], fanout_changed[i]);
+  }
+  else {
+    VertexSeq fanin_changed, fanout_changed;
+    InstanceSet::Iterator inst_iter(instances_to_annotate_);
+    while (inst_iter.hasNext()) {
+      const Instance *inst = inst_iter.next();
+      annotateVertexEdges(inst, true, fanin_changed, fanout_changed);
+    }
+    edgesChangeAfter(fanin_changed, fanout_changed);
+  }
+}
+
+void
+Sim::edgesChangeAfter(VertexSeq &fanin_changed,
+		      VertexSeq &fanout_changed)
+{
+  if (observer_) {
+    for (Vertex *vertex : fanout_changed)
+      observer_->fanoutEdgesChangeAfter(vertex);
+    for (Vertex *vertex : fanin_changed)
+      observer_->faninEdgesChangeAfter(vertex);
   }
 }
 
 void
 Sim::annotateVertexEdges(const Instance *inst,
-			 bool annotate)
+			 bool annotate,
+			 // Return values.
+			 VertexSeq &fanin_changed,
+			 VertexSeq &fanout_changed)
 {
   debugPrint2(debug_, "sim", 4, "annotate %s %s\n",
 	      network_->pathName(inst),
@@ -1076,9 +1571,11 @@ Sim::annotateVertexEdges(const Instance *inst,
     Vertex *vertex, *bidirect_drvr_vertex;
     graph_->pinVertices(pin, vertex, bidirect_drvr_vertex);
     if (vertex)
-      annotateVertexEdges(inst, pin, vertex, annotate);
+      annotateVertexEdges(inst, pin, vertex, annotate,
+			  fanin_changed, fanout_changed);
     if (bidirect_drvr_vertex)
-      annotateVertexEdges(inst, pin, bidirect_drvr_vertex, annotate);
+      annotateVertexEdges(inst, pin, bidirect_drvr_vertex, annotate,
+			  fanin_changed, fanout_changed);
   }
   delete pin_iter;
 }
@@ -1087,7 +1584,10 @@ void
 Sim::annotateVertexEdges(const Instance *inst,
 			 const Pin *pin,
 			 Vertex *vertex,
-			 bool annotate)
+			 bool annotate,
+			 // Return values.
+			 VertexSeq &fanin_changed,
+			 VertexSeq &fanout_changed)
 {
   bool fanin_disables_changed = false;
   VertexInEdgeIterator edge_iter(vertex, graph_);
@@ -1126,12 +1626,12 @@ Sim::annotateVertexEdges(const Instance *inst,
 	disables_changed = true;
 	fanin_disables_changed = true;
       }
-      if (observer_ && disables_changed)
-	observer_->fanoutEdgesChangeAfter(from_vertex);
+      if (disables_changed)
+	fanout_changed.push_back(from_vertex);
     }
   }
-  if (observer_ && fanin_disables_changed)
-    observer_->faninEdgesChangeAfter(vertex);
+  if (fanin_disables_changed)
+    fanin_changed.push_back(vertex);
 }
 
 bool
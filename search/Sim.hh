@@ -18,14 +18,17 @@
 #define STA_SIM_H
 
 #include <queue>
+#include <vector>
 #include <mutex>
 #include "StaConfig.hh"  // CUDD
 #include "DisallowCopyAssign.hh"
 #include "Map.hh"
+#include "UnorderedMap.hh"
 #include "StaState.hh"
 #include "NetworkClass.hh"
 #include "GraphClass.hh"
 #include "SdcClass.hh"
+#include "LibertyClass.hh"
 
 struct DdNode;
 struct DdManager;
@@ -33,10 +36,14 @@ struct DdManager;
 namespace sta {
 
 class SimObserver;
+class SimTruthTable;
 
 typedef Map<const Pin*, LogicValue> PinValueMap;
 typedef std::queue<const Instance*> EvalQueue;
 typedef Map<const char*, DdNode*, CharPtrLess> BddSymbolTable;
+typedef UnorderedMap<const FuncExpr*, SimTruthTable*> SimTruthTableMap;
+typedef std::pair<const Pin*, LogicValue> PinValue;
+typedef std::vector<PinValue> PinValueSeq;
 
 // Propagate constants from constraints and netlist tie high/low
 // connections thru gates.
@@ -74,6 +81,7 @@ protected:
   virtual void seedConstants();
   void seedInvalidConstants();
   void propagateConstants();
+  void propagateConstantsParallel();
   void setConstraintConstPins(LogicValueMap *pin_value_map,
 			      bool propagate);
   void setConstFuncPins(bool propagate);
@@ -83,9 +91,23 @@ protected:
 			   bool propagate);
   void enqueue(const Instance *inst);
   void evalInstance(const Instance *inst);
+  void findOutputValues(const Instance *inst,
+			// Return value.
+			PinValueSeq &values) const;
   TimingSense functionSense(const FuncExpr *expr,
 			    const Pin *input_pin,
 			    const Instance *inst);
+  // Evaluation without truth tables.
+  LogicValue evalFuncExpr(const FuncExpr *expr,
+			  const Instance *inst) const;
+  TimingSense funcExprSense(const FuncExpr *expr,
+			    const Pin *input_pin,
+			    const Instance *inst);
+  void ensureTruthTables();
+  void makeTruthTables(LibertyCell *cell);
+  void makeTruthTable(const FuncExpr *expr);
+  void makePinTruthTables(const Pin *pin);
+  void deleteTruthTables();
   void functionSense(const FuncExpr *expr,
 		     const Pin *input_pin,
 		     const Instance *inst,
@@ -98,9 +120,17 @@ protected:
   void annotateVertexEdges(const Instance *inst,
 			   const Pin *pin,
 			   Vertex *vertex,
-			   bool annotate);
+			   bool annotate,
+			   // Return values.
+			   VertexSeq &fanin_changed,
+			   VertexSeq &fanout_changed);
   void annotateVertexEdges(const Instance *inst,
-			   bool annotate);
+			   bool annotate,
+			   // Return values.
+			   VertexSeq &fanin_changed,
+			   VertexSeq &fanout_changed);
+  void edgesChangeAfter(VertexSeq &fanin_changed,
+			VertexSeq &fanout_changed);
   void removePropagatedValue(const Pin *pin);
   void propagateFromInvalidDrvrsToLoads();
   void propagateToInvalidLoads();
@@ -126,6 +156,11 @@ protected:
   // Instances with constant pin values for annotateVertexEdges.
   InstanceSet instances_with_const_pins_;
   InstanceSet instances_to_annotate_;
+  // Truth tables of the functions of the liberty cells in the network.
+  // Tables are only made by serial code so they are read without locks.
+  SimTruthTableMap truth_tables_;
+  LibertyCellSet truth_table_cells_;
+  bool truth_tables_valid_;
 
 #ifdef CUDD
   DdNode *funcBdd(const FuncExpr *expr,
@@ -20,6 +20,7 @@
 #include "ReportTcl.hh"
 #include "Debug.hh"
 #include "Stats.hh"
+#include "Profiler.hh"
 #include "Units.hh"
 #include "Fuzzy.hh"
 #include "PortDirection.hh"
@@ -68,6 +69,11 @@
 #include "SdfWriter.hh"
 #include "Genclks.hh"
 #include "Power.hh"
+#include "PowerWindows.hh"
+#include "ActivityReader.hh"
+#include "RegionTiming.hh"
+#include "EcoJournal.hh"
+#include "EditBatch.hh"
 #include "Sta.hh"
 
 namespace sta {
@@ -96,10 +102,12 @@ pinInstances(PinSet *pins,
 // When an incremental change is made the delay calculation
 // changes downstream.  This invalidates the required times
 // for all vertices upstream of the changes.
+// The searches of the modes that are not current record the changes.
 class StaDelayCalcObserver : public DelayCalcObserver
 {
 public:
-  explicit StaDelayCalcObserver(Search *search);
+  StaDelayCalcObserver(Search *search,
+		       SearchModeMap *mode_searches);
   virtual void delayChangedFrom(Vertex *vertex);
   virtual void delayChangedTo(Vertex *vertex);
   virtual void checkDelayChangedTo(Vertex *vertex);
@@ -107,12 +115,17 @@ public:
 private:
   DISALLOW_COPY_AND_ASSIGN(StaDelayCalcObserver);
 
+  void modeDelayChanged(Vertex *vertex);
+
   Search *search_;
+  SearchModeMap *mode_searches_;
 };
 
-StaDelayCalcObserver::StaDelayCalcObserver(Search *search) :
+StaDelayCalcObserver::StaDelayCalcObserver(Search *search,
+					   SearchModeMap *mode_searches) :
   DelayCalcObserver(),
-  search_(search)
+  search_(search),
+  mode_searches_(mode_searches)
 {
 }
 
@@ -120,18 +133,31 @@ void
 StaDelayCalcObserver::delayChangedFrom(Vertex *vertex)
 {
   search_->requiredInvalid(vertex);
+  modeDelayChanged(vertex);
 }
 
 void
 StaDelayCalcObserver::delayChangedTo(Vertex *vertex)
 {
   search_->arrivalInvalid(vertex);
+  modeDelayChanged(vertex);
 }
 
 void
 StaDelayCalcObserver::checkDelayChangedTo(Vertex *vertex)
 {
   search_->requiredInvalid(vertex);
+  modeDelayChanged(vertex);
+}
+
+void
+StaDelayCalcObserver::modeDelayChanged(Vertex *vertex)
+{
+  SearchModeMap::Iterator search_iter(mode_searches_);
+  while (search_iter.hasNext()) {
+    Search *mode_search = search_iter.next();
+    mode_search->modeDelayChanged(vertex);
+  }
 }
 
 ////////////////////////////////////////////////////////////////
@@ -200,6 +226,8 @@ class StaLevelizeObserver : public LevelizeObserver
 public:
   StaLevelizeObserver(Search *search);
   virtual void levelChangedBefore(Vertex *vertex);
+  virtual void levelsChangedBefore();
+  virtual void levelChangedAfter(Vertex *vertex);
 
 private:
   DISALLOW_COPY_AND_ASSIGN(StaLevelizeObserver);
@@ -218,6 +246,18 @@ StaLevelizeObserver::levelChangedBefore(Vertex *vertex)
   search_->levelChangedBefore(vertex);
 }
 
+void
+StaLevelizeObserver::levelsChangedBefore()
+{
+  search_->levelsChangedBefore();
+}
+
+void
+StaLevelizeObserver::levelChangedAfter(Vertex *vertex)
+{
+  search_->levelChangedAfter(vertex);
+}
+
 ////////////////////////////////////////////////////////////////
 
 void
@@ -226,7 +266,6 @@ initSta()
   initElapsedTime();
   TimingRole::init();
   PortDirection::init();
-  initTmpStrings();
   initLiberty();
   initDelayConstants();
   registerDelayCalcs();
@@ -245,7 +284,6 @@ deleteAllMemory()
     Sta::setSta(nullptr);
   }
   deleteDelayCalcs();
-  deleteTmpStrings();
   TimingRole::destroy();
   PortDirection::destroy();
   deleteLiberty();
@@ -269,7 +307,11 @@ Sta::Sta() :
   power_(nullptr),
   link_make_black_boxes_(true),
   update_genclks_(false),
-  equiv_cells_(nullptr)
+  compact_delays_(false),
+  equiv_cells_(nullptr),
+  eco_journal_(nullptr),
+  edit_batch_(nullptr),
+  mode_name_(nullptr)
 {
 }
 
@@ -303,7 +345,8 @@ Sta::makeComponents()
 void
 Sta::makeObservers()
 {
-  graph_delay_calc_->setObserver(new StaDelayCalcObserver(search_));
+  graph_delay_calc_->setObserver(new StaDelayCalcObserver(search_,
+							  &mode_searches_));
   sim_->setObserver(new StaSimObserver(graph_delay_calc_, levelize_, search_));
   levelize_->setObserver(new StaLevelizeObserver(search_));
 }
@@ -332,6 +375,12 @@ Sta::updateComponentsState()
   if (graph_)
     graph_->copyState(this);
   sdc_->copyState(this);
+  SdcModeMap::Iterator mode_iter(modes_);
+  while (mode_iter.hasNext()) {
+    Sdc *mode_sdc = mode_iter.next();
+    if (mode_sdc != sdc_)
+      mode_sdc->copyState(this);
+  }
   corners_->copyState(this);
   levelize_->copyState(this);
   parasitics_->copyState(this);
@@ -344,6 +393,8 @@ Sta::updateComponentsState()
   report_path_->copyState(this);
   if (check_timing_)
     check_timing_->copyState(this);
+  if (clk_skews_)
+    clk_skews_->copyState(this);
   if (power_)
     power_->copyState(this);
 }
@@ -494,6 +545,12 @@ Sta::~Sta()
   delete report_path_;
   // Constraints reference search filter, so delete search first.
   delete search_;
+  SearchModeMap::Iterator search_iter(mode_searches_);
+  while (search_iter.hasNext()) {
+    Search *mode_search = search_iter.next();
+    mode_search->deleteModePaths();
+    delete mode_search;
+  }
   delete latches_;
   delete parasitics_;
   if (arc_delay_calc_)
@@ -501,6 +558,15 @@ Sta::~Sta()
   delete graph_delay_calc_;
   delete sim_;
   delete levelize_;
+  SdcModeMap::Iterator mode_iter(modes_);
+  while (mode_iter.hasNext()) {
+    const char *mode_name;
+    Sdc *mode_sdc;
+    mode_iter.next(mode_name, mode_sdc);
+    if (mode_sdc != sdc_)
+      delete mode_sdc;
+    stringDelete(mode_name);
+  }
   delete sdc_;
   delete corners_;
   delete graph_;
@@ -511,20 +577,40 @@ Sta::~Sta()
   delete report_;
   delete power_;
   delete equiv_cells_;
+  delete eco_journal_;
+  delete edit_batch_;
 }
 
 void
 Sta::clear()
 {
+  delete eco_journal_;
+  eco_journal_ = nullptr;
+  if (edit_batch_)
+    edit_batch_->clear();
   // Constraints reference search filter, so clear search first.
   search_->clear();
+  SearchModeMap::Iterator search_iter(mode_searches_);
+  while (search_iter.hasNext()) {
+    Search *mode_search = search_iter.next();
+    mode_search->deleteModePaths();
+    delete mode_search;
+  }
+  mode_searches_.clear();
   sdc_->clear();
+  SdcModeMap::Iterator mode_iter(modes_);
+  while (mode_iter.hasNext()) {
+    Sdc *mode_sdc = mode_iter.next();
+    if (mode_sdc != sdc_)
+      mode_sdc->clear();
+  }
   // corners are NOT cleared because they are used to index liberty files.
   levelize_->clear();
   if (parasitics_)
     parasitics_->clear();
   graph_delay_calc_->clear();
   sim_->clear();
+  power_->clear();
   if (check_min_pulse_widths_)
     check_min_pulse_widths_->clear();
   if (check_min_periods_)
@@ -593,6 +679,7 @@ Sta::readLiberty(const char *filename,
 		 const MinMaxAll *min_max,
 		 bool infer_latches)
 {
+  ProfilePhase phase(debug_, "read_liberty");
   Stats stats(debug_);
   LibertyLibrary *library = readLibertyFile(filename, corner, min_max,
 					    infer_latches, network_);
@@ -627,6 +714,9 @@ Sta::readLibertyFile(const char *filename,
     else
       readLibertyAfter(liberty, corner, min_max->asMinMax());
     network_->readLibertyAfter(liberty);
+    // Cached driver solutions are keyed by gate models.
+    if (arc_delay_calc_)
+      arc_delay_calc_->clearCache();
   }
   return liberty;
 }
@@ -677,6 +767,7 @@ bool
 Sta::linkDesign(const char *top_cell_name)
 {
   clear();
+  ProfilePhase phase(debug_, "link");
   Stats stats(debug_);
   bool status = network_->linkNetwork(top_cell_name,
 				      link_make_black_boxes_,
@@ -762,6 +853,9 @@ Sta::setPvt(Instance *inst,
 	    Pvt *pvt)
 {
   sdc_->setPvt(inst, min_max, pvt);
+  // Cached driver solutions are keyed by pvts.
+  if (arc_delay_calc_)
+    arc_delay_calc_->clearCache();
   delaysInvalidFrom(inst);
 }
 
@@ -1913,6 +2007,19 @@ Sta::resetPath(ExceptionFrom *from,
   search_->arrivalsInvalid();
 }
 
+void
+Sta::exceptionsBulkBegin()
+{
+  sdc_->exceptionsBulkBegin();
+}
+
+void
+Sta::exceptionsBulkEnd()
+{
+  sdc_->exceptionsBulkEnd();
+  search_->arrivalsInvalid();
+}
+
 void
 Sta::makeGroupPath(const char *name,
 		   bool is_default,
@@ -2062,6 +2169,134 @@ Sta::constraintsChanged()
   sim_->constantsInvalid();
 }
 
+////////////////////////////////////////////////////////////////
+
+// The constraints read before the first mode is made are the default
+// mode.
+void
+Sta::ensureModes()
+{
+  if (modes_.empty()) {
+    mode_name_ = stringCopy("default");
+    modes_[mode_name_] = sdc_;
+  }
+}
+
+void
+Sta::makeMode(const char *name)
+{
+  ensureModes();
+  if (!modes_.hasKey(name)) {
+    Sdc *sdc = new Sdc(this);
+    modes_[stringCopy(name)] = sdc;
+  }
+}
+
+bool
+Sta::hasMode(const char *name)
+{
+  ensureModes();
+  return modes_.hasKey(name);
+}
+
+const char *
+Sta::modeName() const
+{
+  return mode_name_ ? mode_name_ : "default";
+}
+
+// The network, libraries, parasitics, graph and delays are shared by
+// all of the modes. Each mode has its own search, which keeps the
+// arrivals and requireds of the mode while it is not current.
+// Constraint annotations on the graph and simulated constants belong
+// to the current mode so they are found again for the new mode, which
+// invalidates the delays and arrivals of the pins with different
+// constants.
+bool
+Sta::setMode(const char *name)
+{
+  ensureModes();
+  const char *mode_name;
+  Sdc *sdc;
+  bool exists;
+  modes_.findKey(name, mode_name, sdc, exists);
+  if (!exists)
+    return false;
+  if (sdc != sdc_) {
+    AnalysisType prev_analysis_type = sdc_->analysisType();
+    // Delays are kept when the modes have the same constraints that
+    // delay calculation uses.
+    bool keep_delays = graph_
+      && delayCalcSdcEqual(network_->topInstance(), sdc_, sdc);
+    debugPrint2(debug_, "mode", 1, "mode %s %s delays\n",
+		mode_name, keep_delays ? "keeps" : "invalidates");
+    // Levelize again so loop breaking exceptions are made in the new sdc.
+    levelize_->invalid();
+    if (!keep_delays)
+      graph_delay_calc_->delaysInvalid();
+    if (eco_journal_)
+      // The journaled paths belong to the search of this mode.
+      ecoGraphChanged();
+    // Search references exceptions in the current sdc, so it keeps
+    // the paths of this mode until it is current again.
+    Search *prev_search = search_;
+    search_->saveModePaths();
+    mode_searches_[mode_name_] = search_;
+    Search *mode_search = mode_searches_.findKey(mode_name);
+    if (mode_search)
+      mode_searches_.erase(mode_name);
+    sim_->constantsInvalid();
+    power_->activitiesInvalid();
+    if (check_min_pulse_widths_)
+      check_min_pulse_widths_->clear();
+    if (check_min_periods_)
+      check_min_periods_->clear();
+    if (graph_)
+      // Remove graph constraint annotations of the old mode.
+      sdc_->annotateGraph(false);
+
+    sdc_ = sdc;
+    mode_name_ = mode_name;
+    if (mode_search)
+      search_ = mode_search;
+    else
+      makeSearch();
+    updateComponentsState();
+    makeObservers();
+    search_->restoreModePaths();
+    if (search_->crprArrivalLimit() != prev_search->crprArrivalLimit()) {
+      search_->setCrprArrivalLimit(prev_search->crprArrivalLimit());
+      search_->arrivalsInvalid();
+    }
+    if (keep_delays)
+      graph_delay_calc_->remapIdealClks();
+
+    // The hierarchical pins disabled by clocks may have been found
+    // with a different netlist.
+    sdc_->clkHpinDisablesInvalid();
+    if (graph_)
+      sdc_->annotateGraph(true);
+    if (sdc_->analysisType() != prev_analysis_type) {
+      corners_->analysisTypeChanged();
+      if (graph_)
+	graph_->setDelayCount(corners_->dcalcAnalysisPtCount());
+      // The path analysis points of the saved arrivals changed.
+      search_->arrivalsInvalid();
+    }
+  }
+  return true;
+}
+
+void
+Sta::modeSearchesInvalid()
+{
+  SearchModeMap::Iterator search_iter(mode_searches_);
+  while (search_iter.hasNext()) {
+    Search *mode_search = search_iter.next();
+    mode_search->deleteModePaths();
+  }
+}
+
 void
 Sta::writeSdc(const char *filename,
 	      bool compatible,
@@ -2130,6 +2365,21 @@ Sta::setCrprMode(CrprMode mode)
   sdc_->setCrprMode(mode);
 }
 
+int
+Sta::crprArrivalLimit() const
+{
+  return search_->crprArrivalLimit();
+}
+
+void
+Sta::setCrprArrivalLimit(int limit)
+{
+  if (sdc_->crprActive()
+      && search_->crprArrivalLimit() != limit)
+    search_->arrivalsInvalid();
+  search_->setCrprArrivalLimit(limit);
+}
+
 bool
 Sta::pocvEnabled() const
 {
@@ -2142,6 +2392,7 @@ Sta::setPocvEnabled(bool enabled)
   if (enabled != pocv_enabled_) {
     graph_delay_calc_->delaysInvalid();
     search_->arrivalsInvalid();
+    modeSearchesInvalid();
   }
   pocv_enabled_ = enabled;
   updateComponentsState();
@@ -2153,10 +2404,40 @@ Sta::setSigmaFactor(float factor)
   if (!fuzzyEqual(factor, sigma_factor_)) {
     sigma_factor_ = factor;
     search_->arrivalsInvalid();
+    modeSearchesInvalid();
     updateComponentsState();
   }
 }
 
+bool
+Sta::compactDelays() const
+{
+  return compact_delays_;
+}
+
+void
+Sta::setCompactDelays(bool compact)
+{
+  if (compact != compact_delays_) {
+    compact_delays_ = compact;
+    if (graph_) {
+      // The graph discards the delays when the storage changes.
+      graph_->setCompactDelays(compact);
+      graph_delay_calc_->delaysInvalid();
+      search_->arrivalsInvalid();
+    }
+  }
+}
+
+size_t
+Sta::delayMemoryBytes() const
+{
+  if (graph_)
+    return graph_->delayMemoryBytes();
+  else
+    return 0;
+}
+
 bool
 Sta::propagateGatedClockEnable() const
 {
@@ -2351,6 +2632,8 @@ Sta::makeCorners()
 void
 Sta::makeCorners(StringSet *corner_names)
 {
+  // The path analysis points of the saved mode arrivals change.
+  modeSearchesInvalid();
   corners_->makeCorners(corner_names);
   cmd_corner_ = corners_->findCorner(0);
 }
@@ -2398,6 +2681,7 @@ Sta::findPathEnds(ExceptionFrom *from,
 		  bool clk_gating_setup,
 		  bool clk_gating_hold)
 {
+  ProfilePhase phase(debug_, "find_path_ends");
   searchPreamble();
   return search_->findPathEnds(from, thrus, to, unconstrained,
 			       corner, min_max, group_count, endpoint_count,
@@ -2470,9 +2754,17 @@ Sta::setReportPathNoSplit(bool no_split)
 void
 Sta::reportPathEnds(PathEndSeq *ends)
 {
+  ProfilePhase phase(debug_, "report_path_ends");
   report_path_->reportPathEnds(ends);
 }
 
+void
+Sta::reportPathEndsFormatted(PathEndSeq *ends)
+{
+  ProfilePhase phase(debug_, "report_path_ends");
+  report_path_->reportPathEndsFormatted(ends);
+}
+
 void
 Sta::reportPathEndHeader()
 {
@@ -2507,6 +2799,7 @@ Sta::reportPath(Path *path)
 void
 Sta::updateTiming(bool full)
 {
+  ProfilePhase phase(debug_, "update_timing");
   searchPreamble();
   if (full)
     search_->arrivalsInvalid();
@@ -2531,6 +2824,7 @@ void
 Sta::arrivalsInvalid()
 {
   search_->arrivalsInvalid();
+  modeSearchesInvalid();
 }
 
 void
@@ -2832,6 +3126,18 @@ Sta::vertexSlack(Vertex *vertex,
   return vertexSlack1(vertex, tr, clk_edge_wildcard, path_ap);
 }
 
+bool
+Sta::regionSlacks(InstanceSeq *changed_insts,
+		  VertexSeq *endpoints,
+		  const MinMax *min_max,
+		  // Return value.
+		  SlackSeq &slacks)
+{
+  ensureLevelized();
+  RegionTiming region(this);
+  return region.findSlacks(changed_insts, endpoints, min_max, slacks);
+}
+
 Slack
 Sta::vertexSlack(Vertex *vertex,
 		 const TransRiseFall *tr,
@@ -2974,21 +3280,27 @@ void
 Sta::findDelays(Vertex *to_vertex)
 {
   delayCalcPreamble();
+  search_->propagateInvalidBegin();
   graph_delay_calc_->findDelays(to_vertex->level());
+  search_->propagateInvalidEnd();
 }
 
 void
 Sta::findDelays()
 {
   delayCalcPreamble();
+  search_->propagateInvalidBegin();
   graph_delay_calc_->findDelays(levelize_->maxLevel());
+  search_->propagateInvalidEnd();
 }
 
 void
 Sta::findDelays(Level level)
 {
   delayCalcPreamble();
+  search_->propagateInvalidBegin();
   graph_delay_calc_->findDelays(level);
+  search_->propagateInvalidEnd();
 }
 
 void
@@ -3069,6 +3381,9 @@ Sta::ensureGraph()
     updateComponentsState();
     sdc_->annotateGraph(true);
   }
+  else if (edit_batch_ && !edit_batch_->empty())
+    // Bring the graph up to date with the edits so far.
+    editBatchFlush();
   return graph_;
 }
 
@@ -3076,6 +3391,7 @@ void
 Sta::makeGraph()
 {
   graph_ = new Graph(this, 2, true, corners_->dcalcAnalysisPtCount());
+  graph_->setCompactDelays(compact_delays_);
   graph_->makeGraph();
 }
 
@@ -3453,6 +3769,7 @@ Sta::readSpef(const char *filename,
 	      bool save,
 	      bool quiet)
 {
+  ProfilePhase phase(debug_, "read_spef");
   Corner *corner = cmd_corner_;
   const MinMax *cnst_min_max;
   ParasiticAnalysisPt *ap;
@@ -3578,6 +3895,10 @@ Sta::makeInstance(const char *name,
   Instance *inst = network->makeInstance(cell, name, parent);
   network->makePins(inst);
   makeInstanceAfter(inst);
+  if (eco_journal_) {
+    eco_journal_->makeInstance(inst);
+    ecoGraphChanged();
+  }
   return inst;
 }
 
@@ -3585,6 +3906,10 @@ void
 Sta::deleteInstance(Instance *inst)
 {
   NetworkEdit *network = networkCmdEdit();
+  if (eco_journal_) {
+    eco_journal_->deleteInstance();
+    ecoGraphChanged();
+  }
   deleteInstanceBefore(inst);
   network->deleteInstance(inst);
 }
@@ -3612,10 +3937,19 @@ Sta::replaceCell(Instance *inst,
 {
   NetworkEdit *network = networkCmdEdit();
   LibertyCell *from_lib_cell = network->libertyCell(inst);
-  if (sta::equivCells(from_lib_cell, to_lib_cell)) {
+  bool equiv_cells = sta::equivCells(from_lib_cell, to_lib_cell);
+  if (eco_journal_) {
+    eco_journal_->replaceCell(inst, network->cell(inst), equiv_cells);
+    if (!equiv_cells)
+      ecoGraphChanged();
+  }
+  if (equiv_cells) {
+    size_t invalid_count = ecoInvalidCount();
     replaceEquivCellBefore(inst, to_lib_cell);
     network->replaceCell(inst, to_cell);
     replaceEquivCellAfter(inst);
+    if (eco_journal_)
+      eco_journal_->editInvalid(ecoInvalidCount() - invalid_count);
   }
   else {
     replaceCellBefore(inst, to_lib_cell);
@@ -3631,6 +3965,8 @@ Sta::makeNet(const char *name,
   NetworkEdit *network = networkCmdEdit();
   Net *net = network->makeNet(name, parent);
   // Sta notification unnecessary.
+  if (eco_journal_)
+    eco_journal_->makeNet(net);
   return net;
 }
 
@@ -3638,6 +3974,10 @@ void
 Sta::deleteNet(Net *net)
 {
   NetworkEdit *network = networkCmdEdit();
+  if (eco_journal_) {
+    eco_journal_->deleteNet();
+    ecoGraphChanged();
+  }
   deleteNetBefore(net);
   network->deleteNet(net);
 }
@@ -3648,6 +3988,8 @@ Sta::connectPin(Instance *inst,
 		Net *net)
 {
   NetworkEdit *network = networkCmdEdit();
+  if (eco_journal_)
+    ecoConnectPin(inst, port);
   Pin *pin = network->connect(inst, port, net);
   connectPinAfter(pin);
 }
@@ -3658,18 +4000,299 @@ Sta::connectPin(Instance *inst,
 		Net *net)
 {
   NetworkEdit *network = networkCmdEdit();
+  if (eco_journal_)
+    ecoConnectPin(inst, network->findPort(network->cell(inst),
+					  port->name()));
   Pin *pin = network->connect(inst, port, net);
   connectPinAfter(pin);
 }
 
+void
+Sta::ecoConnectPin(Instance *inst,
+		   Port *port)
+{
+  Pin *prev_pin = network_->findPin(inst, port);
+  Net *prev_net = prev_pin ? network_->net(prev_pin) : nullptr;
+  eco_journal_->connectPin(inst, port, prev_net);
+  ecoGraphChanged();
+}
+
 void
 Sta::disconnectPin(Pin *pin)
 {
   NetworkEdit *network = networkCmdEdit();
+  if (eco_journal_) {
+    eco_journal_->disconnectPin(network->instance(pin), network->port(pin),
+				network->net(pin));
+    ecoGraphChanged();
+  }
   disconnectPinBefore(pin);
   network->disconnectPin(pin);
 }
 
+////////////////////////////////////////////////////////////////
+
+void
+Sta::ecoBegin()
+{
+  if (eco_journal_ == nullptr) {
+    // Journaled values must be the up to date timing before the edits.
+    search_->deleteFilteredArrivals();
+    findRequireds();
+    eco_journal_ = new EcoJournal;
+    eco_journal_->setInvalidCount(ecoInvalidCount());
+    graph_->setJournalDelays(true);
+    search_->setJournalPaths(true);
+  }
+}
+
+void
+Sta::ecoCommit()
+{
+  if (eco_journal_) {
+    delete eco_journal_;
+    eco_journal_ = nullptr;
+    graph_->setJournalDelays(false);
+    graph_->clearJournalDelays();
+    search_->setJournalPaths(false);
+    search_->clearJournalPaths();
+  }
+}
+
+void
+Sta::ecoRollback()
+{
+  if (eco_journal_) {
+    EcoJournal *journal = eco_journal_;
+    if (journal->reversible()) {
+      // Restoring the journaled timing would discard invalidations
+      // that are not undone with the edits.
+      bool restore_timing = journal->graphUnchanged()
+	&& journal->onlyEditsInvalid(ecoInvalidCount())
+	&& search_->journalPathsRestorable();
+      // Stop journaling before undoing the edits.
+      eco_journal_ = nullptr;
+      graph_->setJournalDelays(false);
+      search_->setJournalPaths(false);
+      const EcoEditSeq &edits = journal->edits();
+      for (auto edit_iter = edits.rbegin();
+	   edit_iter != edits.rend();
+	   edit_iter++)
+	ecoUndo(*edit_iter);
+      if (restore_timing) {
+	graph_->restoreJournalDelays();
+	graph_delay_calc_->clearInvalidDelays();
+	search_->restoreJournalPaths();
+      }
+      else {
+	graph_->clearJournalDelays();
+	search_->clearJournalPaths();
+      }
+      delete journal;
+    }
+    else
+      report_->error("eco with deleted instances or nets cannot be rolled back.\n");
+  }
+}
+
+void
+Sta::ecoUndo(const EcoEdit &edit)
+{
+  NetworkEdit *network = networkCmdEdit();
+  Instance *inst = edit.instance();
+  switch (edit.type()) {
+  case EcoEditType::replace_cell:
+    replaceCell(inst, edit.cell());
+    break;
+  case EcoEditType::make_instance:
+    deleteInstance(inst);
+    break;
+  case EcoEditType::make_net:
+    deleteNet(edit.net());
+    break;
+  case EcoEditType::connect_pin: {
+    Net *prev_net = edit.net();
+    Pin *pin = network->findPin(inst, edit.port());
+    if (pin) {
+      if (network->net(pin))
+	disconnectPin(pin);
+      if (prev_net)
+	connectPin(inst, edit.port(), prev_net);
+    }
+    break;
+  }
+  case EcoEditType::disconnect_pin:
+    if (edit.net())
+      connectPin(inst, edit.port(), edit.net());
+    break;
+  }
+}
+
+size_t
+Sta::ecoInvalidCount() const
+{
+  // Invalidations propagated by delay calc and search passes follow
+  // from the counted ones.
+  return graph_delay_calc_->invalidCount() + search_->invalidCount()
+    - search_->propagatedInvalidCount();
+}
+
+// Journaled timing cannot be restored after graph edits,
+// so stop journaling it.
+void
+Sta::ecoGraphChanged()
+{
+  graph_->setJournalDelays(false);
+  graph_->clearJournalDelays();
+  search_->setJournalPaths(false);
+  search_->clearJournalPaths();
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+Sta::editBatchBegin()
+{
+  if (edit_batch_ == nullptr)
+    edit_batch_ = new EditBatch;
+}
+
+void
+Sta::editBatchEnd()
+{
+  if (edit_batch_) {
+    editBatchFlush();
+    delete edit_batch_;
+    edit_batch_ = nullptr;
+    if (search_->arrivalsExist())
+      // One incremental delay calculation and arrival search for the batch.
+      updateTiming(false);
+  }
+}
+
+// Make the deferred wire edges and invalidate the delays, arrivals and
+// requireds collected by the batch.
+class MakeMissingEdgesThruHierPin : public HierPinThruVisitor
+{
+public:
+  MakeMissingEdgesThruHierPin(Graph *graph);
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(MakeMissingEdgesThruHierPin);
+  virtual void visit(Pin *drvr,
+		     Pin *load);
+
+  Graph *graph_;
+};
+
+MakeMissingEdgesThruHierPin::MakeMissingEdgesThruHierPin(Graph *graph) :
+  HierPinThruVisitor(),
+  graph_(graph)
+{
+}
+
+void
+MakeMissingEdgesThruHierPin::visit(Pin *drvr,
+				   Pin *load)
+{
+  Vertex *drvr_vertex = graph_->pinDrvrVertex(drvr);
+  Vertex *load_vertex = graph_->pinLoadVertex(load);
+  VertexOutEdgeIterator edge_iter(drvr_vertex, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *edge = edge_iter.next();
+    if (edge->to(graph_) == load_vertex
+	&& edge->role()->isWire())
+      return;
+  }
+  graph_->makeWireEdge(drvr, load);
+}
+
+void
+Sta::editBatchFlush()
+{
+  Stats stats(debug_);
+  if (graph_) {
+    PinSet &pins = edit_batch_->connectedPins();
+    debugPrint1(debug_, "edit_batch", 1, "edit batch %zu connected pins\n",
+		pins.size());
+    PinSeq hpins;
+    for (auto pin : pins) {
+      if (network_->isHierarchical(pin)) {
+	hpins.push_back(pin);
+	continue;
+      }
+      Vertex *vertex, *bidir_drvr_vertex;
+      graph_->pinVertices(pin, vertex, bidir_drvr_vertex);
+      if (network_->isDriver(pin)) {
+	graph_->makeWireEdgesFromPin(pin);
+	connectDrvrPinAfter(bidir_drvr_vertex ? bidir_drvr_vertex : vertex);
+      }
+      if (network_->isLoad(pin)) {
+	// Wire edges from drivers connected in the batch are made
+	// by makeWireEdgesFromPin.
+	PinSet *drvrs = network_->drivers(pin);
+	if (drvrs) {
+	  for (auto drvr : *drvrs) {
+	    if (drvr != pin
+		&& !pins.hasKey(drvr))
+	      graph_->makeWireEdge(drvr, pin);
+	  }
+	}
+	connectLoadPinAfter(vertex);
+      }
+    }
+    // Edges thru hierarchical pins are made after the leaf pin edges
+    // and skip the driver/load edges that already exist.
+    MakeMissingEdgesThruHierPin visitor(graph_);
+    for (auto hpin : hpins) {
+      visitDrvrLoadsThruHierPin(hpin, network_, &visitor);
+      connectHierPinAfter(hpin);
+    }
+
+    debugPrint3(debug_, "edit_batch", 1,
+		"edit batch invalid %zu delays %zu arrivals %zu requireds\n",
+		edit_batch_->delaysInvalid().size(),
+		edit_batch_->arrivalsInvalid().size(),
+		edit_batch_->requiredsInvalid().size());
+    for (auto vertex : edit_batch_->delaysInvalid())
+      graph_delay_calc_->delayInvalid(vertex);
+    for (auto vertex : edit_batch_->arrivalsInvalid())
+      search_->arrivalInvalid(vertex);
+    for (auto vertex : edit_batch_->requiredsInvalid())
+      search_->requiredInvalid(vertex);
+  }
+  edit_batch_->clear();
+  stats.report("Flush edit batch");
+}
+
+void
+Sta::editArrivalInvalid(Vertex *vertex)
+{
+  if (edit_batch_)
+    edit_batch_->arrivalInvalid(vertex);
+  else
+    search_->arrivalInvalid(vertex);
+}
+
+void
+Sta::editRequiredInvalid(Vertex *vertex)
+{
+  if (edit_batch_)
+    edit_batch_->requiredInvalid(vertex);
+  else
+    search_->requiredInvalid(vertex);
+}
+
+void
+Sta::editDelayInvalid(Vertex *vertex)
+{
+  if (edit_batch_)
+    edit_batch_->delayInvalid(vertex);
+  else
+    graph_delay_calc_->delayInvalid(vertex);
+}
+
+
 LibertyPort *
 Sta::findCellPort(LibertyCell *cell,
 		  PortDirection *dir)
@@ -3756,7 +4379,7 @@ Sta::replaceEquivCellBefore(Instance *inst,
       else {
 	// Force delay calculation on output pins.
 	Vertex *vertex = graph_->pinDrvrVertex(pin);
-	graph_delay_calc_->delayInvalid(vertex);
+	editDelayInvalid(vertex);
       }
     }
     delete pin_iter;
@@ -3823,6 +4446,7 @@ void
 Sta::replaceCellBefore(Instance *inst,
 		       LibertyCell *to_cell)
 {
+  modeSearchesInvalid();
   if (graph_) {
     // Delete all graph edges between instance pins.
     InstancePinIterator *pin_iter = network_->pinIterator(inst);
@@ -3855,6 +4479,7 @@ Sta::replaceCellAfter(Instance *inst)
     while (pin_iter->hasNext()) {
       Pin *pin = pin_iter->next();
       sim_->pinSetFuncAfter(pin);
+      power_->pinSetFuncAfter(pin);
       if (network_->direction(pin)->isAnyInput())
 	parasitics_->loadPinCapacitanceChanged(pin);
     }
@@ -3862,17 +4487,21 @@ Sta::replaceCellAfter(Instance *inst)
   }
 }
 
+// Graph edits are not recorded for the modes that are not current,
+// so their arrivals are found again.
 void
 Sta::connectPinAfter(Pin *pin)
 {
+  modeSearchesInvalid();
   if (graph_) {
     if (network_->isHierarchical(pin)) {
-      graph_->makeWireEdgesThruPin(pin);
-      EdgesThruHierPinIterator edge_iter(pin, network_, graph_);
-      while (edge_iter.hasNext()) {
-	Edge *edge = edge_iter.next();
-	if (edge->role()->isWire())
-	  connectDrvrPinAfter(edge->from(graph_));
+      if (edit_batch_)
+	// Make edges thru the hierarchical pin when the batch is flushed
+	// so they are not duplicated by the edges of connected leaf pins.
+	edit_batch_->connectPin(pin);
+      else {
+	graph_->makeWireEdgesThruPin(pin);
+	connectHierPinAfter(pin);
       }
     }
     else {
@@ -3883,28 +4512,53 @@ Sta::connectPinAfter(Pin *pin)
       }
       else
 	graph_->pinVertices(pin, vertex, bidir_drvr_vertex);
-      search_->arrivalInvalid(vertex);
-      search_->requiredInvalid(vertex);
+      editArrivalInvalid(vertex);
+      editRequiredInvalid(vertex);
       if (bidir_drvr_vertex) {
-	search_->arrivalInvalid(bidir_drvr_vertex);
-	search_->requiredInvalid(bidir_drvr_vertex);
+	editArrivalInvalid(bidir_drvr_vertex);
+	editRequiredInvalid(bidir_drvr_vertex);
       }
 
-      // Make interconnect edges from/to pin.
-      if (network_->isDriver(pin)) {
-	graph_->makeWireEdgesFromPin(pin);
-	connectDrvrPinAfter(bidir_drvr_vertex ? bidir_drvr_vertex : vertex);
-      }
-      // Note that a bidirect is both a driver and a load so this
-      // is NOT an else clause for the above "if".
-      if (network_->isLoad(pin)) {
-	graph_->makeWireEdgesToPin(pin);
-	connectLoadPinAfter(vertex);
+      if (edit_batch_)
+	// Make interconnect edges when the batch is flushed.
+	edit_batch_->connectPin(pin);
+      else {
+	// Make interconnect edges from/to pin.
+	if (network_->isDriver(pin)) {
+	  graph_->makeWireEdgesFromPin(pin);
+	  connectDrvrPinAfter(bidir_drvr_vertex ? bidir_drvr_vertex : vertex);
+	}
+	// Note that a bidirect is both a driver and a load so this
+	// is NOT an else clause for the above "if".
+	if (network_->isLoad(pin)) {
+	  graph_->makeWireEdgesToPin(pin);
+	  connectLoadPinAfter(vertex);
+	}
       }
     }
   }
-  sdc_->connectPinAfter(pin);
+  SdcModeMap::Iterator mode_iter(modes_);
+  while (mode_iter.hasNext()) {
+    Sdc *mode_sdc = mode_iter.next();
+    if (mode_sdc != sdc_)
+      mode_sdc->connectPinAfter(pin);
+  }
+  PinSet thru_edge_loads;
+  sdc_->connectPinAfter(pin, &thru_edge_loads);
+  search_->connectPinAfter(pin, &thru_edge_loads);
   sim_->connectPinAfter(pin);
+  power_->connectPinAfter(pin);
+}
+
+void
+Sta::connectHierPinAfter(Pin *hpin)
+{
+  EdgesThruHierPinIterator edge_iter(hpin, network_, graph_);
+  while (edge_iter.hasNext()) {
+    Edge *edge = edge_iter.next();
+    if (edge->role()->isWire())
+      connectDrvrPinAfter(edge->from(graph_));
+  }
 }
 
 void
@@ -3915,13 +4569,13 @@ Sta::connectDrvrPinAfter(Vertex *vertex)
   while (edge_iter.hasNext()) {
     Edge *edge = edge_iter.next();
     Vertex *to_vertex = edge->to(graph_);
-    search_->arrivalInvalid(to_vertex);
+    editArrivalInvalid(to_vertex);
     search_->endpointInvalid(to_vertex);
     sdc_->clkHpinDisablesChanged(to_vertex->pin());
   }
   sdc_->clkHpinDisablesChanged(vertex->pin());
-  graph_delay_calc_->delayInvalid(vertex);
-  search_->requiredInvalid(vertex);
+  editDelayInvalid(vertex);
+  editRequiredInvalid(vertex);
   search_->endpointInvalid(vertex);
   levelize_->invalidFrom(vertex);
 }
@@ -3934,23 +4588,32 @@ Sta::connectLoadPinAfter(Vertex *vertex)
   while (edge_iter.hasNext()) {
     Edge *edge = edge_iter.next();
     Vertex *from_vertex = edge->from(graph_);
-    graph_delay_calc_->delayInvalid(from_vertex);
-    search_->requiredInvalid(from_vertex);
+    editDelayInvalid(from_vertex);
+    editRequiredInvalid(from_vertex);
     sdc_->clkHpinDisablesChanged(from_vertex->pin());
   }
   sdc_->clkHpinDisablesChanged(vertex->pin());
-  graph_delay_calc_->delayInvalid(vertex);
+  editDelayInvalid(vertex);
   levelize_->invalidFrom(vertex);
-  search_->arrivalInvalid(vertex);
+  editArrivalInvalid(vertex);
   search_->endpointInvalid(vertex);
 }
 
 void
 Sta::disconnectPinBefore(Pin *pin)
 {
+  modeSearchesInvalid();
   parasitics_->disconnectPinBefore(pin);
+  SdcModeMap::Iterator mode_iter(modes_);
+  while (mode_iter.hasNext()) {
+    Sdc *mode_sdc = mode_iter.next();
+    if (mode_sdc != sdc_)
+      mode_sdc->disconnectPinBefore(pin);
+  }
   sdc_->disconnectPinBefore(pin);
+  search_->disconnectPinBefore(pin);
   sim_->disconnectPinBefore(pin);
+  power_->disconnectPinBefore(pin);
   if (graph_) {
     if (network_->isDriver(pin)) {
       Vertex *vertex = graph_->pinDrvrVertex(pin);
@@ -3993,9 +4656,9 @@ Sta::deleteEdge(Edge *edge)
 {
   Vertex *from = edge->from(graph_);
   Vertex *to = edge->to(graph_);
-  search_->arrivalInvalid(to);
-  search_->requiredInvalid(from);
-  graph_delay_calc_->delayInvalid(to);
+  editArrivalInvalid(to);
+  editRequiredInvalid(from);
+  editDelayInvalid(to);
   levelize_->relevelizeFrom(to);
   levelize_->deleteEdgeBefore(edge);
   sdc_->clkHpinDisablesChanged(edge->from(graph_)->pin());
@@ -4058,10 +4721,16 @@ Sta::deleteLeafInstanceBefore(Instance *inst)
 void
 Sta::deletePinBefore(Pin *pin)
 {
+  modeSearchesInvalid();
+  if (edit_batch_)
+    edit_batch_->deletePinBefore(pin);
+  power_->deletePinBefore(pin);
   if (graph_) {
     if (network_->isLoad(pin)) {
       Vertex *vertex = graph_->pinLoadVertex(pin);
 
+      if (edit_batch_)
+	edit_batch_->deleteVertexBefore(vertex);
       levelize_->deleteVertexBefore(vertex);
       graph_delay_calc_->deleteVertexBefore(vertex);
       search_->deleteVertexBefore(vertex);
@@ -4072,7 +4741,7 @@ Sta::deletePinBefore(Pin *pin)
 	if (edge->role()->isWire()) {
 	  Vertex *from = edge->from(graph_);
 	  // Only notify from vertex (to vertex will be deleted).
-	  search_->requiredInvalid(from);
+	  editRequiredInvalid(from);
 	}
 	levelize_->deleteEdgeBefore(edge);
       }
@@ -4081,6 +4750,8 @@ Sta::deletePinBefore(Pin *pin)
     if (network_->isDriver(pin)) {
       Vertex *vertex = graph_->pinDrvrVertex(pin);
 
+      if (edit_batch_)
+	edit_batch_->deleteVertexBefore(vertex);
       levelize_->deleteVertexBefore(vertex);
       graph_delay_calc_->deleteVertexBefore(vertex);
       search_->deleteVertexBefore(vertex);
@@ -4093,7 +4764,7 @@ Sta::deletePinBefore(Pin *pin)
 	  Vertex *to = edge->to(graph_);
 	  // to->prev_paths point to vertex, so delete them.
 	  search_->arrivalInvalidDelete(to);
-	  graph_delay_calc_->delayInvalid(to);
+	  editDelayInvalid(to);
 	  levelize_->relevelizeFrom(to);
 	}
 	levelize_->deleteEdgeBefore(edge);
@@ -4150,9 +4821,9 @@ Sta::delaysInvalidFrom(Pin *pin)
 void
 Sta::delaysInvalidFrom(Vertex *vertex)
 {
-  search_->arrivalInvalid(vertex);
-  search_->requiredInvalid(vertex);
-  graph_delay_calc_->delayInvalid(vertex);
+  editArrivalInvalid(vertex);
+  editRequiredInvalid(vertex);
+  editDelayInvalid(vertex);
 }
 
 void
@@ -4210,7 +4881,7 @@ Sta::delaysInvalidFromFanin(Vertex *vertex)
     Edge *edge = edge_iter.next();
     Vertex *from_vertex = edge->from(graph_);
     delaysInvalidFrom(from_vertex);
-    search_->requiredInvalid(from_vertex);
+    editRequiredInvalid(from_vertex);
   }
 }
 
@@ -4979,4 +5650,39 @@ Sta::power(const Instance *inst,
   power_->power(inst, corner, result);
 }
 
+bool
+Sta::readSaif(const char *filename,
+	      const char *scope)
+{
+  // Activities are annotated per cycle of the pin clocks.
+  powerPreamble();
+  return sta::readSaif(filename, scope, power_);
+}
+
+bool
+Sta::readVcd(const char *filename,
+	     const char *scope)
+{
+  powerPreamble();
+  return sta::readVcd(filename, scope, power_);
+}
+
+bool
+Sta::reportPowerWindows(const char *vcd_filename,
+			const char *scope,
+			float window_width,
+			int hier_depth,
+			const Corner *corner,
+			int digits,
+			bool series)
+{
+  powerPreamble();
+  PowerWindows windows(power_);
+  bool read = windows.findPower(vcd_filename, scope, window_width,
+				hier_depth, corner);
+  if (read)
+    windows.report(digits, series);
+  return read;
+}
+
 } // namespace
@@ -19,6 +19,8 @@
 
 #include <string>
 #include "DisallowCopyAssign.hh"
+#include "Map.hh"
+#include "StringUtil.hh"
 #include "StringSeq.hh"
 #include "StaState.hh"
 #include "LibertyClass.hh"
@@ -59,10 +61,15 @@ class Power;
 class PowerResult;
 class ClockIterator;
 class EquivCells;
+class EcoJournal;
+class EcoEdit;
+class EditBatch;
 
 typedef InstanceSeq::Iterator SlowDrvrIterator;
 typedef Vector<const char*> CheckError;
 typedef Vector<CheckError*> CheckErrorSeq;
+typedef Map<const char*, Sdc*, CharPtrLess> SdcModeMap;
+typedef Map<const char*, Search*, CharPtrLess> SearchModeMap;
 
 enum class CmdNamespace { sta, sdc };
 
@@ -529,6 +536,10 @@ public:
 		 ExceptionThruSeq *thrus,
 		 ExceptionTo *to,
 		 const MinMaxAll *min_max);
+  // Defer merging exceptions until exceptionsBulkEnd.
+  // Use when defining large numbers of exceptions (read_sdc -bulk).
+  void exceptionsBulkBegin();
+  void exceptionsBulkEnd();
   // Make an exception -from specification.
   ExceptionFrom *makeExceptionFrom(PinSet *from_pins,
 				   ClockSet *from_clks,
@@ -696,6 +707,21 @@ public:
   // Notify the sta that the constraints have changed directly rather
   // than thru this sta API.
   virtual void constraintsChanged();
+  // Modes are named sets of constraints that share the network,
+  // libraries, parasitics and timing graph. Commands that set or
+  // report constraints and timing apply to the current mode.
+  // The constraints defined before any modes are made are the
+  // "default" mode.
+  // Make an empty mode. The current mode does not change.
+  void makeMode(const char *name);
+  // Return false if there is no mode named name.
+  // Each mode keeps its arrivals and requireds while it is not current.
+  // Delays are only found again if the modes have different clocks,
+  // disables, loads, drives or slews. Constants and case analysis
+  // only invalidate the delays and arrivals of the pins they change.
+  bool setMode(const char *name);
+  bool hasMode(const char *name);
+  const char *modeName() const;
   // Namespace used by command interpreter.
   CmdNamespace cmdNamespace();
   void setCmdNamespace(CmdNamespace namespc);
@@ -731,12 +757,24 @@ public:
   // TCL variable sta_crpr_mode.
   CrprMode crprMode() const;
   void setCrprMode(CrprMode mode);
+  // TCL variable sta_crpr_arrival_limit.
+  // Max arrivals per vertex that differ only by crpr clock path
+  // (0 is no limit).
+  int crprArrivalLimit() const;
+  void setCrprArrivalLimit(int limit);
   // TCL variable sta_pocv_enabled.
   // Parametric on chip variation (statisical sta).
   bool pocvEnabled() const;
   void setPocvEnabled(bool enabled);
   // Number of std deviations from mean to use for normal distributions.
   void setSigmaFactor(float factor);
+  // TCL variable sta_compact_delays.
+  // Keep graph arc delays and slews in 16 bits relative to a scale
+  // shared by the analysis points of each arc and vertex.
+  bool compactDelays() const;
+  void setCompactDelays(bool compact);
+  // Bytes used by the graph to store arc delays and slews.
+  size_t delayMemoryBytes() const;
   // TCL variable sta_propagate_gated_clock_enable.
   // Propagate gated clock enable arrivals.
   bool propagateGatedClockEnable() const;
@@ -885,7 +923,10 @@ public:
   void reportPathEnd(PathEnd *end,
 		     PathEnd *prev_end);
   void reportPathEnd(PathEnd *end);
+  // Group headers and full reports of ends. The report format is not used.
   void reportPathEnds(PathEndSeq *ends);
+  // Header, reportPathEnd of each end and footer.
+  void reportPathEndsFormatted(PathEndSeq *ends);
   ReportPath *reportPath() { return report_path_; }
   void reportPath(Path *path);
   // Update arrival times for all pins.
@@ -999,6 +1040,18 @@ public:
   Slack vertexSlack(Vertex *vertex,
 		    const TransRiseFall *tr,
 		    const PathAnalysisPt *path_ap);
+  // What-if endpoint slacks after changing instances (replaceCell etc).
+  // Delays and arrivals are only found in the fanout of changed_insts
+  // that is in the fanin of endpoints, and are not saved in the graph
+  // or search arrivals.
+  // Requireds must be found (findRequireds) before the change.
+  // Return false if the change affects clock arrivals, which requires
+  // updateTiming.
+  bool regionSlacks(InstanceSeq *changed_insts,
+		    VertexSeq *endpoints,
+		    const MinMax *min_max,
+		    // Return value.
+		    SlackSeq &slacks);
   // Slew for one delay calc analysis pt(corner).
   Slew vertexSlew(Vertex *vertex,
 		  const TransRiseFall *tr,
@@ -1104,6 +1157,34 @@ public:
   // disconnect_net
   virtual void disconnectPin(Pin *pin);
 
+  // ECO transactions (begin_eco, commit_eco, rollback_eco).
+  // Netlist edits made with the functions above after ecoBegin are
+  // undone by ecoRollback. Slews, arc delays, arrivals and requireds
+  // changed after ecoBegin are journaled. When the only edits are
+  // equivalent cell replacements (equivCells) ecoRollback restores
+  // the journaled timing instead of recomputing it. Otherwise the
+  // edits are undone and timing is updated incrementally.
+  // Edits that are not netlist edits (sdc, parasitics) are not undone,
+  // and ecoRollback updates timing incrementally after them.
+  // deleteInstance and deleteNet cannot be rolled back.
+  void ecoBegin();
+  // Keep the edits and discard the journal.
+  void ecoCommit();
+  void ecoRollback();
+  bool ecoActive() const { return eco_journal_ != nullptr; }
+
+  // Network edit batch (begin_edit_batch, end_edit_batch).
+  // Wire edges for pins connected by network edits between
+  // editBatchBegin and editBatchEnd are made in bulk, and the delay,
+  // arrival and required invalidations of the edits are collected so
+  // each vertex is invalidated once. Relevelization, delay calculation
+  // and arrival search are done once when the batch ends.
+  // The batch is flushed before the graph is used by timing queries
+  // inside the batch (ensureGraph).
+  void editBatchBegin();
+  void editBatchEnd();
+  bool editBatchActive() const { return edit_batch_ != nullptr; }
+
   // Network edit before/after methods.
   void makeInstanceAfter(Instance *inst);
   // Not used by Sta (connectPinAfter).
@@ -1182,6 +1263,22 @@ public:
 	     const Corner *corner,
 	     // Return values.
 	     PowerResult &result);
+  // Annotate pin activities from a SAIF or VCD file.
+  // Return true if the file was read.
+  bool readSaif(const char *filename,
+		const char *scope);
+  bool readVcd(const char *filename,
+	       const char *scope);
+  // Report power in windows of window_width of a VCD simulation run
+  // by hierarchical instance hier_depth levels below the top.
+  // Return true if the file was read.
+  bool reportPowerWindows(const char *vcd_filename,
+			  const char *scope,
+			  float window_width,
+			  int hier_depth,
+			  const Corner *corner,
+			  int digits,
+			  bool series);
 
   // Find equivalent cells in equiv_libs.
   // Optionally add mappings for cells in map_libs.
@@ -1248,7 +1345,17 @@ protected:
 		     const PathAnalysisPt *path_ap);
   void findRequired(Vertex *vertex);
   void connectDrvrPinAfter(Vertex *vertex);
+  void connectHierPinAfter(Pin *hpin);
   void connectLoadPinAfter(Vertex *vertex);
+  void ecoConnectPin(Instance *inst,
+		     Port *port);
+  void ecoUndo(const EcoEdit &edit);
+  void ecoGraphChanged();
+  size_t ecoInvalidCount() const;
+  void editBatchFlush();
+  void editArrivalInvalid(Vertex *vertex);
+  void editRequiredInvalid(Vertex *vertex);
+  void editDelayInvalid(Vertex *vertex);
   Path *latchEnablePath(Path *q_path,
 			Edge *d_q_edge,
 			const ClockEdge *en_clk_edge);
@@ -1303,6 +1410,9 @@ protected:
   void replaceCell(Instance *inst,
 		   Cell *to_cell,
 		   LibertyCell *to_lib_cell);
+  void ensureModes();
+  // Discard the arrivals of the modes that are not current.
+  void modeSearchesInvalid();
 
   CmdNamespace cmd_namespace_;
   Instance *current_instance_;
@@ -1318,7 +1428,17 @@ protected:
   Tcl_Interp *tcl_interp_;
   bool link_make_black_boxes_;
   bool update_genclks_;
+  bool compact_delays_;
   EquivCells *equiv_cells_;
+  // Journal of netlist edits since ecoBegin.
+  EcoJournal *eco_journal_;
+  // Network edits deferred since editBatchBegin.
+  EditBatch *edit_batch_;
+  // Constraints of each mode, including the current mode sdc_.
+  SdcModeMap modes_;
+  const char *mode_name_;
+  // Searches of the modes that are not current.
+  SearchModeMap mode_searches_;
 
   // Singleton sta used by tcl command interpreter.
   static Sta *sta_;
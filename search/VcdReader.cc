@@ -0,0 +1,324 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdlib.h>
+#include "Machine.hh"
+#include "Report.hh"
+#include "Network.hh"
+#include "Power.hh"
+#include "VcdReader.hh"
+
+namespace sta {
+
+using std::string;
+
+bool
+readVcd(const char *filename,
+	const char *scope,
+	Power *power)
+{
+  VcdReader reader(filename, scope, power);
+  return reader.read();
+}
+
+VcdReader::VcdReader(const char *filename,
+		     const char *scope,
+		     Power *power) :
+  ActivityReader(filename, scope, power),
+  time_(0),
+  start_time_(0),
+  has_time_(false)
+{
+}
+
+VcdReader::~VcdReader()
+{
+  vars_.deleteContents();
+}
+
+void
+VcdReader::readFile()
+{
+  if (readHeader()) {
+    readValueChanges();
+    annotateVars();
+  }
+}
+
+bool
+VcdReader::readHeader()
+{
+  while (readToken(token_)) {
+    if (token_ == "$scope")
+      readScope();
+    else if (token_ == "$upscope") {
+      popScope();
+      skipToEnd();
+    }
+    else if (token_ == "$var")
+      readVar();
+    else if (token_ == "$timescale") {
+      string timescale;
+      while (readToken(token_) && token_ != "$end")
+	timescale += token_;
+      parseTimescale(timescale);
+    }
+    else if (token_ == "$enddefinitions") {
+      skipToEnd();
+      return true;
+    }
+    else if (token_[0] == '$')
+      skipToEnd();
+  }
+  report_->fileError(filename_, line_, "$enddefinitions expected.\n");
+  return false;
+}
+
+// $scope module name $end
+void
+VcdReader::readScope()
+{
+  string name;
+  if (readToken(token_) && token_ != "$end"
+      && readToken(token_) && token_ != "$end") {
+    name = token_;
+    skipToEnd();
+  }
+  pushScope(name);
+}
+
+// $var type width id reference [range] $end
+void
+VcdReader::readVar()
+{
+  std::vector<string> tokens;
+  while (readToken(token_) && token_ != "$end")
+    tokens.push_back(token_);
+  Instance *inst = scopeInstance();
+  if (inst && tokens.size() >= 4) {
+    const string &type = tokens[0];
+    if (type == "real" || type == "realtime" || type == "event")
+      return;
+    int width = atoi(tokens[1].c_str());
+    const string &id = tokens[2];
+    string name = tokens[3];
+    string range;
+    if (tokens.size() >= 5)
+      range = tokens[4];
+    else {
+      size_t bracket = name.find('[');
+      if (bracket != string::npos && bracket > 0 && name[bracket - 1] != '\\') {
+	range = name.substr(bracket);
+	name.erase(bracket);
+      }
+    }
+    if (width < 1)
+      return;
+    // [msb:lsb] or [index]
+    int msb = width - 1;
+    int lsb = 0;
+    bool has_range = false;
+    if (!range.empty() && range[0] == '[') {
+      const char *str = range.c_str() + 1;
+      char *end;
+      msb = strtol(str, &end, 10);
+      lsb = msb;
+      if (*end == ':')
+	lsb = strtol(end + 1, &end, 10);
+      has_range = true;
+    }
+    VcdVar *var = vars_.findKey(id);
+    bool new_var = (var == nullptr);
+    if (new_var)
+      var = new VcdVar(width);
+    else if (var->width() != width)
+      return;
+    bool found_pins = false;
+    for (int i = 0; i < width; i++) {
+      string bit_name = name;
+      if (width > 1 || has_range) {
+	int index = (msb >= lsb) ? msb - i : msb + i;
+	bit_name += '[';
+	bit_name += std::to_string(index);
+	bit_name += ']';
+      }
+      PinSeq &pins = var->bit(i).pins();
+      size_t pin_count = pins.size();
+      findPins(inst, bit_name, pins);
+      // Scalar wires without a bit select match the whole name.
+      if (pins.size() == pin_count && width == 1 && has_range)
+	findPins(inst, name, pins);
+      found_pins |= (pins.size() > pin_count);
+    }
+    if (new_var) {
+      if (found_pins)
+	vars_[id] = var;
+      else
+	delete var;
+    }
+  }
+}
+
+void
+VcdReader::readValueChanges()
+{
+  while (readToken(token_)) {
+    char ch = token_[0];
+    switch (ch) {
+    case '#': {
+      time_ = strtoull(token_.c_str() + 1, nullptr, 10);
+      if (!has_time_) {
+	start_time_ = time_;
+	has_time_ = true;
+      }
+      break;
+    }
+    case '0':
+    case '1':
+    case 'x':
+    case 'X':
+    case 'z':
+    case 'Z':
+      setScalar(ch, token_.substr(1));
+      break;
+    case 'b':
+    case 'B': {
+      string value = token_.substr(1);
+      if (readToken(token_))
+	setVector(value, token_);
+      break;
+    }
+    case 'r':
+    case 'R':
+      // Real values are not logic signals.
+      readToken(token_);
+      break;
+    case '$':
+      if (token_ == "$comment")
+	skipToEnd();
+      // $dumpvars, $dumpall, $dumpon, $dumpoff and their $end are
+      // followed by value changes.
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void
+VcdReader::setScalar(char value,
+		     const string &id)
+{
+  VcdVar *var = vars_.findKey(id);
+  if (var)
+    setBitValue(var->bit(var->width() - 1), value);
+}
+
+void
+VcdReader::setVector(const string &value,
+		     const string &id)
+{
+  VcdVar *var = vars_.findKey(id);
+  if (var) {
+    int width = var->width();
+    int value_length = value.size();
+    // Values shorter than the variable are extended with 0, or x/z
+    // if the leftmost value bit is x/z.
+    char extend = (value_length > 0 && value[0] != '1') ? value[0] : '0';
+    for (int i = 0; i < width; i++) {
+      int value_index = i - (width - value_length);
+      char bit_value = (value_index >= 0) ? value[value_index] : extend;
+      setBitValue(var->bit(i), bit_value);
+    }
+  }
+}
+
+void
+VcdReader::setBitValue(VcdBit &bit,
+		       char value)
+{
+  bit.setValue(value, time_);
+}
+
+void
+VcdReader::annotateVars()
+{
+  double duration = time_ - start_time_;
+  for (auto id_var : vars_) {
+    VcdVar *var = id_var.second;
+    for (int i = 0; i < var->width(); i++) {
+      VcdBit &bit = var->bit(i);
+      bit.finish(time_);
+      for (Pin *pin : bit.pins())
+	annotate(pin, bit.toggles(), bit.highTime(), duration);
+    }
+  }
+}
+
+void
+VcdReader::skipToEnd()
+{
+  while (readToken(token_) && token_ != "$end") {
+  }
+}
+
+////////////////////////////////////////////////////////////////
+
+VcdBit::VcdBit() :
+  value_('x'),
+  time_(0),
+  toggles_(0),
+  high_time_(0),
+  index_(0)
+{
+}
+
+void
+VcdBit::setValue(char value,
+		 VcdTime time)
+{
+  if (value != '0' && value != '1')
+    value = 'x';
+  if (value != value_) {
+    if (value_ == '1')
+      high_time_ += time - time_;
+    if (value_ != 'x' && value != 'x')
+      toggles_++;
+    value_ = value;
+    time_ = time;
+  }
+}
+
+void
+VcdBit::finish(VcdTime time)
+{
+  if (value_ == '1')
+    high_time_ += time - time_;
+  time_ = time;
+}
+
+void
+VcdBit::setIndex(size_t index)
+{
+  index_ = index;
+}
+
+VcdVar::VcdVar(int width) :
+  bits_(width)
+{
+}
+
+} // namespace
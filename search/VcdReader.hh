@@ -0,0 +1,105 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_VCD_READER_H
+#define STA_VCD_READER_H
+
+#include <string>
+#include <vector>
+#include "UnorderedMap.hh"
+#include "ActivityReader.hh"
+
+namespace sta {
+
+typedef unsigned long long VcdTime;
+
+// Toggle count and time at 1 of one signal bit.
+class VcdBit
+{
+public:
+  VcdBit();
+  // Value is '0', '1' or 'x'.
+  char value() const { return value_; }
+  void setValue(char value,
+		VcdTime time);
+  void finish(VcdTime time);
+  double toggles() const { return toggles_; }
+  double highTime() const { return high_time_; }
+  PinSeq &pins() { return pins_; }
+  // Index of the bit in the state kept by VcdReader subclasses.
+  size_t index() const { return index_; }
+  void setIndex(size_t index);
+
+private:
+  char value_;
+  VcdTime time_;
+  VcdTime toggles_;
+  VcdTime high_time_;
+  PinSeq pins_;
+  size_t index_;
+};
+
+// Bits of a $var. Bit 0 is the most significant (leftmost) bit of
+// vector values.
+class VcdVar
+{
+public:
+  explicit VcdVar(int width);
+  int width() const { return bits_.size(); }
+  VcdBit &bit(int index) { return bits_[index]; }
+
+private:
+  std::vector<VcdBit> bits_;
+};
+
+typedef UnorderedMap<std::string, VcdVar*> VcdVarMap;
+
+// Value Change Dump reader.
+// Only the toggle counts and time at 1 of the variables that map onto
+// design pins are kept while the value changes are read.
+class VcdReader : public ActivityReader
+{
+public:
+  VcdReader(const char *filename,
+	    const char *scope,
+	    Power *power);
+  ~VcdReader();
+
+protected:
+  virtual void readFile();
+  bool readHeader();
+  void readScope();
+  void readVar();
+  void readValueChanges();
+  void setScalar(char value,
+		 const std::string &id);
+  void setVector(const std::string &value,
+		 const std::string &id);
+  // Called for every value change of a bit mapped onto design pins.
+  virtual void setBitValue(VcdBit &bit,
+			   char value);
+  void annotateVars();
+  void skipToEnd();
+
+  std::string token_;
+  VcdVarMap vars_;
+  VcdTime time_;
+  VcdTime start_time_;
+  bool has_time_;
+};
+
+} // namespace
+#endif
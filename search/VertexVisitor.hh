@@ -32,6 +32,9 @@ public:
   virtual VertexVisitor *copy() = 0;
   virtual void visit(Vertex *vertex) = 0;
   void operator()(Vertex *vertex) { visit(vertex); }
+  // Called by BfsIterator::visit/visitParallel after the vertices of
+  // a level are visited.
+  virtual void levelFinished(Level /* level */) {}
 
 private:
   DISALLOW_COPY_AND_ASSIGN(VertexVisitor);
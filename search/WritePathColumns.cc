@@ -0,0 +1,791 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Machine.hh"
+#include "Error.hh"
+#include "StringUtil.hh"
+#include "Report.hh"
+#include "Units.hh"
+#include "UnorderedMap.hh"
+#include "ThreadForEach.hh"
+#include "MinMax.hh"
+#include "Transition.hh"
+#include "TimingRole.hh"
+#include "TimingArc.hh"
+#include "Network.hh"
+#include "Graph.hh"
+#include "Sdc.hh"
+#include "DcalcAnalysisPt.hh"
+#include "ArcDelayCalc.hh"
+#include "GraphDelayCalc.hh"
+#include "PathAnalysisPt.hh"
+#include "PathRef.hh"
+#include "PathEnd.hh"
+#include "PathExpanded.hh"
+#include "PathGroup.hh"
+#include "Search.hh"
+#include "ReportPath.hh"
+#include "StaState.hh"
+#include "WritePathColumns.hh"
+
+namespace sta {
+
+using std::string;
+using std::vector;
+
+typedef UnorderedMap<const void*, uint32_t> PathColumnStringIndexMap;
+
+class PathColumn
+{
+public:
+  const char *name_;
+  // 'u' uint32, 'b' uint8, 'f' float32
+  char type_;
+};
+
+// Chunks write their columns in the order of these tables.
+static const PathColumn path_columns[] = {
+  {"end_pin", 'u'},
+  {"start_pin", 'u'},
+  {"group", 'u'},
+  {"path_type", 'u'},
+  // 0 min, 1 max
+  {"min_max", 'b'},
+  // 0 rise, 1 fall
+  {"end_transition", 'b'},
+  {"arrival", 'f'},
+  {"required", 'f'},
+  {"slack", 'f'},
+  // Stage table rows of the path in the chunk.
+  {"stage_begin", 'u'},
+  {"stage_count", 'u'}
+};
+
+static const PathColumn stage_columns[] = {
+  {"pin", 'u'},
+  // Timing role of the arc to the pin; empty for the first stage.
+  {"arc", 'u'},
+  {"transition", 'b'},
+  {"is_clock", 'b'},
+  {"delay", 'f'},
+  {"slew", 'f'},
+  {"cap", 'f'},
+  {"fanout", 'f'},
+  {"arrival", 'f'},
+  // Stage arrival plus the path required minus the path arrival.
+  {"required", 'f'}
+};
+
+static const float column_blank = std::numeric_limits<float>::quiet_NaN();
+
+class PathColumnChunk
+{
+public:
+  PathColumnChunk();
+  void clear();
+  // Index of the string for key, adding str if key is new.
+  uint32_t stringIndex(const void *key,
+		       const char *str);
+  bool findString(const void *key,
+		  // Return value.
+		  uint32_t &index) const;
+
+  PathColumnStringIndexMap string_indices_;
+  vector<uint32_t> string_offsets_;
+  string string_chars_;
+
+  // Path table.
+  vector<uint32_t> end_pin_;
+  vector<uint32_t> start_pin_;
+  vector<uint32_t> group_;
+  vector<uint32_t> path_type_;
+  vector<uint8_t> min_max_;
+  vector<uint8_t> end_tr_;
+  vector<float> arrival_;
+  vector<float> required_;
+  vector<float> slack_;
+  vector<uint32_t> stage_begin_;
+  vector<uint32_t> stage_count_;
+
+  // Stage table.
+  vector<uint32_t> pin_;
+  vector<uint32_t> arc_;
+  vector<uint8_t> tr_;
+  vector<uint8_t> is_clk_;
+  vector<float> delay_;
+  vector<float> slew_;
+  vector<float> cap_;
+  vector<float> fanout_;
+  vector<float> stage_arrival_;
+  vector<float> stage_required_;
+};
+
+PathColumnChunk::PathColumnChunk() :
+  string_offsets_({0})
+{
+}
+
+void
+PathColumnChunk::clear()
+{
+  string_indices_.clear();
+  string_offsets_.clear();
+  string_offsets_.push_back(0);
+  string_chars_.clear();
+
+  end_pin_.clear();
+  start_pin_.clear();
+  group_.clear();
+  path_type_.clear();
+  min_max_.clear();
+  end_tr_.clear();
+  arrival_.clear();
+  required_.clear();
+  slack_.clear();
+  stage_begin_.clear();
+  stage_count_.clear();
+
+  pin_.clear();
+  arc_.clear();
+  tr_.clear();
+  is_clk_.clear();
+  delay_.clear();
+  slew_.clear();
+  cap_.clear();
+  fanout_.clear();
+  stage_arrival_.clear();
+  stage_required_.clear();
+}
+
+bool
+PathColumnChunk::findString(const void *key,
+			    // Return value.
+			    uint32_t &index) const
+{
+  bool exists;
+  string_indices_.findKey(key, index, exists);
+  return exists;
+}
+
+uint32_t
+PathColumnChunk::stringIndex(const void *key,
+			     const char *str)
+{
+  uint32_t index;
+  if (!findString(key, index)) {
+    index = string_offsets_.size() - 1;
+    string_chars_ += str;
+    string_offsets_.push_back(string_chars_.size());
+    string_indices_[key] = index;
+  }
+  return index;
+}
+
+////////////////////////////////////////////////////////////////
+
+class WritePathColumns : public StaState
+{
+public:
+  WritePathColumns(PathEndSeq *ends,
+		   const char *filename,
+		   const StaState *sta);
+  ~WritePathColumns();
+  void writeColumns();
+
+protected:
+  void writeSchema();
+  void writeTable(const char *name,
+		  const PathColumn *columns,
+		  size_t column_count);
+  void makeChunk(size_t ends_begin,
+		 size_t ends_end,
+		 ArcDelayCalc *arc_delay_calc,
+		 PathColumnChunk &chunk);
+  void makePath(PathEnd *end,
+		ArcDelayCalc *arc_delay_calc,
+		PathColumnChunk &chunk);
+  uint32_t pinIndex(const Pin *pin,
+		    PathColumnChunk &chunk);
+  void writeChunks(vector<PathColumnChunk> &chunks,
+		   size_t chunk_count);
+  void writeChunk(PathColumnChunk &chunk);
+  template <class T>
+  void writeColumn(const vector<T> &column);
+  void writeUint32(uint32_t value);
+  void writeString(const char *str);
+
+  PathEndSeq *ends_;
+  const char *filename_;
+  FILE *stream_;
+  // Delay calculator of each thread for the whole file because
+  // finding parasitics is not thread safe.
+  vector<ArcDelayCalc*> arc_delay_calcs_;
+
+  // Path ends in each chunk.
+  static const size_t chunk_ends_;
+  static const size_t stream_buffer_size_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(WritePathColumns);
+};
+
+const size_t WritePathColumns::chunk_ends_ = 1024;
+const size_t WritePathColumns::stream_buffer_size_ = 1 << 20;
+
+void
+writePathColumns(PathEndSeq *ends,
+		 const char *filename,
+		 StaState *sta)
+{
+  WritePathColumns writer(ends, filename, sta);
+  writer.writeColumns();
+}
+
+WritePathColumns::WritePathColumns(PathEndSeq *ends,
+				   const char *filename,
+				   const StaState *sta) :
+  StaState(sta),
+  ends_(ends),
+  filename_(filename),
+  stream_(nullptr)
+{
+}
+
+// Closes the file if a chunk thread threw.
+WritePathColumns::~WritePathColumns()
+{
+  if (stream_)
+    fclose(stream_);
+  for (ArcDelayCalc *arc_delay_calc : arc_delay_calcs_)
+    delete arc_delay_calc;
+}
+
+void
+WritePathColumns::writeColumns()
+{
+  stream_ = fopen(filename_, "wb");
+  if (stream_ == nullptr)
+    throw FileNotWritable(filename_);
+  setvbuf(stream_, nullptr, _IOFBF, stream_buffer_size_);
+  writeSchema();
+
+  size_t end_count = ends_->size();
+  size_t thread_count = std::max(thread_count_, 1);
+  size_t batch_size = chunk_ends_ * thread_count;
+  vector<PathColumnChunk> chunks(thread_count);
+  vector<PathColumnChunk> prev_chunks(thread_count);
+  size_t prev_chunk_count = 0;
+  if (thread_count > 1) {
+    for (size_t i = 0; i < thread_count; i++)
+      arc_delay_calcs_.push_back(arc_delay_calc_
+				 ? arc_delay_calc_->copy()
+				 : nullptr);
+  }
+  for (size_t batch_begin = 0; batch_begin < end_count;
+       batch_begin += batch_size) {
+    size_t batch_end = std::min(batch_begin + batch_size, end_count);
+    size_t chunk_count = (batch_end - batch_begin + chunk_ends_ - 1)
+      / chunk_ends_;
+    auto make_chunk = [=, &chunks] (size_t chunk_index,
+				    ArcDelayCalc *arc_delay_calc) {
+      size_t ends_begin = batch_begin + chunk_index * chunk_ends_;
+      size_t ends_end = std::min(ends_begin + chunk_ends_, batch_end);
+      makeChunk(ends_begin, ends_end, arc_delay_calc, chunks[chunk_index]);
+    };
+    if (thread_count > 1) {
+      // The last thread writes the previous batch while this one is built.
+      // forEachThread rethrows an exception from a thread after the join.
+      forEachThread(chunk_count + 1, [&] (size_t i) {
+	if (i == chunk_count)
+	  writeChunks(prev_chunks, prev_chunk_count);
+	else
+	  make_chunk(i, arc_delay_calcs_[i]);
+      });
+    }
+    else {
+      writeChunks(prev_chunks, prev_chunk_count);
+      make_chunk(0, arc_delay_calc_);
+    }
+    std::swap(chunks, prev_chunks);
+    prev_chunk_count = chunk_count;
+  }
+  writeChunks(prev_chunks, prev_chunk_count);
+  // An empty chunk marks the end of the file.
+  PathColumnChunk end_chunk;
+  writeChunk(end_chunk);
+
+  FILE *stream = stream_;
+  stream_ = nullptr;
+  bool write_error = ferror(stream);
+  if (fclose(stream) != 0 || write_error)
+    throw FileNotWritable(filename_);
+}
+
+void
+WritePathColumns::writeSchema()
+{
+  fwrite("STAPCOL1", 1, 8, stream_);
+  // Byte order mark.
+  writeUint32(0x01020304);
+  writeUint32(2);
+  writeTable("paths", path_columns,
+	     sizeof(path_columns) / sizeof(path_columns[0]));
+  writeTable("stages", stage_columns,
+	     sizeof(stage_columns) / sizeof(stage_columns[0]));
+}
+
+void
+WritePathColumns::writeTable(const char *name,
+			     const PathColumn *columns,
+			     size_t column_count)
+{
+  writeString(name);
+  writeUint32(column_count);
+  for (size_t i = 0; i < column_count; i++) {
+    writeString(columns[i].name_);
+    fputc(columns[i].type_, stream_);
+  }
+}
+
+void
+WritePathColumns::makeChunk(size_t ends_begin,
+			    size_t ends_end,
+			    ArcDelayCalc *arc_delay_calc,
+			    PathColumnChunk &chunk)
+{
+  chunk.clear();
+  for (size_t i = ends_begin; i < ends_end; i++)
+    makePath((*ends_)[i], arc_delay_calc, chunk);
+}
+
+void
+WritePathColumns::makePath(PathEnd *end,
+			   ArcDelayCalc *arc_delay_calc,
+			   PathColumnChunk &chunk)
+{
+  PathExpanded expanded(end->path(), this);
+  const MinMax *min_max = end->minMax(this);
+  DcalcAnalysisPt *dcalc_ap = end->pathAnalysisPt(this)->dcalcAnalysisPt();
+  DcalcAPIndex ap_index = dcalc_ap->index();
+  float time_offset = end->sourceClkOffset(this);
+  float end_arrival = delayAsFloat(end->dataArrivalTimeOffset(this));
+  float end_required = delayAsFloat(end->requiredTimeOffset(this));
+  PathGroup *group = search_->pathGroup(end);
+  const char *type_name = end->typeName();
+
+  chunk.end_pin_.push_back(pinIndex(end->vertex(this)->pin(), chunk));
+  chunk.start_pin_.push_back(pinIndex(expanded.startPath()->pin(this), chunk));
+  chunk.group_.push_back(chunk.stringIndex(group, group ? group->name() : ""));
+  chunk.path_type_.push_back(chunk.stringIndex(type_name, type_name));
+  chunk.min_max_.push_back(min_max->index());
+  chunk.end_tr_.push_back(end->transition(this)->index());
+  chunk.arrival_.push_back(end_arrival);
+  chunk.required_.push_back(end_required);
+  chunk.slack_.push_back(delayAsFloat(end->slack(this)));
+  chunk.stage_begin_.push_back(chunk.pin_.size());
+  chunk.stage_count_.push_back(expanded.size());
+
+  float required_offset = end_required - end_arrival;
+  float prev_time = 0.0;
+  for (size_t i = 0; i < expanded.size(); i++) {
+    PathRef *path = expanded.path(i);
+    TimingArc *prev_arc = expanded.prevArc(i);
+    Vertex *vertex = path->vertex(this);
+    Pin *pin = vertex->pin();
+    const TransRiseFall *tr = path->transition(this);
+    float time = delayAsFloat(path->arrival(this)) + time_offset;
+    TimingRole *role = prev_arc ? prev_arc->role() : nullptr;
+    bool is_driver = network_->isDriver(pin);
+    chunk.pin_.push_back(pinIndex(pin, chunk));
+    chunk.arc_.push_back(chunk.stringIndex(role,
+					   role ? role->asString() : ""));
+    chunk.tr_.push_back(tr->index());
+    chunk.is_clk_.push_back(path->isClock(search_));
+    chunk.delay_.push_back(prev_arc ? time - prev_time : 0.0F);
+    chunk.slew_.push_back(delayAsFloat(graph_->slew(vertex, tr, ap_index)));
+    chunk.cap_.push_back(is_driver
+			 ? drvrLoadCap(pin, tr, dcalc_ap, arc_delay_calc, this)
+			 : column_blank);
+    chunk.fanout_.push_back(is_driver
+			    ? drvrFanout(vertex, min_max, this)
+			    : column_blank);
+    chunk.stage_arrival_.push_back(time);
+    chunk.stage_required_.push_back(time + required_offset);
+    prev_time = time;
+  }
+}
+
+uint32_t
+WritePathColumns::pinIndex(const Pin *pin,
+			   PathColumnChunk &chunk)
+{
+  uint32_t index;
+  // Only make the path name the first time the pin is in the chunk.
+  if (!chunk.findString(pin, index))
+    index = chunk.stringIndex(pin, cmd_network_->pathName(pin));
+  return index;
+}
+
+void
+WritePathColumns::writeChunks(vector<PathColumnChunk> &chunks,
+			      size_t chunk_count)
+{
+  for (size_t i = 0; i < chunk_count; i++)
+    writeChunk(chunks[i]);
+}
+
+void
+WritePathColumns::writeChunk(PathColumnChunk &chunk)
+{
+  writeUint32(chunk.end_pin_.size());
+  writeUint32(chunk.pin_.size());
+  writeUint32(chunk.string_offsets_.size() - 1);
+  writeUint32(chunk.string_chars_.size());
+  writeColumn(chunk.string_offsets_);
+  fwrite(chunk.string_chars_.data(), 1, chunk.string_chars_.size(), stream_);
+
+  // Path table in path_columns order.
+  writeColumn(chunk.end_pin_);
+  writeColumn(chunk.start_pin_);
+  writeColumn(chunk.group_);
+  writeColumn(chunk.path_type_);
+  writeColumn(chunk.min_max_);
+  writeColumn(chunk.end_tr_);
+  writeColumn(chunk.arrival_);
+  writeColumn(chunk.required_);
+  writeColumn(chunk.slack_);
+  writeColumn(chunk.stage_begin_);
+  writeColumn(chunk.stage_count_);
+
+  // Stage table in stage_columns order.
+  writeColumn(chunk.pin_);
+  writeColumn(chunk.arc_);
+  writeColumn(chunk.tr_);
+  writeColumn(chunk.is_clk_);
+  writeColumn(chunk.delay_);
+  writeColumn(chunk.slew_);
+  writeColumn(chunk.cap_);
+  writeColumn(chunk.fanout_);
+  writeColumn(chunk.stage_arrival_);
+  writeColumn(chunk.stage_required_);
+}
+
+template <class T>
+void
+WritePathColumns::writeColumn(const vector<T> &column)
+{
+  fwrite(column.data(), sizeof(T), column.size(), stream_);
+}
+
+void
+WritePathColumns::writeUint32(uint32_t value)
+{
+  fwrite(&value, sizeof(value), 1, stream_);
+}
+
+void
+WritePathColumns::writeString(const char *str)
+{
+  size_t length = strlen(str);
+  writeUint32(length);
+  fwrite(str, 1, length, stream_);
+}
+
+////////////////////////////////////////////////////////////////
+
+class ReportPathColumns : public StaState
+{
+public:
+  ReportPathColumns(const char *filename,
+		    const StaState *sta);
+  ~ReportPathColumns();
+  bool reportColumns();
+
+protected:
+  bool readSchema();
+  bool readTable(const char *name,
+		 const PathColumn *columns,
+		 size_t column_count);
+  bool readChunk(PathColumnChunk &chunk);
+  bool reportChunk(const PathColumnChunk &chunk);
+  bool chunkString(const PathColumnChunk &chunk,
+		   uint32_t index,
+		   // Return value.
+		   string &str);
+  const char *timeString(float value);
+  template <class T>
+  bool readColumn(vector<T> &column,
+		  size_t count);
+  bool readUint32(uint32_t &value);
+  bool readString(string &str);
+
+  const char *filename_;
+  FILE *stream_;
+  size_t path_count_;
+  size_t stage_count_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ReportPathColumns);
+};
+
+bool
+reportPathColumns(const char *filename,
+		  StaState *sta)
+{
+  ReportPathColumns reporter(filename, sta);
+  return reporter.reportColumns();
+}
+
+ReportPathColumns::ReportPathColumns(const char *filename,
+				     const StaState *sta) :
+  StaState(sta),
+  filename_(filename),
+  stream_(nullptr),
+  path_count_(0),
+  stage_count_(0)
+{
+}
+
+ReportPathColumns::~ReportPathColumns()
+{
+  if (stream_)
+    fclose(stream_);
+}
+
+bool
+ReportPathColumns::reportColumns()
+{
+  stream_ = fopen(filename_, "rb");
+  if (stream_ == nullptr)
+    throw FileNotReadable(filename_);
+  if (!readSchema()) {
+    report_->error("%s is not a path column file.\n", filename_);
+    return false;
+  }
+  PathColumnChunk chunk;
+  while (true) {
+    if (!readChunk(chunk)) {
+      report_->error("path column file %s is truncated or corrupt.\n",
+		     filename_);
+      return false;
+    }
+    // The end chunk has no paths.
+    if (chunk.end_pin_.empty())
+      break;
+    if (!reportChunk(chunk)) {
+      report_->error("path column file %s is truncated or corrupt.\n",
+		     filename_);
+      return false;
+    }
+  }
+  report_->print("%lu paths %lu stages\n", path_count_, stage_count_);
+  return true;
+}
+
+bool
+ReportPathColumns::readSchema()
+{
+  char magic[8];
+  uint32_t byte_order, table_count;
+  return fread(magic, 1, 8, stream_) == 8
+    && memcmp(magic, "STAPCOL1", 8) == 0
+    && readUint32(byte_order)
+    && byte_order == 0x01020304
+    && readUint32(table_count)
+    && table_count == 2
+    && readTable("paths", path_columns,
+		 sizeof(path_columns) / sizeof(path_columns[0]))
+    && readTable("stages", stage_columns,
+		 sizeof(stage_columns) / sizeof(stage_columns[0]));
+}
+
+// The table must have the columns this version writes.
+bool
+ReportPathColumns::readTable(const char *name,
+			     const PathColumn *columns,
+			     size_t column_count)
+{
+  string table_name;
+  uint32_t count;
+  if (!(readString(table_name)
+	&& table_name == name
+	&& readUint32(count)
+	&& count == column_count))
+    return false;
+  for (size_t i = 0; i < column_count; i++) {
+    string column_name;
+    if (!(readString(column_name)
+	  && column_name == columns[i].name_
+	  && fgetc(stream_) == columns[i].type_))
+      return false;
+  }
+  return true;
+}
+
+bool
+ReportPathColumns::readChunk(PathColumnChunk &chunk)
+{
+  uint32_t path_count, stage_count, string_count, string_bytes;
+  if (!(readUint32(path_count)
+	&& readUint32(stage_count)
+	&& readUint32(string_count)
+	&& readUint32(string_bytes)))
+    return false;
+  chunk.clear();
+  chunk.string_chars_.resize(string_bytes);
+  return readColumn(chunk.string_offsets_, string_count + 1)
+    && fread(&chunk.string_chars_[0], 1, string_bytes, stream_) == string_bytes
+    // Path table in path_columns order.
+    && readColumn(chunk.end_pin_, path_count)
+    && readColumn(chunk.start_pin_, path_count)
+    && readColumn(chunk.group_, path_count)
+    && readColumn(chunk.path_type_, path_count)
+    && readColumn(chunk.min_max_, path_count)
+    && readColumn(chunk.end_tr_, path_count)
+    && readColumn(chunk.arrival_, path_count)
+    && readColumn(chunk.required_, path_count)
+    && readColumn(chunk.slack_, path_count)
+    && readColumn(chunk.stage_begin_, path_count)
+    && readColumn(chunk.stage_count_, path_count)
+    // Stage table in stage_columns order.
+    && readColumn(chunk.pin_, stage_count)
+    && readColumn(chunk.arc_, stage_count)
+    && readColumn(chunk.tr_, stage_count)
+    && readColumn(chunk.is_clk_, stage_count)
+    && readColumn(chunk.delay_, stage_count)
+    && readColumn(chunk.slew_, stage_count)
+    && readColumn(chunk.cap_, stage_count)
+    && readColumn(chunk.fanout_, stage_count)
+    && readColumn(chunk.stage_arrival_, stage_count)
+    && readColumn(chunk.stage_required_, stage_count);
+}
+
+// Strings are looked up so files written with different chunks
+// report the same.
+bool
+ReportPathColumns::reportChunk(const PathColumnChunk &chunk)
+{
+  Unit *cap_unit = units_->capacitanceUnit();
+  size_t stage_count = chunk.pin_.size();
+  for (size_t i = 0; i < chunk.end_pin_.size(); i++) {
+    string end_pin, start_pin, group, path_type;
+    size_t stage_begin = chunk.stage_begin_[i];
+    size_t stage_end = stage_begin + chunk.stage_count_[i];
+    if (!(chunkString(chunk, chunk.end_pin_[i], end_pin)
+	  && chunkString(chunk, chunk.start_pin_[i], start_pin)
+	  && chunkString(chunk, chunk.group_[i], group)
+	  && chunkString(chunk, chunk.path_type_[i], path_type)
+	  && stage_end <= stage_count))
+      return false;
+    path_count_++;
+    report_->print("Path %lu %s %s %s %s %s %s\n",
+		   path_count_,
+		   start_pin.c_str(),
+		   end_pin.c_str(),
+		   group.c_str(),
+		   path_type.c_str(),
+		   MinMax::find(chunk.min_max_[i])->asString(),
+		   TransRiseFall::find(chunk.end_tr_[i])->asString());
+    report_->print("  arrival %s required %s slack %s\n",
+		   timeString(chunk.arrival_[i]),
+		   timeString(chunk.required_[i]),
+		   timeString(chunk.slack_[i]));
+    for (size_t j = stage_begin; j < stage_end; j++) {
+      string pin, arc;
+      if (!(chunkString(chunk, chunk.pin_[j], pin)
+	    && chunkString(chunk, chunk.arc_[j], arc)))
+	return false;
+      stage_count_++;
+      report_->print("  %s %s %s%s\n",
+		     pin.c_str(),
+		     arc.empty() ? "-" : arc.c_str(),
+		     TransRiseFall::find(chunk.tr_[j])->asString(),
+		     chunk.is_clk_[j] ? " clock" : "");
+      report_->print("    delay %s slew %s cap %s fanout %s"
+		     " arrival %s required %s\n",
+		     timeString(chunk.delay_[j]),
+		     timeString(chunk.slew_[j]),
+		     std::isnan(chunk.cap_[j])
+		     ? "-"
+		     : cap_unit->asString(chunk.cap_[j]),
+		     std::isnan(chunk.fanout_[j])
+		     ? "-"
+		     : stringPrintTmp("%.0f", chunk.fanout_[j]),
+		     timeString(chunk.stage_arrival_[j]),
+		     timeString(chunk.stage_required_[j]));
+    }
+  }
+  return true;
+}
+
+bool
+ReportPathColumns::chunkString(const PathColumnChunk &chunk,
+			       uint32_t index,
+			       // Return value.
+			       string &str)
+{
+  const vector<uint32_t> &offsets = chunk.string_offsets_;
+  if (index + 1 < offsets.size()
+      && offsets[index] <= offsets[index + 1]
+      && offsets[index + 1] <= chunk.string_chars_.size()) {
+    str.assign(chunk.string_chars_, offsets[index],
+	       offsets[index + 1] - offsets[index]);
+    return true;
+  }
+  else
+    return false;
+}
+
+const char *
+ReportPathColumns::timeString(float value)
+{
+  return std::isnan(value) ? "-" : units_->timeUnit()->asString(value);
+}
+
+template <class T>
+bool
+ReportPathColumns::readColumn(vector<T> &column,
+			      size_t count)
+{
+  column.resize(count);
+  return fread(column.data(), sizeof(T), count, stream_) == count;
+}
+
+bool
+ReportPathColumns::readUint32(uint32_t &value)
+{
+  return fread(&value, sizeof(value), 1, stream_) == 1;
+}
+
+bool
+ReportPathColumns::readString(string &str)
+{
+  uint32_t length;
+  if (!readUint32(length))
+    return false;
+  str.resize(length);
+  return fread(&str[0], 1, length, stream_) == length;
+}
+
+} // namespace
@@ -0,0 +1,65 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_WRITE_PATH_COLUMNS_H
+#define STA_WRITE_PATH_COLUMNS_H
+
+#include "SearchClass.hh"
+
+namespace sta {
+
+class StaState;
+
+// Write path ends and the stages of their paths to a binary file of
+// column chunks for programs that read timing paths in bulk.
+//
+// Chunks are built by the threads set by set_thread_count and written
+// while the next chunks are built, so only a few chunks are in memory.
+// All values are in the byte order of the machine that writes the file.
+//
+//  file:   "STAPCOL1" uint32 0x01020304 schema chunk* end_chunk
+//  schema: uint32 table_count, per table:
+//            string name, uint32 column_count,
+//            per column: string name, uint8 type
+//          type: 'u' uint32, 'b' uint8, 'f' float32
+//  string: uint32 length, chars
+//  chunk:  uint32 path_count, uint32 stage_count,
+//          uint32 string_count, uint32 string_bytes,
+//          uint32 string_offsets[string_count + 1], chars[string_bytes],
+//          path table columns, each path_count values,
+//          stage table columns, each stage_count values
+//  end_chunk: chunk with zero paths, stages and strings
+//
+// Pin, group, path type and arc role columns are indices into the
+// strings of their chunk. Times, slews and caps are in SI units.
+// Float columns are NaN where there is no value (cap and fanout of
+// load pins).
+// Throws FileNotWritable
+void
+writePathColumns(PathEndSeq *ends,
+		 const char *filename,
+		 StaState *sta);
+
+// Read a file written by writePathColumns and report a line for each
+// row of the path and stage tables. Returns false if the file is not
+// a path column file or is truncated.
+// Throws FileNotReadable
+bool
+reportPathColumns(const char *filename,
+		  StaState *sta);
+
+} // namespace
+#endif
@@ -2018,6 +2018,31 @@ proc write_path_spice { args } {
   }
 }
 
+################################################################
+
+define_cmd_args "write_path_columns" {[-path_args path_args] filename}
+
+proc write_path_columns { args } {
+  parse_key_args "write_path_columns" args keys {-path_args} flags {}
+
+  check_argc_eq1 "write_path_columns" $args
+  set filename [file_expand_tilde [lindex $args 0]]
+  set path_args {}
+  if { [info exists keys(-path_args)] } {
+    set path_args $keys(-path_args)
+  }
+  set path_ends [eval [concat find_timing_paths $path_args]]
+  write_path_columns_cmd $path_ends $filename
+}
+
+define_cmd_args "report_path_columns" {filename}
+
+proc report_path_columns { args } {
+  check_argc_eq1 "report_path_columns" $args
+  set filename [file_expand_tilde [lindex $args 0]]
+  return [report_path_columns_cmd $filename]
+}
+
 proc file_expand_tilde { filename } {
   global env
 
@@ -68,9 +68,8 @@ Net *
 make_net_cmd(const char *name,
 	     Instance *parent)
 {
-  Net *net = cmdEditNetwork()->makeNet(name, parent);
-  // Sta notification unnecessary.
-  return net;
+  cmdEditNetwork();
+  return Sta::sta()->makeNet(name, parent);
 }
 
 void
@@ -93,4 +92,48 @@ disconnect_pin_cmd(Pin *pin)
   Sta::sta()->disconnectPin(pin);
 }
 
+void
+begin_eco_cmd()
+{
+  cmdEditNetwork();
+  Sta::sta()->ecoBegin();
+}
+
+void
+commit_eco_cmd()
+{
+  Sta::sta()->ecoCommit();
+}
+
+void
+rollback_eco_cmd()
+{
+  Sta::sta()->ecoRollback();
+}
+
+bool
+eco_active()
+{
+  return Sta::sta()->ecoActive();
+}
+
+void
+begin_edit_batch_cmd()
+{
+  cmdEditNetwork();
+  Sta::sta()->editBatchBegin();
+}
+
+void
+end_edit_batch_cmd()
+{
+  Sta::sta()->editBatchEnd();
+}
+
+bool
+edit_batch_active()
+{
+  return Sta::sta()->editBatchActive();
+}
+
 %} // inline
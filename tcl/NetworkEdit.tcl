@@ -263,5 +263,49 @@ proc insert_buffer { buffer_name buffer_cell net load_pins buffer_out_net_name }
   }
 }
 
+################################################################
+
+proc begin_eco { args } {
+  check_argc_eq0 "begin_eco" $args
+  if { [eco_active] } {
+    sta_error "eco already begun."
+  }
+  begin_eco_cmd
+}
+
+proc commit_eco { args } {
+  check_argc_eq0 "commit_eco" $args
+  if { ![eco_active] } {
+    sta_error "no eco to commit."
+  }
+  commit_eco_cmd
+}
+
+proc rollback_eco { args } {
+  check_argc_eq0 "rollback_eco" $args
+  if { ![eco_active] } {
+    sta_error "no eco to roll back."
+  }
+  rollback_eco_cmd
+}
+
+################################################################
+
+proc begin_edit_batch { args } {
+  check_argc_eq0 "begin_edit_batch" $args
+  if { [edit_batch_active] } {
+    sta_error "edit batch already begun."
+  }
+  begin_edit_batch_cmd
+}
+
+proc end_edit_batch { args } {
+  check_argc_eq0 "end_edit_batch" $args
+  if { ![edit_batch_active] } {
+    sta_error "no edit batch to end."
+  }
+  end_edit_batch_cmd
+}
+
 # sta namespace end.
 }
@@ -244,5 +244,78 @@ proc set_power_activity { args } {
   }
 }
 
+################################################################
+
+define_cmd_args "read_saif" {[-scope scope] filename}
+
+proc read_saif { args } {
+  parse_key_args "read_saif" args keys {-scope} flags {}
+  check_argc_eq1 "read_saif" $args
+  set filename [file nativename [lindex $args 0]]
+  set scope ""
+  if { [info exists keys(-scope)] } {
+    set scope $keys(-scope)
+  }
+  return [read_saif_file $filename $scope]
+}
+
+define_cmd_args "read_vcd" {[-scope scope] filename}
+
+proc read_vcd { args } {
+  parse_key_args "read_vcd" args keys {-scope} flags {}
+  check_argc_eq1 "read_vcd" $args
+  set filename [file nativename [lindex $args 0]]
+  set scope ""
+  if { [info exists keys(-scope)] } {
+    set scope $keys(-scope)
+  }
+  return [read_vcd_file $filename $scope]
+}
+
+define_cmd_args "report_power_windows" \
+  { -window window\
+      [-scope scope]\
+      [-hierarchy_depth depth]\
+      [-corner corner_name]\
+      [-digits digits]\
+      [-series]\
+      filename\
+      [> filename] [>> filename] }
+
+proc_redirect report_power_windows {
+  global sta_report_default_digits
+
+  parse_key_args "report_power_windows" args \
+    keys {-window -scope -hierarchy_depth -corner -digits} flags {-series} 1
+  check_argc_eq1 "report_power_windows" $args
+  set filename [file nativename [lindex $args 0]]
+
+  if { ![info exists keys(-window)] } {
+    sta_error "report_power_windows missing -window."
+  }
+  set window $keys(-window)
+  check_positive_float "-window" $window
+  set window [time_ui_sta $window]
+  set scope ""
+  if { [info exists keys(-scope)] } {
+    set scope $keys(-scope)
+  }
+  set depth 1
+  if { [info exists keys(-hierarchy_depth)] } {
+    set depth $keys(-hierarchy_depth)
+    check_cardinal "-hierarchy_depth" $depth
+  }
+  if { [info exists keys(-digits)] } {
+    set digits $keys(-digits)
+    check_positive_integer "-digits" $digits
+  } else {
+    set digits $sta_report_default_digits
+  }
+  set corner [parse_corner keys]
+  set series [info exists flags(-series)]
+  report_power_windows_cmd $filename $scope $window $depth $corner \
+    $digits $series
+}
+
 # sta namespace end.
 }
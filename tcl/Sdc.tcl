@@ -26,15 +26,26 @@
 
 namespace eval sta {
 
-define_cmd_args "read_sdc" {[-echo] filename}
+define_cmd_args "read_sdc" {[-echo] [-bulk] filename}
 
 proc_redirect read_sdc {
-  parse_key_args "read_sdc" args keys {} flags {-echo}
+  parse_key_args "read_sdc" args keys {} flags {-echo -bulk}
 
   check_argc_eq1 "read_sdc" $args
   set echo [info exists flags(-echo)]
+  set bulk [info exists flags(-bulk)]
   set filename [lindex $args 0]
-  source_ $filename $echo 0
+  if { $bulk } {
+    exceptions_bulk_begin
+    # Merge the exceptions even if reading the file fails.
+    set code [catch {source_ $filename $echo 0} result]
+    exceptions_bulk_end
+    if { $code } {
+      return -code $code $result
+    }
+  } else {
+    source_ $filename $echo 0
+  }
 }
 
 ################################################################
@@ -145,6 +156,33 @@ proc write_sdc { args } {
   write_sdc_cmd $filename $compatible $no_timestamp $digits
 }
 
+################################################################
+
+define_cmd_args "create_mode" {mode_name}
+
+proc create_mode { args } {
+  check_argc_eq1 "create_mode" $args
+  set mode_name [lindex $args 0]
+  if { [has_mode $mode_name] } {
+    sta_error "mode $mode_name already exists."
+  }
+  make_mode $mode_name
+}
+
+################################################################
+
+define_cmd_args "current_mode" {[mode_name]}
+
+# Constraint and timing commands apply to the current mode.
+proc current_mode { {mode_name ""} } {
+  if { $mode_name != "" } {
+    if { ![set_mode_cmd $mode_name] } {
+      sta_error "mode $mode_name not found."
+    }
+  }
+  return [mode_name]
+}
+
 ################################################################
 #
 # General Purpose Commands
@@ -756,6 +756,16 @@ define_sta_cmd_args "replace_cell" {instance lib_cell}
 define_sta_cmd_args "insert_buffer" {buffer_name buffer_cell net load_pins\
 				       buffer_out_net_name}
 
+define_sta_cmd_args "begin_eco" {}
+
+define_sta_cmd_args "commit_eco" {}
+
+define_sta_cmd_args "rollback_eco" {}
+
+define_sta_cmd_args "begin_edit_batch" {}
+
+define_sta_cmd_args "end_edit_batch" {}
+
 ################################################################
 #
 # Delay calculation commands
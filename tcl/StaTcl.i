@@ -37,6 +37,8 @@
 #include "Machine.hh"
 #include "StaConfig.hh"  // STA_VERSION
 #include "Stats.hh"
+#include "Profiler.hh"
+#include "Trace.hh"
 #include "Report.hh"
 #include "Error.hh"
 #include "StringUtil.hh"
@@ -80,6 +82,7 @@
 #include "Power.hh"
 #include "Property.hh"
 #include "WritePathSpice.hh"
+#include "WritePathColumns.hh"
 #include "Sta.hh"
 
 namespace sta {
@@ -1253,6 +1256,10 @@ using namespace sta;
   Tcl_SetObjResult(interp, obj);
 }
 
+%typemap(in) PathEndSeq* {
+  $1 = tclListSeq<PathEnd*>($input, SWIGTYPE_p_PathEnd, interp);
+}
+
 %typemap(out) PathEndSeq* {
   Tcl_Obj *list = Tcl_NewListObj(0, nullptr);
   const PathEndSeq *path_ends = $1;
@@ -4015,6 +4022,18 @@ set_crpr_mode(const char *mode)
     internalError("unknown common clk pessimism mode.");
 }
 
+int
+crpr_arrival_limit()
+{
+  return Sta::sta()->crprArrivalLimit();
+}
+
+void
+set_crpr_arrival_limit(int limit)
+{
+  Sta::sta()->setCrprArrivalLimit(limit);
+}
+
 bool
 pocv_enabled()
 {
@@ -4043,6 +4062,24 @@ set_pocv_sigma_factor(float factor)
   Sta::sta()->setSigmaFactor(factor);
 }
 
+bool
+compact_delays()
+{
+  return Sta::sta()->compactDelays();
+}
+
+void
+set_compact_delays(bool compact)
+{
+  Sta::sta()->setCompactDelays(compact);
+}
+
+double
+delay_memory_bytes()
+{
+  return Sta::sta()->delayMemoryBytes();
+}
+
 bool
 propagate_gated_clock_enable()
 {
@@ -4226,6 +4263,15 @@ report_path_end2(PathEnd *end,
   Sta::sta()->reportPathEnd(end, prev_end);
 }
 
+void
+report_path_ends_cmd(PathEndSeq *ends)
+{
+  // Empty lists are null.
+  PathEndSeq empty_ends;
+  Sta::sta()->reportPathEndsFormatted(ends ? ends : &empty_ends);
+  delete ends;
+}
+
 void
 set_report_path_format(ReportPathFormat format)
 {
@@ -4301,6 +4347,18 @@ remove_constraints()
   Sta::sta()->removeConstraints();
 }
 
+void
+exceptions_bulk_begin()
+{
+  Sta::sta()->exceptionsBulkBegin();
+}
+
+void
+exceptions_bulk_end()
+{
+  Sta::sta()->exceptionsBulkEnd();
+}
+
 void
 report_path_cmd(PathRef *path)
 {
@@ -4675,6 +4733,36 @@ set_power_pin_activity(const Pin *pin,
 					     PwrActivityOrigin::user);
 }
 
+bool
+read_saif_file(const char *filename,
+	       const char *scope)
+{
+  cmdLinkedNetwork();
+  return Sta::sta()->readSaif(filename, scope);
+}
+
+bool
+read_vcd_file(const char *filename,
+	      const char *scope)
+{
+  cmdLinkedNetwork();
+  return Sta::sta()->readVcd(filename, scope);
+}
+
+bool
+report_power_windows_cmd(const char *filename,
+			 const char *scope,
+			 float window_width,
+			 int hier_depth,
+			 const Corner *corner,
+			 int digits,
+			 bool series)
+{
+  cmdLinkedNetwork();
+  return Sta::sta()->reportPowerWindows(filename, scope, window_width,
+					hier_depth, corner, digits, series);
+}
+
 ////////////////////////////////////////////////////////////////
 
 EdgeSeq *
@@ -4694,6 +4782,30 @@ write_sdc_cmd(const char *filename,
   Sta::sta()->writeSdc(filename, compatible, no_timestamp, digits);
 }
 
+void
+make_mode(const char *name)
+{
+  Sta::sta()->makeMode(name);
+}
+
+bool
+has_mode(const char *name)
+{
+  return Sta::sta()->hasMode(name);
+}
+
+bool
+set_mode_cmd(const char *name)
+{
+  return Sta::sta()->setMode(name);
+}
+
+const char *
+mode_name()
+{
+  return Sta::sta()->modeName();
+}
+
 void
 write_path_spice_cmd(PathRef *path,
 		     const char *spice_filename,
@@ -4709,6 +4821,22 @@ write_path_spice_cmd(PathRef *path,
 		 power_name, gnd_name, sta);
 }
 
+void
+write_path_columns_cmd(PathEndSeq *ends,
+		       const char *filename)
+{
+  // Empty lists are null.
+  PathEndSeq empty_ends;
+  writePathColumns(ends ? ends : &empty_ends, filename, Sta::sta());
+  delete ends;
+}
+
+bool
+report_path_columns_cmd(const char *filename)
+{
+  return reportPathColumns(filename, Sta::sta());
+}
+
 bool
 liberty_supply_exists(const char *supply_name)
 {
@@ -5148,6 +5276,116 @@ mem()
   return memoryUsage();
 }
 
+bool
+profile_enabled()
+{
+  return Sta::sta()->debug()->profiler()->enabled();
+}
+
+void
+set_profile_enabled(bool enabled)
+{
+  Sta::sta()->debug()->profiler()->setEnabled(enabled);
+}
+
+void
+report_profile_cmd(int digits)
+{
+  Sta *sta = Sta::sta();
+  sta->debug()->profiler()->report(sta->report(), digits);
+}
+
+void
+write_profile_json(const char *filename)
+{
+  Sta::sta()->debug()->profiler()->writeJson(filename);
+}
+
+void
+write_profile_chrome(const char *filename)
+{
+  Sta::sta()->debug()->profiler()->writeChromeTrace(filename);
+}
+
+bool
+profile_phase_exists(const char *path)
+{
+  return Sta::sta()->debug()->profiler()->findPhase(path) != nullptr;
+}
+
+TmpStringSeq *
+profile_phase_children(const char *path)
+{
+  StringSeq *names = new StringSeq;
+  const ProfilerPhase *phase = Sta::sta()->debug()->profiler()->findPhase(path);
+  if (phase) {
+    for (ProfilerPhase *child : phase->children())
+      names->push_back(child->name());
+  }
+  return names;
+}
+
+// key is count, elapsed, user, system, memory_peak, memory_delta,
+// thread_busy, thread_idle or a counter name.
+double
+profile_phase_value_cmd(const char *path,
+			const char *key)
+{
+  const ProfilerPhase *phase = Sta::sta()->debug()->profiler()->findPhase(path);
+  if (phase) {
+    if (stringEq(key, "count"))
+      return phase->count();
+    else if (stringEq(key, "elapsed"))
+      return phase->elapsed();
+    else if (stringEq(key, "user"))
+      return phase->user();
+    else if (stringEq(key, "system"))
+      return phase->system();
+    else if (stringEq(key, "memory_peak"))
+      return phase->memoryPeak();
+    else if (stringEq(key, "memory_delta"))
+      return phase->memoryDelta();
+    else if (stringEq(key, "thread_busy"))
+      return phase->threadBusy();
+    else if (stringEq(key, "thread_idle"))
+      return phase->threadIdle();
+    else
+      return phase->counter(key);
+  }
+  else
+    return 0.0;
+}
+
+bool
+trace_compiled()
+{
+  return TRACE;
+}
+
+void
+trace_begin_cmd(int buffer_records)
+{
+  traceBegin(buffer_records);
+}
+
+void
+trace_end_cmd()
+{
+  traceEnd();
+}
+
+void
+write_trace_cmd(const char *filename)
+{
+  writeTrace(filename);
+}
+
+void
+report_trace_cmd(const char *filename)
+{
+  reportTrace(filename, Sta::sta()->report());
+}
+
 int
 processor_count()
 {
@@ -293,6 +293,106 @@ proc write_stats { filename } {
 
 ################################################################
 
+# Phase profiles are recorded while sta_profile_enabled is set.
+define_cmd_args "report_profile" {[-digits digits]}
+
+proc report_profile { args } {
+  parse_key_args "report_profile" args keys {-digits} flags {}
+  check_argc_eq0 "report_profile" $args
+
+  set digits 2
+  if { [info exists keys(-digits)] } {
+    set digits $keys(-digits)
+    check_positive_integer "-digits" $digits
+  }
+  report_profile_cmd $digits
+}
+
+define_cmd_args "write_profile" {[-format json|chrome] filename}
+
+proc write_profile { args } {
+  parse_key_args "write_profile" args keys {-format} flags {}
+  check_argc_eq1 "write_profile" $args
+
+  set format "json"
+  if { [info exists keys(-format)] } {
+    set format $keys(-format)
+  }
+  set filename [file nativename [lindex $args 0]]
+  if { $format == "json" } {
+    write_profile_json $filename
+  } elseif { $format == "chrome" } {
+    write_profile_chrome $filename
+  } else {
+    sta_error "-format must be json or chrome."
+  }
+}
+
+# phase is a path of phase names separated by '/' such as
+# update_timing/delay_calc.
+define_cmd_args "profile_phase_value" {phase key}
+
+proc profile_phase_value { phase key } {
+  if { ![profile_phase_exists $phase] } {
+    sta_error "profile phase $phase not found."
+  }
+  return [profile_phase_value_cmd $phase $key]
+}
+
+define_cmd_args "profile_phases" {[phase]}
+
+proc profile_phases { {phase ""} } {
+  if { ![profile_phase_exists $phase] } {
+    sta_error "profile phase $phase not found."
+  }
+  return [profile_phase_children $phase]
+}
+
+################################################################
+
+# Trace points are only compiled in builds with TRACE=1.
+# Each thread records up to buffer_records of the latest events.
+define_cmd_args "trace_begin" {[-buffer_records count]}
+
+proc trace_begin { args } {
+  parse_key_args "trace_begin" args keys {-buffer_records} flags {}
+  check_argc_eq0 "trace_begin" $args
+
+  if { ![trace_compiled] } {
+    sta_error "tracing requires compilation with TRACE=1."
+  }
+  set buffer_records 65536
+  if { [info exists keys(-buffer_records)] } {
+    set buffer_records $keys(-buffer_records)
+    check_positive_integer "-buffer_records" $buffer_records
+  }
+  trace_begin_cmd $buffer_records
+}
+
+define_cmd_args "trace_end" {}
+
+proc trace_end { args } {
+  check_argc_eq0 "trace_end" $args
+  trace_end_cmd
+}
+
+define_cmd_args "write_trace" {filename}
+
+proc write_trace { args } {
+  check_argc_eq1 "write_trace" $args
+  write_trace_cmd [file nativename [lindex $args 0]]
+}
+
+# Decode a file written by write_trace.
+define_cmd_args "report_trace" {filename}
+
+proc report_trace { args } {
+  check_argc_eq1 "report_trace" $args
+  report_trace_cmd [file nativename [lindex $args 0]]
+}
+
+################################################################
+
 # Begin/end logging all output to a file.
 # Defined by StaTcl.i
 define_cmd_args "log_begin" {filename}
@@ -72,6 +72,24 @@ proc trace_crpr_mode { name1 name2 op } {
   }
 }
 
+trace variable ::sta_crpr_arrival_limit "rw" \
+  sta::trace_crpr_arrival_limit
+
+proc trace_crpr_arrival_limit { name1 name2 op } {
+  global sta_crpr_arrival_limit
+
+  if { $op == "r" } {
+    set sta_crpr_arrival_limit [crpr_arrival_limit]
+  } elseif { $op == "w" } {
+    if { [string is integer $sta_crpr_arrival_limit] \
+	   && $sta_crpr_arrival_limit >= 0 } {
+      set_crpr_arrival_limit $sta_crpr_arrival_limit
+    } else {
+      sta_error "sta_crpr_arrival_limit must be a positive integer."
+    }
+  }
+}
+
 trace variable ::sta_cond_default_arcs_enabled "rw" \
   sta::trace_cond_default_arcs_enabled
 
@@ -168,6 +186,22 @@ proc trace_pocv_enabled { name1 name2 op } {
     pocv_enabled set_pocv_enabled
 }
 
+trace variable ::sta_profile_enabled "rw" \
+  sta::trace_profile_enabled
+
+proc trace_profile_enabled { name1 name2 op } {
+  trace_boolean_var $op ::sta_profile_enabled \
+    profile_enabled set_profile_enabled
+}
+
+trace variable ::sta_compact_delays "rw" \
+  sta::trace_compact_delays
+
+proc trace_compact_delays { name1 name2 op } {
+  trace_boolean_var $op ::sta_compact_delays \
+    compact_delays set_compact_delays
+}
+
 # Report path numeric field width is digits + extra.
 set report_path_field_width_extra 5
 
@@ -16,6 +16,7 @@
 
 #include "Machine.hh"
 #include "Report.hh"
+#include "Profiler.hh"
 #include "Debug.hh"
 
 namespace sta {
@@ -25,12 +26,14 @@ bool debug_on = false;
 Debug::Debug(Report *&report) :
   report_(report),
   debug_map_(nullptr),
-  stats_level_(0)
+  stats_level_(0),
+  profiler_(new Profiler)
 {
 }
 
 Debug::~Debug()
 {
+  delete profiler_;
   if (debug_map_) {
     DebugMap::Iterator debug_iter(debug_map_);
     // Delete the debug map keys.
@@ -26,6 +26,7 @@ namespace sta {
 
 class Report;
 class Pin;
+class Profiler;
 
 // Flag that is set when any debug mode is enabled.
 // Debug macros bypass Debug::check map lookup unless some debug mode
@@ -45,6 +46,7 @@ public:
   void setLevel(const char *what,
 		int level);
   int statsLevel() const { return stats_level_; }
+  Profiler *profiler() const { return profiler_; }
   void print(const char *fmt,
 	     ...) const
     __attribute__((format (printf, 2, 3)));
@@ -53,6 +55,7 @@ protected:
   Report *&report_;
   DebugMap *debug_map_;
   int stats_level_;
+  Profiler *profiler_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(Debug);
@@ -85,6 +85,12 @@ memoryUsage()
   return 0;
 }
 
+size_t
+peakMemoryUsage()
+{
+  return 0;
+}
+
 }
 
 #else // _WINDOWS
@@ -173,6 +179,20 @@ memoryUsage()
   return memory;
 }
 
+size_t
+peakMemoryUsage()
+{
+  struct rusage rusage;
+  getrusage(RUSAGE_SELF, &rusage);
+#if defined(__APPLE__)
+  // ru_maxrss is in bytes.
+  return rusage.ru_maxrss;
+#else
+  // ru_maxrss is in kilobytes.
+  return rusage.ru_maxrss * 1024;
+#endif
+}
+
 }
 
 #endif // !_WINDOWS
@@ -0,0 +1,427 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <string.h>
+#include <algorithm>
+#include "Machine.hh"
+#include "Mutex.hh"
+#include "Error.hh"
+#include "StringUtil.hh"
+#include "Report.hh"
+#include "Debug.hh"
+#include "Profiler.hh"
+
+namespace sta {
+
+using std::string;
+
+static void
+writeJsonString(const char *str,
+		FILE *stream);
+
+ProfilerPhase::ProfilerPhase(const char *name,
+			     ProfilerPhase *parent) :
+  name_(name),
+  parent_(parent),
+  count_(0),
+  elapsed_(0.0),
+  user_(0.0),
+  system_(0.0),
+  memory_peak_(0),
+  memory_delta_(0.0)
+{
+}
+
+ProfilerPhase::~ProfilerPhase()
+{
+  for (ProfilerPhase *child : children_)
+    delete child;
+}
+
+ProfilerPhase *
+ProfilerPhase::findChild(const char *name) const
+{
+  for (ProfilerPhase *child : children_) {
+    if (child->name_ == name)
+      return child;
+  }
+  return nullptr;
+}
+
+double
+ProfilerPhase::counter(const char *name) const
+{
+  auto itr = counters_.find(name);
+  if (itr == counters_.end())
+    return 0.0;
+  else
+    return itr->second;
+}
+
+double
+ProfilerPhase::threadBusy(size_t thread_index) const
+{
+  return thread_busy_[thread_index];
+}
+
+double
+ProfilerPhase::threadIdle(size_t thread_index) const
+{
+  return thread_idle_[thread_index];
+}
+
+double
+ProfilerPhase::threadBusy() const
+{
+  double busy = 0.0;
+  for (double thread_busy : thread_busy_)
+    busy += thread_busy;
+  return busy;
+}
+
+double
+ProfilerPhase::threadIdle() const
+{
+  double idle = 0.0;
+  for (double thread_idle : thread_idle_)
+    idle += thread_idle;
+  return idle;
+}
+
+string
+ProfilerPhase::path() const
+{
+  if (parent_ == nullptr)
+    return "";
+  else if (parent_->parent_ == nullptr)
+    return name_;
+  else
+    return parent_->path() + '/' + name_;
+}
+
+////////////////////////////////////////////////////////////////
+
+Profiler::Profiler() :
+  enabled_(false),
+  top_(new ProfilerPhase("", nullptr)),
+  current_(top_),
+  top_begin_(0.0)
+{
+}
+
+Profiler::~Profiler()
+{
+  delete top_;
+}
+
+void
+Profiler::setEnabled(bool enabled)
+{
+  if (enabled && !enabled_) {
+    clear();
+    thread_ = std::this_thread::get_id();
+    top_begin_ = elapsedRunTime();
+  }
+  enabled_ = enabled;
+}
+
+void
+Profiler::clear()
+{
+  delete top_;
+  top_ = new ProfilerPhase("", nullptr);
+  current_ = top_;
+  begin_elapsed_.clear();
+  begin_user_.clear();
+  begin_system_.clear();
+  begin_memory_.clear();
+  events_.clear();
+}
+
+bool
+Profiler::phaseBegin(const char *name)
+{
+  if (enabled_ && std::this_thread::get_id() == thread_) {
+    ProfilerPhase *phase = current_->findChild(name);
+    if (phase == nullptr) {
+      phase = new ProfilerPhase(name, current_);
+      current_->children_.push_back(phase);
+    }
+    // Counters from other threads go to current_.
+    UniqueLock lock(lock_);
+    current_ = phase;
+    begin_elapsed_.push_back(elapsedRunTime());
+    begin_user_.push_back(userRunTime());
+    begin_system_.push_back(systemRunTime());
+    size_t memory = memoryUsage();
+    begin_memory_.push_back(memory);
+    phase->memory_peak_ = std::max(phase->memory_peak_, memory);
+    return true;
+  }
+  else
+    return false;
+}
+
+void
+Profiler::phaseEnd()
+{
+  if (current_ != top_) {
+    UniqueLock lock(lock_);
+    ProfilerPhase *phase = current_;
+    double end = elapsedRunTime();
+    double begin = begin_elapsed_.back();
+    size_t memory = memoryUsage();
+    phase->count_++;
+    phase->elapsed_ += end - begin;
+    phase->user_ += userRunTime() - begin_user_.back();
+    phase->system_ += systemRunTime() - begin_system_.back();
+    phase->memory_delta_ += static_cast<double>(memory)
+      - static_cast<double>(begin_memory_.back());
+    phase->memory_peak_ = std::max(phase->memory_peak_, memory);
+    ProfilerPhase *parent = phase->parent_;
+    parent->memory_peak_ = std::max(parent->memory_peak_, phase->memory_peak_);
+    events_.push_back({phase, begin, end});
+    begin_elapsed_.pop_back();
+    begin_user_.pop_back();
+    begin_system_.pop_back();
+    begin_memory_.pop_back();
+    current_ = parent;
+  }
+}
+
+void
+Profiler::count(const char *counter,
+		double count)
+{
+  UniqueLock lock(lock_);
+  current_->counters_[counter] += count;
+}
+
+void
+Profiler::threadTime(size_t thread_index,
+		     double busy,
+		     double idle)
+{
+  UniqueLock lock(lock_);
+  ProfilerPhase *phase = current_;
+  if (thread_index >= phase->thread_busy_.size()) {
+    phase->thread_busy_.resize(thread_index + 1, 0.0);
+    phase->thread_idle_.resize(thread_index + 1, 0.0);
+  }
+  phase->thread_busy_[thread_index] += busy;
+  phase->thread_idle_[thread_index] += idle;
+}
+
+const ProfilerPhase *
+Profiler::findPhase(const char *path) const
+{
+  const ProfilerPhase *phase = top_;
+  string path1(path);
+  size_t begin = 0;
+  while (phase && begin < path1.size()) {
+    size_t end = path1.find('/', begin);
+    if (end == string::npos)
+      end = path1.size();
+    string name = path1.substr(begin, end - begin);
+    phase = phase->findChild(name.c_str());
+    begin = end + 1;
+  }
+  return phase;
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+Profiler::report(Report *report,
+		 int digits) const
+{
+  int field_width = digits + 6;
+  report->print("%-32s %6s %*s %*s %*s %7s\n",
+		"Phase", "Count",
+		field_width, "Elapsed",
+		field_width, "User",
+		field_width, "Peak MB",
+		"Busy %");
+  for (ProfilerPhase *child : top_->children_)
+    reportPhase(child, 0, digits, report);
+  if (enabled_)
+    report->print("%-32s %6s %*.*f\n", "total", "",
+		  field_width, digits, elapsedRunTime() - top_begin_);
+}
+
+void
+Profiler::reportPhase(const ProfilerPhase *phase,
+		      int depth,
+		      int digits,
+		      Report *report) const
+{
+  int field_width = digits + 6;
+  string name(depth * 2, ' ');
+  name += phase->name();
+  string busy;
+  double thread_busy = phase->threadBusy();
+  double thread_time = thread_busy + phase->threadIdle();
+  if (thread_time > 0.0)
+    stringPrint(busy, "%7.1f", thread_busy / thread_time * 100.0);
+  report->print("%-32s %6d %*.*f %*.*f %*.*f %s\n",
+		name.c_str(),
+		phase->count(),
+		field_width, digits, phase->elapsed(),
+		field_width, digits, phase->user(),
+		field_width, digits, phase->memoryPeak() * 1e-6,
+		busy.c_str());
+  string indent((depth + 2) * 2, ' ');
+  for (auto name_count : phase->counters()) {
+    const string &counter = name_count.first;
+    report->print("%s%s %.0f\n",
+		  indent.c_str(), counter.c_str(), name_count.second);
+    // Report the hit rate of <name>_hits and <name>_misses counters.
+    size_t hits_pos = counter.rfind("_hits");
+    if (hits_pos != string::npos
+	&& hits_pos + strlen("_hits") == counter.size()) {
+      string prefix = counter.substr(0, hits_pos);
+      string misses_name = prefix + "_misses";
+      double hits = name_count.second;
+      double misses = phase->counter(misses_name.c_str());
+      if (hits + misses > 0.0)
+	report->print("%s%s_hit_rate %.1f%%\n",
+		      indent.c_str(), prefix.c_str(),
+		      hits / (hits + misses) * 100.0);
+    }
+  }
+  for (ProfilerPhase *child : phase->children())
+    reportPhase(child, depth + 1, digits, report);
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+Profiler::writeJson(const char *filename) const
+{
+  FILE *stream = fopen(filename, "w");
+  if (stream) {
+    writeJsonPhase(top_, 0, stream);
+    fprintf(stream, "\n");
+    fclose(stream);
+  }
+  else
+    throw FileNotWritable(filename);
+}
+
+void
+Profiler::writeJsonPhase(const ProfilerPhase *phase,
+			 int depth,
+			 FILE *stream) const
+{
+  string indent(depth * 2, ' ');
+  fprintf(stream, "%s{\n", indent.c_str());
+  fprintf(stream, "%s  \"name\": ", indent.c_str());
+  writeJsonString(phase->name(), stream);
+  fprintf(stream, ",\n");
+  fprintf(stream, "%s  \"count\": %d,\n", indent.c_str(), phase->count());
+  fprintf(stream, "%s  \"elapsed\": %.6f,\n", indent.c_str(),
+	  phase->elapsed());
+  fprintf(stream, "%s  \"user\": %.6f,\n", indent.c_str(), phase->user());
+  fprintf(stream, "%s  \"system\": %.6f,\n", indent.c_str(),
+	  phase->system());
+  fprintf(stream, "%s  \"memory_peak\": %lu,\n", indent.c_str(),
+	  static_cast<unsigned long>(phase->memoryPeak()));
+  fprintf(stream, "%s  \"memory_delta\": %.0f,\n", indent.c_str(),
+	  phase->memoryDelta());
+
+  fprintf(stream, "%s  \"counters\": {", indent.c_str());
+  bool first = true;
+  for (auto name_count : phase->counters()) {
+    fprintf(stream, "%s\n%s    ", first ? "" : ",", indent.c_str());
+    writeJsonString(name_count.first.c_str(), stream);
+    fprintf(stream, ": %.0f", name_count.second);
+    first = false;
+  }
+  fprintf(stream, "%s},\n", first ? "" : ("\n" + indent + "  ").c_str());
+
+  fprintf(stream, "%s  \"threads\": [", indent.c_str());
+  for (size_t i = 0; i < phase->threadCount(); i++)
+    fprintf(stream, "%s{\"busy\": %.6f, \"idle\": %.6f}",
+	    (i == 0) ? "" : ", ",
+	    phase->threadBusy(i),
+	    phase->threadIdle(i));
+  fprintf(stream, "],\n");
+
+  fprintf(stream, "%s  \"children\": [", indent.c_str());
+  first = true;
+  for (ProfilerPhase *child : phase->children()) {
+    fprintf(stream, "%s\n", first ? "" : ",");
+    writeJsonPhase(child, depth + 2, stream);
+    first = false;
+  }
+  fprintf(stream, "%s]\n", first ? "" : ("\n" + indent + "  ").c_str());
+  fprintf(stream, "%s}", indent.c_str());
+}
+
+void
+Profiler::writeChromeTrace(const char *filename) const
+{
+  FILE *stream = fopen(filename, "w");
+  if (stream) {
+    fprintf(stream, "{\"traceEvents\": [");
+    bool first = true;
+    for (const ProfilerEvent &event : events_) {
+      fprintf(stream, "%s\n  {\"name\": ", first ? "" : ",");
+      writeJsonString(event.phase_->name(), stream);
+      // Times are in microseconds.
+      fprintf(stream, ", \"cat\": \"sta\", \"ph\": \"X\", \"ts\": %.0f, \"dur\": %.0f, \"pid\": 0, \"tid\": 0}",
+	      (event.begin_ - top_begin_) * 1e6,
+	      (event.end_ - event.begin_) * 1e6);
+      first = false;
+    }
+    fprintf(stream, "\n], \"displayTimeUnit\": \"ms\"}\n");
+    fclose(stream);
+  }
+  else
+    throw FileNotWritable(filename);
+}
+
+static void
+writeJsonString(const char *str,
+		FILE *stream)
+{
+  fputc('"', stream);
+  for (const char *s = str; *s; s++) {
+    char ch = *s;
+    if (ch == '"' || ch == '\\')
+      fputc('\\', stream);
+    fputc(ch, stream);
+  }
+  fputc('"', stream);
+}
+
+////////////////////////////////////////////////////////////////
+
+ProfilePhase::ProfilePhase(Debug *debug,
+			   const char *name) :
+  profiler_(debug->profiler())
+{
+  begun_ = profiler_->enabled()
+    && profiler_->phaseBegin(name);
+}
+
+ProfilePhase::~ProfilePhase()
+{
+  if (begun_)
+    profiler_->phaseEnd();
+}
+
+} // namespace
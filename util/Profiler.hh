@@ -0,0 +1,185 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_PROFILER_H
+#define STA_PROFILER_H
+
+#include <stddef.h>  // size_t
+#include <stdio.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DisallowCopyAssign.hh"
+
+namespace sta {
+
+class Debug;
+class Report;
+class ProfilerPhase;
+
+typedef std::vector<ProfilerPhase*> ProfilerPhaseSeq;
+typedef std::map<std::string, double> ProfilerCounterMap;
+
+// Run time, memory and counters of a named phase summed over the
+// times the phase ran with the same parent phase.
+class ProfilerPhase
+{
+public:
+  ProfilerPhase(const char *name,
+		ProfilerPhase *parent);
+  ~ProfilerPhase();
+  const char *name() const { return name_.c_str(); }
+  ProfilerPhase *parent() const { return parent_; }
+  const ProfilerPhaseSeq &children() const { return children_; }
+  ProfilerPhase *findChild(const char *name) const;
+  // Number of times the phase ran.
+  int count() const { return count_; }
+  // Seconds.
+  double elapsed() const { return elapsed_; }
+  double user() const { return user_; }
+  double system() const { return system_; }
+  // Largest memory use (bytes) seen at the beginning or end of the
+  // phase or its children.
+  size_t memoryPeak() const { return memory_peak_; }
+  // Memory use change (bytes).
+  double memoryDelta() const { return memory_delta_; }
+  double counter(const char *name) const;
+  const ProfilerCounterMap &counters() const { return counters_; }
+  // Threads used by parallel visits in the phase.
+  size_t threadCount() const { return thread_busy_.size(); }
+  // Seconds thread_index spent visiting and waiting for the other
+  // threads to finish a level.
+  double threadBusy(size_t thread_index) const;
+  double threadIdle(size_t thread_index) const;
+  double threadBusy() const;
+  double threadIdle() const;
+  // Phase names from the top phase separated by '/'.
+  std::string path() const;
+
+private:
+  std::string name_;
+  ProfilerPhase *parent_;
+  ProfilerPhaseSeq children_;
+  int count_;
+  double elapsed_;
+  double user_;
+  double system_;
+  size_t memory_peak_;
+  double memory_delta_;
+  ProfilerCounterMap counters_;
+  std::vector<double> thread_busy_;
+  std::vector<double> thread_idle_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProfilerPhase);
+
+  friend class Profiler;
+};
+
+// A run of a phase for traces.
+class ProfilerEvent
+{
+public:
+  const ProfilerPhase *phase_;
+  double begin_;
+  double end_;
+};
+
+typedef std::vector<ProfilerEvent> ProfilerEventSeq;
+
+// Hierarchical phase profiler.
+//
+// Phases are named steps (read_liberty, levelize, delay_calc,
+// arrivals, ...) that nest when one phase runs inside another.
+// Counters and thread busy/idle times are added to the phase that is
+// running, so they can come from the threads of a parallel visit.
+// Phases are only recorded by the thread that enabled the profiler.
+class Profiler
+{
+public:
+  Profiler();
+  ~Profiler();
+  bool enabled() const { return enabled_; }
+  // Enabling the profiler clears any previous results.
+  void setEnabled(bool enabled);
+  void clear();
+  // Return true if the phase was begun.
+  bool phaseBegin(const char *name);
+  void phaseEnd();
+  // Add count to a counter of the running phase.
+  void count(const char *counter,
+	     double count);
+  // Add busy/idle seconds of thread_index to the running phase.
+  void threadTime(size_t thread_index,
+		  double busy,
+		  double idle);
+  // Phases that do not run inside another phase are children of
+  // the top phase.
+  const ProfilerPhase *top() const { return top_; }
+  // Find a phase from its path of names separated by '/'.
+  // The empty path is the top phase.
+  const ProfilerPhase *findPhase(const char *path) const;
+  void report(Report *report,
+	      int digits) const;
+  void writeJson(const char *filename) const;
+  // Chrome trace event format (chrome://tracing, Perfetto).
+  void writeChromeTrace(const char *filename) const;
+
+protected:
+  void reportPhase(const ProfilerPhase *phase,
+		   int depth,
+		   int digits,
+		   Report *report) const;
+  void writeJsonPhase(const ProfilerPhase *phase,
+		      int depth,
+		      FILE *stream) const;
+
+  bool enabled_;
+  std::thread::id thread_;
+  ProfilerPhase *top_;
+  ProfilerPhase *current_;
+  // Begin times and memory of the running phases.
+  std::vector<double> begin_elapsed_;
+  std::vector<double> begin_user_;
+  std::vector<double> begin_system_;
+  std::vector<size_t> begin_memory_;
+  double top_begin_;
+  ProfilerEventSeq events_;
+  std::mutex lock_;
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(Profiler);
+};
+
+// Run a profiler phase for the lifetime of the object.
+//   ProfilePhase phase(debug_, "levelize");
+class ProfilePhase
+{
+public:
+  ProfilePhase(Debug *debug,
+	       const char *name);
+  ~ProfilePhase();
+
+private:
+  Profiler *profiler_;
+  bool begun_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProfilePhase);
+};
+
+} // namespace
+#endif
@@ -23,6 +23,10 @@ namespace sta {
 
 using std::min;
 
+// Redirected output is written to the file directly (not through the
+// Tcl channels) in blocks of this size.
+static const size_t redirect_buffer_size = 1 << 20;
+
 Report::Report() :
   log_stream_(nullptr),
   redirect_stream_(nullptr),
@@ -254,6 +258,7 @@ Report::redirectFileBegin(const char *filename)
   redirect_stream_ = fopen(filename, "w");
   if (redirect_stream_ == nullptr)
     throw FileNotWritable(filename);
+  setvbuf(redirect_stream_, nullptr, _IOFBF, redirect_buffer_size);
 }
 
 void
@@ -262,6 +267,7 @@ Report::redirectFileAppendBegin(const char *filename)
   redirect_stream_ = fopen(filename, "a");
   if (redirect_stream_ == nullptr)
     throw FileNotWritable(filename);
+  setvbuf(redirect_stream_, nullptr, _IOFBF, redirect_buffer_size);
 }
 
 void
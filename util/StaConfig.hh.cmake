@@ -7,3 +7,5 @@
 #define CUDD ${CUDD}
 
 #define SSTA ${SSTA}
+
+#define TRACE ${TRACE}
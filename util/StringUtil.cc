@@ -17,9 +17,7 @@
 #include <limits>
 #include <ctype.h>
 #include <stdio.h>
-#include <mutex>
 #include "Machine.hh"
-#include "Mutex.hh"
 #include "StringUtil.hh"
 
 namespace sta {
@@ -157,38 +155,78 @@ stringPrintTmp(const char *fmt,
 
 ////////////////////////////////////////////////////////////////
 
-static int tmp_string_count_ = 100;
-static char **tmp_strings_ = nullptr;
-static size_t *tmp_string_lengths_ = nullptr;
-static int tmp_string_next_;
-static std::mutex string_lock_;
-
-void
-initTmpStrings()
+// Temporary strings are a ring of strings for each thread so threads
+// formatting names and reports in parallel do not reuse each other's
+// strings. The strings are made when a thread first uses them and
+// deleted when it exits, so threads that return formatted text copy it
+// before they finish.
+class TmpStringRing
 {
-  size_t initial_length = 100;
+public:
+  TmpStringRing();
+  ~TmpStringRing();
+  void tmpString(// Return values.
+		 char *&str,
+		 size_t &length);
+  char *makeTmpString(size_t length);
+
+private:
+  static const int string_count_ = 100;
+  char *strings_[string_count_];
+  size_t string_lengths_[string_count_];
+  int string_next_;
+  static const size_t initial_length_ = 100;
+};
 
-  tmp_strings_ = new char*[tmp_string_count_];
-  tmp_string_lengths_ = new size_t[tmp_string_count_];
-  for (int i = 0; i < tmp_string_count_; i++) {
-    tmp_strings_[i] = new char[initial_length];
-    tmp_string_lengths_[i] = initial_length;
+static thread_local TmpStringRing tmp_strings_;
+
+TmpStringRing::TmpStringRing() :
+  string_next_(0)
+{
+  for (int i = 0; i < string_count_; i++) {
+    strings_[i] = nullptr;
+    string_lengths_[i] = 0;
   }
-  tmp_string_next_ = 0;
+}
+
+TmpStringRing::~TmpStringRing()
+{
+  for (int i = 0; i < string_count_; i++)
+    delete [] strings_[i];
 }
 
 void
-deleteTmpStrings()
+TmpStringRing::tmpString(// Return values.
+			 char *&str,
+			 size_t &length)
 {
-  if (tmp_strings_) {
-    for (int i = 0; i < tmp_string_count_; i++)
-      delete [] tmp_strings_[i];
-    delete [] tmp_strings_;
-    tmp_strings_ = nullptr;
+  if (string_next_ == string_count_)
+    string_next_ = 0;
+  if (strings_[string_next_] == nullptr) {
+    strings_[string_next_] = new char[initial_length_];
+    string_lengths_[string_next_] = initial_length_;
+  }
+  str = strings_[string_next_];
+  length = string_lengths_[string_next_];
+  string_next_++;
+}
 
-    delete [] tmp_string_lengths_;
-    tmp_string_lengths_ = nullptr;
+char *
+TmpStringRing::makeTmpString(size_t length)
+{
+  if (string_next_ == string_count_)
+    string_next_ = 0;
+  char *tmp_str = strings_[string_next_];
+  size_t tmp_length = string_lengths_[string_next_];
+  if (tmp_length < length) {
+    // String isn't long enough.  Make a new one.
+    stringDelete(tmp_str);
+    tmp_str = new char[length];
+    strings_[string_next_] = tmp_str;
+    string_lengths_[string_next_] = length;
   }
+  string_next_++;
+  return tmp_str;
 }
 
 static void
@@ -196,31 +234,13 @@ getTmpString(// Return values.
 	     char *&str,
 	     size_t &length)
 {
-  UniqueLock lock(string_lock_);
-  if (tmp_string_next_ == tmp_string_count_)
-    tmp_string_next_ = 0;
-  str = tmp_strings_[tmp_string_next_];
-  length = tmp_string_lengths_[tmp_string_next_];
-  tmp_string_next_++;
+  tmp_strings_.tmpString(str, length);
 }
 
 char *
 makeTmpString(size_t length)
 {
-  UniqueLock lock(string_lock_);
-  if (tmp_string_next_ == tmp_string_count_)
-    tmp_string_next_ = 0;
-  char *tmp_str = tmp_strings_[tmp_string_next_];
-  size_t tmp_length = tmp_string_lengths_[tmp_string_next_];
-  if (tmp_length < length) {
-    // String isn't long enough.  Make a new one.
-    stringDelete(tmp_str);
-    tmp_str = new char[length];
-    tmp_strings_[tmp_string_next_] = tmp_str;
-    tmp_string_lengths_[tmp_string_next_] = length;
-  }
-  tmp_string_next_++;
-  return tmp_str;
+  return tmp_strings_.makeTmpString(length);
 }
 
 ////////////////////////////////////////////////////////////////
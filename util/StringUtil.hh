@@ -166,10 +166,6 @@ integerString(int number);
 
 char *
 makeTmpString(size_t length);
-void
-initTmpStrings();
-void
-deleteTmpStrings();
 
 ////////////////////////////////////////////////////////////////
 
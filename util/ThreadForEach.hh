@@ -17,6 +17,8 @@
 #ifndef STA_THREAD_FOR_EACH_H
 #define STA_THREAD_FOR_EACH_H
 
+#include <algorithm>
+#include <exception>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -108,5 +110,50 @@ forEach(Iterator *iter,
   }
 }
 
+// Call func(thread_index) in thread_count threads and wait for them
+// to finish. An exception thrown by func is rethrown after the join.
+template<class Func>
+void
+forEachThread(size_t thread_count,
+	      Func func)
+{
+  std::vector<std::thread> threads;
+  std::vector<std::exception_ptr> thread_excps(thread_count);
+  for (size_t i = 0; i < thread_count; i++)
+    threads.push_back(std::thread([&func, &thread_excps, i] () {
+      try {
+	func(i);
+      }
+      catch (...) {
+	thread_excps[i] = std::current_exception();
+      }
+    }));
+  for (auto &thread : threads)
+    thread.join();
+  for (auto &excp : thread_excps) {
+    if (excp)
+      std::rethrow_exception(excp);
+  }
+}
+
+// Split [0, count) into at most thread_count contiguous chunks and
+// call func(chunk_index, begin, end) for each chunk in its own thread.
+template<class Func>
+void
+forEachChunk(size_t count,
+	     size_t thread_count,
+	     Func func)
+{
+  if (count > 0) {
+    size_t chunk_size = (count + thread_count - 1) / thread_count;
+    size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    forEachThread(chunk_count, [&func, chunk_size, count] (size_t i) {
+      size_t begin = i * chunk_size;
+      size_t end = std::min(begin + chunk_size, count);
+      func(i, begin, end);
+    });
+  }
+}
+
 } // namespace
 #endif
@@ -0,0 +1,483 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Machine.hh"
+#include "Error.hh"
+#include "Mutex.hh"
+#include "Report.hh"
+#include "Trace.hh"
+
+namespace sta {
+
+using std::string;
+
+bool trace_on = false;
+
+// Trace file layout (native byte order):
+//  "STATRC02"
+//  uint64 begin time (ns)
+//  uint32 event count
+//   uint32 name length, name, arg types[4]
+//  uint32 lane count
+//   uint64 dropped record count, uint64 record count, records
+//  record: uint64 time, uint32 event, uint32 thread, uint64 args[4]
+static const char trace_file_magic[] = "STATRC02";
+static const size_t trace_file_magic_length = 8;
+
+class TraceRecord
+{
+public:
+  uint64_t time_;
+  uint32_t event_;
+  // Buffers are reused by the threads of later parallel visits, so
+  // the thread is recorded with each record.
+  uint32_t thread_;
+  uint64_t args_[TraceEvent::arg_count_max];
+};
+
+// Ring buffer of the records of one thread.
+// Only the owning thread writes records. The writer publishes a record
+// by advancing head_, so the records can be read without locking once
+// tracing has ended.
+class TraceBuffer
+{
+public:
+  TraceBuffer(size_t records);
+  void reset(size_t records);
+  void record(const TraceEvent *event,
+	      uint32_t thread,
+	      uint64_t arg1,
+	      uint64_t arg2,
+	      uint64_t arg3,
+	      uint64_t arg4);
+  // Number of records written since the last reset.
+  uint64_t head() const { return head_.load(std::memory_order_acquire); }
+  size_t capacity() const { return records_.size(); }
+  const TraceRecord &record(uint64_t index) const
+  { return records_[index & mask_]; }
+
+private:
+  std::vector<TraceRecord> records_;
+  uint64_t mask_;
+  std::atomic<uint64_t> head_;
+};
+
+// Gives the buffer of a thread back to the free buffers when the
+// thread exits so the threads of each parallel visit reuse them.
+class TraceBufferHolder
+{
+public:
+  TraceBufferHolder();
+  ~TraceBufferHolder();
+
+  TraceBuffer *buffer_;
+  // Number of the thread in the order threads first record.
+  uint32_t thread_;
+};
+
+static uint64_t
+traceTime();
+static size_t
+roundPowerOf2(size_t size);
+static void
+writeUint32(uint32_t value,
+	    FILE *stream);
+static void
+writeUint64(uint64_t value,
+	    FILE *stream);
+static bool
+readUint32(uint32_t &value,
+	   FILE *stream);
+static bool
+readUint64(uint64_t &value,
+	   FILE *stream);
+
+static std::mutex trace_lock;
+static std::vector<const TraceEvent*> trace_events;
+// Buffers are never deleted because trace points running in other
+// threads may hold them.
+static std::vector<TraceBuffer*> trace_buffers;
+static std::vector<TraceBuffer*> trace_free_buffers;
+static size_t trace_buffer_records = 1 << 16;
+static uint64_t trace_begin_time = 0;
+static std::atomic<uint32_t> trace_thread_count(0);
+static thread_local TraceBufferHolder trace_buffer_holder;
+
+TraceEvent::TraceEvent(const char *name,
+		       TraceArgType arg1_type,
+		       TraceArgType arg2_type,
+		       TraceArgType arg3_type,
+		       TraceArgType arg4_type) :
+  name_(name)
+{
+  arg_types_[0] = arg1_type;
+  arg_types_[1] = arg2_type;
+  arg_types_[2] = arg3_type;
+  arg_types_[3] = arg4_type;
+  UniqueLock lock(trace_lock);
+  id_ = trace_events.size();
+  trace_events.push_back(this);
+}
+
+////////////////////////////////////////////////////////////////
+
+TraceBuffer::TraceBuffer(size_t records) :
+  head_(0)
+{
+  reset(records);
+}
+
+void
+TraceBuffer::reset(size_t records)
+{
+  records = roundPowerOf2(records);
+  records_.resize(records);
+  records_.shrink_to_fit();
+  mask_ = records - 1;
+  head_.store(0, std::memory_order_release);
+}
+
+void
+TraceBuffer::record(const TraceEvent *event,
+		    uint32_t thread,
+		    uint64_t arg1,
+		    uint64_t arg2,
+		    uint64_t arg3,
+		    uint64_t arg4)
+{
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  TraceRecord &record = records_[head & mask_];
+  record.time_ = traceTime();
+  record.event_ = event->id();
+  record.thread_ = thread;
+  record.args_[0] = arg1;
+  record.args_[1] = arg2;
+  record.args_[2] = arg3;
+  record.args_[3] = arg4;
+  head_.store(head + 1, std::memory_order_release);
+}
+
+TraceBufferHolder::TraceBufferHolder() :
+  buffer_(nullptr),
+  thread_(trace_thread_count++)
+{
+}
+
+TraceBufferHolder::~TraceBufferHolder()
+{
+  if (buffer_) {
+    UniqueLock lock(trace_lock);
+    trace_free_buffers.push_back(buffer_);
+  }
+}
+
+static TraceBuffer *
+threadTraceBuffer()
+{
+  TraceBuffer *buffer = trace_buffer_holder.buffer_;
+  if (buffer == nullptr) {
+    UniqueLock lock(trace_lock);
+    if (trace_free_buffers.empty()) {
+      buffer = new TraceBuffer(trace_buffer_records);
+      trace_buffers.push_back(buffer);
+    }
+    else {
+      buffer = trace_free_buffers.back();
+      trace_free_buffers.pop_back();
+    }
+    trace_buffer_holder.buffer_ = buffer;
+  }
+  return buffer;
+}
+
+void
+traceRecord(const TraceEvent *event,
+	    uint64_t arg1,
+	    uint64_t arg2,
+	    uint64_t arg3,
+	    uint64_t arg4)
+{
+  threadTraceBuffer()->record(event, trace_buffer_holder.thread_,
+			      arg1, arg2, arg3, arg4);
+}
+
+////////////////////////////////////////////////////////////////
+
+void
+traceBegin(size_t buffer_records)
+{
+  UniqueLock lock(trace_lock);
+  trace_buffer_records = roundPowerOf2(std::max(buffer_records,
+						static_cast<size_t>(1)));
+  for (TraceBuffer *buffer : trace_buffers)
+    buffer->reset(trace_buffer_records);
+  trace_begin_time = traceTime();
+  trace_on = true;
+}
+
+void
+traceEnd()
+{
+  trace_on = false;
+}
+
+void
+writeTrace(const char *filename)
+{
+  FILE *stream = fopen(filename, "wb");
+  if (stream) {
+    UniqueLock lock(trace_lock);
+    fwrite(trace_file_magic, 1, trace_file_magic_length, stream);
+    writeUint64(trace_begin_time, stream);
+    writeUint32(trace_events.size(), stream);
+    for (const TraceEvent *event : trace_events) {
+      uint32_t name_length = strlen(event->name());
+      writeUint32(name_length, stream);
+      fwrite(event->name(), 1, name_length, stream);
+      for (int i = 0; i < TraceEvent::arg_count_max; i++)
+	fputc(static_cast<char>(event->argType(i)), stream);
+    }
+    writeUint32(trace_buffers.size(), stream);
+    for (TraceBuffer *buffer : trace_buffers) {
+      uint64_t head = buffer->head();
+      uint64_t tail = (head > buffer->capacity())
+	? head - buffer->capacity()
+	: 0;
+      // Records that were overwritten.
+      writeUint64(tail, stream);
+      writeUint64(head - tail, stream);
+      for (uint64_t i = tail; i < head; i++)
+	fwrite(&buffer->record(i), sizeof(TraceRecord), 1, stream);
+    }
+    bool failed = ferror(stream);
+    fclose(stream);
+    if (failed)
+      throw FileNotWritable(filename);
+  }
+  else
+    throw FileNotWritable(filename);
+}
+
+////////////////////////////////////////////////////////////////
+
+class TraceFileEvent
+{
+public:
+  string name_;
+  char arg_types_[TraceEvent::arg_count_max];
+};
+
+class TraceFileRecord
+{
+public:
+  uint32_t lane_;
+  TraceRecord record_;
+};
+
+static bool
+readTraceFile(FILE *stream,
+	      uint64_t &begin_time,
+	      std::vector<TraceFileEvent> &events,
+	      std::vector<TraceFileRecord> &records,
+	      uint64_t &dropped);
+static void
+reportTraceArg(char arg_type,
+	       uint64_t arg,
+	       string &line);
+
+void
+reportTrace(const char *filename,
+	    Report *report)
+{
+  FILE *stream = fopen(filename, "rb");
+  if (stream == nullptr)
+    throw FileNotReadable(filename);
+  uint64_t begin_time;
+  std::vector<TraceFileEvent> events;
+  std::vector<TraceFileRecord> records;
+  uint64_t dropped;
+  bool valid = readTraceFile(stream, begin_time, events, records, dropped);
+  fclose(stream);
+  if (!valid) {
+    report->error("%s is not a trace file.\n", filename);
+    return;
+  }
+  // Records of each lane are in time order, so a stable sort keeps
+  // records with the same time in the order they were written.
+  std::stable_sort(records.begin(), records.end(),
+		   [] (const TraceFileRecord &record1,
+		       const TraceFileRecord &record2) {
+		     return record1.record_.time_ < record2.record_.time_;
+		   });
+  if (dropped > 0)
+    report->print("%llu records overwritten\n",
+		  static_cast<unsigned long long>(dropped));
+  report->print("    Time(us) Lane Thread Event\n");
+  for (const TraceFileRecord &file_record : records) {
+    const TraceRecord &record = file_record.record_;
+    double time = (record.time_ >= begin_time)
+      ? (record.time_ - begin_time) * 1e-3
+      : 0.0;
+    if (record.event_ < events.size()) {
+      const TraceFileEvent &event = events[record.event_];
+      string line;
+      for (int i = 0; i < TraceEvent::arg_count_max; i++)
+	reportTraceArg(event.arg_types_[i], record.args_[i], line);
+      report->print("%12.3f %4u %6u %s%s\n",
+		    time,
+		    file_record.lane_,
+		    record.thread_,
+		    event.name_.c_str(),
+		    line.c_str());
+    }
+  }
+}
+
+static bool
+readTraceFile(FILE *stream,
+	      uint64_t &begin_time,
+	      std::vector<TraceFileEvent> &events,
+	      std::vector<TraceFileRecord> &records,
+	      uint64_t &dropped)
+{
+  char magic[trace_file_magic_length];
+  if (fread(magic, 1, trace_file_magic_length, stream)
+      != trace_file_magic_length
+      || memcmp(magic, trace_file_magic, trace_file_magic_length) != 0)
+    return false;
+  uint32_t event_count;
+  if (!readUint64(begin_time, stream)
+      || !readUint32(event_count, stream))
+    return false;
+  events.resize(event_count);
+  for (TraceFileEvent &event : events) {
+    uint32_t name_length;
+    if (!readUint32(name_length, stream))
+      return false;
+    event.name_.resize(name_length);
+    if (fread(&event.name_[0], 1, name_length, stream) != name_length
+	|| fread(event.arg_types_, 1, TraceEvent::arg_count_max, stream)
+	!= TraceEvent::arg_count_max)
+      return false;
+  }
+  uint32_t lane_count;
+  if (!readUint32(lane_count, stream))
+    return false;
+  dropped = 0;
+  for (uint32_t lane = 0; lane < lane_count; lane++) {
+    uint64_t lane_dropped, record_count;
+    if (!readUint64(lane_dropped, stream)
+	|| !readUint64(record_count, stream))
+      return false;
+    dropped += lane_dropped;
+    for (uint64_t i = 0; i < record_count; i++) {
+      TraceFileRecord file_record;
+      file_record.lane_ = lane;
+      if (fread(&file_record.record_, sizeof(TraceRecord), 1, stream) != 1)
+	return false;
+      records.push_back(file_record);
+    }
+  }
+  return true;
+}
+
+static void
+reportTraceArg(char arg_type,
+	       uint64_t arg,
+	       string &line)
+{
+  char buffer[32];
+  switch (static_cast<TraceArgType>(arg_type)) {
+  case TraceArgType::integer:
+    snprintf(buffer, sizeof(buffer), " %lld",
+	     static_cast<long long>(static_cast<int64_t>(arg)));
+    break;
+  case TraceArgType::unsign:
+    snprintf(buffer, sizeof(buffer), " %llu",
+	     static_cast<unsigned long long>(arg));
+    break;
+  case TraceArgType::real: {
+    double value;
+    memcpy(&value, &arg, sizeof(value));
+    snprintf(buffer, sizeof(buffer), " %.6g", value);
+    break;
+  }
+  case TraceArgType::pointer:
+    snprintf(buffer, sizeof(buffer), " 0x%llx",
+	     static_cast<unsigned long long>(arg));
+    break;
+  case TraceArgType::none:
+  default:
+    return;
+  }
+  line += buffer;
+}
+
+////////////////////////////////////////////////////////////////
+
+static uint64_t
+traceTime()
+{
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+    .count();
+}
+
+static size_t
+roundPowerOf2(size_t size)
+{
+  size_t power = 1;
+  while (power < size)
+    power <<= 1;
+  return power;
+}
+
+static void
+writeUint32(uint32_t value,
+	    FILE *stream)
+{
+  fwrite(&value, sizeof(value), 1, stream);
+}
+
+static void
+writeUint64(uint64_t value,
+	    FILE *stream)
+{
+  fwrite(&value, sizeof(value), 1, stream);
+}
+
+static bool
+readUint32(uint32_t &value,
+	   FILE *stream)
+{
+  return fread(&value, sizeof(value), 1, stream) == 1;
+}
+
+static bool
+readUint64(uint64_t &value,
+	   FILE *stream)
+{
+  return fread(&value, sizeof(value), 1, stream) == 1;
+}
+
+} // namespace
@@ -0,0 +1,216 @@
+// OpenSTA, Static Timing Analyzer
+// Copyright (c) 2019, Parallax Software, Inc.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef STA_TRACE_H
+#define STA_TRACE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "StaConfig.hh"  // TRACE
+#include "DisallowCopyAssign.hh"
+
+namespace sta {
+
+class Report;
+
+// Binary event tracing for multi-threaded code.
+//
+// Trace points are compiled out unless the build has TRACE=1.
+// When they are compiled in, a trace point records the time, the
+// thread, its event and up to 4 integer, float or pointer arguments in
+// a ring buffer of the thread that hits it. Recording does not lock or
+// format, so tracing a parallel timing update does not serialize it.
+// The buffers are written to a file by writeTrace and decoded later
+// by reportTrace.
+//
+//   traceEvent2("arrival_visit", graph->index(vertex), vertex->level());
+
+// Flag that is set while tracing. Trace points only record when it is set.
+extern bool trace_on;
+
+// Argument types stored with the event.
+enum class TraceArgType : char { none = 0, integer = 'i', unsign = 'u',
+				 real = 'f', pointer = 'p' };
+
+class TraceEvent
+{
+public:
+  TraceEvent(const char *name,
+	     TraceArgType arg1_type = TraceArgType::none,
+	     TraceArgType arg2_type = TraceArgType::none,
+	     TraceArgType arg3_type = TraceArgType::none,
+	     TraceArgType arg4_type = TraceArgType::none);
+  const char *name() const { return name_; }
+  uint32_t id() const { return id_; }
+  TraceArgType argType(int arg_index) const { return arg_types_[arg_index]; }
+
+  static const int arg_count_max = 4;
+
+private:
+  const char *name_;
+  uint32_t id_;
+  TraceArgType arg_types_[arg_count_max];
+
+  DISALLOW_COPY_AND_ASSIGN(TraceEvent);
+};
+
+// Begin tracing with ring buffers of buffer_records records.
+// Previous records are discarded.
+// Not thread safe; call while no timing threads are running.
+void
+traceBegin(size_t buffer_records);
+void
+traceEnd();
+// Write the records in the thread buffers to filename.
+void
+writeTrace(const char *filename);
+// Decode the records of a trace file in time order.
+void
+reportTrace(const char *filename,
+	    Report *report);
+
+void
+traceRecord(const TraceEvent *event,
+	    uint64_t arg1,
+	    uint64_t arg2,
+	    uint64_t arg3,
+	    uint64_t arg4);
+
+template <class T>
+inline TraceArgType
+traceArgType()
+{
+  typedef typename std::decay<T>::type Type;
+  if (std::is_floating_point<Type>::value)
+    return TraceArgType::real;
+  else if (std::is_pointer<Type>::value)
+    return TraceArgType::pointer;
+  else if (std::is_signed<Type>::value)
+    return TraceArgType::integer;
+  else
+    return TraceArgType::unsign;
+}
+
+inline uint64_t
+traceArgBits(double arg)
+{
+  uint64_t bits;
+  memcpy(&bits, &arg, sizeof(bits));
+  return bits;
+}
+
+inline uint64_t
+traceArgBits(float arg)
+{
+  return traceArgBits(static_cast<double>(arg));
+}
+
+template <class T>
+inline uint64_t
+traceArgBits(T arg,
+	     // is_pointer
+	     std::true_type)
+{
+  return reinterpret_cast<uintptr_t>(arg);
+}
+
+template <class T>
+inline uint64_t
+traceArgBits(T arg,
+	     // is_pointer
+	     std::false_type)
+{
+  // Sign extend signed integers.
+  return static_cast<uint64_t>(static_cast<int64_t>(arg));
+}
+
+template <class T>
+inline uint64_t
+traceArgBits(T arg)
+{
+  return traceArgBits(arg, std::is_pointer<T>());
+}
+
+} // namespace
+
+#if TRACE
+
+#define traceEvent0(name) \
+  do { \
+    if (sta::trace_on) { \
+      static const sta::TraceEvent trace_event(name); \
+      sta::traceRecord(&trace_event, 0, 0, 0, 0); \
+    } \
+  } while (0)
+
+#define traceEvent1(name, arg1) \
+  do { \
+    if (sta::trace_on) { \
+      static const sta::TraceEvent trace_event(name, \
+        sta::traceArgType<decltype(arg1)>()); \
+      sta::traceRecord(&trace_event, sta::traceArgBits(arg1), 0, 0, 0); \
+    } \
+  } while (0)
+
+#define traceEvent2(name, arg1, arg2) \
+  do { \
+    if (sta::trace_on) { \
+      static const sta::TraceEvent trace_event(name, \
+        sta::traceArgType<decltype(arg1)>(), \
+        sta::traceArgType<decltype(arg2)>()); \
+      sta::traceRecord(&trace_event, sta::traceArgBits(arg1), \
+		       sta::traceArgBits(arg2), 0, 0); \
+    } \
+  } while (0)
+
+#define traceEvent3(name, arg1, arg2, arg3) \
+  do { \
+    if (sta::trace_on) { \
+      static const sta::TraceEvent trace_event(name, \
+        sta::traceArgType<decltype(arg1)>(), \
+        sta::traceArgType<decltype(arg2)>(), \
+        sta::traceArgType<decltype(arg3)>()); \
+      sta::traceRecord(&trace_event, sta::traceArgBits(arg1), \
+		       sta::traceArgBits(arg2), sta::traceArgBits(arg3), 0); \
+    } \
+  } while (0)
+
+#define traceEvent4(name, arg1, arg2, arg3, arg4) \
+  do { \
+    if (sta::trace_on) { \
+      static const sta::TraceEvent trace_event(name, \
+        sta::traceArgType<decltype(arg1)>(), \
+        sta::traceArgType<decltype(arg2)>(), \
+        sta::traceArgType<decltype(arg3)>(), \
+        sta::traceArgType<decltype(arg4)>()); \
+      sta::traceRecord(&trace_event, sta::traceArgBits(arg1), \
+		       sta::traceArgBits(arg2), sta::traceArgBits(arg3), \
+		       sta::traceArgBits(arg4)); \
+    } \
+  } while (0)
+
+#else
+
+#define traceEvent0(name) do { } while (0)
+#define traceEvent1(name, arg1) do { } while (0)
+#define traceEvent2(name, arg1, arg2) do { } while (0)
+#define traceEvent3(name, arg1, arg2, arg3) do { } while (0)
+#define traceEvent4(name, arg1, arg2, arg3, arg4) do { } while (0)
+
+#endif
+
+#endif
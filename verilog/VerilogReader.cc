@@ -21,6 +21,7 @@
 #include "Report.hh"
 #include "Error.hh"
 #include "Stats.hh"
+#include "Profiler.hh"
 #include "PortDirection.hh"
 #include "Liberty.hh"
 #include "Network.hh"
@@ -179,6 +180,7 @@ VerilogReader::read(const char *filename)
   // Use zlib to uncompress gzip'd files automagically.
   stream_ = gzopen(filename, "rb");
   if (stream_) {
+    ProfilePhase phase(debug_, "read_verilog");
     Stats stats(debug_);
     init(filename);
     bool success = (::VerilogParse_parse() == 0);